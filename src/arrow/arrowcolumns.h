@@ -0,0 +1,297 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARROWCOLUMNS_H
+#define ARROWCOLUMNS_H
+
+#include "global.h"
+#include "basics.h"
+
+#include "common.h"
+
+#include <cstdint>
+#include <cstdio>
+
+/*
+ * Columns of the Arrow and Parquet tables, one function per report type.
+ *
+ * Each call names a column and gives its value for the report; the
+ * present flag of the data item becomes the validity of the column, a
+ * t_Tres is a boolean that is null while undefined. time() marks a time
+ * of day; both tables store it as a double in seconds, as the report
+ * structures and the JSON output do, since the 1/128 s and finer ASTERIX
+ * resolutions do not fit milliseconds. Column names follow the JSON keys,
+ * with the members of a data item joined by '_'. Units are those of the
+ * report structures (metres, radians, seconds).
+ *
+ * The columns are a chosen subset of the report structures, not all of
+ * their data items: per report type the identification (time, source,
+ * category, line number), position, height, codes and identities, speed,
+ * the detection type and Mode S flags, the status flags used for
+ * filtering and the BDS registers as sent (number and hex value, up to
+ * M_MAX_BDS_REGISTERS per report, under the JSON keys bds0 ...). Items
+ * left out (e.g. quality and accuracy items, ACAS reports, the decoded
+ * BDS contents, WEC lists) are available from the JSON output.
+ *
+ * The column order must not depend on the report, it is the schema.
+ */
+
+// days since 1970-01-01 of a proleptic Gregorian date
+inline int32_t daysSinceEpoch (const t_Date& date)
+{
+    int y = date.year - (date.month <= 2 ? 1 : 0);
+    int era = (y >= 0 ? y : y - 399) / 400;
+    int yoe = y - era * 400;
+    int doy = (153 * (date.month + (date.month > 2 ? -3 : 9)) + 2) / 5 + date.day - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+    return era * 146097 + doe - 719468;
+}
+
+// column names, per BDS register of a report
+static const char* const arrow_bds_columns[][2] =
+{
+    { "bds0_number", "bds0_value" }, { "bds1_number", "bds1_value" },
+    { "bds2_number", "bds2_value" }, { "bds3_number", "bds3_value" },
+    { "bds4_number", "bds4_value" }, { "bds5_number", "bds5_value" },
+    { "bds6_number", "bds6_value" }, { "bds7_number", "bds7_value" },
+    { "bds8_number", "bds8_value" }, { "bds9_number", "bds9_value" },
+    { "bds10_number", "bds10_value" }, { "bds11_number", "bds11_value" }
+};
+static_assert (sizeof (arrow_bds_columns) / sizeof (arrow_bds_columns[0]) == M_MAX_BDS_REGISTERS,
+               "Arrow columns of the BDS registers");
+
+// the first count registers, the value as 14 hex digits like the JSON output
+template <typename A>
+void arrowBdsColumns (A& a, const t_BDS_Register* registers, int count)
+{
+    for (int cnt = 0; cnt < M_MAX_BDS_REGISTERS; ++cnt)
+    {
+        const t_BDS_Register& reg = registers[cnt];
+        bool present = cnt < count && reg.present;
+        char text[2 * M_BDS_REGISTER_LENGTH + 1];
+
+        text[0] = '\0';
+        if (present)
+        {
+            for (int ix = 0; ix < M_BDS_REGISTER_LENGTH; ++ix)
+                snprintf (&text[2 * ix], 3, "%02X", reg.value[ix]);
+        }
+
+        a.value (arrow_bds_columns[cnt][0], present, reg.number);
+        a.value (arrow_bds_columns[cnt][1], present, static_cast<const char*> (text));
+    }
+}
+
+template <typename A>
+void arrowDetectionType (A& a, const t_Detection_Type& d)
+{
+    // members of an absent item are undefined, i.e. null
+    t_Tres u = e_is_undefined;
+
+    a.tres ("detection_type_from_fixed_field_transponder", d.present ? d.from_fixed_field_transponder : u);
+    a.tres ("detection_type_is_radar_track", d.present ? d.is_radar_track : u);
+    a.tres ("detection_type_is_raw_plot", d.present ? d.is_raw_plot : u);
+    a.tres ("detection_type_mode_s_all_call", d.present ? d.mode_s_all_call : u);
+    a.tres ("detection_type_mode_s_roll_call", d.present ? d.mode_s_roll_call : u);
+    a.tres ("detection_type_reported_from_ads", d.present ? d.reported_from_ads : u);
+    a.tres ("detection_type_reported_from_mds", d.present ? d.reported_from_mds : u);
+    a.tres ("detection_type_reported_from_mlt", d.present ? d.reported_from_mlt : u);
+    a.tres ("detection_type_reported_from_psr", d.present ? d.reported_from_psr : u);
+    a.tres ("detection_type_reported_from_ssr", d.present ? d.reported_from_ssr : u);
+    a.value ("detection_type_sector_crossing", d.present, d.sector_crossing != 0);
+    a.tres ("detection_type_simulated", d.present ? d.simulated : u);
+    a.tres ("detection_type_test_target", d.present ? d.test_target : u);
+}
+
+template <typename A>
+void arrowColumns (A& a, const t_Adsb& r)
+{
+    a.value ("frame_date", r.frame_date.present, r.frame_date.value);
+    a.time ("frame_time", r.frame_time.present, r.frame_time.value);
+    a.value ("asterix_category", true, r.asterix_category);
+    a.value ("line_number", true, r.line_number);
+    a.value ("data_source_identifier_sac", r.data_source_identifier.present, r.data_source_identifier.sac);
+    a.value ("data_source_identifier_sic", r.data_source_identifier.present, r.data_source_identifier.sic);
+    a.value ("sensor_number", r.sensor_number.present, r.sensor_number.value);
+    a.time ("detection_time", r.detection_time.present, r.detection_time.value);
+    a.time ("time_of_report", r.time_of_report.present, r.time_of_report.value);
+    a.time ("toa_position", r.toa_position.present, r.toa_position.value);
+    a.time ("toa_velocity", r.toa_velocity.present, r.toa_velocity.value);
+    arrowDetectionType (a, r.detection_type);
+    a.value ("target_address", r.target_address.present, r.target_address.value);
+    a.value ("target_identification", r.target_identification.present, r.target_identification.value_idt);
+    a.value ("track_number", r.track_number.present, r.track_number.value);
+    a.value ("wgs84_position_lat_rad", r.wgs84_position.present, r.wgs84_position.value_lat);
+    a.value ("wgs84_position_lon_rad", r.wgs84_position.present, r.wgs84_position.value_lon);
+    a.flag ("wgs84_position_high_precision", r.wgs84_position.high_precision);
+    a.value ("mode_3_info_code", r.mode_3a_info.present, r.mode_3a_info.code);
+    a.tres ("mode_3_info_code_invalid", r.mode_3a_info.code_invalid);
+    a.value ("mode_c_height_m", r.mode_c_height.present, r.mode_c_height.value);
+    a.value ("geometric_altitude_m", r.geometric_altitude.present, r.geometric_altitude.value);
+    a.value ("ground_vector_gsp_ms", r.ground_vector.present, r.ground_vector.value_gsp);
+    a.value ("ground_vector_hdg_rad", r.ground_vector.present, r.ground_vector.value_hdg);
+    a.flag ("ground_bit_set", r.ground_bit_set);
+    a.flag ("special_position_indication", r.special_position_indication);
+    a.tres ("differential_correction", r.differential_correction);
+    a.tres ("range_check", r.range_check);
+    arrowBdsColumns (a, r.bds_registers, M_MAX_BDS_REGISTERS);
+}
+
+template <typename A>
+void arrowColumns (A& a, const t_Mlat& r)
+{
+    a.value ("frame_date", r.frame_date.present, r.frame_date.value);
+    a.time ("frame_time", r.frame_time.present, r.frame_time.value);
+    a.value ("asterix_category", true, r.asterix_category);
+    a.value ("line_number", true, r.line_number);
+    a.value ("data_source_identifier_sac", r.data_source_identifier.present, r.data_source_identifier.sac);
+    a.value ("data_source_identifier_sic", r.data_source_identifier.present, r.data_source_identifier.sic);
+    a.value ("sensor_number", r.sensor_number.present, r.sensor_number.value);
+    a.time ("detection_time", r.detection_time.present, r.detection_time.value);
+    arrowDetectionType (a, r.detection_type);
+    a.value ("target_address", r.target_address.present, r.target_address.value);
+    a.value ("target_identification", r.target_identification.present, r.target_identification.value_idt);
+    a.value ("track_number", r.track_number.present, r.track_number.value);
+    a.value ("computed_position_x", r.computed_position.present, r.computed_position.value_x);
+    a.value ("computed_position_y", r.computed_position.present, r.computed_position.value_y);
+    a.value ("wgs84_position_lat_rad", r.wgs84_position.present, r.wgs84_position.value_lat);
+    a.value ("wgs84_position_lon_rad", r.wgs84_position.present, r.wgs84_position.value_lon);
+    a.value ("mode_3_info_code", r.mode_3a_info.present, r.mode_3a_info.code);
+    a.tres ("mode_3_info_code_invalid", r.mode_3a_info.code_invalid);
+    a.value ("mode_c_height_m", r.mode_c_height.present, r.mode_c_height.value);
+    a.value ("ground_vector_gsp_ms", r.ground_vector.present, r.ground_vector.value_gsp);
+    a.value ("ground_vector_hdg_rad", r.ground_vector.present, r.ground_vector.value_hdg);
+    a.flag ("ground_bit_set", r.ground_bit_set);
+    a.flag ("special_position_indication", r.special_position_indication);
+    a.tres ("fs_airborne", r.fs_airborne);
+    a.tres ("fs_alert", r.fs_alert);
+    a.tres ("fs_on_ground", r.fs_on_ground);
+    a.tres ("fs_spi", r.fs_spi);
+    arrowBdsColumns (a, r.bds_registers, M_MAX_BDS_REGISTERS);
+}
+
+template <typename A>
+void arrowColumns (A& a, const t_Rsrv& r)
+{
+    a.value ("frame_date", r.frame_date.present, r.frame_date.value);
+    a.time ("frame_time", r.frame_time.present, r.frame_time.value);
+    a.value ("asterix_category", true, r.asterix_category);
+    a.value ("rsrv_type", true, static_cast<uint8_t> (r.rsrv_type));
+    a.value ("data_source_identifier_sac", r.data_source_identifier.present, r.data_source_identifier.sac);
+    a.value ("data_source_identifier_sic", r.data_source_identifier.present, r.data_source_identifier.sic);
+    a.value ("sensor_number", r.sensor_number.present, r.sensor_number.value);
+    a.time ("message_time", r.message_time.present, r.message_time.value);
+    a.value ("antenna_azimuth_rad", r.antenna_azimuth.present, r.antenna_azimuth.value);
+    a.value ("sector_number", r.sector_number.present, r.sector_number.value);
+    a.flag ("north_crossing", r.north_crossing);
+}
+
+template <typename A>
+void arrowColumns (A& a, const t_Rtgt& r)
+{
+    a.value ("frame_date", r.frame_date.present, r.frame_date.value);
+    a.time ("frame_time", r.frame_time.present, r.frame_time.value);
+    a.value ("asterix_category", true, r.asterix_category);
+    a.value ("line_number", true, r.line_number);
+    a.value ("data_source_identifier_sac", r.data_source_identifier.present, r.data_source_identifier.sac);
+    a.value ("data_source_identifier_sic", r.data_source_identifier.present, r.data_source_identifier.sic);
+    a.value ("sensor_number", r.sensor_number.present, r.sensor_number.value);
+    a.time ("detection_time", r.detection_time.present, r.detection_time.value);
+    arrowDetectionType (a, r.detection_type);
+    a.value ("measured_rng_m", r.measured_rng.present, r.measured_rng.value);
+    a.value ("measured_azm_rad", r.measured_azm.present, r.measured_azm.value);
+    a.value ("computed_position_x", r.computed_position.present, r.computed_position.value_x);
+    a.value ("computed_position_y", r.computed_position.present, r.computed_position.value_y);
+    a.value ("mode_3_info_code", r.mode_3a_info.present, r.mode_3a_info.code);
+    a.tres ("mode_3_info_code_garbled", r.mode_3a_info.code_garbled);
+    a.tres ("mode_3_info_code_invalid", r.mode_3a_info.code_invalid);
+    a.value ("mode_c_height_m", r.mode_c_height.present, r.mode_c_height.value);
+    a.tres ("mode_c_height_garbled", r.mode_c_height.garbled);
+    a.tres ("mode_c_height_invalid", r.mode_c_height.invalid);
+    a.value ("target_address", r.target_address.present, r.target_address.value);
+    a.value ("aircraft_identification", r.aircraft_identification.present, r.aircraft_identification.value_idt);
+    a.value ("track_number", r.track_number.present, r.track_number.value);
+    a.value ("ground_vector_gsp_ms", r.ground_vector.present, r.ground_vector.value_gsp);
+    a.value ("ground_vector_hdg_rad", r.ground_vector.present, r.ground_vector.value_hdg);
+    a.tres ("special_position_indication", r.special_position_indication);
+    a.tres ("fs_airborne", r.fs_airborne);
+    a.tres ("fs_alert", r.fs_alert);
+    a.tres ("fs_on_ground", r.fs_on_ground);
+    a.tres ("fs_spi", r.fs_spi);
+    a.value ("mode_s_flags_aic", r.mode_s_flags.present, r.mode_s_flags.value_aic);
+    a.value ("mode_s_flags_arc", r.mode_s_flags.present, r.mode_s_flags.value_arc);
+    a.value ("mode_s_flags_b1a", r.mode_s_flags.present, r.mode_s_flags.value_b1a);
+    a.value ("mode_s_flags_b1b", r.mode_s_flags.present, r.mode_s_flags.value_b1b);
+    a.value ("mode_s_flags_cc", r.mode_s_flags.present, r.mode_s_flags.value_cc);
+    a.value ("mode_s_flags_fs", r.mode_s_flags.present, r.mode_s_flags.value_fs);
+    a.value ("mode_s_flags_mssc", r.mode_s_flags.present, r.mode_s_flags.value_mssc);
+    a.tres ("mode_s_flags_si", r.mode_s_flags.present ? r.mode_s_flags.value_si : e_is_undefined);
+    arrowBdsColumns (a, r.bds_registers, M_MAX_BDS_REGISTERS);
+}
+
+template <typename A>
+void arrowColumns (A& a, const t_Strk& r)
+{
+    a.value ("frame_date", r.frame_date.present, r.frame_date.value);
+    a.time ("frame_time", r.frame_time.present, r.frame_time.value);
+    a.value ("asterix_category", true, r.asterix_category);
+    a.value ("line_number", true, r.line_number);
+    a.value ("server_sacsic_sac", r.server_sacsic.present, r.server_sacsic.sac);
+    a.value ("server_sacsic_sic", r.server_sacsic.present, r.server_sacsic.sic);
+    a.time ("time_of_message", r.time_of_message.present, r.time_of_message.value);
+    a.time ("time_of_last_update", r.time_of_last_update.present, r.time_of_last_update.value);
+    a.value ("last_updating_sensor_sac", r.last_updating_sensor.present, r.last_updating_sensor.sac);
+    a.value ("last_updating_sensor_sic", r.last_updating_sensor.present, r.last_updating_sensor.sic);
+    a.value ("track_number", r.track_number.present, r.track_number.value);
+    a.value ("calculated_position_x", r.calculated_position.present, r.calculated_position.value_x);
+    a.value ("calculated_position_y", r.calculated_position.present, r.calculated_position.value_y);
+    a.value ("calculated_wgs84_position_lat_rad", r.calculated_wgs84_position.present,
+             r.calculated_wgs84_position.value_latitude);
+    a.value ("calculated_wgs84_position_lon_rad", r.calculated_wgs84_position.present,
+             r.calculated_wgs84_position.value_longitude);
+    a.value ("calculated_cartesian_velocity_vx_ms", r.calculated_cartesian_velocity.present,
+             r.calculated_cartesian_velocity.value_vx);
+    a.value ("calculated_cartesian_velocity_vy_ms", r.calculated_cartesian_velocity.present,
+             r.calculated_cartesian_velocity.value_vy);
+    a.value ("calculated_track_flight_level_m", r.calculated_track_flight_level.present,
+             r.calculated_track_flight_level.value);
+    a.value ("measured_track_mode_c_height_m", r.measured_track_mode_c_height.present,
+             r.measured_track_mode_c_height.value);
+    a.value ("geometric_altitude_m", r.geometric_altitude.present, r.geometric_altitude.value);
+    a.value ("mode_3_info_code", r.mode_3a_info.present, r.mode_3a_info.code);
+    a.tres ("mode_3_info_code_invalid", r.mode_3a_info.present ? (r.mode_3a_info.code_invalid ? e_is_true : e_is_false)
+                                                               : e_is_undefined);
+    a.value ("aircraft_address", r.aircraft_address.present, r.aircraft_address.value);
+    a.value ("aircraft_identification", r.aircraft_identification.present, r.aircraft_identification.value_idt);
+    a.value ("callsign", r.callsign.present, r.callsign.value);
+    a.tres ("coasted_track", r.coasted_track);
+    a.tres ("multi_sensor_track", r.multi_sensor_track);
+    a.tres ("track_created", r.track_created);
+    a.tres ("track_terminated", r.track_terminated);
+    a.tres ("tentative_track", r.tentative_track);
+    a.tres ("observed_by_ads", r.observed_by_ads);
+    a.tres ("observed_by_mds", r.observed_by_mds);
+    a.tres ("observed_by_psr", r.observed_by_psr);
+    a.tres ("observed_by_ssr", r.observed_by_ssr);
+    a.tres ("simulated", r.simulated);
+    a.tres ("test_target", r.test_target);
+    a.tres ("special_position_indication", r.special_position_indication);
+    arrowBdsColumns (a, r.mode_s_mb_data.value, r.mode_s_mb_data.present ? r.mode_s_mb_data.count : 0);
+}
+
+#endif // ARROWCOLUMNS_H
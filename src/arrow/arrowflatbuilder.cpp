@@ -0,0 +1,131 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "arrowflatbuilder.h"
+
+#include <algorithm>
+#include <cassert>
+
+uint32_t ArrowFlatBuilder::addString (const std::string& text)
+{
+    align (4, text.size() + 1);
+    prepend<uint8_t> (0);
+    prepend (text.data(), text.size());
+    prepend<uint32_t> (static_cast<uint32_t> (text.size()));
+
+    return size();
+}
+
+uint32_t ArrowFlatBuilder::addOffsetVector (const std::vector<uint32_t>& offsets)
+{
+    align (4, 4 * offsets.size());
+
+    for (auto it = offsets.rbegin(); it != offsets.rend(); ++it)
+        prependOffset (*it);
+
+    prepend<uint32_t> (static_cast<uint32_t> (offsets.size()));
+
+    return size();
+}
+
+uint32_t ArrowFlatBuilder::addStructVector (const void* data, size_t count, size_t size, size_t alignment)
+{
+    align (4, count * size);
+    align (alignment, count * size);
+    if (count)
+        prepend (data, count * size);
+    prepend<uint32_t> (static_cast<uint32_t> (count));
+
+    return this->size();
+}
+
+void ArrowFlatBuilder::startTable ()
+{
+    fields_.clear();
+    table_start_ = size();
+}
+
+void ArrowFlatBuilder::addOffsetField (uint16_t id, uint32_t offset)
+{
+    prependOffset (offset);
+    fields_.push_back ({id, size()});
+}
+
+uint32_t ArrowFlatBuilder::endTable ()
+{
+    // the table starts with the (signed) distance back to its vtable
+    align (4);
+    prepend<int32_t> (0);
+
+    uint32_t table = size();
+
+    uint16_t count = 0;
+    for (const auto& field : fields_)
+        count = std::max (count, static_cast<uint16_t> (field.first + 1));
+
+    std::vector<uint16_t> vtable (2 + count, 0);
+
+    vtable[0] = static_cast<uint16_t> (2 * vtable.size());
+    vtable[1] = static_cast<uint16_t> (table - table_start_);
+    for (const auto& field : fields_)
+        vtable[2 + field.first] = static_cast<uint16_t> (table - field.second);
+
+    for (auto it = vtable.rbegin(); it != vtable.rend(); ++it)
+        prepend (*it);
+
+    int32_t distance = static_cast<int32_t> (size() - table);
+
+    for (size_t cnt = 0; cnt < 4; ++cnt)
+        buf_[buf_.size() - table + cnt] = static_cast<char> (static_cast<uint32_t> (distance) >> (8 * cnt));
+
+    fields_.clear();
+
+    return table;
+}
+
+std::string ArrowFlatBuilder::finish (uint32_t root)
+{
+    align (min_align_, 4);
+    prependOffset (root);
+
+    std::string buffer;
+    buffer.swap (buf_);
+    min_align_ = 1;
+
+    return buffer;
+}
+
+void ArrowFlatBuilder::align (size_t size, size_t extra)
+{
+    assert (size && !(size & (size - 1)));
+
+    min_align_ = std::max (min_align_, size);
+
+    size_t padding = (~(buf_.size() + extra) + 1) & (size - 1);
+
+    buf_.insert (0, padding, '\0');
+}
+
+void ArrowFlatBuilder::prependOffset (uint32_t offset)
+{
+    align (4);
+
+    assert (offset <= size());
+
+    // relative to the position of the offset itself
+    prepend<uint32_t> (size() + 4 - offset);
+}
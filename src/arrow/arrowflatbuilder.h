@@ -0,0 +1,86 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARROWFLATBUILDER_H
+#define ARROWFLATBUILDER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+ * Just enough of a FlatBuffers builder to write the Arrow IPC metadata
+ * (Schema.fbs, Message.fbs, File.fbs), so no FlatBuffers or Arrow library
+ * is needed.
+ *
+ * As in the FlatBuffers library, the buffer is built back to front:
+ * children are added before the tables referring to them, and every
+ * add...() returns the position of the new object counted from the end of
+ * the buffer. The metadata is small, so the bytes are simply prepended.
+ */
+
+class ArrowFlatBuilder
+{
+public:
+    uint32_t addString (const std::string& text);
+    // vector of tables or strings
+    uint32_t addOffsetVector (const std::vector<uint32_t>& offsets);
+    // vector of structs, given as raw little-endian bytes
+    uint32_t addStructVector (const void* data, size_t count, size_t size, size_t alignment);
+
+    void startTable ();
+    template <typename T>
+    void addField (uint16_t id, T value)
+    {
+        align (sizeof (T));
+        prepend (value);
+        fields_.push_back ({id, size()});
+    }
+    void addOffsetField (uint16_t id, uint32_t offset);
+    uint32_t endTable ();
+
+    // returns the finished buffer, with the root offset in front
+    std::string finish (uint32_t root);
+
+private:
+    std::string buf_;
+    size_t min_align_ {1};
+
+    std::vector<std::pair<uint16_t, uint32_t>> fields_;
+    uint32_t table_start_ {0};
+
+    uint32_t size () const { return static_cast<uint32_t> (buf_.size()); }
+
+    void align (size_t size, size_t extra = 0);
+    void prepend (const void* data, size_t size) { buf_.insert (0, static_cast<const char*> (data), size); }
+
+    template <typename T>
+    void prepend (T value)
+    {
+        char bytes[sizeof (T)];
+
+        for (size_t cnt = 0; cnt < sizeof (T); ++cnt)
+            bytes[cnt] = static_cast<char> (static_cast<uint64_t> (value) >> (8 * cnt));
+        prepend (bytes, sizeof (T));
+    }
+
+    void prependOffset (uint32_t offset);
+};
+
+#endif // ARROWFLATBUILDER_H
@@ -0,0 +1,327 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "arrowtable.h"
+#include "arrowflatbuilder.h"
+#include "arrowcolumns.h"
+
+#include <cstdio>
+
+// Arrow IPC format constants, see Schema.fbs and Message.fbs
+const char ARROW_MAGIC[] = "ARROW1";
+const int16_t ARROW_METADATA_V5 = 4;
+const uint8_t ARROW_HEADER_SCHEMA = 1;
+const uint8_t ARROW_HEADER_RECORD_BATCH = 3;
+const uint8_t ARROW_TYPE_INT = 2;
+const uint8_t ARROW_TYPE_FLOATING_POINT = 3;
+const uint8_t ARROW_TYPE_UTF8 = 5;
+const uint8_t ARROW_TYPE_BOOL = 6;
+const uint8_t ARROW_TYPE_DATE = 8;
+const int16_t ARROW_PRECISION_DOUBLE = 2;
+const int16_t ARROW_DATE_DAY = 0;
+// body buffers are padded to this, as Arrow C++ does
+const size_t ARROW_BUFFER_ALIGNMENT = 64;
+
+namespace
+{
+    size_t padded (size_t size, size_t alignment)
+    {
+        return (size + alignment - 1) / alignment * alignment;
+    }
+}
+
+void ArrowColumn::buffers (std::vector<const std::string*>& buffers)
+{
+    buffers.push_back (&validity_);
+
+    if (type_ == ARROW_UTF8)
+    {
+        if (offsets_.empty())
+            offsets_.push_back (0);
+        offset_bytes_.assign (reinterpret_cast<const char*> (offsets_.data()),
+                              offsets_.size() * sizeof (int32_t));
+        buffers.push_back (&offset_bytes_);
+    }
+
+    buffers.push_back (&values_);
+}
+
+void ArrowColumn::clear ()
+{
+    rows_ = 0;
+    null_count_ = 0;
+    validity_.clear();
+    values_.clear();
+    offsets_.clear();
+    offset_bytes_.clear();
+}
+
+ArrowTable::ArrowTable (const std::string& path, size_t batch_rows)
+    : path_ {path}, batch_rows_ {batch_rows}
+{
+    file_.open (path_, std::ios::out | std::ios::binary);
+
+    if (!file_)
+    {
+        printf ("-> Cannot open Arrow file '%s'\n", path_.c_str());
+        return;
+    }
+
+    // magic, padded to 8 bytes
+    file_.write (ARROW_MAGIC, 8);
+    file_offset_ = 8;
+}
+
+ArrowTable::~ArrowTable ()
+{
+    if (!file_.is_open())
+        return;
+
+    flush ();
+
+    // without rows, the schema is still needed for a valid file
+    if (blocks_.empty())
+        writeSchema ();
+
+    writeFooter ();
+    file_.close();
+}
+
+void ArrowTable::value (const char* name, bool present, const t_Date& date)
+{
+    column (name, ARROW_DATE32).append (present, present ? daysSinceEpoch (date) : 0);
+}
+
+void ArrowTable::value (const char* name, bool present, const char* text)
+{
+    column (name, ARROW_UTF8).appendString (present, text);
+}
+
+ArrowColumn& ArrowTable::column (const char* name, ARROW_COLUMN_TYPE type)
+{
+    if (!schema_)
+    {
+        columns_.emplace_back (name, type);
+        return columns_.back();
+    }
+
+    assert (column_ < columns_.size());
+    assert (columns_[column_].name() == name && columns_[column_].type() == type);
+
+    return columns_[column_++];
+}
+
+void ArrowTable::flush ()
+{
+    if (!rows_)
+        return;
+
+    // the rows cannot be written, and are not kept either
+    if (!file_.is_open())
+    {
+        for (ArrowColumn& column : columns_)
+            column.clear();
+
+        rows_ = 0;
+        return;
+    }
+
+    if (!blocks_.size())
+        writeSchema ();
+
+    // body: all buffers of all columns, each padded
+
+    std::vector<const std::string*> buffers;
+    for (ArrowColumn& column : columns_)
+        column.buffers (buffers);
+
+    struct Buffer
+    {
+        int64_t offset;
+        int64_t length;
+    };
+    struct FieldNode
+    {
+        int64_t length;
+        int64_t null_count;
+    };
+
+    std::vector<Buffer> buffer_index;
+    int64_t body_length = 0;
+
+    for (const std::string* buffer : buffers)
+    {
+        buffer_index.push_back ({body_length, static_cast<int64_t> (buffer->size())});
+        body_length += padded (buffer->size(), ARROW_BUFFER_ALIGNMENT);
+    }
+
+    std::vector<FieldNode> nodes;
+    for (const ArrowColumn& column : columns_)
+        nodes.push_back ({static_cast<int64_t> (rows_), static_cast<int64_t> (column.nullCount())});
+
+    ArrowFlatBuilder builder;
+
+    uint32_t buffers_vector = builder.addStructVector (buffer_index.data(), buffer_index.size(), sizeof (Buffer), 8);
+    uint32_t nodes_vector = builder.addStructVector (nodes.data(), nodes.size(), sizeof (FieldNode), 8);
+
+    builder.startTable();
+    builder.addField<int64_t> (0, rows_);
+    builder.addOffsetField (1, nodes_vector);
+    builder.addOffsetField (2, buffers_vector);
+    uint32_t batch = builder.endTable();
+
+    builder.startTable();
+    builder.addField<int64_t> (3, body_length);
+    builder.addOffsetField (2, batch);
+    builder.addField<int16_t> (0, ARROW_METADATA_V5);
+    builder.addField<uint8_t> (1, ARROW_HEADER_RECORD_BATCH);
+    uint32_t message = builder.endTable();
+
+    int64_t offset = file_offset_;
+
+    writeMessage (builder.finish (message));
+
+    static const char zeros[ARROW_BUFFER_ALIGNMENT] = {};
+
+    for (const std::string* buffer : buffers)
+    {
+        file_.write (buffer->data(), buffer->size());
+        file_.write (zeros, padded (buffer->size(), ARROW_BUFFER_ALIGNMENT) - buffer->size());
+    }
+    file_offset_ += body_length;
+
+    blocks_.push_back ({offset, static_cast<int32_t> (file_offset_ - offset - body_length), 0, body_length});
+
+    for (ArrowColumn& column : columns_)
+        column.clear();
+
+    rows_written_ += rows_;
+    rows_ = 0;
+}
+
+uint32_t ArrowTable::schema (ArrowFlatBuilder& builder)
+{
+    std::vector<uint32_t> fields;
+
+    for (const ArrowColumn& column : columns_)
+    {
+        uint32_t name = builder.addString (column.name());
+        uint32_t children = builder.addOffsetVector ({});
+
+        uint8_t type_type = 0;
+
+        builder.startTable();
+        switch (column.type())
+        {
+        case ARROW_BOOL:
+            type_type = ARROW_TYPE_BOOL;
+            break;
+        case ARROW_UINT8:
+        case ARROW_UINT16:
+        case ARROW_UINT32:
+        case ARROW_INT16:
+        case ARROW_INT32:
+            type_type = ARROW_TYPE_INT;
+            builder.addField<int32_t> (0, column.type() == ARROW_UINT8 ? 8 :
+                                          column.type() == ARROW_UINT32 || column.type() == ARROW_INT32 ? 32 : 16);
+            builder.addField<uint8_t> (1, column.type() == ARROW_INT16 || column.type() == ARROW_INT32);
+            break;
+        case ARROW_DOUBLE:
+            type_type = ARROW_TYPE_FLOATING_POINT;
+            builder.addField<int16_t> (0, ARROW_PRECISION_DOUBLE);
+            break;
+        case ARROW_DATE32:
+            type_type = ARROW_TYPE_DATE;
+            builder.addField<int16_t> (0, ARROW_DATE_DAY);
+            break;
+        case ARROW_UTF8:
+            type_type = ARROW_TYPE_UTF8;
+            break;
+        }
+        uint32_t type = builder.endTable();
+
+        builder.startTable();
+        builder.addOffsetField (0, name);
+        builder.addOffsetField (3, type);
+        builder.addOffsetField (5, children);
+        builder.addField<uint8_t> (1, 1);
+        builder.addField<uint8_t> (2, type_type);
+        fields.push_back (builder.endTable());
+    }
+
+    uint32_t fields_vector = builder.addOffsetVector (fields);
+
+    // little endian is the default
+    builder.startTable();
+    builder.addOffsetField (1, fields_vector);
+    return builder.endTable();
+}
+
+void ArrowTable::writeMessage (const std::string& metadata)
+{
+    // continuation marker and length, metadata padded to 8 bytes
+    int32_t prefix[2] = {-1, static_cast<int32_t> (padded (metadata.size(), 8))};
+    static const char zeros[8] = {};
+
+    file_.write (reinterpret_cast<const char*> (prefix), sizeof (prefix));
+    file_.write (metadata.data(), metadata.size());
+    file_.write (zeros, prefix[1] - metadata.size());
+
+    file_offset_ += sizeof (prefix) + prefix[1];
+}
+
+void ArrowTable::writeSchema ()
+{
+    ArrowFlatBuilder builder;
+
+    uint32_t schema_table = schema (builder);
+
+    builder.startTable();
+    builder.addOffsetField (2, schema_table);
+    builder.addField<int16_t> (0, ARROW_METADATA_V5);
+    builder.addField<uint8_t> (1, ARROW_HEADER_SCHEMA);
+    uint32_t message = builder.endTable();
+
+    writeMessage (builder.finish (message));
+}
+
+void ArrowTable::writeFooter ()
+{
+    // end-of-stream marker, then the footer for random access
+    int32_t eos[2] = {-1, 0};
+    file_.write (reinterpret_cast<const char*> (eos), sizeof (eos));
+
+    ArrowFlatBuilder builder;
+
+    uint32_t batches = builder.addStructVector (blocks_.data(), blocks_.size(), sizeof (Block), 8);
+    uint32_t dictionaries = builder.addStructVector (nullptr, 0, sizeof (Block), 8);
+    uint32_t schema_table = schema (builder);
+
+    builder.startTable();
+    builder.addOffsetField (1, schema_table);
+    builder.addOffsetField (2, dictionaries);
+    builder.addOffsetField (3, batches);
+    builder.addField<int16_t> (0, ARROW_METADATA_V5);
+    uint32_t footer = builder.endTable();
+
+    std::string metadata = builder.finish (footer);
+    int32_t length = static_cast<int32_t> (metadata.size());
+
+    file_.write (metadata.data(), metadata.size());
+    file_.write (reinterpret_cast<const char*> (&length), sizeof (length));
+    file_.write (ARROW_MAGIC, 6);
+}
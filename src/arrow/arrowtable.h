@@ -0,0 +1,212 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARROWTABLE_H
+#define ARROWTABLE_H
+
+#include "global.h"
+#include "basics.h"
+
+#include "common.h"
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+typedef enum
+{
+    ARROW_BOOL,
+    ARROW_UINT8,
+    ARROW_UINT16,
+    ARROW_UINT32,
+    ARROW_INT16,
+    ARROW_INT32,
+    ARROW_DOUBLE,
+    ARROW_DATE32,
+    ARROW_UTF8
+} ARROW_COLUMN_TYPE;
+
+/*
+ * One column of the record batch being collected: a validity bitmap (set
+ * where the value is present), the values (fixed width, a bitmap for
+ * ARROW_BOOL) and, for ARROW_UTF8, the string offsets.
+ */
+
+class ArrowColumn
+{
+public:
+    ArrowColumn (const std::string& name, ARROW_COLUMN_TYPE type)
+        : name_ {name}, type_ {type} {}
+
+    const std::string& name () const { return name_; }
+    ARROW_COLUMN_TYPE type () const { return type_; }
+    size_t nullCount () const { return null_count_; }
+
+    template <typename T>
+    void append (bool present, T value)
+    {
+        appendValidity (present);
+
+        if (type_ == ARROW_BOOL)
+            appendBit (values_, rows_ - 1, present && value);
+        else
+        {
+            T v = present ? value : T ();
+            values_.append (reinterpret_cast<const char*> (&v), sizeof (v));
+        }
+    }
+
+    void appendString (bool present, const char* text)
+    {
+        assert (type_ == ARROW_UTF8);
+
+        appendValidity (present);
+
+        if (offsets_.empty())
+            offsets_.push_back (0);
+        if (present)
+            values_.append (text, strlen (text));
+        offsets_.push_back (static_cast<int32_t> (values_.size()));
+    }
+
+    // validity, then offsets (ARROW_UTF8 only), then values
+    void buffers (std::vector<const std::string*>& buffers);
+    void clear ();
+
+private:
+    std::string name_;
+    ARROW_COLUMN_TYPE type_;
+
+    size_t rows_ {0};
+    size_t null_count_ {0};
+    std::string validity_;
+    std::string values_;
+    std::vector<int32_t> offsets_;
+    std::string offset_bytes_;
+
+    void appendValidity (bool present)
+    {
+        appendBit (validity_, rows_, present);
+        if (!present)
+            null_count_++;
+        rows_++;
+    }
+
+    static void appendBit (std::string& bitmap, size_t index, bool bit)
+    {
+        if (index % 8 == 0)
+            bitmap.push_back ('\0');
+        if (bit)
+            bitmap.back() |= static_cast<char> (1 << (index % 8));
+    }
+};
+
+/*
+ * The reports of one type, written as an Arrow IPC file (Feather v2):
+ * the schema, record batches of up to batch_rows reports and a footer
+ * indexing them, so readers can memory-map the file and use the columns
+ * in place.
+ *
+ * The columns are those visited by arrowColumns() in arrowcolumns.h. The
+ * same function fills a row, so schema and rows cannot disagree.
+ */
+
+class ArrowTable
+{
+public:
+    ArrowTable (const std::string& path, size_t batch_rows);
+    ~ArrowTable ();
+
+    template <typename T>
+    void add (const T& record);
+
+    // writes the reports collected so far as a record batch
+    void flush ();
+
+    size_t rows () const { return rows_written_ + rows_; }
+
+    // called by arrowColumns()
+    template <typename T>
+    void value (const char* name, bool present, T value);
+    void value (const char* name, bool present, const t_Date& date);
+    void value (const char* name, bool present, const char* text);
+    void time (const char* name, bool present, t_Secs secs) { value<double> (name, present, secs); }
+    void flag (const char* name, t_Bool flag) { value<bool> (name, true, flag != 0); }
+    void tres (const char* name, t_Tres tres) { value<bool> (name, tres != e_is_undefined, tres == e_is_true); }
+
+private:
+    struct Block
+    {
+        int64_t offset;
+        int32_t metadata_length;
+        int32_t padding;
+        int64_t body_length;
+    };
+
+    std::string path_;
+    size_t batch_rows_;
+
+    std::ofstream file_;
+    int64_t file_offset_ {0};
+    std::vector<Block> blocks_;
+
+    std::vector<ArrowColumn> columns_;
+    size_t column_ {0};
+    bool schema_ {false};
+    size_t rows_ {0};
+    size_t rows_written_ {0};
+
+    ArrowColumn& column (const char* name, ARROW_COLUMN_TYPE type);
+
+    template <typename T>
+    static ARROW_COLUMN_TYPE columnType ();
+
+    uint32_t schema (class ArrowFlatBuilder& builder);
+    void writeMessage (const std::string& metadata);
+    void writeSchema ();
+    void writeFooter ();
+};
+
+template <typename T>
+void ArrowTable::add (const T& record)
+{
+    column_ = 0;
+    arrowColumns (*this, record);
+    schema_ = true;
+
+    if (++rows_ >= batch_rows_)
+        flush ();
+}
+
+template <typename T>
+void ArrowTable::value (const char* name, bool present, T value)
+{
+    column (name, columnType<T>()).append (present, value);
+}
+
+template <> inline ARROW_COLUMN_TYPE ArrowTable::columnType<bool> () { return ARROW_BOOL; }
+template <> inline ARROW_COLUMN_TYPE ArrowTable::columnType<uint8_t> () { return ARROW_UINT8; }
+template <> inline ARROW_COLUMN_TYPE ArrowTable::columnType<uint16_t> () { return ARROW_UINT16; }
+template <> inline ARROW_COLUMN_TYPE ArrowTable::columnType<uint32_t> () { return ARROW_UINT32; }
+template <> inline ARROW_COLUMN_TYPE ArrowTable::columnType<int16_t> () { return ARROW_INT16; }
+template <> inline ARROW_COLUMN_TYPE ArrowTable::columnType<int32_t> () { return ARROW_INT32; }
+template <> inline ARROW_COLUMN_TYPE ArrowTable::columnType<double> () { return ARROW_DOUBLE; }
+
+#endif // ARROWTABLE_H
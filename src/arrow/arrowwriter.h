@@ -0,0 +1,65 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARROWWRITER_H
+#define ARROWWRITER_H
+
+#include "global.h"
+#include "basics.h"
+
+#include "common.h"
+
+#include <memory>
+#include <string>
+
+#include "arrowtable.h"
+
+/*
+ * Writes the decoded reports as Arrow IPC files (Feather v2), one file
+ * per report type since every file has a single schema: "<stem>_<type>"
+ * plus the extension of the given path, e.g. out_rtgt.arrow for
+ * out.arrow. A file is only created once a report of its type arrives.
+ */
+
+class ArrowWriter
+{
+public:
+    // the files are completed when the writer is deleted
+    explicit ArrowWriter (const std::string& path);
+
+    void write (const t_Adsb *adsb_ptr);
+    void write (const t_Mlat *mlat_ptr);
+    void write (const t_Rsrv *rsrv_ptr);
+    void write (const t_Rtgt *rtgt_ptr);
+    void write (const t_Strk *strk_ptr);
+
+    void printStatistics ();
+
+private:
+    std::string path_;
+
+    std::unique_ptr<ArrowTable> adsb_;
+    std::unique_ptr<ArrowTable> mlat_;
+    std::unique_ptr<ArrowTable> rsrv_;
+    std::unique_ptr<ArrowTable> rtgt_;
+    std::unique_ptr<ArrowTable> strk_;
+
+    template <typename T>
+    void writeRecord (std::unique_ptr<ArrowTable>& table, const T& record, const char* type);
+};
+
+#endif // ARROWWRITER_H
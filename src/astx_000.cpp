@@ -434,8 +434,8 @@ static t_Retc proc_i000_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 #endif /* LISTER */
 
                    /* Remember this information: */
-	last_tod_available = TRUE;
-	last_tod = tod;
+	remember_tod (rsrv.data_source_identifier.present,
+                  rsrv.data_source_identifier.value, tod);
 
 				   /* Store this information: */
 	rsrv.message_time.present = TRUE;
@@ -1343,6 +1343,7 @@ static t_Retc proc_i001_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	t_Byte df2;    /* Data field octet 2 */
 	t_Byte df3;    /* Data field octet 3 */
 	t_Byte df4;    /* Data field octet 4 */
+	t_Si16 alt;    /* Height decoded from mode C code; 100 feet */
 	t_Ui16 mcc;    /* Mode C code (in Gray notation) */
 	t_Ui16 mccc;   /* Mode C code confidence */
 	t_Retc ret;    /* Return code */
@@ -1364,6 +1365,9 @@ static t_Retc proc_i001_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	mcc = make_ui16 (df1 & 0x0f, df2);
 	mccc = make_ui16 (df3 & 0x0f, df4);
 
+				   /* Decode the Gillham code: */
+	alt = gillham_to_alt (mcc);
+
 #if LISTER
 				   /* List data field: */
 	list_text (2, ";  Mode C (Gray) Code:");
@@ -1371,6 +1375,10 @@ static t_Retc proc_i001_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	list_text (2, " g=" M_FMT_BYTE ";", (df1 >> 6) & 0x01);
 	list_text (2, " code=" M_FMT_CODE ";", mcc);
 	list_text (2, " conf=" M_FMT_CODE, mccc);
+	if (alt != M_UTL_NVA)
+	{
+		list_text (2, "; alt=%d ft", 100 * alt);
+	}
 	list_text (2, "\n");
 #endif /* LISTER */
 
@@ -1380,6 +1388,11 @@ static t_Retc proc_i001_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	rtgt.mode_c_code.code_confidence_present = TRUE;
 	rtgt.mode_c_code.code_garbled = M_TRES (df1 & 0x40);
 	rtgt.mode_c_code.code_invalid = M_TRES (df1 & 0x80);
+	if (alt != M_UTL_NVA)
+	{
+		rtgt.mode_c_code.height = alt;
+		rtgt.mode_c_code.height_present = TRUE;
+	}
 	rtgt.mode_c_code.present = TRUE;
 
 				   /* Set the return code: */
@@ -1556,8 +1569,24 @@ static t_Retc proc_i001_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 				   /* Extract information: */
 	ttod = make_ui16 (df1, df2);
 
-                   /* Try to fill up this truncated time of day: */
-	lrc = fillup_tod (ttod, &tod);
+                   /* Try to fill up this truncated time of day
+                      (with the SAC/SIC of this record or, failing
+                      that, of an earlier record of this data block
+                      or of the last radar service message): */
+	if (rtgt.data_source_identifier.present)
+	{
+		lrc = fillup_tod (TRUE, rtgt.data_source_identifier.value,
+                          ttod, &tod);
+	}
+	else if (last_sacsic_available)
+	{
+		lrc = fillup_tod (TRUE, last_sacsic, ttod, &tod);
+	}
+	else
+	{
+		lrc = fillup_tod (last_service_sacsic_available,
+                          last_service_sacsic, ttod, &tod);
+	}
 	if (lrc == RC_OKAY)
 	{
 		tm = (1.0 / 128.0) * tod;
@@ -578,6 +578,8 @@ static t_Retc proc_i002_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
                    /* Remember this information: */
 	last_sacsic_available = TRUE;
 	last_sacsic = dsi;
+	last_service_sacsic_available = TRUE;
+	last_service_sacsic = dsi;
                    /* This is a feature specific to ASTERIX category 001
                       where radar target reports without SAC/SIC will
                       inherit this information from a preceding radar
@@ -691,8 +693,8 @@ static t_Retc proc_i002_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 #endif /* LISTER */
 
                    /* Remember this information: */
-	last_tod_available = TRUE;
-	last_tod = tod;
+	remember_tod (rsrv.data_source_identifier.present,
+                  rsrv.data_source_identifier.value, tod);
 
 				   /* Store this information: */
 	rsrv.message_time.present = TRUE;
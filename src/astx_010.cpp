@@ -1364,8 +1364,8 @@ static t_Retc proc_i010_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 #endif /* LISTER */
 
                    /* Remember this information: */
-	last_tod_available = TRUE;
-	last_tod = tod;
+	remember_tod (mlat.data_source_identifier.present,
+                  mlat.data_source_identifier.value, tod);
 
                    /* Store this information: */
 	mlat.detection_time.present = TRUE;
@@ -1799,24 +1799,11 @@ static t_Retc proc_i010_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
  static
  t_Retc proc_i010_245 (t_Ui16 length, t_Byte *buffer)
 {
-	t_Byte c1;     /* Character 1 */
-	t_Byte c2;     /* Character 2 */
-	t_Byte c3;     /* Character 3 */
-	t_Byte c4;     /* Character 4 */
-	t_Byte c5;     /* Character 5 */
-	t_Byte c6;     /* Character 6 */
-	t_Byte c7;     /* Character 7 */
-	t_Byte c8;     /* Character 8 */
 #if CCWARN
 	t_Byte df1;    /* Data field octet 1 */
 #endif /* CCWARN */
-	t_Byte df2;    /* Data field octet 2 */
-	t_Byte df3;    /* Data field octet 3 */
-	t_Byte df4;    /* Data field octet 4 */
-	t_Byte df5;    /* Data field octet 5 */
-	t_Byte df6;    /* Data field octet 6 */
-	t_Byte df7;    /* Data field octet 7 */
 	t_Retc ret;    /* Return code */
+	t_Bool valid;  /* All characters are valid */
 #if CCWARN
 	t_Byte sti;    /* Source of target identification */
 #endif /* CCWARN */
@@ -1834,44 +1821,12 @@ static t_Retc proc_i010_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 #if CCWARN
 	df1 = buffer[0];
 #endif /* CCWARN */
-	df2 = buffer[1];
-	df3 = buffer[2];
-	df4 = buffer[3];
-	df5 = buffer[4];
-	df6 = buffer[5];
-	df7 = buffer[6];
 
 				   /* Extract information: */
 #if CCWARN
 	sti = (df1 >> 6) & 0x03;
 #endif /* CCWARN */
-	c1 = (df2 >> 2) & 0x3f;
-	c2 = df2 & 0x03;
-	c2 <<= 4;
-	c2 |= (df3 >> 4) & 0x0f;
-	c3 = df3 & 0x0f;
-	c3 <<= 2;
-	c3 |= (df4 >> 6) & 0x03;
-	c4 = df4 & 0x3f;
-	c5 = (df5 >> 2) & 0x3f;
-	c6 = df5 & 0x03;
-	c6 <<= 4;
-	c6 |= (df6 >> 4) & 0x0f;
-	c7 = df6 & 0x0f;
-	c7 <<= 2;
-	c7 |= (df7 >> 6) & 0x03;
-	c8 = df7 & 0x3f;
-
-                   /* Convert to conventional text: */
-	memset (txt, 0, M_AIRCRAFT_IDENTIFICATION_LENGTH + 1);
-	txt[0] = expand_c (c1);
-	txt[1] = expand_c (c2);
-	txt[2] = expand_c (c3);
-	txt[3] = expand_c (c4);
-	txt[4] = expand_c (c5);
-	txt[5] = expand_c (c6);
-	txt[6] = expand_c (c7);
-	txt[7] = expand_c (c8);
+	valid = expand_idt (buffer + 1, txt);
 
 #if LISTER
 				   /* List data field: */
@@ -1883,6 +1838,7 @@ static t_Retc proc_i010_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	mlat.target_identification.present = TRUE;
 	strncpy (mlat.target_identification.value_idt,
              txt, M_AIRCRAFT_IDENTIFICATION_LENGTH);
+	mlat.target_identification.value_invalid = !valid;
 
 				   /* Set the return code: */
 	ret = RC_OKAY;
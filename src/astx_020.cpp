@@ -2063,15 +2063,9 @@ static t_Retc proc_i020_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
  static
  t_Retc proc_i020_245 (t_Ui16 length, t_Byte *buffer)
 {
-	t_Byte c6;     /* Character in 6-bit encoding */
 	t_Byte df1;    /* Data field octet 1 */
-	t_Byte df2;    /* Data field octet 2 */
-	t_Byte df3;    /* Data field octet 3 */
-	t_Byte df4;    /* Data field octet 4 */
-	t_Byte df5;    /* Data field octet 5 */
-	t_Byte df6;    /* Data field octet 6 */
-	t_Byte df7;    /* Data field octet 7 */
 	t_Retc ret;    /* Return code */
+	t_Bool valid;  /* All characters are valid */
 	t_Byte sti;    /* Source of target identification */
 	char txt[9];   /* Text buffer for target identification */
                    /* If a flight plan has been submitted to the
@@ -2089,32 +2083,10 @@ static t_Retc proc_i020_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 
 				   /* Extract octets: */
 	df1 = buffer[0];
-	df2 = buffer[1];
-	df3 = buffer[2];
-	df4 = buffer[3];
-	df5 = buffer[4];
-	df6 = buffer[5];
-	df7 = buffer[6];
 
 				   /* Extract information: */
 	sti = (df1 >> 6) & 0x03;
-	memset (txt, 0, 9);
-	c6 = (df2 >> 2) & 0x3f;
-	txt[0] = expand_c (c6);
-	c6 = ((df2 & 0x03) << 4) | ((df3 >> 4) & 0x0f);
-	txt[1] = expand_c (c6);
-    c6 = ((df3 & 0x0f) << 2) | ((df4 >> 6) & 0x03);
-	txt[2] = expand_c (c6);
-	c6 = df4 & 0x3f;
-	txt[3] = expand_c (c6);
-	c6 = (df5 >> 2) & 0x3f;
-	txt[4] = expand_c (c6);
-	c6 = ((df5 & 0x03) << 4) | ((df6 >> 4) & 0x0f);
-	txt[5] = expand_c (c6);
-	c6 = ((df6 & 0x0f) << 2) | ((df7 >> 6) & 0x03);
-	txt[6] = expand_c (c6);
-	c6 = df7 & 0x3f;
-	txt[7] = expand_c (c6);
+	valid = expand_idt (buffer + 1, txt);
 
 #if LISTER
 				   /* List data field: */
@@ -2128,6 +2100,7 @@ static t_Retc proc_i020_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	mlat.target_identification.present = TRUE;
 	strncpy (mlat.target_identification.value_idt, txt,
              M_AIRCRAFT_IDENTIFICATION_LENGTH);
+	mlat.target_identification.value_invalid = !valid;
 	mlat.target_identification.value_sti = sti;
 
 				   /* Set the return code: */
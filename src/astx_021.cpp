@@ -67,6 +67,8 @@
                    /* Basic system definitions */
 #include "common.h"
                    /* Common declarations and definitions */
+#include "astx_items.h"
+                   /* Values of ASTERIX data items */
 
 #include <ctype.h>
 #include <math.h>
@@ -1677,7 +1679,7 @@ static t_Retc proc_i021_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	tod = make_ui32 (0x00, df1, df2, df3);
 
                    /* Convert to seconds: */
-	tod_in_secs = (1.0 / 128.0) * tod;
+	tod_in_secs = item_tod (buffer);
 
 #if LISTER
                    /* List data field: */
@@ -1688,8 +1690,8 @@ static t_Retc proc_i021_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 #endif /* LISTER */
 
                    /* Remember this information: */
-	last_tod_available = TRUE;
-	last_tod = tod;
+	remember_tod (adsb.data_source_identifier.present,
+                  adsb.data_source_identifier.value, tod);
 
                    /* Store this information: */
 	adsb.detection_time.present = TRUE;
@@ -2599,8 +2601,6 @@ static t_Retc proc_i021_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
  static
  t_Retc proc_i021_070 (t_Ui16 length, t_Byte *buffer)
 {
-	t_Byte df1;    /* Data field octet 1 */
-	t_Byte df2;    /* Data field octet 2 */
 	t_Ui16 m3a;    /* Mode 3/A code */
 	t_Retc ret;    /* Return code */
 
@@ -2616,12 +2616,8 @@ static t_Retc proc_i021_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
             reference_vsn == 21 || reference_vsn == 24,
             "Data item not defined");
 
-                   /* Extract octets: */
-	df1 = buffer[0];
-	df2 = buffer[1];
-
                    /* Extract information: */
-	m3a = make_ui16 (df1 & 0x0f, df2);
+	m3a = item_mode_3a (buffer);
 
 #if LISTER
                    /* List data field: */
@@ -2677,7 +2673,7 @@ static t_Retc proc_i021_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	tod = make_ui32 (0x00, df1, df2, df3);
 
                    /* Convert ot seconds: */
-	tod_in_secs = (1.0 / 128.0) * tod;
+	tod_in_secs = item_tod (buffer);
 
 #if LISTER
                    /* List data field: */
@@ -2734,7 +2730,7 @@ static t_Retc proc_i021_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	tod = make_ui32 (0x00, df1, df2, df3);
 
                    /* Convert ot seconds: */
-	tod_in_secs = (1.0 / 128.0) * tod;
+	tod_in_secs = item_tod (buffer);
 
 #if LISTER
                    /* List data field: */
@@ -2791,7 +2787,7 @@ static t_Retc proc_i021_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	tod = make_ui32 (0x00, df1, df2, df3);
 
                    /* Convert ot seconds: */
-	tod_in_secs = (1.0 / 128.0) * tod;
+	tod_in_secs = item_tod (buffer);
 
 #if LISTER
                    /* List data field: */
@@ -2910,7 +2906,7 @@ static t_Retc proc_i021_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	tod = make_ui32 (0x00, df1, df2, df3);
 
                    /* Convert to seconds: */
-	tod_in_secs = (1.0 / 128.0) * tod;
+	tod_in_secs = item_tod (buffer);
 
 #if LISTER
                    /* List data field: */
@@ -3029,7 +3025,7 @@ static t_Retc proc_i021_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	tod = make_ui32 (0x00, df1, df2, df3);
 
                    /* Convert to seconds: */
-	tod_in_secs = (1.0 / 128.0) * tod;
+	tod_in_secs = item_tod (buffer);
 
 #if LISTER
                    /* List data field: */
@@ -3065,9 +3061,6 @@ static t_Retc proc_i021_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
  static
  t_Retc proc_i021_080 (t_Ui16 length, t_Byte *buffer)
 {
-	t_Byte df1;    /* Data field octet 1 */
-	t_Byte df2;    /* Data field octet 2 */
-	t_Byte df3;    /* Data field octet 3 */
 	t_Retc ret;    /* Return code */
 	t_Ui32 ta;     /* Target address */
 
@@ -3078,13 +3071,8 @@ static t_Retc proc_i021_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	Assert (length == 3, "Invalid parameter");
 	Assert (buffer != NULL, "Invalid parameter");
 
-                   /* Extract octets: */
-	df1 = buffer[0];
-	df2 = buffer[1];
-	df3 = buffer[2];
-
                    /* Extract information: */
-	ta = make_ui32 (0x00, df1, df2, df3);
+	ta = item_ui24 (buffer);
 
 #if LISTER
                    /* List data field: */
@@ -3841,12 +3829,6 @@ static t_Retc proc_i021_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
  static
  t_Retc proc_i021_130 (t_Ui16 length, t_Byte *buffer)
 {
-	t_Byte df1;    /* Data field octet 1 */
-	t_Byte df2;    /* Data field octet 2 */
-	t_Byte df3;    /* Data field octet 3 */
-	t_Byte df4;    /* Data field octet 4 */
-	t_Byte df5;    /* Data field octet 5 */
-	t_Byte df6;    /* Data field octet 6 */
 	t_Si32 lat;    /* Latitude; 180/2**23 degrees */
 	t_Real latf;   /* Latitude; degrees */
 	t_Si32 lon;    /* Longitude; 180/2**23 degrees */
@@ -3860,35 +3842,12 @@ static t_Retc proc_i021_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	Assert (length == 6, "Invalid parameter");
 	Assert (buffer != NULL, "Invalid parameter");
 
-                   /* Extract octets: */
-	df1 = buffer[0];
-	df2 = buffer[1];
-	df3 = buffer[2];
-	df4 = buffer[3];
-	df5 = buffer[4];
-	df6 = buffer[5];
-
                    /* Extract information: */
-	if (df1 & 0x80)
-	{
-		lat = make_si32 (0xff, df1, df2, df3);
-	}
-	else
-	{
-		lat = make_si32 (0x00, df1, df2, df3);
-	}
-	if (df4 & 0x80)
-	{
-		lon = make_si32 (0xff, df4, df5, df6);
-	}
-	else
-	{
-		lon = make_si32 (0x00, df4, df5, df6);
-	}
+	lat = item_si24 (buffer);
+	lon = item_si24 (buffer + 3);
 
                    /* Convert: */
-	latf = (180.0 / M_TWO_POWER_23) * lat;
-	lonf = (180.0 / M_TWO_POWER_23) * lon;
+	item_wgs84 (buffer, 3, 180.0 / M_TWO_POWER_23, &latf, &lonf);
 
 #if LISTER
                    /* List data field: */
@@ -3924,14 +3883,6 @@ static t_Retc proc_i021_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
  static
  t_Retc proc_i021_131 (t_Ui16 length, t_Byte *buffer)
 {
-	t_Byte df1;    /* Data field octet 1 */
-	t_Byte df2;    /* Data field octet 2 */
-	t_Byte df3;    /* Data field octet 3 */
-	t_Byte df4;    /* Data field octet 4 */
-	t_Byte df5;    /* Data field octet 5 */
-	t_Byte df6;    /* Data field octet 6 */
-	t_Byte df7;    /* Data field octet 7 */
-	t_Byte df8;    /* Data field octet 8 */
 	t_Si32 lat;    /* Latitude; 180/2**30 degrees */
 	t_Real latf;   /* Latitude; degrees */
 	t_Si32 lon;    /* Longitude; 180/2**30 degrees */
@@ -3950,23 +3901,12 @@ static t_Retc proc_i021_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
             reference_vsn == 21 || reference_vsn == 24,
             "Data item not defined");
 
-                   /* Extract octets: */
-	df1 = buffer[0];
-	df2 = buffer[1];
-	df3 = buffer[2];
-	df4 = buffer[3];
-	df5 = buffer[4];
-	df6 = buffer[5];
-	df7 = buffer[6];
-	df8 = buffer[7];
-
                    /* Extract information: */
-	lat = make_si32 (df1, df2, df3, df4);
-	lon = make_si32 (df5, df6, df7, df8);
+	lat = item_si32 (buffer);
+	lon = item_si32 (buffer + 4);
 
                    /* Convert: */
-	latf = (180.0 / M_TWO_POWER_30) * lat;
-	lonf = (180.0 / M_TWO_POWER_30) * lon;
+	item_wgs84 (buffer, 4, 180.0 / M_TWO_POWER_30, &latf, &lonf);
 
 #if LISTER
                    /* List data field: */
@@ -4101,8 +4041,6 @@ static t_Retc proc_i021_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
  static
  t_Retc proc_i021_145 (t_Ui16 length, t_Byte *buffer)
 {
-	t_Byte df1;    /* Data field octet 1 */
-	t_Byte df2;    /* Data field octet 2 */
 	t_Si16 fl;     /* Flight level; 25 feet */
 	t_Retc ret;    /* Return code */
 
@@ -4113,12 +4051,8 @@ static t_Retc proc_i021_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	Assert (length == 2, "Invalid parameter");
 	Assert (buffer != NULL, "Invalid parameter");
 
-                   /* Extract octets: */
-	df1 = buffer[0];
-	df2 = buffer[1];
-
                    /* Extract information: */
-	fl = make_si16 (df1, df2);
+	fl = item_altitude (buffer);
 
 #if LISTER
                    /* List data field: */
@@ -4825,9 +4759,14 @@ static t_Retc proc_i021_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
         reference_vsn == 21 || reference_vsn == 24)
 	{
 		adsb.ground_vector.range_exceeded = M_TRES (re);
+		item_ground_vector (buffer, &adsb.ground_vector.value_gsp,
+                            &adsb.ground_vector.value_hdg);
+	}
+	else
+	{
+		adsb.ground_vector.value_gsp = (M_NMI2MTR / 16384.0) * spd;
+		adsb.ground_vector.value_hdg = (M_TWO_PI / 65536.0) * ta; 
 	}
-	adsb.ground_vector.value_gsp = (M_NMI2MTR / 16384.0) * spd;
-	adsb.ground_vector.value_hdg = (M_TWO_PI / 65536.0) * ta; 
                    /* Value is in radians */
 	/* tba ... */
 
@@ -5056,14 +4995,8 @@ static t_Retc proc_i021_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
  static
  t_Retc proc_i021_170 (t_Ui16 length, t_Byte *buffer)
 {
-	t_Byte c6;     /* Character in 6-bit encoding */
-	t_Byte df1;    /* Data field octet 1 */
-	t_Byte df2;    /* Data field octet 2 */
-	t_Byte df3;    /* Data field octet 3 */
-	t_Byte df4;    /* Data field octet 4 */
-	t_Byte df5;    /* Data field octet 5 */
-	t_Byte df6;    /* Data field octet 6 */
 	t_Retc ret;    /* Return code */
+	t_Bool valid;  /* All characters are valid */
 	char txt[9];   /* Text buffer for target identification */
                    /* If a flight plan has been submitted to the
                       responsible ATC/ATM authorities, this ID is
@@ -5078,32 +5011,8 @@ static t_Retc proc_i021_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	Assert (length == 6, "Invalid parameter");
 	Assert (buffer != NULL, "Invalid parameter");
 
-                   /* Extract octets: */
-	df1 = buffer[0];
-	df2 = buffer[1];
-	df3 = buffer[2];
-	df4 = buffer[3];
-	df5 = buffer[4];
-	df6 = buffer[5];
-
                    /* Extract information: */
-	memset (txt, 0, 9);
-	c6 = (df1 >> 2) & 0x3f;
-	txt[0] = expand_c (c6);
-	c6 = ((df1 & 0x03) << 4) | ((df2 >> 4) & 0x0f);
-	txt[1] = expand_c (c6);
-    c6 = ((df2 & 0x0f) << 2) | ((df3 >> 6) & 0x03);
-	txt[2] = expand_c (c6);
-	c6 = df3 & 0x3f;
-	txt[3] = expand_c (c6);
-	c6 = (df4 >> 2) & 0x3f;
-	txt[4] = expand_c (c6);
-	c6 = ((df4 & 0x03) << 4) | ((df5 >> 4) & 0x0f);
-	txt[5] = expand_c (c6);
-	c6 = ((df5 & 0x0f) << 2) | ((df6 >> 6) & 0x03);
-	txt[6] = expand_c (c6);
-	c6 = df6 & 0x3f;
-	txt[7] = expand_c (c6);
+	valid = expand_idt (buffer, txt);
 
 #if LISTER
                    /* List data field: */
@@ -5116,6 +5025,7 @@ static t_Retc proc_i021_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	adsb.target_identification.present = TRUE;
 	strncpy (adsb.target_identification.value_idt, txt,
              M_AIRCRAFT_IDENTIFICATION_LENGTH);
+	adsb.target_identification.value_invalid = !valid;
 
                    /* Set the return code: */
 	ret = RC_OKAY;
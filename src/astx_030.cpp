@@ -3325,16 +3325,10 @@ static t_Retc proc_i030_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
  static
  t_Retc proc_i030_384 (t_Ui16 length, t_Byte *buffer)
 {
-	t_Byte c;      /* 6 bits character */
-	t_Byte df1;    /* Data field octet 1 */
-	t_Byte df2;    /* Data field octet 2 */
-	t_Byte df3;    /* Data field octet 3 */
-	t_Byte df4;    /* Data field octet 4 */
-	t_Byte df5;    /* Data field octet 5 */
-	t_Byte df6;    /* Data field octet 6 */
 	char idt[M_AIRCRAFT_IDENTIFICATION_LENGTH + 1];
                    /* Aircraft identification */
 	t_Retc ret;    /* Return code */
+	t_Bool valid;  /* All characters are valid */
 
 				   /* Preset the return code: */
 	ret = RC_FAIL;
@@ -3343,36 +3337,8 @@ static t_Retc proc_i030_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	Assert (length == 6, "Invalid parameter");
 	Assert (buffer != NULL, "Invalid parameter");
 
-				   /* Extract octets: */
-	df1 = buffer[0];
-	df2 = buffer[1];
-	df3 = buffer[2];
-	df4 = buffer[3];
-	df5 = buffer[4];
-	df6 = buffer[5];
-
 				   /* Extract information: */
-	memset (idt, 0, 9);
-	c = (df1 >> 2) & 0x3f;
-	idt[0] = expand_c (c);
-	c = (df1 & 0x03) << 4;
-	c |= (df2 >> 4) & 0x0f;
-	idt[1] = expand_c (c);
-	c = (df2 & 0x0f) << 2;
-	c |= (df3 >> 6) & 0x03;
-	idt[2] = expand_c (c);
-	c = df3 & 0x03f;
-	idt[3] = expand_c (c);
-	c = (df4 >> 2) & 0x3f;
-	idt[4] = expand_c (c);
-	c = (df4 & 0x03) << 4;
-	c |= (df5 >> 4) & 0x0f;
-	idt[5] = expand_c (c);
-	c = (df5 & 0x0f) << 2;
-	c |= (df6 >> 6) & 0x03;
-	idt[6] = expand_c (c);
-	c = df6 & 0x3f;
-	idt[7] = expand_c (c);
+	valid = expand_idt (buffer, idt);
 
 #if LISTER
 				   /* List data field: */
@@ -3385,6 +3351,7 @@ static t_Retc proc_i030_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	strk.aircraft_identification.present = TRUE;
 	strncpy (strk.aircraft_identification.value_idt, idt,
              M_AIRCRAFT_IDENTIFICATION_LENGTH);
+	strk.aircraft_identification.value_invalid = !valid;
 
 				   /* Set the return code: */
 	ret = RC_OKAY;
@@ -47,6 +47,8 @@
                    /* Basic system definitions */
 #include "common.h"
                    /* Common declarations and definitions */
+#include "astx_items.h"
+                   /* Values of ASTERIX data items */
 
 #include <math.h>
 #include <stddef.h>
@@ -1059,11 +1061,8 @@ static t_Retc proc_i048_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 
 				   /* Store this information: */
 	rtgt.measured_azm.present = TRUE;
-	rtgt.measured_azm.value = (M_TWO_PI / 65536.0) * theta;
-                   /* In radians */
 	rtgt.measured_rng.present = TRUE;
-	rtgt.measured_rng.value = (M_NMI2MTR / 256.0) * rho;
-                   /* In metres */
+	item_polar (buffer, &rtgt.measured_rng.value, &rtgt.measured_azm.value);
 
 				   /* Set the return code: */
 	ret = RC_OKAY;
@@ -1343,7 +1342,6 @@ static t_Retc proc_i048_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
  t_Retc proc_i048_070 (t_Ui16 length, t_Byte *buffer)
 {
 	t_Byte df1;    /* Data field octet 1 */
-	t_Byte df2;    /* Data field octet 2 */
 	t_Ui16 m3c;    /* Mode 3/A code */
 	t_Retc ret;    /* Return code */
 
@@ -1354,12 +1352,11 @@ static t_Retc proc_i048_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	Assert (length == 2, "Invalid parameter");
 	Assert (buffer != NULL, "Invalid parameter");
 
-				   /* Extract octets: */
+				   /* Extract octet: */
 	df1 = buffer[0];
-	df2 = buffer[1];
 
 				   /* Extract information: */
-	m3c = make_ui16 (df1 & 0x0f, df2);
+	m3c = item_mode_3a (buffer);
 
 #if LISTER
 				   /* List data field: */
@@ -1439,7 +1436,6 @@ static t_Retc proc_i048_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
  t_Retc proc_i048_090 (t_Ui16 length, t_Byte *buffer)
 {
 	t_Byte df1;    /* Data field octet 1 */
-	t_Byte df2;    /* Data field octet 2 */
 	t_Si16 mch;    /* Mode C height; 25 feet */
 	t_Retc ret;    /* Return code */
 
@@ -1450,17 +1446,11 @@ static t_Retc proc_i048_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	Assert (length == 2, "Invalid parameter");
 	Assert (buffer != NULL, "Invalid parameter");
 
-				   /* Extract octets: */
+				   /* Extract octet: */
 	df1 = buffer[0];
-	df2 = buffer[1];
 
 				   /* Extract information: */
-	mch = make_si16 (df1 & 0x1f, df2);
-	if (df1 & 0x20)
-	{
-		mch |= 0xe000;
-                   /* Negative height encoded in two's complement */
-	}
+	mch = item_mode_c (buffer);
 
 #if LISTER
 				   /* List data field: */
@@ -1500,6 +1490,7 @@ static t_Retc proc_i048_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	t_Byte df2;    /* Data field octet 2 */
 	t_Byte df3;    /* Data field octet 3 */
 	t_Byte df4;    /* Data field octet 4 */
+	t_Si16 alt;    /* Height decoded from mode C code; 100 feet */
 	t_Ui16 mcc;    /* Mode C code (in Gray notation) */
 	t_Ui16 mccc;   /* Mode C code confidence */
 	t_Retc ret;    /* Return code */
@@ -1521,6 +1512,9 @@ static t_Retc proc_i048_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	mcc = make_ui16 (df1 & 0x0f, df2);
 	mccc = make_ui16 (df3 & 0x0f, df4);
 
+				   /* Decode the Gillham code: */
+	alt = gillham_to_alt (mcc);
+
 #if LISTER
 				   /* List data field: */
 	list_text (2, ";  Mode C (Gray) Code:");
@@ -1528,6 +1522,10 @@ static t_Retc proc_i048_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	list_text (2, " g=" M_FMT_BYTE ";", (df1 >> 6) & 0x01);
 	list_text (2, " code=" M_FMT_CODE ";", mcc);
 	list_text (2, " conf=" M_FMT_CODE, mccc);
+	if (alt != M_UTL_NVA)
+	{
+		list_text (2, "; alt=%d ft", 100 * alt);
+	}
 	list_text (2, "\n");
 #endif /* LISTER */
 
@@ -1538,6 +1536,11 @@ static t_Retc proc_i048_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	rtgt.mode_c_code.code_confidence = mccc;
                    /* Not inverted, i. e. 0=high confidence */
 	rtgt.mode_c_code.code_confidence_present = TRUE;
+	if (alt != M_UTL_NVA)
+	{
+		rtgt.mode_c_code.height = alt;
+		rtgt.mode_c_code.height_present = TRUE;
+	}
 	rtgt.mode_c_code.present = TRUE;
 
 				   /* Set the return code: */
@@ -2046,8 +2049,8 @@ static t_Retc proc_i048_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 				   /* Extract information: */
 	tod = make_ui32 (0x00, df1, df2, df3);
 
-                   /* Convert to milliseconds: */
-	tod_in_secs = (1.0 / 128.0) * tod;
+                   /* Convert to seconds: */
+	tod_in_secs = item_tod (buffer);
 
 #if LISTER
 				   /* List data field: */
@@ -2355,9 +2358,6 @@ static t_Retc proc_i048_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
  t_Retc proc_i048_220 (t_Ui16 length, t_Byte *buffer)
 {
 	t_Ui32 aa;     /* Aircraft address */
-	t_Byte df1;    /* Data field octet 1 */
-	t_Byte df2;    /* Data field octet 2 */
-	t_Byte df3;    /* Data field octet 3 */
 	t_Retc ret;    /* Return code */
 
 				   /* Preset the return code: */
@@ -2367,13 +2367,8 @@ static t_Retc proc_i048_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	Assert (length == 3, "Invalid parameter");
 	Assert (buffer != NULL, "Invalid parameter");
 
-				   /* Extract octets: */
-	df1 = buffer[0];
-	df2 = buffer[1];
-	df3 = buffer[2];
-
                    /* Extract information: */
-	aa = make_ui32 (0x00, df1, df2, df3);
+	aa = item_ui24 (buffer);
 
 #if LISTER
 				   /* List data field: */
@@ -2574,21 +2569,8 @@ static t_Retc proc_i048_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
  static
  t_Retc proc_i048_240 (t_Ui16 length, t_Byte *buffer)
 {
-	t_Byte c1;     /* Character 1 */
-	t_Byte c2;     /* Character 2 */
-	t_Byte c3;     /* Character 3 */
-	t_Byte c4;     /* Character 4 */
-	t_Byte c5;     /* Character 5 */
-	t_Byte c6;     /* Character 6 */
-	t_Byte c7;     /* Character 7 */
-	t_Byte c8;     /* Character 8 */
-	t_Byte df1;    /* Data field octet 1 */
-	t_Byte df2;    /* Data field octet 2 */
-	t_Byte df3;    /* Data field octet 3 */
-	t_Byte df4;    /* Data field octet 4 */
-	t_Byte df5;    /* Data field octet 5 */
-	t_Byte df6;    /* Data field octet 6 */
 	t_Retc ret;    /* Return code */
+	t_Bool valid;  /* All characters are valid */
 	char txt[9];   /* Text buffer */
 
 				   /* Preset the return code: */
@@ -2598,42 +2580,8 @@ static t_Retc proc_i048_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	Assert (length == 6, "Invalid parameter");
 	Assert (buffer != NULL, "Invalid parameter");
 
-				   /* Extract octets: */
-	df1 = buffer[0];
-	df2 = buffer[1];
-	df3 = buffer[2];
-	df4 = buffer[3];
-	df5 = buffer[4];
-	df6 = buffer[5];
-
                    /* Extract information: */
-	c1 = (df1 >> 2) & 0x3f;
-	c2 = df1 & 0x03;
-	c2 <<= 4;
-	c2 |= (df2 >> 4) & 0x0f;
-	c3 = df2 & 0x0f;
-	c3 <<= 2;
-	c3 |= (df3 >> 6) & 0x03;
-	c4 = df3 & 0x3f;
-	c5 = (df4 >> 2) & 0x3f;
-	c6 = df4 & 0x03;
-	c6 <<= 4;
-	c6 |= (df5 >> 4) & 0x0f;
-	c7 = df5 & 0x0f;
-	c7 <<= 2;
-	c7 |= (df6 >> 6) & 0x03;
-	c8 = df6 & 0x3f;
-
-                   /* Convert to conventional text: */
-	memset (txt, 0, 9);
-	txt[0] = expand_c (c1);
-	txt[1] = expand_c (c2);
-	txt[2] = expand_c (c3);
-	txt[3] = expand_c (c4);
-	txt[4] = expand_c (c5);
-	txt[5] = expand_c (c6);
-	txt[6] = expand_c (c7);
-	txt[7] = expand_c (c8);
+	valid = expand_idt (buffer, txt);
 
 #if LISTER
 				   /* List data field: */
@@ -2644,6 +2592,7 @@ static t_Retc proc_i048_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	rtgt.aircraft_identification.present = TRUE;
 	strncpy (rtgt.aircraft_identification.value_idt, txt,
              M_AIRCRAFT_IDENTIFICATION_LENGTH);
+	rtgt.aircraft_identification.value_invalid = !valid;
 
 				   /* Set the return code: */
 	ret = RC_OKAY;
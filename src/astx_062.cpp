@@ -44,6 +44,8 @@
                    /* Basic system definitions */
 #include "common.h"
                    /* Common declarations and definitions */
+#include "astx_items.h"
+                   /* Values of ASTERIX data items */
 
 #include <stddef.h>
 #include <stdio.h>
@@ -819,7 +821,6 @@ static t_Retc proc_i062_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
  t_Retc proc_i062_060 (t_Ui16 length, t_Byte *buffer)
 {
 	t_Byte df1;    /* Data field octet 1 */
-	t_Byte df2;    /* Data field octet 2 */
 	t_Ui16 m3c;    /* Track mode 3/A code */
 	t_Byte m3c_changed;
                    /* Track mode 3/A code changed */
@@ -836,12 +837,11 @@ static t_Retc proc_i062_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	Assert (length == 2, "Invalid parameter");
 	Assert (buffer != NULL, "Invalid parameter");
 
-				   /* Extract octets: */
+				   /* Extract octet: */
 	df1 = buffer[0];
-	df2 = buffer[1];
 
 				   /* Extract information: */
-	m3c = make_ui16 (df1 & 0x0f, df2);
+	m3c = item_mode_3a (buffer);
 	m3c_invalid = (df1 >> 7) & 0x01;
 	m3c_garbled = (df1 >> 6) & 0x01;
 	m3c_changed = (df1 >> 5) & 0x01;
@@ -900,7 +900,7 @@ static t_Retc proc_i062_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	tod = make_ui32 (0x00, df1, df2, df3);
 
                    /* Compute time (of day): */
-	tod_in_secs = (1.0 / 128.0) * tod;
+	tod_in_secs = item_tod (buffer);
 
 #if LISTER
 				   /* List data field: */
@@ -1242,12 +1242,6 @@ static t_Retc proc_i062_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
  static
  t_Retc proc_i062_100 (t_Ui16 length, t_Byte *buffer)
 {
-	t_Byte df1;    /* Data field octet 1 */
-	t_Byte df2;    /* Data field octet 2 */
-	t_Byte df3;    /* Data field octet 3 */
-	t_Byte df4;    /* Data field octet 4 */
-	t_Byte df5;    /* Data field octet 5 */
-	t_Byte df6;    /* Data field octet 6 */
 	t_Retc ret;    /* Return code */
 	t_Si32 x;      /* x coordinate; 0.5 metres */
 	t_Si32 y;      /* y coordinate; 0.5 metres */
@@ -1259,31 +1253,9 @@ static t_Retc proc_i062_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	Assert (length == 6, "Invalid parameter");
 	Assert (buffer != NULL, "Invalid parameter");
 
-				   /* Extract octets: */
-	df1 = buffer[0];
-	df2 = buffer[1];
-	df3 = buffer[2];
-	df4 = buffer[3];
-	df5 = buffer[4];
-	df6 = buffer[5];
-
 				   /* Extract information: */
-	if (df1 & 0x80)
-	{
-		x = make_si32 (0xff, df1, df2, df3);
-	}
-	else
-	{
-		x = make_si32 (0x00, df1, df2, df3);
-	}
-	if (df4 & 0x80)
-	{
-		y = make_si32 (0xff, df4, df5, df6);
-	}
-	else
-	{
-		y = make_si32 (0x00, df4, df5, df6);
-	}
+	x = item_si24 (buffer);
+	y = item_si24 (buffer + 3);
 
 #if LISTER
 				   /* List data field: */
@@ -1295,8 +1267,8 @@ static t_Retc proc_i062_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 
 				   /* Store this information: */
 	strk.calculated_position.present = TRUE;
-	strk.calculated_position.value_x = 0.5 * x;
-	strk.calculated_position.value_y = 0.5 * y;
+	item_cartesian (buffer, &strk.calculated_position.value_x,
+                    &strk.calculated_position.value_y);
 
 				   /* Set the return code: */
 	ret = RC_OKAY;
@@ -1311,14 +1283,6 @@ static t_Retc proc_i062_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
  static
  t_Retc proc_i062_105 (t_Ui16 length, t_Byte *buffer)
 {
-	t_Byte df1;    /* Data field octet 1 */
-	t_Byte df2;    /* Data field octet 2 */
-	t_Byte df3;    /* Data field octet 3 */
-	t_Byte df4;    /* Data field octet 4 */
-	t_Byte df5;    /* Data field octet 5 */
-	t_Byte df6;    /* Data field octet 6 */
-	t_Byte df7;    /* Data field octet 7 */
-	t_Byte df8;    /* Data field octet 8 */
 	t_Si32 lat;    /* Latitude; 180/2**25 degrees */
 	t_Real latf;   /* Latitude; degrees */
 	t_Si32 lon;    /* Longitude; 180/2**25 degrees */
@@ -1332,23 +1296,12 @@ static t_Retc proc_i062_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	Assert (length == 8, "Invalid parameter");
 	Assert (buffer != NULL, "Invalid parameter");
 
-				   /* Extract octets: */
-	df1 = buffer[0];
-	df2 = buffer[1];
-	df3 = buffer[2];
-	df4 = buffer[3];
-	df5 = buffer[4];
-	df6 = buffer[5];
-	df7 = buffer[6];
-	df8 = buffer[7];
-
 				   /* Extract information: */
-	lat = make_si32 (df1, df2, df3, df4);
-	lon = make_si32 (df5, df6, df7, df8);
+	lat = item_si32 (buffer);
+	lon = item_si32 (buffer + 4);
 
                    /* Convert: */
-	latf = (180.0 / M_TWO_POWER_25) * lat;
-	lonf = (180.0 / M_TWO_POWER_25) * lon;
+	item_wgs84 (buffer, 4, 180.0 / M_TWO_POWER_25, &latf, &lonf);
 
 #if LISTER
 				   /* List data field: */
@@ -1837,8 +1790,6 @@ static t_Retc proc_i062_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
  t_Retc proc_i062_136 (t_Ui16 length, t_Byte *buffer)
 {
 	t_Si16 alt;    /* Altitude; 25 feet */
-	t_Byte df1;    /* Data field octet 1 */
-	t_Byte df2;    /* Data field octet 2 */
 	t_Retc ret;    /* Return code */
 
 				   /* Preset the return code: */
@@ -1848,12 +1799,8 @@ static t_Retc proc_i062_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	Assert (length == 2, "Invalid parameter");
 	Assert (buffer != NULL, "Invalid parameter");
 
-				   /* Extract octets: */
-	df1 = buffer[0];
-	df2 = buffer[1];
-
 				   /* Extract information: */
-	alt = make_si16 (df1, df2);
+	alt = item_altitude (buffer);
 
 #if LISTER
 				   /* List data field: */
@@ -1917,8 +1864,8 @@ static t_Retc proc_i062_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 
 				   /* Store this information: */
 	strk.calculated_cartesian_velocity.present = TRUE;
-	strk.calculated_cartesian_velocity.value_vx = 0.25 * vx;
-	strk.calculated_cartesian_velocity.value_vy = 0.25 * vy;
+	item_velocity (buffer, &strk.calculated_cartesian_velocity.value_vx,
+                   &strk.calculated_cartesian_velocity.value_vy);
                    /* In metres/second */
 
 				   /* Set the return code: */
@@ -2134,17 +2081,11 @@ static t_Retc proc_i062_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
  static
  t_Retc proc_i062_245 (t_Ui16 length, t_Byte *buffer)
 {
-	t_Byte c;      /* 6 bits character */
 	t_Byte df1;    /* Data field octet 1 */
-	t_Byte df2;    /* Data field octet 2 */
-	t_Byte df3;    /* Data field octet 3 */
-	t_Byte df4;    /* Data field octet 4 */
-	t_Byte df5;    /* Data field octet 5 */
-	t_Byte df6;    /* Data field octet 6 */
-	t_Byte df7;    /* Data field octet 7 */
 	char idt[M_AIRCRAFT_IDENTIFICATION_LENGTH + 1];
                    /* Target identification */
 	t_Retc ret;    /* Return code */
+	t_Bool valid;  /* All characters are valid */
 	t_Byte sti;    /* Source of target identification */
 
 				   /* Preset the return code: */
@@ -2156,36 +2097,10 @@ static t_Retc proc_i062_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 
 				   /* Extract octets: */
 	df1 = buffer[0];
-	df2 = buffer[1];
-	df3 = buffer[2];
-	df4 = buffer[3];
-	df5 = buffer[4];
-	df6 = buffer[5];
-	df7 = buffer[6];
 
 				   /* Extract information: */
 	sti = (df1 >> 6) & 0x03;
-	memset (idt, 0, 9);
-    c = (df2 >> 2) & 0x3f;
-    idt[0] = expand_c (c);
-    c = (df2 & 0x03) << 4;
-    c |= (df3 >> 4) & 0x0f;
-    idt[1] = expand_c (c);
-    c = (df3 & 0x0f) << 2;
-    c |= (df4 >> 6) & 0x03;
-    idt[2] = expand_c (c);
-    c = df4 & 0x03f;
-    idt[3] = expand_c (c);
-    c = (df5 >> 2) & 0x3f;
-    idt[4] = expand_c (c);
-    c = (df5 & 0x03) << 4;
-    c |= (df6 >> 4) & 0x0f;
-    idt[5] = expand_c (c);
-    c = (df6 & 0x0f) << 2;
-    c |= (df7 >> 6) & 0x03;
-    idt[6] = expand_c (c);
-    c = df7 & 0x3f;
-    idt[7] = expand_c (c);
+	valid = expand_idt (buffer + 1, idt);
 
 #if LISTER
 				   /* List data field: */
@@ -2200,6 +2115,7 @@ static t_Retc proc_i062_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	strk.aircraft_identification.sti_present = TRUE;
 	strncpy (strk.aircraft_identification.value_idt, idt,
              M_AIRCRAFT_IDENTIFICATION_LENGTH);
+	strk.aircraft_identification.value_invalid = !valid;
 	strk.aircraft_identification.value_sti = sti;
 
 				   /* Set the return code: */
@@ -4029,7 +3945,6 @@ static t_Retc proc_i062_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	t_Ui16 bps;    /* Barometric pressure setting */
 #endif /* LISTER */
 	t_Si16 bvr;    /* Barometric vertical rate; 6.25 feet/minute */
-	t_Byte c;      /* Auxiliary */
 	t_Ui16 com;    /* Communications/ACAS capability and flight
                       status */
 	t_Byte df1;    /* Data field octet 1 */
@@ -4057,6 +3972,8 @@ static t_Retc proc_i062_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	t_Ui16 ias;    /* Indicated airspeed / Mach number */
 	char id[M_AIRCRAFT_IDENTIFICATION_LENGTH + 1];
                    /* Target identification */
+	t_Bool id_valid;
+                   /* All characters of target identification valid */
 	int ix;        /* Auxiliary */
 #if LISTER
 	int j;         /* Auxiliary */
@@ -4167,6 +4084,7 @@ static t_Retc proc_i062_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	Assert (pos_ptr != NULL, "Invalid parameter");
 
                    /* Preset local data: */
+	id_valid = FALSE;
 	mb_cnt = 0;
 	mb_rep = 0;
 	tid_rep = 0;
@@ -4390,36 +4308,8 @@ static t_Retc proc_i062_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	}
 	if (sf2_present)
 	{
-		df5 = buffer[pos + ix];
-		df6 = buffer[pos + ix + 1];
-		df7 = buffer[pos + ix + 2];
-		df8 = buffer[pos + ix + 3];
-		df9 = buffer[pos + ix + 4];
-		df10 = buffer[pos + ix + 5];
+		id_valid = expand_idt (buffer + pos + ix, id);
 		ix += 6;
-
-		memset (id, 0, 9);
-
-		c = (df5 >> 2) & 0x3f;
-		id[0] = expand_c (c);
-		c = (df5 & 0x03) << 4;
-		c |= (df6 >> 4) & 0x0f;
-		id[1] = expand_c (c);
-		c = (df6 & 0x0f) << 2;
-		c |= (df7 >> 6) & 0x03;
-		id[2] = expand_c (c);
-		c = df7 & 0x03f;
-		id[3] = expand_c (c);
-		c = (df8 >> 2) & 0x3f;
-		id[4] = expand_c (c);
-		c = (df8 & 0x03) << 4;
-		c |= (df9 >> 4) & 0x0f;
-		id[5] = expand_c (c);
-		c = (df9 & 0x0f) << 2;
-		c |= (df10 >> 6) & 0x03;
-		id[6] = expand_c (c);
-		c = df10 & 0x3f;
-		id[7] = expand_c (c);
 	}
 	if (sf3_present)
 	{
@@ -5061,6 +4951,7 @@ static t_Retc proc_i062_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 		strk.aircraft_identification.present = TRUE;
 		strncpy (strk.aircraft_identification.value_idt, id,
                  M_AIRCRAFT_IDENTIFICATION_LENGTH);
+		strk.aircraft_identification.value_invalid = !id_valid;
 	}
 	if (sf3_present)
 	{
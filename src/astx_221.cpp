@@ -872,8 +872,8 @@ static t_Retc proc_i221_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 #endif /* LISTER */
 
                    /* Remember this information: */
-	last_tod_available = TRUE;
-	last_tod = tod;
+	remember_tod (adsb.data_source_identifier.present,
+                  adsb.data_source_identifier.value, tod);
 
                    /* Store this information: */
 	adsb.detection_time.present = TRUE;
@@ -2163,14 +2163,8 @@ static t_Retc proc_i221_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
  static
  t_Retc proc_i221_170 (t_Ui16 length, t_Byte *buffer)
 {
-	t_Byte c6;     /* Character in 6-bit encoding */
-	t_Byte df1;    /* Data field octet 1 */
-	t_Byte df2;    /* Data field octet 2 */
-	t_Byte df3;    /* Data field octet 3 */
-	t_Byte df4;    /* Data field octet 4 */
-	t_Byte df5;    /* Data field octet 5 */
-	t_Byte df6;    /* Data field octet 6 */
 	t_Retc ret;    /* Return code */
+	t_Bool valid;  /* All characters are valid */
 	char txt[9];   /* Text buffer for target identification */
                    /* If a flight plan has been submitted to the
                       responsible ATC/ATM authorities, this ID is
@@ -2185,32 +2179,8 @@ static t_Retc proc_i221_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	Assert (length == 6, "Invalid parameter");
 	Assert (buffer != NULL, "Invalid parameter");
 
-				   /* Extract octets: */
-	df1 = buffer[0];
-	df2 = buffer[1];
-	df3 = buffer[2];
-	df4 = buffer[3];
-	df5 = buffer[4];
-	df6 = buffer[5];
-
 				   /* Extract information: */
-	memset (txt, 0, 9);
-	c6 = (df1 >> 2) & 0x3f;
-	txt[0] = expand_c (c6);
-	c6 = ((df1 & 0x03) << 4) | ((df2 >> 4) & 0x0f);
-	txt[1] = expand_c (c6);
-    c6 = ((df2 & 0x0f) << 2) | ((df3 >> 6) & 0x03);
-	txt[2] = expand_c (c6);
-	c6 = df3 & 0x3f;
-	txt[3] = expand_c (c6);
-	c6 = (df4 >> 2) & 0x3f;
-	txt[4] = expand_c (c6);
-	c6 = ((df4 & 0x03) << 4) | ((df5 >> 4) & 0x0f);
-	txt[5] = expand_c (c6);
-	c6 = ((df5 & 0x0f) << 2) | ((df6 >> 6) & 0x03);
-	txt[6] = expand_c (c6);
-	c6 = df6 & 0x3f;
-	txt[7] = expand_c (c6);
+	valid = expand_idt (buffer, txt);
 
 #if LISTER
 				   /* List data field: */
@@ -2223,6 +2193,7 @@ static t_Retc proc_i221_spf (t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
 	adsb.target_identification.present = TRUE;
 	strncpy (adsb.target_identification.value_idt, txt,
              M_AIRCRAFT_IDENTIFICATION_LENGTH);
+	adsb.target_identification.value_invalid = !valid;
 
 				   /* Set the return code: */
 	ret = RC_OKAY;
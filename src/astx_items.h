@@ -0,0 +1,292 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*----------------------------------------------------------------------------*/
+/* Project:        Surveillance Data Decoder and Lister                       */
+/* File:           src/astx_items.h                                           */
+/* Contents:       Values of ASTERIX data items                               */
+/* Author(s):      agent                                                      */
+/* Last change:    2026-10-18                                                 */
+/*----------------------------------------------------------------------------*/
+
+/* The values of the data items most often used from ASTERIX categories
+   021, 048 and 062, as stored by astx_021.cpp, astx_048.cpp and
+   astx_062.cpp and by the fast path decoder (fastpath/fastpath.h).
+   The functions neither check their parameters nor use any state;
+   the caller has checked the length of the data item. */
+
+#ifndef INCLUDED_ASTX_ITEMS_H
+#define INCLUDED_ASTX_ITEMS_H
+
+#include "basics.h"
+                   /* Basic system definitions */
+#include "common.h"
+                   /* Common declarations and definitions */
+
+#include <string.h>
+                   /* String functions */
+#if defined (__BMI2__)
+#include <immintrin.h>
+#endif
+
+/*----------------------------------------------------------------------------*/
+/* item_ui24       -- Unsigned value of three octets                          */
+/*----------------------------------------------------------------------------*/
+
+ inline t_Ui32 item_ui24 (const t_Byte *buffer)
+{
+	return ((t_Ui32) buffer[0] << 16) | ((t_Ui32) buffer[1] << 8) |
+           (t_Ui32) buffer[2];
+}
+
+/*----------------------------------------------------------------------------*/
+/* item_si24       -- Signed value of three octets                            */
+/*----------------------------------------------------------------------------*/
+
+ inline t_Si32 item_si24 (const t_Byte *buffer)
+{
+	t_Ui32 u;      /* Unsigned value */
+
+	u = item_ui24 (buffer);
+	if (u & 0x00800000)
+	{
+		u |= 0xff000000;
+                   /* Negative value encoded in two's complement */
+	}
+
+	return (t_Si32) u;
+}
+
+/*----------------------------------------------------------------------------*/
+/* item_si32       -- Signed value of four octets                             */
+/*----------------------------------------------------------------------------*/
+
+ inline t_Si32 item_si32 (const t_Byte *buffer)
+{
+	return (t_Si32) (((t_Ui32) buffer[0] << 24) | item_ui24 (buffer + 1));
+}
+
+/*----------------------------------------------------------------------------*/
+/* item_tod        -- Time of day (I021/071, I021/073, I048/140, I062/070)    */
+/*----------------------------------------------------------------------------*/
+
+ inline t_Secs item_tod (const t_Byte *buffer)
+{
+                   /* 3 octets; 1/128 seconds */
+	return (1.0 / 128.0) * item_ui24 (buffer);
+}
+
+/*----------------------------------------------------------------------------*/
+/* item_mode_3a    -- Mode 3/A code (I021/070, I048/070, I062/060)            */
+/*----------------------------------------------------------------------------*/
+
+ inline t_Ui16 item_mode_3a (const t_Byte *buffer)
+{
+                   /* Lower 12 bits of 2 octets */
+	return (t_Ui16) (((buffer[0] & 0x0f) << 8) | buffer[1]);
+}
+
+/*----------------------------------------------------------------------------*/
+/* item_mode_c     -- Mode C height in 25 feet (I048/090)                     */
+/*----------------------------------------------------------------------------*/
+
+ inline t_Si16 item_mode_c (const t_Byte *buffer)
+{
+	t_Ui16 mch;    /* Mode C height; 25 feet */
+
+                   /* Lower 14 bits of 2 octets */
+	mch = (t_Ui16) (((buffer[0] & 0x1f) << 8) | buffer[1]);
+	if (buffer[0] & 0x20)
+	{
+		mch |= 0xe000;
+                   /* Negative height encoded in two's complement */
+	}
+
+	return (t_Si16) mch;
+}
+
+/*----------------------------------------------------------------------------*/
+/* item_altitude   -- Flight level in 25 feet (I021/145, I062/136)            */
+/*----------------------------------------------------------------------------*/
+
+ inline t_Si16 item_altitude (const t_Byte *buffer)
+{
+	return (t_Si16) ((buffer[0] << 8) | buffer[1]);
+}
+
+/*----------------------------------------------------------------------------*/
+/* item_polar      -- Measured position in polar co-ordinates (I048/040)      */
+/*----------------------------------------------------------------------------*/
+
+ inline void item_polar (const t_Byte *buffer, t_Real *rng_ptr, t_Real *azm_ptr)
+{
+	t_Ui16 rho;    /* Slant range; 1/256 nautical miles */
+	t_Ui16 theta;  /* Azimuth; 360/2**16 degrees */
+
+	rho = (t_Ui16) ((buffer[0] << 8) | buffer[1]);
+	theta = (t_Ui16) ((buffer[2] << 8) | buffer[3]);
+
+	*rng_ptr = (M_NMI2MTR / 256.0) * rho;
+                   /* In metres */
+	*azm_ptr = (M_TWO_PI / 65536.0) * theta;
+                   /* In radians */
+}
+
+/*----------------------------------------------------------------------------*/
+/* item_cartesian  -- Calculated position in Cartesian co-ordinates           */
+/*                    (I062/100)                                              */
+/*----------------------------------------------------------------------------*/
+
+ inline void item_cartesian (const t_Byte *buffer, t_Real *x_ptr, t_Real *y_ptr)
+{
+                   /* 2 times 3 octets; 0.5 metres */
+	*x_ptr = 0.5 * item_si24 (buffer);
+	*y_ptr = 0.5 * item_si24 (buffer + 3);
+}
+
+/*----------------------------------------------------------------------------*/
+/* item_velocity   -- Calculated velocity in Cartesian co-ordinates           */
+/*                    (I062/185)                                              */
+/*----------------------------------------------------------------------------*/
+
+ inline void item_velocity (const t_Byte *buffer, t_Real *vx_ptr, t_Real *vy_ptr)
+{
+	t_Si16 vx;     /* x velocity component; 0.25 metres/second */
+	t_Si16 vy;     /* y velocity component; 0.25 metres/second */
+
+	vx = (t_Si16) ((buffer[0] << 8) | buffer[1]);
+	vy = (t_Si16) ((buffer[2] << 8) | buffer[3]);
+
+	*vx_ptr = 0.25 * vx;
+	*vy_ptr = 0.25 * vy;
+}
+
+/*----------------------------------------------------------------------------*/
+/* item_wgs84      -- WGS-84 position in degrees (I021/130, I021/131,         */
+/*                    I062/105)                                               */
+/*----------------------------------------------------------------------------*/
+
+ inline void item_wgs84 (const t_Byte *buffer, int octets, t_Real lsb,
+                         t_Real *lat_ptr, t_Real *lon_ptr)
+{
+                   /* Latitude and longitude of 3 or 4 octets each;
+                      lsb in degrees: */
+	if (octets == 3)
+	{
+		*lat_ptr = lsb * item_si24 (buffer);
+		*lon_ptr = lsb * item_si24 (buffer + 3);
+	}
+	else
+	{
+		*lat_ptr = lsb * item_si32 (buffer);
+		*lon_ptr = lsb * item_si32 (buffer + 4);
+	}
+}
+
+/*----------------------------------------------------------------------------*/
+/* item_ground_vector -- Airborne ground vector (I021/160, edition 1.0P and   */
+/*                    later)                                                  */
+/*----------------------------------------------------------------------------*/
+
+ inline void item_ground_vector (const t_Byte *buffer,
+                                 t_Real *gsp_ptr, t_Real *hdg_ptr)
+{
+	t_Si16 spd;    /* Ground speed; 2**-14 nautical miles/second */
+	t_Ui16 ta;     /* Track angle; 360/2**16 degrees */
+
+	spd = (t_Si16) (((buffer[0] & 0x7f) << 8) | buffer[1]);
+                   /* Without the range exceeded indicator */
+	ta = (t_Ui16) ((buffer[2] << 8) | buffer[3]);
+
+	*gsp_ptr = (M_NMI2MTR / 16384.0) * spd;
+                   /* In metres/second */
+	*hdg_ptr = (M_TWO_PI / 65536.0) * ta;
+                   /* In radians */
+}
+
+/*----------------------------------------------------------------------------*/
+/* item_idt        -- Expand ICAO 6-bits aircraft identification              */
+/*----------------------------------------------------------------------------*/
+
+ inline t_Bool item_idt (const t_Byte *buffer, char *txt)
+{
+	const t_Ui64 ones = 0x0101010101010101ULL;
+                   /* Constant 1 in every octet */
+	const t_Ui64 high = 0x8080808080808080ULL;
+                   /* Highest bit of every octet */
+#if !defined (__GNUC__) || __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+	int ix;        /* Auxiliary */
+#endif
+	t_Ui64 m;      /* Mask of octets with invalid characters */
+	t_Ui64 ok;     /* Valid characters (highest bit of octet set) */
+	t_Ui64 v;      /* One 6-bits character per octet */
+	t_Ui64 w;      /* The 48 bits */
+
+                   /* Get the 48 bits (first character in the highest
+                      six bits): */
+	w = ((t_Ui64) buffer[0] << 40) | ((t_Ui64) buffer[1] << 32) |
+        ((t_Ui64) buffer[2] << 24) | ((t_Ui64) buffer[3] << 16) |
+        ((t_Ui64) buffer[4] << 8) | (t_Ui64) buffer[5];
+
+                   /* Spread the characters to one per octet: */
+#if defined (__BMI2__)
+	v = _pdep_u64 (w, 0x3f3f3f3f3f3f3f3fULL);
+#else
+	v = ((w & 0xffffff000000ULL) << 8) | (w & 0xffffffULL);
+                   /* 24 bits in each half */
+	v = ((v & 0x00fff00000fff000ULL) << 4) | (v & 0x00000fff00000fffULL);
+                   /* 12 bits in each quarter */
+	v = ((v & 0x0fc00fc00fc00fc0ULL) << 2) | (v & 0x003f003f003f003fULL);
+                   /* 6 bits in each octet */
+#endif /* __BMI2__ */
+
+                   /* Check all characters at once; every octet is
+                      less than 64, so no carries between octets: */
+	ok = ((v + (0x80 - 1) * ones) & ~(v + (0x7f - 26) * ones)) |
+                   /* 'A' to 'Z' (1 to 26) */
+         ((v + (0x80 - 32) * ones) & ~(v + (0x7f - 32) * ones)) |
+                   /* Space (32) */
+         ((v + (0x80 - 48) * ones) & ~(v + (0x7f - 57) * ones));
+                   /* '0' to '9' (48 to 57) */
+	ok &= high;
+
+                   /* Map to ASCII - add 64 where bit 5 is clear: */
+	v += (~v & 0x2020202020202020ULL) << 1;
+
+                   /* Replace invalid characters by '?', as
+                      expand_c() does: */
+	m = ((ok ^ high) >> 7) * 0xff;
+	v = (v & ~m) | ('?' * ones & m);
+
+                   /* Store text (first character in the highest
+                      octet): */
+#if defined (__GNUC__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	v = __builtin_bswap64 (v);
+	memcpy (txt, &v, 8);
+#else
+	for (ix = 0; ix < 8; ix ++)
+	{
+		txt[ix] = (char) ((v >> (56 - 8 * ix)) & 0xff);
+	}
+#endif /* __GNUC__ */
+	txt[8] = '\0';
+
+	return (ok == high);
+}
+
+#endif /* INCLUDED_ASTX_ITEMS_H */
+/* end-of-file */
@@ -0,0 +1,547 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*----------------------------------------------------------------------------*/
+/* Project:        Surveillance Data Decoder and Lister                       */
+/* File:           bds.cpp                                                    */
+/* Contents:       Decoding of mode S BDS registers                           */
+/* Author(s):      agent                                                      */
+/* Last change:    2026-10-18                                                 */
+/*----------------------------------------------------------------------------*/
+
+#include "basics.h"
+                   /* Basic system definitions */
+#include "common.h"
+                   /* Common declarations and definitions */
+
+#include <stddef.h>
+#include <string.h>
+
+                   /* Local macros: */
+                   /* ------------- */
+
+#define M_BDS_FIELD(w,first,count) \
+	((t_Ui32) (((w) >> (56 - (first) - (count) + 1)) & ((1ULL << (count)) - 1)))
+                   /* Extract a field of a 56 bits register; first
+                      is the (ICAO) bit number of the first bit of
+                      the field, counted from 1 (most significant) */
+
+#define M_BDS_SIGNED(u,count) \
+	(((u) & (1UL << ((count) - 1))) ? \
+	 (t_Si32) (u) - (t_Si32) (1UL << (count)) : (t_Si32) (u))
+                   /* Convert a field (including its sign bit) to
+                      a signed value */
+
+                   /* Plausibility limits: */
+#define M_MAX_ALTITUDE_RATE 6000
+                   /* Max. vertical rate; feet/minute */
+#define M_MAX_GS_TAS_DIFFERENCE 200.0
+                   /* Max. difference between ground speed and
+                      true airspeed; knots */
+#define M_MAX_IAS 500
+                   /* Max. indicated airspeed; knots */
+#define M_MAX_MACH 1.0
+                   /* Max. mach number */
+#define M_MAX_ROLL_ANGLE 50.0
+                   /* Max. roll angle; degrees */
+#define M_MAX_SPEED 600
+                   /* Max. ground speed or true airspeed; knots */
+
+                   /* Local functions: */
+                   /* ---------------- */
+
+static t_Bool decode_bds_40 (t_Ui64 w, t_BDS_40 *ptr);
+                   /* Decode BDS 4,0 register */
+static t_Bool decode_bds_50 (t_Ui64 w, t_BDS_50 *ptr);
+                   /* Decode BDS 5,0 register */
+static t_Bool decode_bds_60 (t_Ui64 w, t_BDS_60 *ptr);
+                   /* Decode BDS 6,0 register */
+static void decode_register (t_BDS_Register *reg_ptr);
+                   /* Decode BDS register (if not yet done) */
+
+/*----------------------------------------------------------------------------*/
+/* bds_40          -- Return decoded BDS 4,0 register                         */
+/*----------------------------------------------------------------------------*/
+
+ const t_BDS_40 * bds_40 (t_BDS_Register *reg_ptr)
+{
+	const t_BDS_40 *ptr;
+
+                   /* Check parameters: */
+	Assert (reg_ptr != NULL, "Invalid parameter");
+
+                   /* Preset the return value: */
+	ptr = NULL;
+
+	if (reg_ptr->present && reg_ptr->number == 0x40)
+	{
+		decode_register (reg_ptr);
+
+		if (reg_ptr->decoding == e_bds_decoded)
+		{
+			ptr = &(reg_ptr->decoded.bds_40);
+		}
+	}
+
+	return ptr;
+}
+
+/*----------------------------------------------------------------------------*/
+/* bds_50          -- Return decoded BDS 5,0 register                         */
+/*----------------------------------------------------------------------------*/
+
+ const t_BDS_50 * bds_50 (t_BDS_Register *reg_ptr)
+{
+	const t_BDS_50 *ptr;
+
+                   /* Check parameters: */
+	Assert (reg_ptr != NULL, "Invalid parameter");
+
+                   /* Preset the return value: */
+	ptr = NULL;
+
+	if (reg_ptr->present && reg_ptr->number == 0x50)
+	{
+		decode_register (reg_ptr);
+
+		if (reg_ptr->decoding == e_bds_decoded)
+		{
+			ptr = &(reg_ptr->decoded.bds_50);
+		}
+	}
+
+	return ptr;
+}
+
+/*----------------------------------------------------------------------------*/
+/* bds_60          -- Return decoded BDS 6,0 register                         */
+/*----------------------------------------------------------------------------*/
+
+ const t_BDS_60 * bds_60 (t_BDS_Register *reg_ptr)
+{
+	const t_BDS_60 *ptr;
+
+                   /* Check parameters: */
+	Assert (reg_ptr != NULL, "Invalid parameter");
+
+                   /* Preset the return value: */
+	ptr = NULL;
+
+	if (reg_ptr->present && reg_ptr->number == 0x60)
+	{
+		decode_register (reg_ptr);
+
+		if (reg_ptr->decoding == e_bds_decoded)
+		{
+			ptr = &(reg_ptr->decoded.bds_60);
+		}
+	}
+
+	return ptr;
+}
+
+/*----------------------------------------------------------------------------*/
+/* bds_decode_all  -- Decode all BDS registers of a table                     */
+/*----------------------------------------------------------------------------*/
+
+ void bds_decode_all (t_BDS_Register *tbl_ptr, t_Ui16 count)
+{
+	t_Ui16 ix;     /* Auxiliary */
+
+                   /* Check parameters: */
+	Assert (tbl_ptr != NULL, "Invalid parameter");
+
+	for (ix = 0; ix < count; ix ++)
+	{
+		if (tbl_ptr[ix].present)
+		{
+			decode_register (&(tbl_ptr[ix]));
+		}
+	}
+
+	return;
+}
+
+/*----------------------------------------------------------------------------*/
+/* bds_find        -- Find BDS register in a table                            */
+/*----------------------------------------------------------------------------*/
+
+ t_BDS_Register * bds_find (t_BDS_Register *tbl_ptr, t_Byte number)
+{
+	t_Ui16 ix;     /* Auxiliary */
+	t_BDS_Register *ptr;
+
+                   /* Check parameters: */
+	Assert (tbl_ptr != NULL, "Invalid parameter");
+
+                   /* Preset the return value: */
+	ptr = NULL;
+
+                   /* The table is filled from its beginning: */
+	for (ix = 0; ix < M_MAX_BDS_REGISTERS; ix ++)
+	{
+		if (!tbl_ptr[ix].present)
+		{
+			break;
+		}
+
+		if (tbl_ptr[ix].number == number)
+		{
+			ptr = &(tbl_ptr[ix]);
+			break;
+		}
+	}
+
+	return ptr;
+}
+
+/*----------------------------------------------------------------------------*/
+/* decode_bds_40   -- Decode BDS 4,0 register                                 */
+/*----------------------------------------------------------------------------*/
+
+ static
+ t_Bool decode_bds_40 (t_Ui64 w, t_BDS_40 *ptr)
+{
+	t_Ui32 bps;    /* Barometric pressure setting; 0.1 mb above 800 mb */
+	t_Ui32 fsa;    /* FMS selected altitude; 16 feet */
+	t_Ui32 msa;    /* MCP/FCU selected altitude; 16 feet */
+	t_Bool ok;     /* Register is plausible */
+
+                   /* Preset the return value: */
+	ok = FALSE;
+
+	msa = M_BDS_FIELD (w, 2, 12);
+	fsa = M_BDS_FIELD (w, 15, 12);
+	bps = M_BDS_FIELD (w, 28, 12);
+
+                   /* Reserved bits must be zero: */
+	if (M_BDS_FIELD (w, 40, 8) != 0 || M_BDS_FIELD (w, 52, 2) != 0)
+	{
+		goto done;
+	}
+
+                   /* No status bit set - nothing to tell: */
+	if (M_BDS_FIELD (w, 1, 1) == 0 && M_BDS_FIELD (w, 14, 1) == 0 &&
+        M_BDS_FIELD (w, 27, 1) == 0 && M_BDS_FIELD (w, 48, 1) == 0 &&
+        M_BDS_FIELD (w, 54, 1) == 0)
+	{
+		goto done;
+	}
+
+                   /* If a status bit is not set, the associated
+                      field must be zero: */
+	if ((M_BDS_FIELD (w, 1, 1) == 0 && msa != 0) ||
+        (M_BDS_FIELD (w, 14, 1) == 0 && fsa != 0) ||
+        (M_BDS_FIELD (w, 27, 1) == 0 && bps != 0) ||
+        (M_BDS_FIELD (w, 48, 1) == 0 && M_BDS_FIELD (w, 49, 3) != 0) ||
+        (M_BDS_FIELD (w, 54, 1) == 0 && M_BDS_FIELD (w, 55, 2) != 0))
+	{
+		goto done;
+	}
+
+                   /* Store the fields: */
+	memset (ptr, 0, sizeof (t_BDS_40));
+	if (M_BDS_FIELD (w, 1, 1))
+	{
+		ptr->mcp_fcu_selected_altitude = (t_Si32) (16 * msa);
+		ptr->mcp_fcu_selected_altitude_present = TRUE;
+	}
+	if (M_BDS_FIELD (w, 14, 1))
+	{
+		ptr->fms_selected_altitude = (t_Si32) (16 * fsa);
+		ptr->fms_selected_altitude_present = TRUE;
+	}
+	if (M_BDS_FIELD (w, 27, 1))
+	{
+		ptr->barometric_pressure_setting = 800.0 + 0.1 * bps;
+		ptr->barometric_pressure_setting_present = TRUE;
+	}
+	if (M_BDS_FIELD (w, 48, 1))
+	{
+		ptr->mode_bits = (t_Byte) M_BDS_FIELD (w, 49, 3);
+		ptr->mode_bits_present = TRUE;
+	}
+	if (M_BDS_FIELD (w, 54, 1))
+	{
+		ptr->target_altitude_source = (t_Byte) M_BDS_FIELD (w, 55, 2);
+		ptr->target_altitude_source_present = TRUE;
+	}
+
+	ok = TRUE;
+
+	done:
+	return ok;
+}
+
+/*----------------------------------------------------------------------------*/
+/* decode_bds_50   -- Decode BDS 5,0 register                                 */
+/*----------------------------------------------------------------------------*/
+
+ static
+ t_Bool decode_bds_50 (t_Ui64 w, t_BDS_50 *ptr)
+{
+	t_Ui32 gs;     /* Ground speed; 2 knots */
+	t_Bool ok;     /* Register is plausible */
+	t_Ui32 rll;    /* Roll angle (with sign); 45/256 degrees */
+	t_Ui32 tar;    /* Track angle rate (with sign); 8/256 degrees/second */
+	t_Ui32 tas;    /* True airspeed; 2 knots */
+	t_Ui32 tta;    /* True track angle (with sign); 90/512 degrees */
+
+                   /* Preset the return value: */
+	ok = FALSE;
+
+	rll = M_BDS_FIELD (w, 2, 10);
+	tta = M_BDS_FIELD (w, 13, 11);
+	gs = M_BDS_FIELD (w, 25, 10);
+	tar = M_BDS_FIELD (w, 36, 10);
+	tas = M_BDS_FIELD (w, 47, 10);
+
+                   /* No status bit set - nothing to tell: */
+	if (M_BDS_FIELD (w, 1, 1) == 0 && M_BDS_FIELD (w, 12, 1) == 0 &&
+        M_BDS_FIELD (w, 24, 1) == 0 && M_BDS_FIELD (w, 35, 1) == 0 &&
+        M_BDS_FIELD (w, 46, 1) == 0)
+	{
+		goto done;
+	}
+
+                   /* If a status bit is not set, the associated
+                      field must be zero: */
+	if ((M_BDS_FIELD (w, 1, 1) == 0 && rll != 0) ||
+        (M_BDS_FIELD (w, 12, 1) == 0 && tta != 0) ||
+        (M_BDS_FIELD (w, 24, 1) == 0 && gs != 0) ||
+        (M_BDS_FIELD (w, 35, 1) == 0 && tar != 0) ||
+        (M_BDS_FIELD (w, 46, 1) == 0 && tas != 0))
+	{
+		goto done;
+	}
+
+                   /* Store the fields: */
+	memset (ptr, 0, sizeof (t_BDS_50));
+	if (M_BDS_FIELD (w, 1, 1))
+	{
+		ptr->roll_angle = (45.0 / 256.0) * M_BDS_SIGNED (rll, 10);
+		ptr->roll_angle_present = TRUE;
+	}
+	if (M_BDS_FIELD (w, 12, 1))
+	{
+		ptr->true_track_angle = (90.0 / 512.0) * M_BDS_SIGNED (tta, 11);
+		if (ptr->true_track_angle < 0.0)
+		{
+			ptr->true_track_angle += 360.0;
+		}
+		ptr->true_track_angle_present = TRUE;
+	}
+	if (M_BDS_FIELD (w, 24, 1))
+	{
+		ptr->ground_speed = 2 * gs;
+		ptr->ground_speed_present = TRUE;
+	}
+	if (M_BDS_FIELD (w, 35, 1))
+	{
+		ptr->track_angle_rate = (8.0 / 256.0) * M_BDS_SIGNED (tar, 10);
+		ptr->track_angle_rate_present = TRUE;
+	}
+	if (M_BDS_FIELD (w, 46, 1))
+	{
+		ptr->true_airspeed = 2 * tas;
+		ptr->true_airspeed_present = TRUE;
+	}
+
+                   /* Check value ranges: */
+	if (ptr->roll_angle_present &&
+        (ptr->roll_angle < -M_MAX_ROLL_ANGLE ||
+         ptr->roll_angle > M_MAX_ROLL_ANGLE))
+	{
+		goto done;
+	}
+	if (ptr->ground_speed_present && ptr->ground_speed > M_MAX_SPEED)
+	{
+		goto done;
+	}
+	if (ptr->true_airspeed_present && ptr->true_airspeed > M_MAX_SPEED)
+	{
+		goto done;
+	}
+	if (ptr->ground_speed_present && ptr->true_airspeed_present)
+	{
+		t_Real diff;
+
+		diff = (t_Real) ptr->ground_speed - (t_Real) ptr->true_airspeed;
+		if (diff < -M_MAX_GS_TAS_DIFFERENCE || diff > M_MAX_GS_TAS_DIFFERENCE)
+		{
+			goto done;
+		}
+	}
+
+	ok = TRUE;
+
+	done:
+	return ok;
+}
+
+/*----------------------------------------------------------------------------*/
+/* decode_bds_60   -- Decode BDS 6,0 register                                 */
+/*----------------------------------------------------------------------------*/
+
+ static
+ t_Bool decode_bds_60 (t_Ui64 w, t_BDS_60 *ptr)
+{
+	t_Ui32 bar;    /* Barometric altitude rate (with sign);
+                      32 feet/minute */
+	t_Ui32 hdg;    /* Magnetic heading (with sign); 90/512 degrees */
+	t_Ui32 ias;    /* Indicated airspeed; knots */
+	t_Ui32 ivv;    /* Inertial vertical velocity (with sign);
+                      32 feet/minute */
+	t_Ui32 mach;   /* Mach number; 2.048/512 */
+	t_Bool ok;     /* Register is plausible */
+
+                   /* Preset the return value: */
+	ok = FALSE;
+
+	hdg = M_BDS_FIELD (w, 2, 11);
+	ias = M_BDS_FIELD (w, 14, 10);
+	mach = M_BDS_FIELD (w, 25, 10);
+	bar = M_BDS_FIELD (w, 36, 10);
+	ivv = M_BDS_FIELD (w, 47, 10);
+
+                   /* No status bit set - nothing to tell: */
+	if (M_BDS_FIELD (w, 1, 1) == 0 && M_BDS_FIELD (w, 13, 1) == 0 &&
+        M_BDS_FIELD (w, 24, 1) == 0 && M_BDS_FIELD (w, 35, 1) == 0 &&
+        M_BDS_FIELD (w, 46, 1) == 0)
+	{
+		goto done;
+	}
+
+                   /* If a status bit is not set, the associated
+                      field must be zero: */
+	if ((M_BDS_FIELD (w, 1, 1) == 0 && hdg != 0) ||
+        (M_BDS_FIELD (w, 13, 1) == 0 && ias != 0) ||
+        (M_BDS_FIELD (w, 24, 1) == 0 && mach != 0) ||
+        (M_BDS_FIELD (w, 35, 1) == 0 && bar != 0) ||
+        (M_BDS_FIELD (w, 46, 1) == 0 && ivv != 0))
+	{
+		goto done;
+	}
+
+                   /* Store the fields: */
+	memset (ptr, 0, sizeof (t_BDS_60));
+	if (M_BDS_FIELD (w, 1, 1))
+	{
+		ptr->magnetic_heading = (90.0 / 512.0) * M_BDS_SIGNED (hdg, 11);
+		if (ptr->magnetic_heading < 0.0)
+		{
+			ptr->magnetic_heading += 360.0;
+		}
+		ptr->magnetic_heading_present = TRUE;
+	}
+	if (M_BDS_FIELD (w, 13, 1))
+	{
+		ptr->indicated_airspeed = ias;
+		ptr->indicated_airspeed_present = TRUE;
+	}
+	if (M_BDS_FIELD (w, 24, 1))
+	{
+		ptr->mach_number = (2.048 / 512.0) * mach;
+		ptr->mach_number_present = TRUE;
+	}
+	if (M_BDS_FIELD (w, 35, 1))
+	{
+		ptr->barometric_altitude_rate = 32 * M_BDS_SIGNED (bar, 10);
+		ptr->barometric_altitude_rate_present = TRUE;
+	}
+	if (M_BDS_FIELD (w, 46, 1))
+	{
+		ptr->inertial_vertical_velocity = 32 * M_BDS_SIGNED (ivv, 10);
+		ptr->inertial_vertical_velocity_present = TRUE;
+	}
+
+                   /* Check value ranges: */
+	if (ptr->indicated_airspeed_present &&
+        ptr->indicated_airspeed > M_MAX_IAS)
+	{
+		goto done;
+	}
+	if (ptr->mach_number_present && ptr->mach_number > M_MAX_MACH)
+	{
+		goto done;
+	}
+	if (ptr->barometric_altitude_rate_present &&
+        (ptr->barometric_altitude_rate < -M_MAX_ALTITUDE_RATE ||
+         ptr->barometric_altitude_rate > M_MAX_ALTITUDE_RATE))
+	{
+		goto done;
+	}
+	if (ptr->inertial_vertical_velocity_present &&
+        (ptr->inertial_vertical_velocity < -M_MAX_ALTITUDE_RATE ||
+         ptr->inertial_vertical_velocity > M_MAX_ALTITUDE_RATE))
+	{
+		goto done;
+	}
+
+	ok = TRUE;
+
+	done:
+	return ok;
+}
+
+/*----------------------------------------------------------------------------*/
+/* decode_register -- Decode BDS register (if not yet done)                   */
+/*----------------------------------------------------------------------------*/
+
+ static
+ void decode_register (t_BDS_Register *reg_ptr)
+{
+	int ix;        /* Auxiliary */
+	t_Bool ok;     /* Register is plausible */
+	t_Ui64 w;      /* Value of the register */
+
+                   /* Decoded before ? */
+	if (reg_ptr->decoding != e_bds_undecoded)
+	{
+		goto done;
+	}
+
+                   /* Get the 56 bits: */
+	w = 0;
+	for (ix = 0; ix < M_BDS_REGISTER_LENGTH; ix ++)
+	{
+		w = (w << 8) | reg_ptr->value[ix];
+	}
+
+                   /* Decode as indicated by the BDS code: */
+	switch (reg_ptr->number)
+	{
+	case 0x40:
+		ok = decode_bds_40 (w, &(reg_ptr->decoded.bds_40));
+		break;
+	case 0x50:
+		ok = decode_bds_50 (w, &(reg_ptr->decoded.bds_50));
+		break;
+	case 0x60:
+		ok = decode_bds_60 (w, &(reg_ptr->decoded.bds_60));
+		break;
+	default:
+		reg_ptr->decoding = e_bds_unsupported;
+		goto done;
+	}
+
+	reg_ptr->decoding = (ok ? e_bds_decoded : e_bds_implausible);
+
+	done:
+	return;
+}
+/* end-of-file */
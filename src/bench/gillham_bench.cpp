@@ -0,0 +1,173 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "global.h"
+#include "basics.h"
+
+#include "common.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+/*
+ * mc_to_alt(), ungarble() and gillham_to_alt() of libsddl, which look
+ * their results up in tables, against the bit loops they replaced: the
+ * results for every input, then the time per call.
+ *
+ *     sddl_gillham_bench [iterations]
+ *
+ * The loops are compiled with the same flags as libsddl, so both sides
+ * are measured alike whatever the build type.
+ */
+
+namespace
+{
+
+const int rounds = 5;
+
+// the bit loop versions, as in utils.cpp before the tables
+const t_Si16 gg_table[8] = { 0, 7, 3, 4, 1, 6, 2, 5 };
+const t_Si16 gz_table[8] = { 7, 0, 4, 3, 6, 1, 5, 2 };
+const t_Si16 pg_table[8] = { M_UTL_NVA, 4, 2, 3, 0, M_UTL_NVA, 1, M_UTL_NVA };
+const t_Si16 pz_table[8] = { M_UTL_NVA, 0, 2, 1, 4, M_UTL_NVA, 3, M_UTL_NVA };
+
+t_Si16 loopMcToAlt (t_Ui16 mc)
+{
+    if (mc & 0xf000)
+        return M_UTL_NVA;
+    if (mc & 0x0001)
+        return M_UTL_NVA;
+
+    t_Ui16 a = (mc & 0x0e00) >> 9;
+    t_Ui16 b = (mc & 0x01c0) >> 6;
+    t_Ui16 c = (mc & 0x0038) >> 3;
+    t_Ui16 d = mc & 0x0007;
+
+    t_Si16 x = gg_table[d];
+    t_Si16 y = (x & 0x0001) ? gz_table[a] : gg_table[a];
+    t_Si16 z = (y & 0x0001) ? gz_table[b] : gg_table[b];
+    t_Si16 v = (z & 0x0001) ? pz_table[c] : pg_table[c];
+
+    if (v == M_UTL_NVA)
+        return M_UTL_NVA;
+
+    return x * 320 + y * 40 + z * 5 + v - 12;
+}
+
+t_Ui16 loopUngarble (t_Ui16 bits)
+{
+    t_Ui16 c1 = (bits >> 12) & 0x0001;
+    t_Ui16 a1 = (bits >> 11) & 0x0001;
+    t_Ui16 c2 = (bits >> 10) & 0x0001;
+    t_Ui16 a2 = (bits >>  9) & 0x0001;
+    t_Ui16 c4 = (bits >>  8) & 0x0001;
+    t_Ui16 a4 = (bits >>  7) & 0x0001;
+    t_Ui16 b1 = (bits >>  5) & 0x0001;
+    t_Ui16 d1 = (bits >>  4) & 0x0001;
+    t_Ui16 b2 = (bits >>  3) & 0x0001;
+    t_Ui16 d2 = (bits >>  2) & 0x0001;
+    t_Ui16 b4 = (bits >>  1) & 0x0001;
+    t_Ui16 d4 = bits & 0x0001;
+
+    return (a4 << 11) | (a2 << 10) | (a1 << 9) |
+           (b4 << 8) | (b2 << 7) | (b1 << 6) |
+           (c4 << 5) | (c2 << 4) | (c1 << 3) |
+           (d4 << 2) | (d2 << 1) | d1;
+}
+
+// pulses without the X pulse, as in I001/100 and I048/100
+t_Si16 loopGillhamToAlt (t_Ui16 pulses)
+{
+    return loopMcToAlt (loopUngarble (((pulses & 0x0fc0) << 1) | (pulses & 0x003f)));
+}
+
+// called through a pointer, so neither side is inlined into the loop
+template <typename T>
+double nsPerCall (T (*function) (t_Ui16), t_Ui16 inputs, long iterations, long& sum)
+{
+    double best = 0.0;
+
+    for (int round = 0; round < rounds; round ++)
+    {
+        T (* volatile call) (t_Ui16) = function;
+
+        auto start = std::chrono::steady_clock::now ();
+        for (long ix = 0; ix < iterations; ix ++)
+            for (t_Ui16 input = 0; input < inputs; input ++)
+                sum += call (input);
+        auto stop = std::chrono::steady_clock::now ();
+
+        double ns = std::chrono::duration<double, std::nano> (stop - start).count ();
+        if (round == 0 || ns < best)
+            best = ns;
+    }
+
+    return best / (static_cast<double> (iterations) * inputs);
+}
+
+template <typename T>
+bool run (const char* name, T (*table) (t_Ui16), T (*loop) (t_Ui16),
+          t_Ui16 inputs, long iterations)
+{
+    int differences = 0;
+    long sum = 0;
+
+    for (t_Ui16 input = 0; input < inputs; input ++)
+    {
+        if (table (input) == loop (input))
+            continue;
+
+        if (differences ++ < 10)
+            printf ("%s (%04o): %d, bit loop %d\n", name, input, table (input), loop (input));
+    }
+
+    double table_ns = nsPerCall (table, inputs, iterations, sum);
+    double loop_ns = nsPerCall (loop, inputs, iterations, sum);
+
+    printf ("%-15s %5u inputs %5d differences  table %5.2f ns  bit loop %5.2f ns  (%.1fx; checksum %ld)\n",
+            name, inputs, differences, table_ns, loop_ns, loop_ns / table_ns, sum);
+
+    return differences == 0;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    long iterations = argc > 1 ? atol (argv[1]) : 2000;
+
+    if (iterations <= 0)
+    {
+        fprintf (stderr, "Usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    bool ok = true;
+
+    ok = run<t_Si16> ("mc_to_alt", mc_to_alt, loopMcToAlt, 010000, iterations) && ok;
+    ok = run<t_Ui16> ("ungarble", ungarble, loopUngarble, 020000, iterations) && ok;
+    ok = run<t_Si16> ("gillham_to_alt", gillham_to_alt, loopGillhamToAlt, 010000, iterations) && ok;
+
+    if (!ok)
+    {
+        fprintf (stderr, "Tables differ from the bit loops\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -53,9 +53,12 @@
 		text_ptr = "Unspecified reason";
 	}
 
-	printf ("E> Assertion violated:\n");
-	printf ("   In file '%s' near line %d: %s.\n",
-			file_name, line_number, text_ptr);
+	if (!hook_error (input_offset, text_ptr))
+	{
+		printf ("E> Assertion violated:\n");
+		printf ("   In file '%s' near line %d: %s.\n",
+				file_name, line_number, text_ptr);
+	}
 
 	longjmp (on_fatal_error, 10001);
 }
@@ -97,10 +97,19 @@
                    /* Max. number of radar sectors */
 #define M_MAX_NUMBER_OF_SENSORS 256
                    /* Max. number of sensors */
+#define M_MAX_NUMBER_OF_SINKS 16
+                   /* Max. number of sinks of decoded reports */
 #define M_MAX_NUMBER_OF_WEC 20
                    /* Max. number of warning/error conditions */
+#define M_MAX_PATH_LENGTH 1024
+                   /* Max. length of a path name */
 #define M_MAX_RFF_FRAME_LENGTH 2048
                    /* Max. length of RFF frame data */
+#define M_MAX_SENSOR_NAME_LENGTH 20
+                   /* Max. length of a sensor name */
+
+#define M_ALL_REPORTS 0xffffffff
+                   /* Sink consuming all report types */
 
                    /* Special ASTERIX data items: */
 #define M_REF_INDICATOR 997
@@ -260,6 +269,15 @@
 #define Assert(a,b)
 #endif
 
+#include "common_data_types.h"
+                   /* Common data types */
+
+                   /* Used by the JSON conversion of the reports in
+                      common_structs.h, so declared before it: */
+struct t_BDS_Register;
+extern void bds_decode_all (struct t_BDS_Register *tbl_ptr, t_Ui16 count);
+                   /* Decode all BDS registers of a table */
+
 #include "common_structs.h"
 
 				   /* Global variables: */
@@ -355,6 +373,10 @@ extern t_Ui16 last_sacsic;
                    /* Last radar SAC/SIC */
 extern t_Bool last_sacsic_available;
                    /* Last radar SAC/SIC available flag */
+extern t_Ui16 last_service_sacsic;
+                   /* SAC/SIC of last radar service message */
+extern t_Bool last_service_sacsic_available;
+                   /* SAC/SIC of last radar service message available */
 extern t_Ui32 last_tod;
                    /* Last time of day; 1/128 seconds */
 extern t_Bool last_tod_available;
@@ -419,6 +441,8 @@ extern t_Bool list_sensor_name;
                    /* List sensor name */
 extern t_Bool list_sensor_number;
                    /* List sensor number */
+extern t_Bool list_sensor_registry;
+                   /* List sensor registry (at end of listing) */
 extern t_Bool list_service_id;
                    /* List service identification (for system tracks) */
 extern t_Bool list_ssta_info;
@@ -431,8 +455,6 @@ extern t_Bool list_time_of_day;
                    /* List time of day */
 extern t_Bool list_wgs84;
                    /* List WGS-84 position */
-extern t_Listed_Sensor listed_sensors[M_MAX_NUMBER_OF_SENSORS];
-                   /* Listed sensors */
 #if USE_JSON
 #include <map>
 #include <string>
@@ -445,35 +467,86 @@ typedef enum
     JSON_TEST,
     JSON_PRINT,
     JSON_TEXT,
+    JSON_NDJSON,
     JSON_CBOR,
     JSON_MESSAGE_PACK,
     JSON_UBJSON,
     JSON_ZIP_TEXT,
+    JSON_ZIP_NDJSON,
     JSON_ZIP_CBOR,
     JSON_ZIP_MESSAGE_PACK,
     JSON_ZIP_UBJSON
 } JSON_OUTPUT_TYPE;
 
+typedef enum
+{
+    JSON_STREAM_BLOCK = 0,
+    JSON_STREAM_DROP
+} JSON_STREAM_POLICY;
+
 extern JSON_OUTPUT_TYPE json_output_type;
 extern std::map<std::string, JSON_OUTPUT_TYPE> json_output_type_map;
 extern std::string json_path;
 extern bool write_json_nulls;
+extern std::string json_fields_path;
+extern JSON_STREAM_POLICY json_stream_policy;
+extern size_t json_stream_buffer_size;
+extern size_t json_batch_min_size;
+extern size_t json_batch_max_size;
+extern unsigned int json_batch_max_latency;
+extern bool json_gzip;
+extern size_t json_zip_entry_records;
+extern unsigned int json_zip_entry_minutes;
 
 extern JSONWriter* json_writer;
 #endif
 
+#include <string>
+
+class ArrowWriter;
+
+extern std::string arrow_path;
+                   /* Path name of Arrow files to be written */
+extern ArrowWriter* arrow_writer;
+                   /* Arrow writer, if Arrow files are written */
+
+class ParquetWriter;
+
+extern std::string parquet_path;
+                   /* Path name of Parquet files to be written */
+extern unsigned int parquet_row_group_minutes;
+                   /* Minutes of frame time per Parquet row group (0=unlimited) */
+extern ParquetWriter* parquet_writer;
+                   /* Parquet writer, if Parquet files are written */
+
+class SqliteWriter;
+
+extern std::string sqlite_path;
+                   /* Path name of SQLite database to be written */
+extern SqliteWriter* sqlite_writer;
+                   /* SQLite writer, if a SQLite database is written */
+
+extern std::string store_path;
+                   /* Path name of record store to be written */
+
 extern t_Mlat mlat;
                    /* Buffer for multilateration report information */
 extern t_Ui16 number_of_sensor_descriptions;
                    /* Number of sensor descriptions */
 extern t_Ui16 records_in_current_frame;
                    /* Number of records in current frame */
+extern t_Ui32 rotate_count;
+                   /* Rotate output files after this many frames or records */
+extern t_Bool rotate_gzip;
+                   /* Compress rotated output files */
+extern t_Ui32 rotate_minutes;
+                   /* Rotate output files every this many minutes (frame time) */
+extern t_Ui64 rotate_size;
+                   /* Rotate output files at this size; bytes */
 extern t_Rsrv rsrv;
                    /* Buffer for radar service information */
 extern t_Rtgt rtgt;
                    /* Buffer for radar target information */
-extern t_Sensor_Ident sacsic_list[M_MAX_NUMBER_OF_SENSORS];
-                   /* List of sensor identities */
 extern t_Byte service_identification;
                    /* Service identification (for ARTAS output) */
 extern t_Bool service_identification_defined;
@@ -519,6 +592,10 @@ extern int track_number_bits;
                    /* Number of bits in a track number */
 extern t_Bool use_mmcc;
                    /* Use minimum mode C condition in ZSF processing */
+extern t_Ui16 wanted_sacsic;
+                   /* Wanted SAC/SIC (record store input) */
+extern t_Bool wanted_sacsic_defined;
+                   /* Wanted SAC/SIC defined */
 extern t_Secs wanted_start_time;
                    /* Wanted start time; seconds */
 extern t_Bool wanted_start_time_defined;
@@ -600,17 +677,43 @@ extern t_Real azimuth (t_Real xpos, t_Real ypos);
 extern void bad_frame (const char *text_ptr,
                        t_Ui32 offset, t_Ui16 length, t_Byte *buffer);
                    /* Dump bad frame */
+extern const t_BDS_40 * bds_40 (t_BDS_Register *reg_ptr);
+                   /* Return decoded BDS 4,0 register */
+extern const t_BDS_50 * bds_50 (t_BDS_Register *reg_ptr);
+                   /* Return decoded BDS 5,0 register */
+extern const t_BDS_60 * bds_60 (t_BDS_Register *reg_ptr);
+                   /* Return decoded BDS 6,0 register */
+extern t_BDS_Register * bds_find (t_BDS_Register *tbl_ptr, t_Byte number);
+                   /* Find BDS register in a table */
+#if LISTER
+extern void check_list_rotation (void);
+                   /* Rotate the list file, if due */
+#endif /* LISTER */
 extern t_Bool check_date (int year, int month, int day);
                    /* Check date */
+#if LISTER
+extern void close_list_file (void);
+                   /* Close the list file */
+#endif /* LISTER */
+extern void close_store_file (void);
+                   /* Write the remaining segments and close the record store */
 #if CHKASS
 extern void chk_assertion (t_Bool condition, const char *text_ptr,
                            const char *file_name, int line_number);
                    /* Check some assertion */
 #endif /* CHKASS */
+extern void clear_sensor_registry (t_Pntr rgy_ptr);
+                   /* Clear a sensor registry */
+extern void clear_tod_table (t_Pntr tbl_ptr);
+                   /* Clear a table of time of day states */
 extern t_Time cnv_wtm_to_tod (t_Wall_Time wtm);
                    /* Convert wall time to time-of-day */
 extern char * cnv_wtm_to_txt (t_Wall_Time wtm);
                    /* Convert wall time to text */
+extern t_Pntr create_sensor_registry (void);
+                   /* Create an (empty) sensor registry */
+extern t_Pntr create_tod_table (void);
+                   /* Create an (empty) table of time of day states */
 extern t_Retc data_item (t_Byte category, t_Ui16 field_reference_number,
                          t_Data_Item_Desc *desc_ptr,
                          t_Ui16 length, t_Byte *buffer, t_Ui16 *pos_ptr);
@@ -619,6 +722,15 @@ extern t_Ui16 days_per_month (t_Ui16 year, t_Ui16 month);
                    /* Give number of days per month */
 extern t_Ui16 days_per_year (t_Ui16 year);
                    /* Give number of days per year */
+extern void deliver_report (t_Object_Type object, t_Pntr pntr);
+                   /* Deliver a decoded report to all sinks consuming it */
+extern t_Retc define_sensor (t_Ui16 dsi, t_Bool rsap_defined, t_Ui16 rsap,
+                             const char *name);
+                   /* Define a sensor (number, alias and name) */
+extern void delete_sensor_registry (t_Pntr rgy_ptr);
+                   /* Delete a sensor registry */
+extern void delete_tod_table (t_Pntr tbl_ptr);
+                   /* Delete a table of time of day states */
 extern t_Real distance (t_Real x, t_Real y);
                    /* Compute Euclidean distance */
 extern t_Real distance (t_Real x, t_Real y, t_Real z);
@@ -632,6 +744,10 @@ extern t_Real dtm_diff (t_Date_Time dt1, t_Date_Time dt2);
                    /* Compute difference in date and time */
 extern t_Bool earlier (t_Date_Time dt1, t_Date_Time dt2);
                    /* Is date+time dt1 earlier than date+time dt2 */
+extern void end_data_block (t_Ui32 offset, t_Byte category);
+                   /* Deliver the reports of a data block to batch sinks */
+extern void end_frame (t_Ui32 offset);
+                   /* Deliver the reports of a frame to batch sinks */
 extern void error_msg (const char *format, ...);
                    /* Error message */
 extern t_Retc eval_latitude (const char *text_ptr, t_Real *value_ptr);
@@ -640,12 +756,23 @@ extern t_Retc eval_longitude (const char *text_ptr, t_Real *value_ptr);
                    /* Evaluate a geographical longitude value */
 extern char expand_c (t_Byte c);
                    /* Expand 6-bits character */
-extern t_Retc fillup_tod (t_Ui16 partial_tod, t_Ui32 *tod_ptr);
+extern t_Bool expand_idt (const t_Byte *buffer, char *txt);
+                   /* Expand ICAO 6-bits aircraft identification */
+extern t_Retc fillup_tod (t_Bool dsi_present, t_Ui16 dsi,
+                          t_Ui16 partial_tod, t_Ui32 *tod_ptr);
                    /* Fill up truncated time of day */
-extern t_Retc find_sensor (t_Ui16 dsi, t_Ui16 *sno_ptr);
+extern t_Retc find_sensor (t_Ui16 dsi, t_Ui16 *sno_ptr, t_Bool *new_ptr);
                    /* Find sensor (number) by data source identifier */
+extern void finish_file (FILE *file, const char *path, t_Bool compress);
+                   /* Close and compress a finished file in background */
+extern t_Sensor * get_sensor (t_Ui16 dsi);
+                   /* Get sensor record for data source identifier */
+extern t_Si16 gillham_to_alt (t_Ui16 pulses);
+                   /* Convert SSR mode C pulses to altitude */
 extern t_Byte hi_byte (t_Ui16 u16);
                    /* Extract high byte */
+extern t_Bool hook_error (t_Ui32 offset, const char *msg);
+                   /* Hand an error message to the error hook, if any */
 extern void init_options (void);
                    /* Initiate program call options */
 extern t_Retc init_radars (void);
@@ -707,6 +834,8 @@ extern void list_rtgt (t_Rtgt *rtgt_ptr);
                    /* List radar target report */
 extern void list_rtgt (t_Rtgt *rtgt_ptr, t_Ui16 length, char *buffer);
                    /* List radar target report */
+extern void list_sensors (void);
+                   /* List sensor registry */
 extern void list_sno (t_Object_Type object, t_Pntr pntr,
                       t_Ui16 length, char *buffer);
                    /* List sensor number */
@@ -759,6 +888,8 @@ extern void nl_terminate (void);
                    /* Terminate network load monitor */
 extern t_Retc normalize (t_Date *date_ptr);
                    /* Normalize date */
+extern t_Retc open_store_file (void);
+                   /* Create the record store */
 extern int ord (t_Bool bval);
                    /* Return ordinal for Boolean value */
 extern t_Retc process_adsb (t_Adsb *adsb_ptr);
@@ -779,14 +910,48 @@ extern void process_term (void);
                    /* Terminate message processing */
 extern t_Retc rec_frame (void);
                    /* Read and process REC frame */
+extern t_Sensor * registered_sensor (t_Ui16 ix);
+                   /* Get sensor record by index (in order of registration) */
+extern t_Retc register_batch_sink (const char *name, t_Ui32 objects,
+                                   t_Batch_Unit unit, t_Sink_Batch batch,
+                                   t_Pntr context);
+                   /* Register a sink of batches of decoded reports */
+extern t_Retc register_sink (const char *name, t_Ui32 objects,
+                             t_Sink_Report report, t_Pntr context);
+                   /* Register a sink of decoded reports */
+extern void remember_tod (t_Bool dsi_present, t_Ui16 dsi, t_Ui32 tod);
+                   /* Remember full time of day of a source */
 extern t_Retc rff_frame (void);
                    /* Read and process RFF frame */
 extern t_Retc rff_header (void);
                    /* Read and process RFF file header */
+extern t_Bool rotation_check (t_Rotation *rot_ptr, size_t bytes,
+                              t_Bool date_present, t_Date date,
+                              t_Bool time_present, t_Secs time);
+                   /* Check whether a file is to be rotated before an item */
+extern void rotation_count (t_Rotation *rot_ptr,
+                            t_Bool date_present, t_Date date,
+                            t_Bool time_present, t_Secs time);
+                   /* Count an item written into a rotated file */
+extern t_Bool rotation_defined (void);
+                   /* Check whether output files are rotated */
+extern void rotation_name (t_Rotation *rot_ptr, const char *path,
+                           char *name, size_t size);
+                   /* Build path name of a finished file */
 extern int rounds (t_Real f);
                    /* Rounds to the nearest integer */
 extern t_Bool same_day (t_Date dt1, t_Date dt2);
                    /* Decide whether from same day */
+extern t_Pntr select_sensor_registry (t_Pntr rgy_ptr);
+                   /* Select the sensor registry in use; NULL is the
+                      registry of the program */
+extern t_Retc select_sink_reports (char *text);
+                   /* Select report types for a sink */
+extern t_Pntr select_tod_table (t_Pntr tbl_ptr);
+                   /* Select the table of time of day states in use;
+                      NULL is the table of the program */
+extern void set_error_hook (t_Error_Hook hook, t_Pntr context);
+                   /* Set function taking error messages */
 extern t_Retc set_vsn010 (char *vsn_text);
                    /* Set ASTERIX category 010 reference version */
 extern t_Retc set_vsn011 (char *vsn_text);
@@ -801,20 +966,36 @@ extern t_Retc set_vsn048 (char *vsn_text);
                    /* Set ASTERIX category 048 reference version */
 extern t_Retc set_vsn065 (char *vsn_text);
                    /* Set ASTERIX category 065 reference version */
+extern t_Bool sink_registered (t_Pntr context);
+                   /* Check whether sinks with this context are registered */
+extern void start_sinks (void);
+                   /* Check the registered sinks before the first report */
 extern t_Bool stat_fits (t_Statistical_Item *item_ptr, t_Real value);
                    /* Check if value fits the statistical item */
 extern void stat_init (t_Statistical_Item *item_ptr);
                    /* Initiate a statistical item */
 extern void stat_updt (t_Statistical_Item *item_ptr, t_Real value);
                    /* Update a statistical item */
+extern t_Retc store_input (void);
+                   /* Read and process a record store */
+extern void store_report (t_Object_Type object, t_Pntr pntr);
+                   /* Append a decoded report to the record store */
 #if LISTER
 extern void term_lister (void);
                    /* Terminate the lister */
 #endif /* LISTER */
+extern void term_rotation (void);
+                   /* Wait for finished files to be closed and compressed */
+extern void term_sinks (void);
+                   /* Unregister all sinks */
 extern t_Secs time_diff (t_Secs tm_1, t_Secs tm_2);
                    /* Compute difference in time */
 extern t_Ui16 ungarble (t_Ui16 bits);
                    /* Ungarble an SSR mode 2 or 3/A code */
+extern t_Retc unregister_sink (t_Pntr context);
+                   /* Unregister the sinks with this context */
+extern void update_sensor (t_Object_Type object, t_Pntr pntr);
+                   /* Update sensor registry from a decoded report */
 extern char * utc_secs (t_Secs utc_time);
                    /* Return text for UTC time in seconds */
 extern char * utc_text (t_Secs utc_time);
@@ -57,6 +57,8 @@ typedef unsigned short int t_Ui16;
                    /* Unsigned 16 bit integer */
 typedef unsigned long int t_Ui32;
                    /* Unsigned 32 bit integer */
+typedef unsigned long long int t_Ui64;
+                   /* Unsigned 64 bit integer */
 #elif WORDSIZE == 64
 typedef signed char t_Si08;
                    /* Signed 8 bit integer */
@@ -68,6 +70,8 @@ typedef unsigned short int t_Ui16;
                    /* Unsigned 16 bit integer */
 typedef unsigned int t_Ui32;
                    /* Unsigned 32 bit integer */
+typedef unsigned long long int t_Ui64;
+                   /* Unsigned 64 bit integer */
 #else
 #error "Unexpected WORDSIZE"
 #endif
@@ -94,6 +98,19 @@ typedef t_Retc (*t_P_Fp) (t_Ui16, t_Byte *);
 typedef t_Retc (*t_R_Fp) (t_Ui16, t_Byte *, t_Ui16 *);
 /* Pointer to ASTERIX data item reading function */
 
+/* Decoding state of a BDS register: */
+typedef enum
+{
+    e_bds_undecoded = 0,
+    /* Not (yet) decoded */
+    e_bds_decoded,
+    /* Decoded and plausible */
+    e_bds_implausible,
+    /* Decoded, but failed the plausibility check */
+    e_bds_unsupported
+    /* No decoder for this BDS register */
+} t_BDS_State;
+
 /* Radar service message types: */
 typedef enum
 {
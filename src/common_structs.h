@@ -32,6 +32,22 @@
 using namespace std;
 
 extern bool write_json_nulls;
+
+/* Whether member name of j is to be written at all, before its value is
+   converted; a JSONStreamNode may not want all members (see
+   jsonstreamwriter.h), a nlohmann::json does: */
+template <typename J>
+inline bool json_wanted (J& j, const char* name)
+{
+    return true;
+}
+
+/* JSON keys of the BDS registers of a report (by index): */
+static const char* const json_bds_keys[] =
+    { "bds0", "bds1", "bds2", "bds3", "bds4", "bds5",
+      "bds6", "bds7", "bds8", "bds9", "bds10", "bds11" };
+static_assert (sizeof (json_bds_keys) / sizeof (json_bds_keys[0]) == M_MAX_BDS_REGISTERS,
+               "JSON keys of the BDS registers");
 #endif
 
 /* Geodetical point: */
@@ -68,8 +84,12 @@ typedef struct
     /* Comm-B message data of BDS register 3,0 */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -88,8 +108,12 @@ typedef struct
     /* Aircraft address */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -109,15 +133,22 @@ typedef struct
     /* Aircraft identification */
     t_Byte value_sti;
     /* Source of target identification */
+    t_Bool value_invalid;
+    /* Aircraft identification with invalid characters (shown as '?') */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["sti_present"] = sti_present;
             j[name]["value_idt"] = value_idt;
             j[name]["value_sti"] = value_sti;
+            j[name]["value_invalid"] = value_invalid;
         }
         else if (write_json_nulls)
             j[name] = nullptr;
@@ -147,8 +178,12 @@ typedef struct
     /* Target state report capability */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["value_arv"] = value_arv;
@@ -179,8 +214,12 @@ typedef struct
     /* IAS or Mach */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["value"] = value;
@@ -220,8 +259,12 @@ typedef struct
 */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["value"] = value;
@@ -267,8 +310,12 @@ typedef struct
     /* Antenna azimuth; radians */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -288,8 +335,12 @@ typedef struct
     /* 0 means: undefined or unknown */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -308,8 +359,12 @@ typedef struct
     /* Antenna rotation speed; radians/second */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -328,8 +383,12 @@ typedef struct
     /* Assumed height; metres */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -348,8 +407,12 @@ typedef struct
     /* Azimuth difference; radians */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -370,8 +433,12 @@ typedef struct
     /* Barometric vertical rate; metres/second */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             convertToJSON(range_exceeded, "range_exceeded", j[name]);
@@ -393,8 +460,147 @@ typedef struct
     /* Batch number */
 } t_Batch_Number;
 
-/* BDS register: */
+/* Decoded BDS 4,0 register (selected vertical intention): */
+typedef struct
+{
+    t_Real barometric_pressure_setting;
+    /* Barometric pressure setting; mb */
+    t_Bool barometric_pressure_setting_present;
+    /* Barometric pressure setting present */
+    t_Si32 fms_selected_altitude;
+    /* FMS selected altitude; feet */
+    t_Bool fms_selected_altitude_present;
+    /* FMS selected altitude present */
+    t_Si32 mcp_fcu_selected_altitude;
+    /* MCP/FCU selected altitude; feet */
+    t_Bool mcp_fcu_selected_altitude_present;
+    /* MCP/FCU selected altitude present */
+    t_Byte mode_bits;
+    /* MCP/FCU mode bits (VNAV, ALT HOLD, APPROACH) */
+    t_Bool mode_bits_present;
+    /* MCP/FCU mode bits present */
+    t_Byte target_altitude_source;
+    /* Target altitude source */
+    t_Bool target_altitude_source_present;
+    /* Target altitude source present */
+
+#if USE_JSON
+    template <typename J>
+    void toJSON (J& j, const char* name)
+    {
+        if (!json_wanted (j, name))
+            return;
+
+        if (mcp_fcu_selected_altitude_present)
+            j[name]["mcp_fcu_selected_altitude_ft"] = mcp_fcu_selected_altitude;
+        if (fms_selected_altitude_present)
+            j[name]["fms_selected_altitude_ft"] = fms_selected_altitude;
+        if (barometric_pressure_setting_present)
+            j[name]["barometric_pressure_setting_mb"] = barometric_pressure_setting;
+        if (mode_bits_present)
+        {
+            j[name]["vnav_mode"] = (mode_bits & 0x04) != 0;
+            j[name]["alt_hold_mode"] = (mode_bits & 0x02) != 0;
+            j[name]["approach_mode"] = (mode_bits & 0x01) != 0;
+        }
+        if (target_altitude_source_present)
+            j[name]["target_altitude_source"] = target_altitude_source;
+    }
+#endif
+} t_BDS_40;
+
+/* Decoded BDS 5,0 register (track and turn report): */
 typedef struct
+{
+    t_Ui16 ground_speed;
+    /* Ground speed; knots */
+    t_Bool ground_speed_present;
+    /* Ground speed present */
+    t_Real roll_angle;
+    /* Roll angle; degrees */
+    t_Bool roll_angle_present;
+    /* Roll angle present */
+    t_Real track_angle_rate;
+    /* Track angle rate; degrees/second */
+    t_Bool track_angle_rate_present;
+    /* Track angle rate present */
+    t_Ui16 true_airspeed;
+    /* True airspeed; knots */
+    t_Bool true_airspeed_present;
+    /* True airspeed present */
+    t_Real true_track_angle;
+    /* True track angle; degrees */
+    t_Bool true_track_angle_present;
+    /* True track angle present */
+
+#if USE_JSON
+    template <typename J>
+    void toJSON (J& j, const char* name)
+    {
+        if (!json_wanted (j, name))
+            return;
+
+        if (roll_angle_present)
+            j[name]["roll_angle_deg"] = roll_angle;
+        if (true_track_angle_present)
+            j[name]["true_track_angle_deg"] = true_track_angle;
+        if (ground_speed_present)
+            j[name]["ground_speed_kt"] = ground_speed;
+        if (track_angle_rate_present)
+            j[name]["track_angle_rate_deg_s"] = track_angle_rate;
+        if (true_airspeed_present)
+            j[name]["true_airspeed_kt"] = true_airspeed;
+    }
+#endif
+} t_BDS_50;
+
+/* Decoded BDS 6,0 register (heading and speed report): */
+typedef struct
+{
+    t_Si32 barometric_altitude_rate;
+    /* Barometric altitude rate; feet/minute */
+    t_Bool barometric_altitude_rate_present;
+    /* Barometric altitude rate present */
+    t_Ui16 indicated_airspeed;
+    /* Indicated airspeed; knots */
+    t_Bool indicated_airspeed_present;
+    /* Indicated airspeed present */
+    t_Si32 inertial_vertical_velocity;
+    /* Inertial vertical velocity; feet/minute */
+    t_Bool inertial_vertical_velocity_present;
+    /* Inertial vertical velocity present */
+    t_Real mach_number;
+    /* Mach number */
+    t_Bool mach_number_present;
+    /* Mach number present */
+    t_Real magnetic_heading;
+    /* Magnetic heading; degrees */
+    t_Bool magnetic_heading_present;
+    /* Magnetic heading present */
+
+#if USE_JSON
+    template <typename J>
+    void toJSON (J& j, const char* name)
+    {
+        if (!json_wanted (j, name))
+            return;
+
+        if (magnetic_heading_present)
+            j[name]["magnetic_heading_deg"] = magnetic_heading;
+        if (indicated_airspeed_present)
+            j[name]["indicated_airspeed_kt"] = indicated_airspeed;
+        if (mach_number_present)
+            j[name]["mach_number"] = mach_number;
+        if (barometric_altitude_rate_present)
+            j[name]["barometric_altitude_rate_ft_min"] = barometric_altitude_rate;
+        if (inertial_vertical_velocity_present)
+            j[name]["inertial_vertical_velocity_ft_min"] = inertial_vertical_velocity;
+    }
+#endif
+} t_BDS_60;
+
+/* BDS register: */
+typedef struct t_BDS_Register
 {
     t_Byte number;
     /* Number of BDS register */
@@ -403,9 +609,25 @@ typedef struct
     t_Byte value[M_BDS_REGISTER_LENGTH];
     /* Value of BDS register */
 
+    t_BDS_State decoding;
+    /* Decoding state; the register is decoded on first
+       access (see bds.cpp) */
+    union
+    {
+        t_BDS_40 bds_40;
+        t_BDS_50 bds_50;
+        t_BDS_60 bds_60;
+    } decoded;
+    /* Decoded register (as indicated by number), valid
+       if decoding is e_bds_decoded */
+
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             char buffer [2*M_BDS_REGISTER_LENGTH+1];
@@ -415,6 +637,18 @@ typedef struct
 
             j[name]["number"] = number;
             j[name]["value"] = buffer;
+
+            if (decoding == e_bds_decoded)
+            {
+                if (number == 0x40)
+                    decoded.bds_40.toJSON(j[name], "decoded");
+                else if (number == 0x50)
+                    decoded.bds_50.toJSON(j[name], "decoded");
+                else if (number == 0x60)
+                    decoded.bds_60.toJSON(j[name], "decoded");
+            }
+            else if (decoding == e_bds_implausible)
+                j[name]["implausible"] = true;
         }
         else if (write_json_nulls)
             j[name] = nullptr;
@@ -443,8 +677,12 @@ typedef struct
     /* Slant range error; metres */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["value_azm_rad"] = value_azm;
@@ -473,8 +711,12 @@ typedef struct
 */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["value"] = value_com;
@@ -518,8 +760,12 @@ typedef struct
     /* Computed y component; metres/second**2 */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["value_ax_ms2"] = value_ax;
@@ -557,8 +803,12 @@ typedef struct
     /* Computed altitude; metres */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["source"] = source;
@@ -623,8 +873,12 @@ typedef struct
     /* Computed y coordinate; metres */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["value_x"] = value_x;
@@ -650,8 +904,12 @@ typedef struct
     /* Standard deviation of y component; metres */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["value_x_m"] = value_x;
@@ -676,8 +934,12 @@ typedef struct
     /* Computed y component; metres/second */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["value_vx_ms"] = value_vx;
@@ -699,8 +961,12 @@ typedef struct
     /* Confidence level */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name] = value;
@@ -852,8 +1118,12 @@ typedef struct
     /* Age of DAP "Velocity Uncertainty" present */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             // t_Bool acs_present;
@@ -1236,8 +1506,12 @@ typedef struct
     /* Data source system identification code */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["supplemented"] = supplemented;
@@ -1266,7 +1540,7 @@ typedef struct
 } t_Data_Source_Position;
 
 /* Date: */
-typedef struct
+typedef struct t_Date
 {
     int year;
     int month;
@@ -1321,8 +1595,12 @@ typedef struct
     /* (Internal or external) test target */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             convertToJSON(from_fixed_field_transponder, "from_fixed_field_transponder", j[name]);
@@ -1358,8 +1636,12 @@ typedef struct
     /* DOP along y axis */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["value_x"] = value_x;
@@ -1383,8 +1665,12 @@ typedef struct
     /* Doppler speed; metres/second */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             convertToJSON(is_doubtful, "is_doubtful", j[name]);
@@ -1432,8 +1718,12 @@ typedef struct
  */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["value"] = value;
@@ -1549,8 +1839,12 @@ typedef struct
     /* Figure of merit */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -1587,8 +1881,12 @@ typedef struct
     /* Manage vertical mode */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["value_m"] = value;
@@ -1615,8 +1913,12 @@ typedef struct
     /* Flight level; feet */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["value_m"] = value;
@@ -1660,8 +1962,12 @@ typedef struct
 */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["value_aic"] = value_aic;
@@ -1712,8 +2018,12 @@ typedef struct
     /* Frame date */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["year"] = value.year;
@@ -1735,8 +2045,12 @@ typedef struct
     /* Frame time (of day); seconds */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -1754,8 +2068,12 @@ typedef struct
     /* Geometric altitude; metres */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -1775,8 +2093,12 @@ typedef struct
     /* Geometric vertical rate; metres/second */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             convertToJSON(range_exceeded, "range_exceeded", j[name]);
@@ -1801,8 +2123,12 @@ typedef struct
     /* Heading; radians */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             convertToJSON(range_exceeded, "range_exceeded", j[name]);
@@ -1828,8 +2154,12 @@ typedef struct
     /* Height from 3D radar; feet */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             convertToJSON(valid, "valid", j[name]);
@@ -1851,8 +2181,12 @@ typedef struct
     /* Indicated airspeed; metres/second */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -1874,6 +2208,8 @@ typedef enum
     /* RFF input */
     e_input_format_sequence_of_records,
     /* Sequence of records */
+    e_input_format_store,
+    /* Record store (of decoded reports) */
     e_input_format_sentinel
     /* Sentinel - DO NOT REMOVE */
     /* MUST BE THE LAST ELEMENT */
@@ -1898,8 +2234,12 @@ typedef struct
 */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["value_m"] = value;
@@ -1941,8 +2281,12 @@ typedef struct
     /* Link technology indicator */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -1951,31 +2295,6 @@ typedef struct
 #endif
 } t_Link_Technology;
 
-/* Listed sensor: */
-typedef struct
-{
-    t_Bool asterix_categories[256];
-    /* ASTERIX categories */
-    t_Data_Format data_format;
-    /* Data format */
-    t_Ui16 data_source_identifier;
-    /* Data source identifier (SAC/SIC) */
-    t_Bool defined;
-    /* Listed sensor defined */
-    t_Ui16 line_number;
-    /* Line number (in IOSS frame) */
-    t_Bool line_number_defined;
-    /* Line number defined */
-    char *name;
-    /* Sensor name */
-    t_Bool name_defined;
-    /* Sensor name defined */
-    t_Ui16 sensor_number;
-    /* Sensor number (in some context) */
-    t_Bool sensor_number_defined;
-    /* Sensor number defined */
-} t_Listed_Sensor;
-
 /* Load counter: */
 typedef struct
 {
@@ -2019,8 +2338,12 @@ typedef struct
     /* Version not supported */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["value_ltt"] = value_ltt;
@@ -2042,8 +2365,12 @@ typedef struct
     /* Air speed as multiple of Mach speed */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -2061,8 +2388,12 @@ typedef struct
     /* Magnetic heading; radians */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -2084,8 +2415,12 @@ typedef struct
     /* Mapped position component; metres */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["value_h"] = value_h;
@@ -2107,8 +2442,12 @@ typedef struct
     /* Measured amplitude; dBm */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -2126,8 +2465,12 @@ typedef struct
     /* Measured azimuth; radians */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -2145,8 +2488,12 @@ typedef struct
     /* Measured height; metres */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -2212,8 +2559,12 @@ typedef struct
     /* Report type: test target report */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             // t_Bool h3d_present;
@@ -2354,8 +2705,12 @@ typedef struct
     /* Measured range; metres */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -2373,8 +2728,12 @@ typedef struct
     /* Message amplitude; dBm */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -2415,8 +2774,12 @@ typedef struct
     /* Wind speed; metres/second */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             if (present_tmp)
@@ -2456,8 +2819,12 @@ typedef struct
     /* Metric height; metres */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             convertToJSON(is_relative, "is_relative", j[name]);
@@ -2484,8 +2851,12 @@ typedef struct
     3 ... no reply */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             convertToJSON(invalid, "invalid", j[name]);
@@ -2531,12 +2902,20 @@ typedef struct
     /* Garbled SSR mode C code */
     t_Tres code_invalid;
     /* Invalid SSR mode C code */
+    t_Si16 height;
+    /* SSR mode C height decoded from the code; 100 feet */
+    t_Bool height_present;
+    /* Decoded SSR mode C height present */
     t_Bool present;
     /* SSR mode C code present */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["code"] = code;
@@ -2548,6 +2927,11 @@ typedef struct
 
             convertToJSON(code_garbled, "code_garbled", j[name]);
             convertToJSON(code_invalid, "code_invalid", j[name]);
+
+            if (height_present)
+                j[name]["height_ft"] = 100 * height;
+            else if (write_json_nulls)
+                j[name]["height_ft"] = nullptr;
         }
         else if (write_json_nulls)
             j[name] = nullptr;
@@ -2575,8 +2959,12 @@ typedef struct
     /* SSR mode C height; feet */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             convertToJSON(garbled, "garbled", j[name]);
@@ -2611,8 +2999,12 @@ typedef struct
     /* SSR mode C information present */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["code"] = code;
@@ -2648,8 +3040,12 @@ typedef struct
     /* Number of SSR mode 1, 2, or 3/A replies */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["code"] = code;
@@ -2724,8 +3120,12 @@ typedef struct
     /* SI */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["value_aic"] = value_aic;
@@ -2765,12 +3165,13 @@ typedef struct
     t_BDS_Register value[M_MAX_BDS_REGISTERS];
     /* Values of downloaded BDS registers */
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
         if (present)
         {
             for (int cnt=0; cnt < count; ++cnt)
-                value[cnt].toJSON(j, "bds"+std::to_string(cnt));
+                value[cnt].toJSON(j, json_bds_keys[cnt]);
         }
         else if (write_json_nulls)
             j[name] = nullptr;
@@ -2799,8 +3200,12 @@ typedef struct
     /* Partial time of day; 1/128 seconds */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -2829,8 +3234,12 @@ typedef struct
     /* Split pair */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (defined)
         {
             j[name]["parent_of_shadow"] = parent_of_shadow;
@@ -2904,8 +3313,12 @@ typedef struct
     /* SIL */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             if (nacp_present)
@@ -2990,8 +3403,12 @@ typedef struct
     /* MCP/FCU: VNAV mode */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["source"] = source;
@@ -3061,8 +3478,12 @@ typedef struct
     /* Radial speed; metres/second */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -3080,8 +3501,12 @@ typedef struct
     /* Range difference; metres */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -3103,8 +3528,12 @@ typedef struct
     /* Raw Doppler speed; metres/second */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["ambiguity_range_ms"] = ambiguity_range;
@@ -3126,8 +3555,12 @@ typedef struct
     /* Received power; dBm */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -3145,8 +3578,12 @@ typedef struct
     /* Replies count */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -3167,8 +3604,12 @@ typedef struct
     /* Encoded values are NOT standardized */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["length"] = length;
@@ -3209,8 +3650,12 @@ typedef struct
     /* Last report for track */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["attitude"] = attitude;
@@ -3261,8 +3706,12 @@ typedef struct
     /* Roll angle; radians */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -3271,6 +3720,27 @@ typedef struct
 #endif
 } t_Roll_Angle;
 
+/* Rotation state of an output file: */
+typedef struct
+{
+    t_Ui32 count;
+    /* Frames or records written into the current file */
+    t_Date date;
+    /* Frame date of the current file */
+    t_Bool date_present;
+    /* Frame date of the current file present */
+    t_Secs first_time;
+    /* First frame time in the current file; seconds */
+    t_Secs last_time;
+    /* Last frame time in the current file; seconds */
+    t_Ui32 sequence;
+    /* Sequence number of the last finished file */
+    long slice;
+    /* Frame time slice of the current file */
+    t_Bool times_present;
+    /* Frame times of the current file present */
+} t_Rotation;
+
 /* Runlength: */
 typedef struct
 {
@@ -3282,8 +3752,12 @@ typedef struct
     /* Runlength; ACPs */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["value_deg"] = value;
@@ -3326,8 +3800,12 @@ typedef struct
     /* 0 = (radar) north crossing */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -3352,8 +3830,12 @@ typedef struct
    3 = FMS selected altitude */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["value_ft"] = value;
@@ -3385,18 +3867,42 @@ typedef struct
 #endif
 } t_Strk_Selected_Altitude;
 
-/* Sensor identity: */
+/* Sensor (entry in the sensor registry): */
 typedef struct
 {
-    t_Bool orig_defined;
-    /* Original SAC/SIC defined */
-    t_Bool rsap_defined;
-    /* RSAP, i. e. RMCDE SAC/SIC, defined */
-    t_Ui16 orig;
-    /* Original SAC/SIC */
+    t_Ui32 adsb_count;
+    /* Number of ADS-B reports */
+    t_Bool announced;
+    /* Sensor already announced in the listing */
+    t_Bool asterix_categories[256];
+    /* ASTERIX categories */
+    t_Ui16 data_source_identifier;
+    /* Data source identifier (SAC/SIC) */
+    t_Ui16 line_number;
+    /* Line number (in IOSS frame) */
+    t_Bool line_number_defined;
+    /* Line number defined */
+    t_Ui32 mlat_count;
+    /* Number of multilateration reports */
+    char name[M_MAX_SENSOR_NAME_LENGTH + 1];
+    /* Sensor name */
+    t_Bool name_defined;
+    /* Sensor name defined */
+    t_Data_Source_Position position;
+    /* Sensor position (from radar service messages) */
+    t_Ui32 rsrv_count;
+    /* Number of radar service messages */
     t_Ui16 rsap;
     /* RSAP, i. e. RMCDE SAC/SIC */
-} t_Sensor_Ident;
+    t_Bool rsap_defined;
+    /* RSAP, i. e. RMCDE SAC/SIC, defined */
+    t_Ui32 rtgt_count;
+    /* Number of radar target reports */
+    t_Ui16 sensor_number;
+    /* Sensor number (as defined by the user) */
+    t_Bool sensor_number_defined;
+    /* Sensor number defined */
+} t_Sensor;
 
 /* Sensor number: */
 typedef struct
@@ -3408,8 +3914,12 @@ typedef struct
     /* Must be from range 1 ... MAX_NUMBER_OF_SENSORS */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -3427,8 +3937,12 @@ typedef struct
     /* Service identification */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -3446,8 +3960,12 @@ typedef struct
     /* Report period; seconds */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value_rp;
         else if (write_json_nulls)
@@ -3506,8 +4024,12 @@ typedef struct
     /* Step number */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -3531,8 +4053,12 @@ typedef struct
     /* SSR mode information present */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["code"] = code;
@@ -3589,8 +4115,12 @@ typedef struct
     /* X pulse presence information present */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             // t_Bool em1_present;
@@ -3700,8 +4230,12 @@ typedef struct
     /* SSR mode 5 code */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -3738,8 +4272,12 @@ typedef struct
 */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             switch (value_longitudinal) {
@@ -3824,8 +4362,12 @@ typedef struct
     /* Width present */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             // t_Bool length_present;
@@ -3918,8 +4460,12 @@ typedef struct
     /* Age of last VDL Mode 4 ADS-B report present */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             // t_Bool ads_present;
@@ -4037,8 +4583,12 @@ typedef struct
     /* Calculated vertical rate; metres/second */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -4058,8 +4608,12 @@ typedef struct
     /* WGS-84 longitude; radians */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["value_latitude_rad"] = value_latitude;
@@ -4080,8 +4634,12 @@ typedef struct
     /* Target address enumeration type */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             convertToJSON(value, name, j);
         else if (write_json_nulls)
@@ -4101,8 +4659,12 @@ typedef struct
     /* Surveillance status */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["value_ps"] = value_ps;
@@ -4124,8 +4686,12 @@ typedef struct
     /* Difference between receiving and detection time */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -4143,8 +4709,12 @@ typedef struct
     /* Time of day; seconds */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -4175,8 +4745,12 @@ typedef struct
     /* Track angle rate; radians/second */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -4194,8 +4768,12 @@ typedef struct
     /* Track number */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -4215,8 +4793,12 @@ typedef struct
     /* True airspeed; metres/second */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             convertToJSON(range_exceeded, "range_exceeded", j[name]);
@@ -4246,8 +4828,12 @@ typedef struct
     /* Vehicle fleet identification */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -4265,8 +4851,12 @@ typedef struct
     /* Velocity accuracy */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -4286,8 +4876,12 @@ typedef struct
     /* List of warning/error conditions present */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             for (unsigned int cnt=0; cnt < count; ++cnt)
@@ -4308,8 +4902,12 @@ typedef struct
     /* WGS-84 altitude; metres */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -4327,8 +4925,12 @@ typedef struct
     /* Accuracy of WGS-84 altitude; metres */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
             j[name] = value;
         else if (write_json_nulls)
@@ -4350,8 +4952,12 @@ typedef struct
     /* WGS-84 longitude; radians */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j, const string& name)
+    template <typename J>
+    void toJSON (J& j, const char* name)
     {
+        if (!json_wanted (j, name))
+            return;
+
         if (present)
         {
             j[name]["high_precision"] = high_precision;
@@ -4381,24 +4987,8 @@ typedef struct
 /* =================================================== */
 
 /* ADS-B report: */
-#if USE_JSON
-
-struct JSONConvertible
-{
-    JSONConvertible() = default;
-    virtual ~JSONConvertible() = default;
-
-    //virtual void toJSON (nlohmann::json& j)=0;
-};
-
-struct t_Adsb : public JSONConvertible
-{
-    t_Adsb() = default;
-    virtual ~t_Adsb() = default;
-#else
 struct t_Adsb
 {
-#endif
     t_ACAS_Resolution_Advisory_Report acas_resolution_advisory_report;
     /* ACAS resolution advisory report */
     t_Aircraft_Operational_Status aircraft_operational_status;
@@ -4525,7 +5115,8 @@ struct t_Adsb
     /* WGS-84 position */
 
 #if USE_JSON
-    virtual void toJSON (nlohmann::json& j)
+    template <typename J>
+    void toJSON (J& j)
     {
         j["message_type"] = "ads-b target";
         j["version"] = "1.0";
@@ -4555,9 +5146,10 @@ struct t_Adsb
         /* Barometric vertical rate */
 
         // t_BDS_Register bds_registers[M_MAX_BDS_REGISTERS];
+        bds_decode_all (bds_registers, M_MAX_BDS_REGISTERS);
         for (unsigned int cnt=0; cnt < M_MAX_BDS_REGISTERS; cnt++)
             if (bds_registers[cnt].present)
-                bds_registers[cnt].toJSON(j, "bds"+std::to_string(cnt));
+                bds_registers[cnt].toJSON(j, json_bds_keys[cnt]);
         /* BDS registers */
 
 //        t_Tres compact_position_reporting;
@@ -4780,15 +5372,8 @@ struct t_Adsb
 };
 
 /* Multilateration report: */
-#if USE_JSON
-struct t_Mlat : public JSONConvertible
-{
-    t_Mlat() = default;
-    virtual ~t_Mlat() = default;
-#else
 struct t_Mlat
 {
-#endif
     t_ACAS_Resolution_Advisory_Report acas_resolution_advisory_report;
     /* ACAS resolution advisory report */
     t_Byte asterix_category;
@@ -4899,7 +5484,8 @@ struct t_Mlat
     /* WGS-84 position */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j)
+    template <typename J>
+    void toJSON (J& j)
     {
         j["message_type"] = "mlat target";
         j["version"] = "1.0";
@@ -4913,9 +5499,10 @@ struct t_Mlat
         /* ASTERIX category */
 
         // t_BDS_Register bds_registers[M_MAX_BDS_REGISTERS];
+        bds_decode_all (bds_registers, M_MAX_BDS_REGISTERS);
         for (unsigned int cnt=0; cnt < M_MAX_BDS_REGISTERS; cnt++)
             if (bds_registers[cnt].present)
-                bds_registers[cnt].toJSON(j, "bds"+std::to_string(cnt));
+                bds_registers[cnt].toJSON(j, json_bds_keys[cnt]);
         /* BDS registers */
 
         // t_Communications_Capability communications_capability;
@@ -5146,16 +5733,52 @@ typedef enum
     /* Must be the last entry - do not remove */
 } t_Object_Type;
 
-/* Radar service message: */
-#if USE_JSON
-struct t_Rsrv : public JSONConvertible
+/* Sink of decoded reports, called with the report and its context: */
+typedef void (*t_Sink_Report) (t_Object_Type object, t_Pntr pntr, t_Pntr context);
+
+/* Function taking error messages, with the input offset: */
+typedef void (*t_Error_Hook) (t_Ui32 offset, const char *msg, t_Pntr context);
+
+/* Reports per batch handed to a batch sink: */
+typedef enum t_Batch_Unit : int
+{
+    e_batch_data_block = 0,
+    /* Reports of an ASTERIX data block */
+    e_batch_frame
+    /* Reports of a data frame */
+} t_Batch_Unit;
+
+/* Batch of decoded reports: */
+typedef struct t_Report_Batch
 {
-    t_Rsrv() = default;
-    virtual ~t_Rsrv() = default;
-#else
+    t_Ui32 count;
+    /* Number of reports */
+    const t_Object_Type *objects;
+    /* Report types */
+    const t_Pntr *pntrs;
+    /* Reports, in order of decoding; valid during the call only */
+    t_Ui32 offset;
+    /* Input offset of the frame */
+    t_Bool category_present;
+    /* ASTERIX category present */
+    t_Byte category;
+    /* ASTERIX category of the data block */
+    t_Bool frame_time_present;
+    /* Frame time present */
+    t_Secs frame_time;
+    /* Frame time; seconds */
+    t_Bool line_number_defined;
+    /* Board/line number defined */
+    int line_number;
+    /* Board/line number */
+} t_Report_Batch;
+
+/* Sink of batches of decoded reports: */
+typedef void (*t_Sink_Batch) (const t_Report_Batch *batch_ptr, t_Pntr context);
+
+/* Radar service message: */
 struct t_Rsrv
 {
-#endif
     t_Rsrv_Type rsrv_type;
     /* Type of radar service message */
 
@@ -5221,7 +5844,8 @@ struct t_Rsrv
     /* Warning/error conditions */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j)
+    template <typename J>
+    void toJSON (J& j)
     {
         j["message_type"] = "radar service";
         j["version"] = "1.0";
@@ -5333,15 +5957,8 @@ struct t_Rsrv
 };
 
 /* Radar target report: */
-#if USE_JSON
-struct t_Rtgt : public JSONConvertible
-{
-    t_Rtgt() = default;
-    virtual ~t_Rtgt() = default;
-#else
 struct t_Rtgt
 {
-#endif
     t_ACAS_Resolution_Advisory_Report acas_resolution_advisory_report;
     /* ACAS resolution advisory report */
     t_Aircraft_Identification aircraft_identification;
@@ -5487,7 +6104,8 @@ struct t_Rtgt
     /* X pulses */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j)
+    template <typename J>
+    void toJSON (J& j)
     {
         j["message_type"] = "radar target";
         j["version"] = "1.0";
@@ -5517,9 +6135,10 @@ struct t_Rtgt
         /* Azimuth difference between PSR and SSR plot */
 
         // t_BDS_Register bds_registers[M_MAX_BDS_REGISTERS];
+        bds_decode_all (bds_registers, M_MAX_BDS_REGISTERS);
         for (unsigned int cnt=0; cnt < M_MAX_BDS_REGISTERS; cnt++)
             if (bds_registers[cnt].present)
-                bds_registers[cnt].toJSON(j, "bds"+std::to_string(cnt));
+                bds_registers[cnt].toJSON(j, json_bds_keys[cnt]);
         /* BDS registers */
 
         // t_Doppler_Speed calculated_doppler_speed;
@@ -5670,7 +6289,7 @@ struct t_Rtgt
         mode_3a_info.toJSON(j, "mode_3_info");
         /* SSR mode 3/A information */
 
-         t_Mode_4_Info mode_4_info;
+        // t_Mode_4_Info mode_4_info;
         mode_4_info.toJSON(j, "mode_4_info");
         /* SSR mode 4 information */
 
@@ -5687,7 +6306,7 @@ struct t_Rtgt
         /* SSR mode S flags */
 
         // t_Plot_Qualification plot_qualification;
-        mode_s_flags.toJSON(j, "mode_s_flags");
+        plot_qualification.toJSON(j, "plot_qualification");
         /* Plot qualification */
 
         // t_Measured_Amplitude psr_amplitude;
@@ -5848,15 +6467,8 @@ typedef struct
 } t_Step;
 
 /* System track information: */
-#if USE_JSON
-struct t_Strk : public JSONConvertible
-{
-    t_Strk() = default;
-    virtual ~t_Strk() = default;
-#else
 struct t_Strk
 {
-#endif
     t_Byte asterix_category;
     /* ASTERIX category */
     t_Bool calculated_cartesian_velocity_accuracy_present;
@@ -6190,7 +6802,8 @@ struct t_Strk
     /* Vehicle fleet identification */
 
 #if USE_JSON
-    void toJSON (nlohmann::json& j)
+    template <typename J>
+    void toJSON (J& j)
     {
         j["message_type"] = "track update";
         j["version"] = "1.0";
@@ -6499,7 +7112,7 @@ struct t_Strk
         if (track_psr_age_present)
             j ["track_psr_age"] = track_psr_age;
         else if (write_json_nulls)
-            j ["user_number"] = nullptr;
+            j ["track_psr_age"] = nullptr;
 
         // t_Bool track_ssr_age_present;
         /* Track age for SSR detection present */
@@ -6669,7 +7282,7 @@ struct t_Strk
         /* System track marked as ghost */
 
         // t_Ground_Vector ground_vector;
-        geometric_altitude.toJSON(j, "geometric_altitude");
+        ground_vector.toJSON(j, "ground_vector");
         /* Ground speed and heading */
 
 //        t_Bool has_been_listed;
@@ -6708,7 +7321,7 @@ struct t_Strk
         /* Measured information */
 
         // t_Flight_Level measured_track_mode_c_height;
-        measured_track_mode_c_height.toJSON(j, "measured_information");
+        measured_track_mode_c_height.toJSON(j, "measured_track_mode_c_height");
         /* Measured track mode C height */
 
         // t_Tres military_emergency;
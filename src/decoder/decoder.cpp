@@ -0,0 +1,652 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "decoder.h"
+
+#include "common.h"
+
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#if CHKASS
+#include <setjmp.h>
+#endif
+
+namespace
+{
+
+// decoding runs on the public variables of libsddl, one frame at a time
+std::mutex decoder_mutex;
+
+// reference versions as preset in astx_nnn.cpp, for decoders not setting one
+struct ReferenceVersion
+{
+    int category;
+    t_Retc (*set) (char* vsn_text);
+    const char* preset;
+};
+
+const ReferenceVersion reference_versions[] = {
+    {10, set_vsn010, "1.1"},
+    {11, set_vsn011, "0.17"},
+    {20, set_vsn020, "1.5"},
+    {21, set_vsn021, "2.1"},
+    {23, set_vsn023, "1.2"},
+    {48, set_vsn048, "1.15"},
+    {65, set_vsn065, "0.12"}
+};
+
+const size_t reference_count = sizeof (reference_versions) / sizeof (reference_versions[0]);
+
+// reference versions last set by a decoder, empty before the first frame;
+// a version is set again only when a decoder wants another one
+std::string applied_versions[reference_count];
+
+// the sinks of libsddl are registered for the decoder decoding, and kept
+// while the decoders after it want the same report types; they hand the
+// reports to Decoder::Impl::active, if any
+struct SinkSetup
+{
+    t_Ui32 types;
+    bool batch;
+    t_Batch_Unit batch_unit;
+};
+
+SinkSetup registered_sinks {};
+// the context of the sinks, no decoder
+const char sink_context = 0;
+
+t_Retc setVersion (const ReferenceVersion& rv, const std::string& version)
+{
+    std::vector<char> text (version.begin(), version.end());
+    text.push_back ('\0');
+
+    return rv.set (text.data());
+}
+
+// public variables of libsddl carried from one frame to the next
+struct State
+{
+    t_Bool after_midnight;
+    int current_line_number;
+    t_Bool current_line_number_defined;
+    t_Byte current_stns;
+    t_Bool current_stns_defined;
+    t_Ui16 current_stns_dsi;
+    t_Date frame_date;
+    t_Bool frame_date_present;
+    t_Ui16 last_service_sacsic;
+    t_Bool last_service_sacsic_available;
+    t_Ui32 last_tod;
+    t_Bool last_tod_available;
+    // tables of fillup.cpp and sensors.cpp; NULL = those of the program
+    t_Pntr tod_table;
+    t_Pntr sensor_registry;
+};
+
+void saveState (State& state)
+{
+    state.after_midnight = after_midnight;
+    state.current_line_number = current_line_number;
+    state.current_line_number_defined = current_line_number_defined;
+    state.current_stns = current_stns;
+    state.current_stns_defined = current_stns_defined;
+    state.current_stns_dsi = current_stns_dsi;
+    state.frame_date = frame_date;
+    state.frame_date_present = frame_date_present;
+    state.last_service_sacsic = last_service_sacsic;
+    state.last_service_sacsic_available = last_service_sacsic_available;
+    state.last_tod = last_tod;
+    state.last_tod_available = last_tod_available;
+}
+
+void loadState (const State& state)
+{
+    after_midnight = state.after_midnight;
+    current_line_number = state.current_line_number;
+    current_line_number_defined = state.current_line_number_defined;
+    current_stns = state.current_stns;
+    current_stns_defined = state.current_stns_defined;
+    current_stns_dsi = state.current_stns_dsi;
+    frame_date = state.frame_date;
+    frame_date_present = state.frame_date_present;
+    last_service_sacsic = state.last_service_sacsic;
+    last_service_sacsic_available = state.last_service_sacsic_available;
+    last_tod = state.last_tod;
+    last_tod_available = state.last_tod_available;
+}
+
+}
+
+struct Decoder::Impl
+{
+    State state {};
+    std::map<int, std::string> versions;
+
+    AdsbCallback adsb;
+    MlatCallback mlat;
+    RsrvCallback rsrv;
+    RtgtCallback rtgt;
+    StrkCallback strk;
+    BatchCallback batch;
+    t_Batch_Unit batch_unit {e_batch_frame};
+    ErrorCallback error;
+
+    size_t reports {0};
+    size_t errors {0};
+    // the callbacks of a frame are being called
+    bool delivering {false};
+
+    // what decoding a frame gave, in order; handed to the callbacks once
+    // the public variables have been released
+    enum EventType { event_report, event_batch, event_error };
+    std::vector<std::pair<EventType, size_t>> events;
+
+    std::vector<t_Object_Type> objects;
+    std::vector<size_t> index;
+    std::vector<t_Adsb> adsb_reports;
+    std::vector<t_Mlat> mlat_reports;
+    std::vector<t_Rsrv> rsrv_reports;
+    std::vector<t_Rtgt> rtgt_reports;
+    std::vector<t_Strk> strk_reports;
+    // without objects and pointers, set when delivered
+    std::vector<t_Report_Batch> batches;
+    // index of the first report of each batch
+    std::vector<size_t> batch_first;
+    std::vector<std::pair<t_Ui32, std::string>> error_messages;
+
+    Impl ();
+    ~Impl ();
+
+    bool decodeFrame (const t_Byte* data, size_t length, t_Ui32 offset,
+                      bool time_present, t_Secs time);
+    void enter (State& saved);
+    void leave (const State& saved);
+    void deliver ();
+    void clear ();
+
+    template <typename T>
+    void keep (std::vector<T>& copies, t_Object_Type object, t_Pntr pntr);
+    const void* report (size_t ix) const;
+
+    static void reportSink (t_Object_Type object, t_Pntr pntr, t_Pntr context);
+    static void batchSink (const t_Report_Batch* batch_ptr, t_Pntr context);
+    static void errorHook (t_Ui32 offset, const char* msg, t_Pntr context);
+
+    // the decoder whose frame is being decoded, set while decoder_mutex
+    // is held
+    static Impl* active;
+};
+
+Decoder::Impl* Decoder::Impl::active = nullptr;
+
+Decoder::Impl::Impl ()
+{
+    state.tod_table = create_tod_table ();
+    state.sensor_registry = create_sensor_registry ();
+}
+
+Decoder::Impl::~Impl ()
+{
+    delete_tod_table (state.tod_table);
+    delete_sensor_registry (state.sensor_registry);
+}
+
+Decoder::Decoder ()
+    : impl_ {new Impl}
+{
+}
+
+Decoder::~Decoder ()
+{
+}
+
+void Decoder::onAdsb (AdsbCallback callback)
+{
+    impl_->adsb = callback;
+}
+
+void Decoder::onMlat (MlatCallback callback)
+{
+    impl_->mlat = callback;
+}
+
+void Decoder::onRsrv (RsrvCallback callback)
+{
+    impl_->rsrv = callback;
+}
+
+void Decoder::onRtgt (RtgtCallback callback)
+{
+    impl_->rtgt = callback;
+}
+
+void Decoder::onStrk (StrkCallback callback)
+{
+    impl_->strk = callback;
+}
+
+void Decoder::onBatch (t_Batch_Unit unit, BatchCallback callback)
+{
+    impl_->batch_unit = unit;
+    impl_->batch = callback;
+}
+
+void Decoder::onError (ErrorCallback callback)
+{
+    impl_->error = callback;
+}
+
+bool Decoder::setReferenceVersion (int category, const std::string& version)
+{
+    for (const ReferenceVersion& rv : reference_versions)
+    {
+        if (rv.category != category)
+            continue;
+
+        // checked against the implemented versions, then restored
+        std::lock_guard<std::mutex> lock (decoder_mutex);
+
+        if (setVersion (rv, version) != RC_OKAY)
+            return false;
+
+        const std::string& applied = applied_versions[&rv - reference_versions];
+        setVersion (rv, applied.empty() ? std::string (rv.preset) : applied);
+        impl_->versions[category] = version;
+        return true;
+    }
+
+    return false;
+}
+
+void Decoder::setFrameDate (const t_Date& date)
+{
+    impl_->state.frame_date = date;
+    impl_->state.frame_date_present = TRUE;
+}
+
+bool Decoder::decode (const t_Byte* data, size_t length, t_Ui32 offset)
+{
+    return impl_->decodeFrame (data, length, offset, false, 0.0);
+}
+
+bool Decoder::decode (const t_Byte* data, size_t length, t_Ui32 offset, t_Secs frame_time)
+{
+    return impl_->decodeFrame (data, length, offset, true, frame_time);
+}
+
+void Decoder::reset ()
+{
+    State& state = impl_->state;
+
+    // the date is configuration, not learnt from the frames
+    t_Date frame_date = state.frame_date;
+    t_Bool frame_date_present = state.frame_date_present;
+    t_Pntr tod_table = state.tod_table;
+    t_Pntr sensor_registry = state.sensor_registry;
+
+    memset (&state, 0, sizeof (state));
+
+    state.frame_date = frame_date;
+    state.frame_date_present = frame_date_present;
+    state.tod_table = tod_table;
+    state.sensor_registry = sensor_registry;
+
+    clear_tod_table (tod_table);
+    clear_sensor_registry (sensor_registry);
+}
+
+size_t Decoder::reports () const
+{
+    return impl_->reports;
+}
+
+size_t Decoder::errors () const
+{
+    return impl_->errors;
+}
+
+bool Decoder::Impl::decodeFrame (const t_Byte* data, size_t length, t_Ui32 offset,
+                                 bool time_present, t_Secs time)
+{
+    // the reports of the frame being delivered would be lost
+    if (delivering)
+    {
+        ++errors;
+        if (error)
+            error (offset, "Decoder called from one of its callbacks");
+        return false;
+    }
+
+    if (data == nullptr || length == 0 || length > 0xffff)
+    {
+        ++errors;
+        if (error)
+            error (offset, "Invalid ASTERIX frame length " + std::to_string (length));
+        return false;
+    }
+
+    size_t errors_before = errors;
+    volatile t_Retc lrc = RC_FAIL;
+
+    {
+        // the public variables hold the state of this decoder while the
+        // guard lives, also if decoding ends early
+        struct Guard
+        {
+            Impl& impl;
+            State saved;
+
+            explicit Guard (Impl& i) : impl (i) { impl.enter (saved); }
+            ~Guard () { impl.leave (saved); }
+        };
+
+        std::lock_guard<std::mutex> lock (decoder_mutex);
+        Guard guard {*this};
+
+        input_offset = offset;
+        input_rtm = 0;
+        frame_time = time;
+        frame_time_present = time_present ? TRUE : FALSE;
+
+#if CHKASS
+        // an assertion violation ends the frame, not the program
+        jmp_buf saved_fatal_error;
+        memcpy (&saved_fatal_error, &on_fatal_error, sizeof (jmp_buf));
+
+        if (setjmp (on_fatal_error) == 0)
+            lrc = do_frame (offset, 0x0000, static_cast<t_Ui16> (length), const_cast<t_Byte*> (data));
+        else
+            end_frame (offset);
+
+        memcpy (&on_fatal_error, &saved_fatal_error, sizeof (jmp_buf));
+#else
+        lrc = do_frame (offset, 0x0000, static_cast<t_Ui16> (length), const_cast<t_Byte*> (data));
+#endif
+    }
+
+    // a data block in error is skipped, yet the frame was not decoded in full
+    bool ok = (lrc == RC_OKAY || lrc == RC_SKIP) && errors == errors_before;
+
+    deliver ();
+
+    return ok;
+}
+
+void Decoder::Impl::enter (State& saved)
+{
+    saveState (saved);
+    loadState (state);
+
+    saved.tod_table = select_tod_table (state.tod_table);
+    saved.sensor_registry = select_sensor_registry (state.sensor_registry);
+
+    data_format = e_data_format_asterix;
+
+    for (size_t ix = 0; ix < reference_count; ix ++)
+    {
+        const ReferenceVersion& rv = reference_versions[ix];
+        auto it = versions.find (rv.category);
+        const std::string wanted = it != versions.end() ? it->second : std::string (rv.preset);
+
+        if (wanted != applied_versions[ix])
+        {
+            setVersion (rv, wanted);
+            applied_versions[ix] = wanted;
+        }
+    }
+
+    // a batch callback takes all report types, as copied by reportSink
+    t_Ui32 types = 0;
+    if (batch)
+        types = M_ALL_REPORTS;
+    if (adsb)
+        types |= (t_Ui32) 1 << e_object_adsb;
+    if (mlat)
+        types |= (t_Ui32) 1 << e_object_mlat;
+    if (rsrv)
+        types |= (t_Ui32) 1 << e_object_rsrv;
+    if (rtgt)
+        types |= (t_Ui32) 1 << e_object_rtgt;
+    if (strk)
+        types |= (t_Ui32) 1 << e_object_strk;
+
+    // registered anew only for other report types or batches, or if the
+    // program has unregistered them meanwhile
+    SinkSetup setup {types, static_cast<bool> (batch), batch_unit};
+    t_Pntr context = const_cast<char*> (&sink_context);
+
+    if (setup.types != registered_sinks.types || setup.batch != registered_sinks.batch ||
+        (setup.batch && setup.batch_unit != registered_sinks.batch_unit) ||
+        (types && !sink_registered (context)))
+    {
+        unregister_sink (context);
+
+        if (types)
+            register_sink ("decoder", types, reportSink, context);
+        if (batch)
+            register_batch_sink ("decoder", M_ALL_REPORTS, batch_unit, batchSink, context);
+
+        registered_sinks = setup;
+    }
+
+    active = this;
+    set_error_hook (errorHook, this);
+}
+
+void Decoder::Impl::leave (const State& saved)
+{
+    set_error_hook (NULL, NULL);
+    active = nullptr;
+
+    select_tod_table (saved.tod_table);
+    select_sensor_registry (saved.sensor_registry);
+
+    t_Pntr tod_table = state.tod_table;
+    t_Pntr sensor_registry = state.sensor_registry;
+
+    saveState (state);
+    loadState (saved);
+
+    state.tod_table = tod_table;
+    state.sensor_registry = sensor_registry;
+}
+
+void Decoder::Impl::deliver ()
+{
+    // cleared also if a callback throws
+    struct Guard
+    {
+        Impl& impl;
+
+        explicit Guard (Impl& i) : impl (i) { impl.delivering = true; }
+        ~Guard () { impl.delivering = false; impl.clear(); }
+    } guard {*this};
+
+    std::vector<t_Pntr> pntrs;
+
+    for (const auto& event : events)
+    {
+        size_t ix = event.second;
+
+        switch (event.first)
+        {
+        case event_report:
+            switch (objects[ix])
+            {
+            case e_object_adsb:
+                if (!adsb)
+                    continue;
+                adsb (adsb_reports[index[ix]]);
+                break;
+            case e_object_mlat:
+                if (!mlat)
+                    continue;
+                mlat (mlat_reports[index[ix]]);
+                break;
+            case e_object_rsrv:
+                if (!rsrv)
+                    continue;
+                rsrv (rsrv_reports[index[ix]]);
+                break;
+            case e_object_rtgt:
+                if (!rtgt)
+                    continue;
+                rtgt (rtgt_reports[index[ix]]);
+                break;
+            case e_object_strk:
+                if (!strk)
+                    continue;
+                strk (strk_reports[index[ix]]);
+                break;
+            default:
+                continue;
+            }
+
+            ++reports;
+            break;
+
+        case event_batch:
+        {
+            t_Report_Batch& b = batches[ix];
+            size_t first = batch_first[ix];
+
+            pntrs.clear();
+            for (size_t jx = first; jx < first + b.count; jx ++)
+                pntrs.push_back (const_cast<void*> (report (jx)));
+
+            b.objects = objects.data() + first;
+            b.pntrs = pntrs.data();
+            batch (b);
+
+            // counted once, by the report callbacks if there are any
+            if (!(adsb || mlat || rsrv || rtgt || strk))
+                reports += b.count;
+            break;
+        }
+
+        case event_error:
+            if (error)
+                error (error_messages[ix].first, error_messages[ix].second);
+            break;
+        }
+    }
+}
+
+void Decoder::Impl::clear ()
+{
+    events.clear();
+    objects.clear();
+    index.clear();
+    adsb_reports.clear();
+    mlat_reports.clear();
+    rsrv_reports.clear();
+    rtgt_reports.clear();
+    strk_reports.clear();
+    batches.clear();
+    batch_first.clear();
+    error_messages.clear();
+}
+
+template <typename T>
+void Decoder::Impl::keep (std::vector<T>& copies, t_Object_Type object, t_Pntr pntr)
+{
+    events.push_back ({event_report, objects.size()});
+    index.push_back (copies.size());
+    objects.push_back (object);
+
+    copies.push_back (*static_cast<T*> (pntr));
+}
+
+const void* Decoder::Impl::report (size_t ix) const
+{
+    switch (objects[ix])
+    {
+    case e_object_adsb:
+        return &adsb_reports[index[ix]];
+    case e_object_mlat:
+        return &mlat_reports[index[ix]];
+    case e_object_rsrv:
+        return &rsrv_reports[index[ix]];
+    case e_object_rtgt:
+        return &rtgt_reports[index[ix]];
+    case e_object_strk:
+        return &strk_reports[index[ix]];
+    default:
+        return nullptr;
+    }
+}
+
+void Decoder::Impl::reportSink (t_Object_Type object, t_Pntr pntr, t_Pntr)
+{
+    // reports of frames decoded by the program itself
+    Impl* impl = active;
+    if (impl == nullptr)
+        return;
+
+    switch (object)
+    {
+    case e_object_adsb:
+        impl->keep (impl->adsb_reports, object, pntr);
+        break;
+    case e_object_mlat:
+        impl->keep (impl->mlat_reports, object, pntr);
+        break;
+    case e_object_rsrv:
+        impl->keep (impl->rsrv_reports, object, pntr);
+        break;
+    case e_object_rtgt:
+        impl->keep (impl->rtgt_reports, object, pntr);
+        break;
+    case e_object_strk:
+        impl->keep (impl->strk_reports, object, pntr);
+        break;
+    default:
+        break;
+    }
+}
+
+void Decoder::Impl::batchSink (const t_Report_Batch* batch_ptr, t_Pntr)
+{
+    Impl* impl = active;
+    if (impl == nullptr)
+        return;
+
+    t_Report_Batch b = *batch_ptr;
+
+    // the reports of the batch were kept by reportSink, as the last ones
+    Assert (b.count <= impl->objects.size(), "Batch of reports not kept");
+    b.objects = nullptr;
+    b.pntrs = nullptr;
+
+    impl->events.push_back ({event_batch, impl->batches.size()});
+    impl->batches.push_back (b);
+    impl->batch_first.push_back (impl->objects.size() - b.count);
+}
+
+void Decoder::Impl::errorHook (t_Ui32 offset, const char* msg, t_Pntr context)
+{
+    Impl* impl = static_cast<Impl*> (context);
+
+    ++impl->errors;
+
+    impl->events.push_back ({event_error, impl->error_messages.size()});
+    impl->error_messages.push_back ({offset, msg});
+}
@@ -0,0 +1,119 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DECODER_H
+#define DECODER_H
+
+#include "global.h"
+#include "basics.h"
+
+#include "common_data_types.h"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+
+// report types of libsddl, defined by common.h
+struct t_Adsb;
+struct t_Date;
+struct t_Mlat;
+struct t_Report_Batch;
+struct t_Rsrv;
+struct t_Rtgt;
+struct t_Strk;
+enum t_Batch_Unit : int;
+
+/*
+ * Decoding of ASTERIX data frames for programs linking libsddl, without
+ * the command line program around it:
+ *
+ *     Decoder decoder;
+ *     decoder.onRtgt ([] (const t_Rtgt& rtgt) { ... });
+ *     decoder.onError ([] (t_Ui32 offset, const std::string& msg) { ... });
+ *     decoder.decode (frame, length);
+ *
+ * A frame holds one or more data blocks. The reports are handed to the
+ * callbacks during decode(), one at a time or, with onBatch(), as the
+ * reports of a data block or frame. Errors go to the error callback, not
+ * to standard error; an assertion violation ends the frame as an error.
+ *
+ * Each decoder has its own configuration, callbacks and decoding state,
+ * that is the time of day per SAC/SIC and the sensor registry, so
+ * decoders may be used from different threads. The decoding code of
+ * libsddl keeps its state in public variables, so the decoding of frames
+ * is serialized over all decoders by one lock: threads decoding with
+ * decoders of their own do not decode faster together than one thread
+ * does. Only the callbacks run in parallel; they are called once the
+ * frame has been decoded, outside of the lock, and may use other
+ * decoders; a callback calling decode() of its own decoder gets an error.
+ *
+ * Switching between decoders costs least when they use the same
+ * reference versions and the same kinds of callbacks: both are applied
+ * to libsddl only when they change from one frame to the next.
+ */
+
+class Decoder
+{
+public:
+    typedef std::function<void (const t_Adsb&)> AdsbCallback;
+    typedef std::function<void (const t_Mlat&)> MlatCallback;
+    typedef std::function<void (const t_Rsrv&)> RsrvCallback;
+    typedef std::function<void (const t_Rtgt&)> RtgtCallback;
+    typedef std::function<void (const t_Strk&)> StrkCallback;
+    typedef std::function<void (const t_Report_Batch&)> BatchCallback;
+    typedef std::function<void (t_Ui32 offset, const std::string& message)> ErrorCallback;
+
+    Decoder ();
+    ~Decoder ();
+
+    Decoder (const Decoder&) = delete;
+    Decoder& operator= (const Decoder&) = delete;
+
+    void onAdsb (AdsbCallback callback);
+    void onMlat (MlatCallback callback);
+    void onRsrv (RsrvCallback callback);
+    void onRtgt (RtgtCallback callback);
+    void onStrk (StrkCallback callback);
+    // all report types, as the reports of each data block or frame
+    void onBatch (t_Batch_Unit unit, BatchCallback callback);
+    void onError (ErrorCallback callback);
+
+    // ASTERIX category 010, 011, 020, 021, 023, 048 or 065 reference
+    // version, like "1.15"; false if not implemented
+    bool setReferenceVersion (int category, const std::string& version);
+    // date of the frames, for reports with a full date and time
+    void setFrameDate (const t_Date& date);
+
+    // false if the frame could not be decoded in full
+    bool decode (const t_Byte* data, size_t length, t_Ui32 offset = 0);
+    // with the time the frame was received; seconds since midnight
+    bool decode (const t_Byte* data, size_t length, t_Ui32 offset, t_Secs frame_time);
+
+    // forgets the time of day and the sensors learnt from earlier frames
+    void reset ();
+
+    size_t reports () const;
+    // error messages, one or more per frame not decoded in full
+    size_t errors () const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+#endif // DECODER_H
@@ -0,0 +1,213 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "decoder.h"
+
+#include "basics.h"
+
+#include "common.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Two threads decoding the same CAT048 frame with a decoder each, one
+ * with report callbacks and reference version 1.14, the other with a
+ * batch callback and reference version 1.16:
+ *
+ *     sddl_decoder_check [frames]
+ *
+ * Every report must equal the one a single decoder of the same
+ * configuration gave for the frame before the threads were started, and
+ * the first one the values the frame was built with.
+ */
+
+namespace
+{
+
+const int records = 4;
+
+void append (std::vector<t_Byte>& data, std::initializer_list<int> bytes)
+{
+    for (int b : bytes)
+        data.push_back (static_cast<t_Byte> (b));
+}
+
+// Mode S plots: I048/010, 140, 020, 040, 070, 090, 130, 220, 240, 250,
+// 161, 042, 200, 170, 230; record ix has track number 256 + ix and target
+// address 0x3c6600 + ix
+std::vector<t_Byte> frame ()
+{
+    std::vector<t_Byte> data;
+
+    append (data, {48, 0x00, 0x00});
+    for (int ix = 0; ix < records; ix ++)
+    {
+        append (data, {0xff, 0xff, 0x02});
+        append (data, {0x08, 0x11});
+        append (data, {0x3c, 0x00, ix});
+        append (data, {0xa0});
+        append (data, {0x2a, ix, 0x40, 0x00});
+        append (data, {0x0a, 0x2b});
+        append (data, {0x00, 0x8c});
+        append (data, {0xe0, 0x40, 0x42, 0x5c});
+        append (data, {0x3c, 0x66, ix});
+        append (data, {0x0c, 0x54, 0x31, 0xd3, 0x4c, 0x20});
+        append (data, {0x01, 0x85, 0x5e, 0x30, 0x00, 0x00, 0x00, 0x00, 0x40});
+        append (data, {0x01, ix});
+        append (data, {0x01, 0x20, 0xfe, 0x10});
+        append (data, {0x08, 0x9a, 0x30, 0x00});
+        append (data, {0x40});
+        append (data, {0x20, 0xfd});
+    }
+
+    data[1] = static_cast<t_Byte> (data.size() >> 8);
+    data[2] = static_cast<t_Byte> (data.size() & 0xff);
+
+    return data;
+}
+
+struct Run
+{
+    std::string version;
+    bool batch;
+    std::vector<t_Rtgt> reports;
+    size_t errors {0};
+
+    Run (const char* v, bool b) : version {v}, batch {b} {}
+
+    void setup (Decoder& decoder)
+    {
+        if (!decoder.setReferenceVersion (48, version))
+        {
+            fprintf (stderr, "CAT048 reference version %s refused\n", version.c_str());
+            exit (1);
+        }
+
+        if (batch)
+        {
+            decoder.onBatch (e_batch_frame, [this] (const t_Report_Batch& b) {
+                for (size_t ix = 0; ix < b.count; ix ++)
+                {
+                    if (b.objects[ix] == e_object_rtgt)
+                        reports.push_back (*static_cast<const t_Rtgt*> (b.pntrs[ix]));
+                }
+            });
+        }
+        else
+            decoder.onRtgt ([this] (const t_Rtgt& rtgt) { reports.push_back (rtgt); });
+
+        decoder.onError ([this] (t_Ui32 offset, const std::string& msg) {
+            ++errors;
+            fprintf (stderr, "Error at offset %u: %s\n", offset, msg.c_str());
+        });
+    }
+};
+
+// the reports of one frame, decoded before any thread runs
+bool reference (Run& run, const std::vector<t_Byte>& data)
+{
+    Decoder decoder;
+    run.setup (decoder);
+
+    if (!decoder.decode (data.data(), data.size()) || run.reports.size() != records)
+    {
+        fprintf (stderr, "Frame not decoded with reference version %s\n", run.version.c_str());
+        return false;
+    }
+
+    for (int ix = 0; ix < records; ix ++)
+    {
+        const t_Rtgt& r = run.reports[ix];
+
+        if (!r.track_number.present || r.track_number.value != 256 + ix ||
+            !r.target_address.present || r.target_address.value != 0x3c6600u + ix ||
+            !r.data_source_identifier.present || r.data_source_identifier.value != 0x0811 ||
+            !r.bds_registers[0].present || r.bds_registers[0].number != 0x40)
+        {
+            fprintf (stderr, "Report %d wrong with reference version %s\n", ix, run.version.c_str());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void decodeFrames (Run& run, const std::vector<t_Byte>& data, int frames)
+{
+    Decoder decoder;
+    run.setup (decoder);
+
+    for (int ix = 0; ix < frames; ix ++)
+        decoder.decode (data.data(), data.size(), static_cast<t_Ui32> (ix));
+}
+
+bool compare (const Run& run, const Run& ref, int frames)
+{
+    if (run.errors || run.reports.size() != static_cast<size_t> (frames) * records)
+    {
+        fprintf (stderr, "Reference version %s: %zu report(s), %zu error(s)\n",
+                 run.version.c_str(), run.reports.size(), run.errors);
+        return false;
+    }
+
+    for (size_t ix = 0; ix < run.reports.size(); ix ++)
+    {
+        if (memcmp (&run.reports[ix], &ref.reports[ix % records], sizeof (t_Rtgt)) != 0)
+        {
+            fprintf (stderr, "Reference version %s: report %zu differs\n", run.version.c_str(), ix);
+            return false;
+        }
+    }
+
+    printf ("Reference version %s%s: %zu report(s) as expected\n", run.version.c_str(),
+            run.batch ? " (batches)" : "", run.reports.size());
+    return true;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    int frames = argc > 1 ? atoi (argv[1]) : 20000;
+    std::vector<t_Byte> data = frame ();
+
+    Run ref_a {"1.14", false};
+    Run ref_b {"1.16", true};
+
+    if (!reference (ref_a, data) || !reference (ref_b, data))
+        return 1;
+
+    Run run_a {"1.14", false};
+    Run run_b {"1.16", true};
+
+    std::thread thread_a {decodeFrames, std::ref (run_a), std::cref (data), frames};
+    std::thread thread_b {decodeFrames, std::ref (run_b), std::cref (data), frames};
+    thread_a.join();
+    thread_b.join();
+
+    bool ok = compare (run_a, ref_a, frames);
+    ok = compare (run_b, ref_b, frames) && ok;
+
+    return ok ? 0 : 1;
+}
@@ -273,6 +273,9 @@ static t_Retc variable_length (t_Byte category, t_Si16 item_number,
 			break;
 		}
 
+                   /* Hand its reports to batch sinks: */
+		end_data_block (offset, cat);
+
 				   /* Check return code: */
 		if (lrc != RC_OKAY && lrc != RC_SKIP)
 		{
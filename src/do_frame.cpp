@@ -73,6 +73,9 @@
 		lrc = RC_FAIL;
 	}
 
+                   /* Hand its reports to batch sinks: */
+	end_frame (offset);
+
 	if (lrc != RC_OKAY && lrc != RC_SKIP)
 	{
 		if (stop_on_error)
@@ -267,6 +267,9 @@ static int midnight_jumps;
 	}
 
 #if LISTER
+                   /* Rotate the list file, if due: */
+	check_list_rotation ();
+
                    /* Check whether frame is to be listed: */
 	to_be_listed = FALSE;
 	if (0 < list_level && list_level <= 3)
@@ -134,6 +134,9 @@
 	}
 
 #if LISTER
+                   /* Rotate the list file, if due: */
+	check_list_rotation ();
+
 				   /* List the "netto" frame (lowest level): */
 	list_text (1, "; Netto frame " M_FMT_UI32 " (length=" M_FMT_UI16 ") "
                   "at offset 0x" M_FMT_UI32_HEX " (" M_FMT_UI32 "):\n",
@@ -115,6 +115,9 @@
 	}
 
 #if LISTER
+                   /* Rotate the list file, if due: */
+	check_list_rotation ();
+
 				   /* List the REC frame (lowest level): */
 	list_text (1, "; REC frame %lu (length=%hu) "
                   "at offset 0x%08lx (%lu):\n",
@@ -468,6 +468,9 @@ static t_Retc get_wall_time (char *buffer, t_Wall_Time *wtm_ptr);
 	}
 
 #if LISTER
+                   /* Rotate the list file, if due: */
+	check_list_rotation ();
+
                    /* Check whether frame is to be listed: */
 	to_be_listed = FALSE;
 	if (0 < list_level && list_level <= 3)
@@ -33,6 +33,15 @@
 #include <stdio.h>
 #include <string.h>
 
+                   /* Local data: */
+                   /* ----------- */
+
+static t_Error_Hook error_hook;
+                   /* Function taking error messages instead of
+                      standard error; NULL if none */
+static t_Pntr error_hook_context;
+                   /* Passed to the function */
+
 /*----------------------------------------------------------------------------*/
 /* error_msg       -- Error message                                           */
 /*----------------------------------------------------------------------------*/
@@ -60,6 +69,12 @@
 				   /* Check message length: */
 	Assert (strlen (msg) <= 1023, "Local memory overwritten");
 
+                   /* Hand to the embedding program, if any: */
+	if (hook_error (input_offset, msg))
+	{
+		goto done;
+	}
+
 	fprintf (stderr, "E> Near offset " M_FMT_UI32, input_offset);
 	if (input_rtm != 0)
 	{
@@ -79,4 +94,31 @@
 	done:          /* We are done */
 	return;
 }
+/*----------------------------------------------------------------------------*/
+/* hook_error      -- Hand an error message to the error hook, if any         */
+/*----------------------------------------------------------------------------*/
+
+ t_Bool hook_error (t_Ui32 offset, const char *msg)
+{
+	if (error_hook == NULL)
+	{
+		return FALSE;
+	}
+
+	error_hook (offset, msg, error_hook_context);
+
+	return TRUE;
+}
+
+/*----------------------------------------------------------------------------*/
+/* set_error_hook  -- Set function taking error messages (NULL for stderr)    */
+/*----------------------------------------------------------------------------*/
+
+ void set_error_hook (t_Error_Hook hook, t_Pntr context)
+{
+	error_hook = hook;
+	error_hook_context = context;
+
+	return;
+}
 /* end-of-file */
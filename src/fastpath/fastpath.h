@@ -0,0 +1,1032 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FASTPATH_H
+#define FASTPATH_H
+
+#include "global.h"
+#include "basics.h"
+
+#include "astx_items.h"
+
+#include <cstddef>
+
+/*
+ * Header-only decoding of ASTERIX categories 048 (monoradar target
+ * reports), 062 (system tracks) and 021 (ADS-B reports), for programs
+ * which need no more than these, at the lowest latency:
+ *
+ *     struct Handler
+ *     {
+ *         void operator() (const FastPlot& plot) { ... }
+ *         void operator() (const FastTrack& track) { ... }
+ *         void operator() (const FastAdsb& adsb) { ... }
+ *     };
+ *
+ *     Handler handler;
+ *     bool ok = FastPath::decode (frame, length, handler);
+ *
+ * Only the data items below are decoded, by the functions of
+ * astx_items.h which astx_048.cpp, astx_062.cpp and astx_021.cpp use as
+ * well, so the values are those of the reports of libsddl; all other data
+ * items are skipped. The User Application Profiles are the ones of the
+ * reference versions libsddl decodes by default: CAT048 1.15, CAT062 as
+ * astx_062.cpp and CAT021 2.1. Track numbers of CAT062 have 16 bits.
+ *
+ * A value is valid only if the flag of its data item is set; values of
+ * data items which are not present are not cleared. Nothing is kept from
+ * one call to the next, nothing is allocated and nothing is printed; a
+ * record in error ends its data block, and decode() returns false.
+ */
+
+// CAT048 target report
+struct FastPlot
+{
+    bool dsi_present;               // I048/010
+    t_Byte sac;
+    t_Byte sic;
+    bool time_present;              // I048/140; seconds since midnight
+    t_Secs time;
+    bool type_present;              // I048/020 TYP
+    t_Byte type;
+    bool position_present;          // I048/040; metres and radians
+    t_Real range;
+    t_Real azimuth;
+    bool mode_3a_present;           // I048/070
+    t_Ui16 mode_3a;
+    bool mode_3a_invalid;
+    bool mode_3a_garbled;
+    bool mode_3a_smoothed;
+    bool mode_c_present;            // I048/090; feet
+    t_Si32 mode_c_height;
+    bool mode_c_invalid;
+    bool mode_c_garbled;
+    bool address_present;           // I048/220
+    t_Ui32 address;
+    bool identification_present;    // I048/240
+    char identification[M_AIRCRAFT_IDENTIFICATION_LENGTH + 1];
+    bool track_number_present;      // I048/161
+    t_Ui16 track_number;
+};
+
+// CAT062 system track
+struct FastTrack
+{
+    bool dsi_present;               // I062/010
+    t_Byte sac;
+    t_Byte sic;
+    bool time_present;              // I062/070; seconds since midnight
+    t_Secs time;
+    bool wgs84_present;             // I062/105; radians
+    t_Real latitude;
+    t_Real longitude;
+    bool position_present;          // I062/100; metres
+    t_Real x;
+    t_Real y;
+    bool velocity_present;          // I062/185; metres/second
+    t_Real vx;
+    t_Real vy;
+    bool mode_3a_present;           // I062/060
+    t_Ui16 mode_3a;
+    bool mode_3a_invalid;
+    bool mode_3a_garbled;
+    bool mode_3a_changed;
+    bool identification_present;    // I062/245
+    char identification[M_AIRCRAFT_IDENTIFICATION_LENGTH + 1];
+    bool address_present;           // I062/380 ADR
+    t_Ui32 address;
+    bool track_number_present;      // I062/040
+    t_Ui16 track_number;
+    bool flight_level_present;      // I062/136; feet
+    t_Si32 flight_level;
+};
+
+// CAT021 ADS-B report
+struct FastAdsb
+{
+    bool dsi_present;               // I021/010
+    t_Byte sac;
+    t_Byte sic;
+    bool track_number_present;      // I021/161
+    t_Ui16 track_number;
+    bool toa_position_present;      // I021/071; seconds since midnight
+    t_Secs toa_position;
+    bool tor_position_present;      // I021/073; seconds since midnight
+    t_Secs tor_position;
+    bool wgs84_present;             // I021/130 or I021/131; radians
+    bool wgs84_high_precision;
+    t_Real latitude;
+    t_Real longitude;
+    bool address_present;           // I021/080
+    t_Ui32 address;
+    bool mode_3a_present;           // I021/070
+    t_Ui16 mode_3a;
+    bool flight_level_present;      // I021/145; feet
+    t_Si32 flight_level;
+    bool ground_vector_present;     // I021/160; metres/second and radians
+    t_Real ground_speed;
+    t_Real track_angle;
+    bool identification_present;    // I021/170
+    char identification[M_AIRCRAFT_IDENTIFICATION_LENGTH + 1];
+};
+
+typedef enum
+{
+    FAST_ITEM_NONE,                 // not in the UAP
+    FAST_ITEM_FIXED,                // size octets
+    FAST_ITEM_VARIABLE,             // parts of size octets, while FX is set
+    FAST_ITEM_REPETITIVE,           // repetition factor, then size octets each
+    FAST_ITEM_COMPOUND,             // primary subfield, then the subfields
+    FAST_ITEM_EXPLICIT              // length octet, which counts itself
+} FAST_ITEM_TYPE;
+
+// layout of a data item, just enough to find the next one
+struct FastItem
+{
+    t_Byte type;
+    // octets, or number of subfields of a compound data item
+    t_Byte size;
+    // octets per subfield of a compound data item; -n for a repetitive
+    // subfield of n octets each
+    const signed char* subfields;
+};
+
+class FastPath
+{
+public:
+    // the records of all data blocks of categories 021, 048 and 062 in a
+    // frame go to handler; false if not all could be decoded
+    template <typename Handler>
+    static bool decode (const t_Byte* data, size_t length, Handler& handler);
+
+    // one record from the data field of a data block; the octets of the
+    // record, 0 if it is in error
+    static size_t decodeRecord (const t_Byte* data, size_t length, FastPlot& plot);
+    static size_t decodeRecord (const t_Byte* data, size_t length, FastTrack& track);
+    static size_t decodeRecord (const t_Byte* data, size_t length, FastAdsb& adsb);
+
+private:
+    enum
+    {
+        MAX_FSPEC_048 = 4,
+        MAX_FSPEC_062 = 5,
+        MAX_FSPEC_021 = 7
+    };
+
+    template <typename Record, typename Handler>
+    static bool decodeBlock (const t_Byte* data, size_t length, Handler& handler);
+
+    static void wgs84 (const t_Byte* item, bool high_precision, FastAdsb& adsb);
+
+    // moves pos past a data item of size octets; false if it does not fit
+    static bool skip (size_t size, size_t length, size_t& pos);
+    // moves pos past the data items of FSPEC octet first and later; 0 if
+    // one is in error
+    static size_t skipItems (const FastItem* uap, const t_Byte* data, size_t length,
+                             size_t fspec, size_t first, size_t pos);
+
+    static size_t fspecLength (const t_Byte* data, size_t length, size_t max_length);
+    static size_t itemLength (const FastItem& item, const t_Byte* data, size_t length);
+    static size_t compoundLength (const FastItem& item, const t_Byte* data, size_t length);
+
+    // indexed by FRN, 7 per FSPEC octet
+    static const FastItem* uap048 ();
+    static const FastItem* uap062 ();
+    static const FastItem* uap021 ();
+};
+
+template <typename Handler>
+inline bool FastPath::decode (const t_Byte* data, size_t length, Handler& handler)
+{
+    bool ok = true;
+    size_t pos = 0;
+
+    while (pos < length)
+    {
+        if (length - pos < 3)
+            return false;
+
+        t_Byte cat = data[pos];
+        size_t len = (static_cast<size_t> (data[pos + 1]) << 8) | data[pos + 2];
+
+        if (len < 3 || len > length - pos)
+            return false;
+
+        switch (cat)
+        {
+        case 21:
+            ok = decodeBlock<FastAdsb> (data + pos + 3, len - 3, handler) && ok;
+            break;
+        case 48:
+            ok = decodeBlock<FastPlot> (data + pos + 3, len - 3, handler) && ok;
+            break;
+        case 62:
+            ok = decodeBlock<FastTrack> (data + pos + 3, len - 3, handler) && ok;
+            break;
+        default:
+            break;
+        }
+
+        pos += len;
+    }
+
+    return ok;
+}
+
+template <typename Record, typename Handler>
+inline bool FastPath::decodeBlock (const t_Byte* data, size_t length, Handler& handler)
+{
+    Record record;
+    size_t pos = 0;
+
+    while (pos < length)
+    {
+        size_t len = decodeRecord (data + pos, length - pos, record);
+
+        // the next record cannot be found
+        if (len == 0)
+            return false;
+
+        handler (static_cast<const Record&> (record));
+        pos += len;
+    }
+
+    return true;
+}
+
+inline size_t FastPath::decodeRecord (const t_Byte* data, size_t length, FastPlot& plot)
+{
+    const FastItem* uap = uap048 ();
+    size_t fspec = fspecLength (data, length, MAX_FSPEC_048);
+    size_t pos = fspec;
+
+    if (fspec == 0)
+        return 0;
+
+    plot.dsi_present = false;
+    plot.time_present = false;
+    plot.type_present = false;
+    plot.position_present = false;
+    plot.mode_3a_present = false;
+    plot.mode_c_present = false;
+    plot.address_present = false;
+    plot.identification_present = false;
+    plot.track_number_present = false;
+
+    // the data items of the first two FSPEC octets in UAP order, FRN 1 to
+    // 14; the rest are skipped
+    unsigned int f1 = data[0];
+    unsigned int f2 = fspec > 1 ? data[1] : 0;
+    const t_Byte* item;
+
+    if (f1 & 0x80)                      // I048/010
+    {
+        item = data + pos;
+        if (!skip (2, length, pos))
+            return 0;
+        plot.dsi_present = true;
+        plot.sac = item[0];
+        plot.sic = item[1];
+    }
+    if (f1 & 0x40)                      // I048/140
+    {
+        item = data + pos;
+        if (!skip (3, length, pos))
+            return 0;
+        plot.time_present = true;
+        plot.time = item_tod (item);
+    }
+    if (f1 & 0x20)                      // I048/020
+    {
+        item = data + pos;
+        if (!skip (itemLength (uap[3], item, length - pos), length, pos))
+            return 0;
+        plot.type_present = true;
+        plot.type = (item[0] >> 5) & 0x07;
+    }
+    if (f1 & 0x10)                      // I048/040
+    {
+        item = data + pos;
+        if (!skip (4, length, pos))
+            return 0;
+        plot.position_present = true;
+        item_polar (item, &plot.range, &plot.azimuth);
+    }
+    if (f1 & 0x08)                      // I048/070
+    {
+        item = data + pos;
+        if (!skip (2, length, pos))
+            return 0;
+        plot.mode_3a_present = true;
+        plot.mode_3a = item_mode_3a (item);
+        plot.mode_3a_invalid = (item[0] & 0x80) != 0;
+        plot.mode_3a_garbled = (item[0] & 0x40) != 0;
+        plot.mode_3a_smoothed = (item[0] & 0x20) != 0;
+    }
+    if (f1 & 0x04)                      // I048/090
+    {
+        item = data + pos;
+        if (!skip (2, length, pos))
+            return 0;
+        plot.mode_c_present = true;
+        plot.mode_c_height = 25 * (t_Si32) item_mode_c (item);
+        plot.mode_c_invalid = (item[0] & 0x80) != 0;
+        plot.mode_c_garbled = (item[0] & 0x40) != 0;
+    }
+    if ((f1 & 0x02) &&                  // I048/130
+        !skip (itemLength (uap[7], data + pos, length - pos), length, pos))
+        return 0;
+
+    if (f2 & 0x80)                      // I048/220
+    {
+        item = data + pos;
+        if (!skip (3, length, pos))
+            return 0;
+        plot.address_present = true;
+        plot.address = item_ui24 (item);
+    }
+    if (f2 & 0x40)                      // I048/240
+    {
+        item = data + pos;
+        if (!skip (6, length, pos))
+            return 0;
+        plot.identification_present = true;
+        item_idt (item, plot.identification);
+    }
+    if ((f2 & 0x20) &&                  // I048/250
+        !skip (itemLength (uap[10], data + pos, length - pos), length, pos))
+        return 0;
+    if (f2 & 0x10)                      // I048/161
+    {
+        item = data + pos;
+        if (!skip (2, length, pos))
+            return 0;
+        plot.track_number_present = true;
+        plot.track_number = item_mode_3a (item);
+    }
+    if ((f2 & 0x08) && !skip (4, length, pos))
+        return 0;                       // I048/042
+    if ((f2 & 0x04) && !skip (4, length, pos))
+        return 0;                       // I048/200
+    if ((f2 & 0x02) &&                  // I048/170
+        !skip (itemLength (uap[14], data + pos, length - pos), length, pos))
+        return 0;
+
+    pos = skipItems (uap, data, length, fspec, 2, pos);
+
+    return pos > fspec ? pos : 0;
+}
+
+inline size_t FastPath::decodeRecord (const t_Byte* data, size_t length, FastTrack& track)
+{
+    const FastItem* uap = uap062 ();
+    size_t fspec = fspecLength (data, length, MAX_FSPEC_062);
+    size_t pos = fspec;
+
+    if (fspec == 0)
+        return 0;
+
+    track.dsi_present = false;
+    track.time_present = false;
+    track.wgs84_present = false;
+    track.position_present = false;
+    track.velocity_present = false;
+    track.mode_3a_present = false;
+    track.identification_present = false;
+    track.address_present = false;
+    track.track_number_present = false;
+    track.flight_level_present = false;
+
+    // the data items of the first three FSPEC octets in UAP order, FRN 1
+    // to 21; the rest are skipped
+    unsigned int f1 = data[0];
+    unsigned int f2 = fspec > 1 ? data[1] : 0;
+    unsigned int f3 = fspec > 2 ? data[2] : 0;
+    const t_Byte* item;
+
+    if (f1 & 0x80)                      // I062/010
+    {
+        item = data + pos;
+        if (!skip (2, length, pos))
+            return 0;
+        track.dsi_present = true;
+        track.sac = item[0];
+        track.sic = item[1];
+    }
+    if (f1 & 0x40)                      // spare
+        return 0;
+    if ((f1 & 0x20) && !skip (1, length, pos))
+        return 0;                       // I062/015
+    if (f1 & 0x10)                      // I062/070
+    {
+        item = data + pos;
+        if (!skip (3, length, pos))
+            return 0;
+        track.time_present = true;
+        track.time = item_tod (item);
+    }
+    if (f1 & 0x08)                      // I062/105
+    {
+        item = data + pos;
+        if (!skip (8, length, pos))
+            return 0;
+        track.wgs84_present = true;
+        item_wgs84 (item, 4, 180.0 / M_TWO_POWER_25, &track.latitude, &track.longitude);
+        track.latitude *= M_DEG2RAD;
+        track.longitude *= M_DEG2RAD;
+    }
+    if (f1 & 0x04)                      // I062/100
+    {
+        item = data + pos;
+        if (!skip (6, length, pos))
+            return 0;
+        track.position_present = true;
+        item_cartesian (item, &track.x, &track.y);
+    }
+    if (f1 & 0x02)                      // I062/185
+    {
+        item = data + pos;
+        if (!skip (4, length, pos))
+            return 0;
+        track.velocity_present = true;
+        item_velocity (item, &track.vx, &track.vy);
+    }
+
+    if ((f2 & 0x80) && !skip (2, length, pos))
+        return 0;                       // I062/210
+    if (f2 & 0x40)                      // I062/060
+    {
+        item = data + pos;
+        if (!skip (2, length, pos))
+            return 0;
+        track.mode_3a_present = true;
+        track.mode_3a = item_mode_3a (item);
+        track.mode_3a_invalid = (item[0] & 0x80) != 0;
+        track.mode_3a_garbled = (item[0] & 0x40) != 0;
+        track.mode_3a_changed = (item[0] & 0x20) != 0;
+    }
+    if (f2 & 0x20)                      // I062/245
+    {
+        item = data + pos;
+        if (!skip (7, length, pos))
+            return 0;
+        track.identification_present = true;
+        item_idt (item + 1, track.identification);
+    }
+    if (f2 & 0x10)                      // I062/380
+    {
+        item = data + pos;
+        if (!skip (itemLength (uap[11], item, length - pos), length, pos))
+            return 0;
+
+        // ADR is the first subfield after the primary subfield
+        if (item[0] & 0x80)
+        {
+            size_t primary = 1;
+
+            while (item[primary - 1] & 0x01)
+                ++ primary;
+
+            track.address_present = true;
+            track.address = item_ui24 (item + primary);
+        }
+    }
+    if (f2 & 0x08)                      // I062/040
+    {
+        item = data + pos;
+        if (!skip (2, length, pos))
+            return 0;
+        track.track_number_present = true;
+        track.track_number = (t_Ui16) ((item[0] << 8) | item[1]);
+    }
+    if ((f2 & 0x04) &&                  // I062/080
+        !skip (itemLength (uap[13], data + pos, length - pos), length, pos))
+        return 0;
+    if ((f2 & 0x02) &&                  // I062/290
+        !skip (itemLength (uap[14], data + pos, length - pos), length, pos))
+        return 0;
+
+    if ((f3 & 0x80) && !skip (1, length, pos))
+        return 0;                       // I062/200
+    if ((f3 & 0x40) &&                  // I062/295
+        !skip (itemLength (uap[16], data + pos, length - pos), length, pos))
+        return 0;
+    if (f3 & 0x20)                      // I062/136
+    {
+        item = data + pos;
+        if (!skip (2, length, pos))
+            return 0;
+        track.flight_level_present = true;
+        track.flight_level = 25 * (t_Si32) item_altitude (item);
+    }
+    if ((f3 & 0x10) && !skip (2, length, pos))
+        return 0;                       // I062/130
+    if ((f3 & 0x08) && !skip (2, length, pos))
+        return 0;                       // I062/135
+    if ((f3 & 0x04) && !skip (2, length, pos))
+        return 0;                       // I062/220
+    if ((f3 & 0x02) &&                  // I062/390
+        !skip (itemLength (uap[21], data + pos, length - pos), length, pos))
+        return 0;
+
+    pos = skipItems (uap, data, length, fspec, 3, pos);
+
+    return pos > fspec ? pos : 0;
+}
+
+inline size_t FastPath::decodeRecord (const t_Byte* data, size_t length, FastAdsb& adsb)
+{
+    const FastItem* uap = uap021 ();
+    size_t fspec = fspecLength (data, length, MAX_FSPEC_021);
+    size_t pos = fspec;
+
+    if (fspec == 0)
+        return 0;
+
+    adsb.dsi_present = false;
+    adsb.track_number_present = false;
+    adsb.toa_position_present = false;
+    adsb.tor_position_present = false;
+    adsb.wgs84_present = false;
+    adsb.address_present = false;
+    adsb.mode_3a_present = false;
+    adsb.flight_level_present = false;
+    adsb.ground_vector_present = false;
+    adsb.identification_present = false;
+
+    // the data items of the first five FSPEC octets in UAP order, FRN 1
+    // to 35; the rest are skipped
+    unsigned int f1 = data[0];
+    unsigned int f2 = fspec > 1 ? data[1] : 0;
+    unsigned int f3 = fspec > 2 ? data[2] : 0;
+    unsigned int f4 = fspec > 3 ? data[3] : 0;
+    unsigned int f5 = fspec > 4 ? data[4] : 0;
+    const t_Byte* item;
+
+    if (f1 & 0x80)                      // I021/010
+    {
+        item = data + pos;
+        if (!skip (2, length, pos))
+            return 0;
+        adsb.dsi_present = true;
+        adsb.sac = item[0];
+        adsb.sic = item[1];
+    }
+    if ((f1 & 0x40) &&                  // I021/040
+        !skip (itemLength (uap[2], data + pos, length - pos), length, pos))
+        return 0;
+    if (f1 & 0x20)                      // I021/161
+    {
+        item = data + pos;
+        if (!skip (2, length, pos))
+            return 0;
+        adsb.track_number_present = true;
+        adsb.track_number = item_mode_3a (item);
+    }
+    if ((f1 & 0x10) && !skip (1, length, pos))
+        return 0;                       // I021/015
+    if (f1 & 0x08)                      // I021/071
+    {
+        item = data + pos;
+        if (!skip (3, length, pos))
+            return 0;
+        adsb.toa_position_present = true;
+        adsb.toa_position = item_tod (item);
+    }
+    if (f1 & 0x04)                      // I021/130
+    {
+        item = data + pos;
+        if (!skip (6, length, pos))
+            return 0;
+        wgs84 (item, false, adsb);
+    }
+    if (f1 & 0x02)                      // I021/131
+    {
+        item = data + pos;
+        if (!skip (8, length, pos))
+            return 0;
+        wgs84 (item, true, adsb);
+    }
+
+    if ((f2 & 0x80) && !skip (3, length, pos))
+        return 0;                       // I021/072
+    if ((f2 & 0x40) && !skip (2, length, pos))
+        return 0;                       // I021/150
+    if ((f2 & 0x20) && !skip (2, length, pos))
+        return 0;                       // I021/151
+    if (f2 & 0x10)                      // I021/080
+    {
+        item = data + pos;
+        if (!skip (3, length, pos))
+            return 0;
+        adsb.address_present = true;
+        adsb.address = item_ui24 (item);
+    }
+    if (f2 & 0x08)                      // I021/073
+    {
+        item = data + pos;
+        if (!skip (3, length, pos))
+            return 0;
+        adsb.tor_position_present = true;
+        adsb.tor_position = item_tod (item);
+    }
+    if ((f2 & 0x04) && !skip (4, length, pos))
+        return 0;                       // I021/074
+    if ((f2 & 0x02) && !skip (3, length, pos))
+        return 0;                       // I021/075
+
+    if ((f3 & 0x80) && !skip (4, length, pos))
+        return 0;                       // I021/076
+    if ((f3 & 0x40) && !skip (2, length, pos))
+        return 0;                       // I021/140
+    if ((f3 & 0x20) &&                  // I021/090
+        !skip (itemLength (uap[17], data + pos, length - pos), length, pos))
+        return 0;
+    if ((f3 & 0x10) && !skip (1, length, pos))
+        return 0;                       // I021/210
+    if (f3 & 0x08)                      // I021/070
+    {
+        item = data + pos;
+        if (!skip (2, length, pos))
+            return 0;
+        adsb.mode_3a_present = true;
+        adsb.mode_3a = item_mode_3a (item);
+    }
+    if ((f3 & 0x04) && !skip (2, length, pos))
+        return 0;                       // I021/230
+    if (f3 & 0x02)                      // I021/145
+    {
+        item = data + pos;
+        if (!skip (2, length, pos))
+            return 0;
+        adsb.flight_level_present = true;
+        adsb.flight_level = 25 * (t_Si32) item_altitude (item);
+    }
+
+    if ((f4 & 0x80) && !skip (2, length, pos))
+        return 0;                       // I021/152
+    if ((f4 & 0x40) && !skip (1, length, pos))
+        return 0;                       // I021/200
+    if ((f4 & 0x20) && !skip (2, length, pos))
+        return 0;                       // I021/155
+    if ((f4 & 0x10) && !skip (2, length, pos))
+        return 0;                       // I021/157
+    if (f4 & 0x08)                      // I021/160
+    {
+        item = data + pos;
+        if (!skip (4, length, pos))
+            return 0;
+        adsb.ground_vector_present = true;
+        item_ground_vector (item, &adsb.ground_speed, &adsb.track_angle);
+    }
+    if ((f4 & 0x04) && !skip (2, length, pos))
+        return 0;                       // I021/165
+    if ((f4 & 0x02) && !skip (3, length, pos))
+        return 0;                       // I021/077
+
+    if (f5 & 0x80)                      // I021/170
+    {
+        item = data + pos;
+        if (!skip (6, length, pos))
+            return 0;
+        adsb.identification_present = true;
+        item_idt (item, adsb.identification);
+    }
+    if ((f5 & 0x40) && !skip (1, length, pos))
+        return 0;                       // I021/020
+    if ((f5 & 0x20) &&                  // I021/220
+        !skip (itemLength (uap[31], data + pos, length - pos), length, pos))
+        return 0;
+    if ((f5 & 0x10) && !skip (2, length, pos))
+        return 0;                       // I021/146
+    if ((f5 & 0x08) && !skip (2, length, pos))
+        return 0;                       // I021/148
+    if ((f5 & 0x04) &&                  // I021/110
+        !skip (itemLength (uap[34], data + pos, length - pos), length, pos))
+        return 0;
+    if ((f5 & 0x02) && !skip (1, length, pos))
+        return 0;                       // I021/016
+
+    pos = skipItems (uap, data, length, fspec, 5, pos);
+
+    return pos > fspec ? pos : 0;
+}
+
+inline void FastPath::wgs84 (const t_Byte* item, bool high_precision, FastAdsb& adsb)
+{
+    t_Real lat;
+    t_Real lon;
+
+    if (high_precision)
+        item_wgs84 (item, 4, 180.0 / M_TWO_POWER_30, &lat, &lon);
+    else
+        item_wgs84 (item, 3, 180.0 / M_TWO_POWER_23, &lat, &lon);
+
+    // out of range positions are ignored, as by astx_021.cpp
+    if (lat >= -90.0 && lat <= 90.0 && lon >= -180.0 && lon <= 180.0)
+    {
+        adsb.wgs84_present = true;
+        adsb.wgs84_high_precision = high_precision;
+        adsb.latitude = M_DEG2RAD * lat;
+        adsb.longitude = M_DEG2RAD * lon;
+    }
+}
+
+inline bool FastPath::skip (size_t size, size_t length, size_t& pos)
+{
+    // a size of 0 is a data item in error
+    if (size == 0 || size > length - pos)
+        return false;
+
+    pos += size;
+    return true;
+}
+
+inline size_t FastPath::skipItems (const FastItem* uap, const t_Byte* data, size_t length,
+                                   size_t fspec, size_t first, size_t pos)
+{
+    for (size_t ix = first; ix < fspec; ix ++)
+    {
+        unsigned int bits = data[ix] & 0xfe;
+        int frn = static_cast<int> (7 * ix);
+
+        // up to the last data item of this FSPEC octet only
+        for (; bits != 0; bits = (bits << 1) & 0xff)
+        {
+            ++ frn;
+            if ((bits & 0x80) && !skip (itemLength (uap[frn], data + pos, length - pos), length, pos))
+                return 0;
+        }
+    }
+
+    return pos;
+}
+
+inline size_t FastPath::fspecLength (const t_Byte* data, size_t length, size_t max_length)
+{
+    size_t len = 0;
+
+    do
+    {
+        if (len >= length || len >= max_length)
+            return 0;
+    }
+    while (data[len ++] & 0x01);
+
+    return len;
+}
+
+inline size_t FastPath::itemLength (const FastItem& item, const t_Byte* data, size_t length)
+{
+    size_t len = 0;
+
+    // most data items have a fixed length
+    if (item.type == FAST_ITEM_FIXED)
+        return item.size <= length ? item.size : 0;
+
+    switch (item.type)
+    {
+    case FAST_ITEM_VARIABLE:
+        do
+        {
+            len += item.size;
+            if (len > length)
+                return 0;
+        }
+        while (data[len - 1] & 0x01);
+        break;
+    case FAST_ITEM_REPETITIVE:
+        if (length < 1)
+            return 0;
+        len = 1 + static_cast<size_t> (data[0]) * item.size;
+        break;
+    case FAST_ITEM_COMPOUND:
+        len = compoundLength (item, data, length);
+        break;
+    case FAST_ITEM_EXPLICIT:
+        if (length < 1)
+            return 0;
+        len = data[0];
+        break;
+    default:
+        return 0;
+    }
+
+    return len <= length ? len : 0;
+}
+
+inline size_t FastPath::compoundLength (const FastItem& item, const t_Byte* data, size_t length)
+{
+    size_t primary = 0;
+
+    do
+    {
+        if (primary >= length)
+            return 0;
+    }
+    while (data[primary ++] & 0x01);
+
+    size_t len = primary;
+
+    for (size_t ix = 0; ix < primary; ix ++)
+    {
+        for (int bit = 0; bit < 7; bit ++)
+        {
+            if (!(data[ix] & (0x80 >> bit)))
+                continue;
+
+            size_t sf = 7 * ix + bit;
+            if (sf >= item.size)
+                return 0;
+
+            int size = item.subfields[sf];
+            if (size < 0)
+            {
+                if (len >= length)
+                    return 0;
+                len += 1 + static_cast<size_t> (data[len]) * -size;
+            }
+            else
+                len += size;
+
+            if (len > length)
+                return 0;
+        }
+    }
+
+    return len;
+}
+
+inline const FastItem* FastPath::uap048 ()
+{
+    static const signed char i120[] = {2, -6};
+    static const signed char i130[] = {1, 1, 1, 1, 1, 1, 1};
+
+    static const FastItem uap[7 * MAX_FSPEC_048 + 1] = {
+        {FAST_ITEM_NONE, 0, nullptr},
+        {FAST_ITEM_FIXED, 2, nullptr},          // I048/010
+        {FAST_ITEM_FIXED, 3, nullptr},          // I048/140
+        {FAST_ITEM_VARIABLE, 1, nullptr},       // I048/020
+        {FAST_ITEM_FIXED, 4, nullptr},          // I048/040
+        {FAST_ITEM_FIXED, 2, nullptr},          // I048/070
+        {FAST_ITEM_FIXED, 2, nullptr},          // I048/090
+        {FAST_ITEM_COMPOUND, 7, i130},          // I048/130
+        {FAST_ITEM_FIXED, 3, nullptr},          // I048/220
+        {FAST_ITEM_FIXED, 6, nullptr},          // I048/240
+        {FAST_ITEM_REPETITIVE, 8, nullptr},     // I048/250
+        {FAST_ITEM_FIXED, 2, nullptr},          // I048/161
+        {FAST_ITEM_FIXED, 4, nullptr},          // I048/042
+        {FAST_ITEM_FIXED, 4, nullptr},          // I048/200
+        {FAST_ITEM_VARIABLE, 1, nullptr},       // I048/170
+        {FAST_ITEM_FIXED, 4, nullptr},          // I048/210
+        {FAST_ITEM_VARIABLE, 1, nullptr},       // I048/030
+        {FAST_ITEM_FIXED, 2, nullptr},          // I048/080
+        {FAST_ITEM_FIXED, 4, nullptr},          // I048/100
+        {FAST_ITEM_FIXED, 2, nullptr},          // I048/110
+        {FAST_ITEM_COMPOUND, 2, i120},          // I048/120
+        {FAST_ITEM_FIXED, 2, nullptr},          // I048/230
+        {FAST_ITEM_FIXED, 7, nullptr},          // I048/260
+        {FAST_ITEM_FIXED, 1, nullptr},          // I048/055
+        {FAST_ITEM_FIXED, 2, nullptr},          // I048/050
+        {FAST_ITEM_FIXED, 1, nullptr},          // I048/065
+        {FAST_ITEM_FIXED, 2, nullptr},          // I048/060
+        {FAST_ITEM_EXPLICIT, 0, nullptr},       // SP
+        {FAST_ITEM_EXPLICIT, 0, nullptr}        // RE
+    };
+
+    return uap;
+}
+
+inline const FastItem* FastPath::uap062 ()
+{
+    static const signed char i110[] = {1, 4, 6, 2, 2, 1, 1};
+    static const signed char i290[] = {1, 1, 1, 1, 2, 1, 1, 1, 1, 1};
+    static const signed char i295[] = {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                                       1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+    static const signed char i340[] = {2, 4, 2, 2, 2, 1};
+    static const signed char i380[] = {3, 6, 2, 2, 2, 2, 2, 1, -15, 2, 2, 7, 2, 2,
+                                       2, 2, 2, 2, 1, 8, 1, 6, 2, 1, -8, 2, 2, 2};
+    static const signed char i390[] = {2, 7, 4, 1, 4, 1, 4, 4, 3, 2, 2, -4, 6, 1,
+                                       7, 7, 2, 7};
+    static const signed char i500[] = {4, 2, 4, 1, 1, 2, 2, 1};
+
+    static const FastItem uap[7 * MAX_FSPEC_062 + 1] = {
+        {FAST_ITEM_NONE, 0, nullptr},
+        {FAST_ITEM_FIXED, 2, nullptr},          // I062/010
+        {FAST_ITEM_NONE, 0, nullptr},           // spare
+        {FAST_ITEM_FIXED, 1, nullptr},          // I062/015
+        {FAST_ITEM_FIXED, 3, nullptr},          // I062/070
+        {FAST_ITEM_FIXED, 8, nullptr},          // I062/105
+        {FAST_ITEM_FIXED, 6, nullptr},          // I062/100
+        {FAST_ITEM_FIXED, 4, nullptr},          // I062/185
+        {FAST_ITEM_FIXED, 2, nullptr},          // I062/210
+        {FAST_ITEM_FIXED, 2, nullptr},          // I062/060
+        {FAST_ITEM_FIXED, 7, nullptr},          // I062/245
+        {FAST_ITEM_COMPOUND, 28, i380},         // I062/380
+        {FAST_ITEM_FIXED, 2, nullptr},          // I062/040
+        {FAST_ITEM_VARIABLE, 1, nullptr},       // I062/080
+        {FAST_ITEM_COMPOUND, 10, i290},         // I062/290
+        {FAST_ITEM_FIXED, 1, nullptr},          // I062/200
+        {FAST_ITEM_COMPOUND, 31, i295},         // I062/295
+        {FAST_ITEM_FIXED, 2, nullptr},          // I062/136
+        {FAST_ITEM_FIXED, 2, nullptr},          // I062/130
+        {FAST_ITEM_FIXED, 2, nullptr},          // I062/135
+        {FAST_ITEM_FIXED, 2, nullptr},          // I062/220
+        {FAST_ITEM_COMPOUND, 18, i390},         // I062/390
+        {FAST_ITEM_VARIABLE, 1, nullptr},       // I062/270
+        {FAST_ITEM_FIXED, 1, nullptr},          // I062/300
+        {FAST_ITEM_COMPOUND, 7, i110},          // I062/110
+        {FAST_ITEM_FIXED, 2, nullptr},          // I062/120
+        {FAST_ITEM_VARIABLE, 3, nullptr},       // I062/510
+        {FAST_ITEM_COMPOUND, 8, i500},          // I062/500
+        {FAST_ITEM_COMPOUND, 6, i340},          // I062/340
+        {FAST_ITEM_NONE, 0, nullptr},           // spare
+        {FAST_ITEM_NONE, 0, nullptr},           // spare
+        {FAST_ITEM_NONE, 0, nullptr},           // spare
+        {FAST_ITEM_NONE, 0, nullptr},           // spare
+        {FAST_ITEM_NONE, 0, nullptr},           // spare
+        {FAST_ITEM_EXPLICIT, 0, nullptr},       // RE
+        {FAST_ITEM_EXPLICIT, 0, nullptr}        // SP
+    };
+
+    return uap;
+}
+
+inline const FastItem* FastPath::uap021 ()
+{
+    static const signed char i110[] = {1, -15};
+    static const signed char i220[] = {2, 2, 2, 1};
+    static const signed char i295[] = {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                                       1, 1, 1, 1, 1, 1, 1};
+
+    static const FastItem uap[7 * MAX_FSPEC_021 + 1] = {
+        {FAST_ITEM_NONE, 0, nullptr},
+        {FAST_ITEM_FIXED, 2, nullptr},          // I021/010
+        {FAST_ITEM_VARIABLE, 1, nullptr},       // I021/040
+        {FAST_ITEM_FIXED, 2, nullptr},          // I021/161
+        {FAST_ITEM_FIXED, 1, nullptr},          // I021/015
+        {FAST_ITEM_FIXED, 3, nullptr},          // I021/071
+        {FAST_ITEM_FIXED, 6, nullptr},          // I021/130
+        {FAST_ITEM_FIXED, 8, nullptr},          // I021/131
+        {FAST_ITEM_FIXED, 3, nullptr},          // I021/072
+        {FAST_ITEM_FIXED, 2, nullptr},          // I021/150
+        {FAST_ITEM_FIXED, 2, nullptr},          // I021/151
+        {FAST_ITEM_FIXED, 3, nullptr},          // I021/080
+        {FAST_ITEM_FIXED, 3, nullptr},          // I021/073
+        {FAST_ITEM_FIXED, 4, nullptr},          // I021/074
+        {FAST_ITEM_FIXED, 3, nullptr},          // I021/075
+        {FAST_ITEM_FIXED, 4, nullptr},          // I021/076
+        {FAST_ITEM_FIXED, 2, nullptr},          // I021/140
+        {FAST_ITEM_VARIABLE, 1, nullptr},       // I021/090
+        {FAST_ITEM_FIXED, 1, nullptr},          // I021/210
+        {FAST_ITEM_FIXED, 2, nullptr},          // I021/070
+        {FAST_ITEM_FIXED, 2, nullptr},          // I021/230
+        {FAST_ITEM_FIXED, 2, nullptr},          // I021/145
+        {FAST_ITEM_FIXED, 2, nullptr},          // I021/152
+        {FAST_ITEM_FIXED, 1, nullptr},          // I021/200
+        {FAST_ITEM_FIXED, 2, nullptr},          // I021/155
+        {FAST_ITEM_FIXED, 2, nullptr},          // I021/157
+        {FAST_ITEM_FIXED, 4, nullptr},          // I021/160
+        {FAST_ITEM_FIXED, 2, nullptr},          // I021/165
+        {FAST_ITEM_FIXED, 3, nullptr},          // I021/077
+        {FAST_ITEM_FIXED, 6, nullptr},          // I021/170
+        {FAST_ITEM_FIXED, 1, nullptr},          // I021/020
+        {FAST_ITEM_COMPOUND, 4, i220},          // I021/220
+        {FAST_ITEM_FIXED, 2, nullptr},          // I021/146
+        {FAST_ITEM_FIXED, 2, nullptr},          // I021/148
+        {FAST_ITEM_COMPOUND, 2, i110},          // I021/110
+        {FAST_ITEM_FIXED, 1, nullptr},          // I021/016
+        {FAST_ITEM_FIXED, 1, nullptr},          // I021/008
+        {FAST_ITEM_VARIABLE, 1, nullptr},       // I021/271
+        {FAST_ITEM_FIXED, 1, nullptr},          // I021/132
+        {FAST_ITEM_REPETITIVE, 8, nullptr},     // I021/250
+        {FAST_ITEM_FIXED, 7, nullptr},          // I021/260
+        {FAST_ITEM_FIXED, 1, nullptr},          // I021/400
+        {FAST_ITEM_COMPOUND, 23, i295},         // I021/295
+        {FAST_ITEM_NONE, 0, nullptr},           // spare
+        {FAST_ITEM_NONE, 0, nullptr},           // spare
+        {FAST_ITEM_NONE, 0, nullptr},           // spare
+        {FAST_ITEM_NONE, 0, nullptr},           // spare
+        {FAST_ITEM_NONE, 0, nullptr},           // spare
+        {FAST_ITEM_EXPLICIT, 0, nullptr},       // RE
+        {FAST_ITEM_EXPLICIT, 0, nullptr}        // SP
+    };
+
+    return uap;
+}
+
+#endif // FASTPATH_H
@@ -0,0 +1,213 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "fastpath.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <initializer_list>
+#include <vector>
+
+/*
+ * Latency of the fast path decoder per record, for data blocks of
+ * typical CAT048 Mode S plots, CAT062 system tracks and CAT021 ADS-B
+ * reports:
+ *
+ *     sddl_fastpath_bench [iterations]
+ */
+
+namespace
+{
+
+const size_t records_per_block = 100;
+const int rounds = 5;
+
+struct Checksum
+{
+    size_t records {0};
+    double sum {0.0};
+
+    void operator() (const FastPlot& plot)
+    {
+        ++records;
+        sum += plot.time + plot.range + plot.mode_c_height + plot.address + plot.identification[0];
+    }
+
+    void operator() (const FastTrack& track)
+    {
+        ++records;
+        sum += track.time + track.latitude + track.x + track.vx + track.track_number + track.identification[0];
+    }
+
+    void operator() (const FastAdsb& adsb)
+    {
+        ++records;
+        sum += adsb.toa_position + adsb.latitude + adsb.flight_level + adsb.ground_speed + adsb.identification[0];
+    }
+};
+
+void append (std::vector<t_Byte>& data, std::initializer_list<int> octets)
+{
+    for (int octet : octets)
+        data.push_back (static_cast<t_Byte> (octet));
+}
+
+// I048/010, 140, 020, 040, 070, 090, 130, 220, 240, 161, 042, 200, 170, 230
+void plotRecord (std::vector<t_Byte>& data, int ix)
+{
+    append (data, {0xff, 0xdf, 0x02});
+    append (data, {0x08, 0x11});
+    append (data, {0x3c, 0x00, ix & 0xff});
+    append (data, {0xa0});
+    append (data, {0x2a, ix & 0xff, 0x40, 0x00});
+    append (data, {0x0a, 0x2b});
+    append (data, {0x00, 0x8c});
+    append (data, {0xe0, 0x40, 0x42, 0x5c});
+    append (data, {0x3c, 0x66, ix & 0xff});
+    append (data, {0x0c, 0x54, 0x31, 0xd3, 0x4c, 0x20});
+    append (data, {0x01, ix & 0xff});
+    append (data, {0x01, 0x20, 0xfe, 0x10});
+    append (data, {0x08, 0x9a, 0x30, 0x00});
+    append (data, {0x40});
+    append (data, {0x20, 0xfd});
+}
+
+// I062/010, 015, 070, 105, 100, 185, 060, 245, 380, 040, 080, 290, 200,
+// 136, 130, 220
+void trackRecord (std::vector<t_Byte>& data, int ix)
+{
+    append (data, {0xbf, 0x7f, 0xb4});
+    append (data, {0x19, 0x01});
+    append (data, {0x00});
+    append (data, {0x3c, 0x00, ix & 0xff});
+    append (data, {0x00, 0x7c, 0x8e, 0x3a, 0x00, 0x0b, 0x2f, ix & 0xff});
+    append (data, {0x00, 0x12, ix & 0xff, 0xff, 0xe3, 0x10});
+    append (data, {0x03, 0x20, 0xfe, 0x70});
+    append (data, {0x0a, 0x2b});
+    append (data, {0x00, 0x0c, 0x54, 0x31, 0xd3, 0x4c, 0x20});
+    append (data, {0xc0, 0x3c, 0x66, ix & 0xff, 0x0c, 0x54, 0x31, 0xd3, 0x4c, 0x20});
+    append (data, {0x10, ix & 0xff});
+    append (data, {0x41, 0x00});
+    append (data, {0x80, 0x04});
+    append (data, {0x00});
+    append (data, {0x01, 0x18});
+    append (data, {0x02, 0xd0});
+    append (data, {0x00, 0x00});
+}
+
+// I021/010, 040, 161, 015, 071, 130, 131, 080, 073, 075, 140, 090, 210,
+// 070, 145, 200, 155, 160, 077, 170, 020, 146, 148
+void adsbRecord (std::vector<t_Byte>& data, int ix)
+{
+    append (data, {0xff, 0x1b, 0x7b, 0x6b, 0xd8});
+    append (data, {0x19, 0x02});
+    append (data, {0x01, 0x00});
+    append (data, {0x00, ix & 0xff});
+    append (data, {0x00});
+    append (data, {0x3c, 0x00, ix & 0xff});
+    append (data, {0x23, 0x1f, 0x44, 0x04, 0x5d, ix & 0xff});
+    append (data, {0x0c, 0x7c, 0x8e, 0x3a, 0x01, 0x17, 0x42, ix & 0xff});
+    append (data, {0x3c, 0x66, ix & 0xff});
+    append (data, {0x3c, 0x00, 0x80});
+    append (data, {0x3c, 0x00, 0x40});
+    append (data, {0x04, 0x6a});
+    append (data, {0x01, 0x00});
+    append (data, {0x12});
+    append (data, {0x0a, 0x2b});
+    append (data, {0x01, 0x18});
+    append (data, {0x00});
+    append (data, {0x00, 0x00});
+    append (data, {0x00, 0xe4, 0x5a, 0x3c});
+    append (data, {0x3c, 0x00, 0x40});
+    append (data, {0x0c, 0x54, 0x31, 0xd3, 0x4c, 0x20});
+    append (data, {0x10});
+    append (data, {0x01, 0x18});
+    append (data, {0x01, 0x18});
+}
+
+std::vector<t_Byte> dataBlock (int category, void (*record) (std::vector<t_Byte>&, int))
+{
+    std::vector<t_Byte> data;
+
+    append (data, {category, 0x00, 0x00});
+    for (size_t ix = 0; ix < records_per_block; ix ++)
+        record (data, static_cast<int> (ix));
+
+    data[1] = static_cast<t_Byte> (data.size() >> 8);
+    data[2] = static_cast<t_Byte> (data.size() & 0xff);
+
+    return data;
+}
+
+bool run (const char* name, const std::vector<t_Byte>& data, long iterations)
+{
+    Checksum checksum;
+    bool ok = true;
+    double best = 0.0;
+
+    // warm up the caches and the branch predictors
+    for (long ix = 0; ix < iterations / 10 + 1; ix ++)
+        ok = FastPath::decode (data.data(), data.size(), checksum) && ok;
+
+    checksum = Checksum ();
+
+    // the fastest round, least disturbed by other processes
+    for (int round = 0; round < rounds; round ++)
+    {
+        auto start = std::chrono::steady_clock::now ();
+        for (long ix = 0; ix < iterations; ix ++)
+            ok = FastPath::decode (data.data(), data.size(), checksum) && ok;
+        auto stop = std::chrono::steady_clock::now ();
+
+        double ns = std::chrono::duration<double, std::nano> (stop - start).count ();
+        if (round == 0 || ns < best)
+            best = ns;
+    }
+
+    printf ("%-6s %4zu octets/block %6.1f ns/record  (checksum %.6g)\n",
+            name, data.size(), best / (iterations * records_per_block), checksum.sum);
+
+    return ok && checksum.records == rounds * iterations * records_per_block;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    long iterations = argc > 1 ? atol (argv[1]) : 10000;
+
+    if (iterations <= 0)
+    {
+        fprintf (stderr, "Usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    bool ok = true;
+
+    ok = run ("CAT048", dataBlock (48, plotRecord), iterations) && ok;
+    ok = run ("CAT062", dataBlock (62, trackRecord), iterations) && ok;
+    ok = run ("CAT021", dataBlock (21, adsbRecord), iterations) && ok;
+
+    if (!ok)
+    {
+        fprintf (stderr, "Records in error\n");
+        return 1;
+    }
+
+    return 0;
+}
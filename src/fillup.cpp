@@ -29,6 +29,8 @@
                    /* Common declarations and definitions */
 
 #include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
 
                    /* Local macros: */
                    /* ------------- */
@@ -40,21 +42,103 @@
                    /* Threshold for condition in case 2 */
                    /* Each unit corresponds to 2 seconds */
 
+#define M_TOD_TABLE_SIZE 1024
+                   /* Size of the table of time of day states; must be
+                      a power of two and should be well above the
+                      number of (line, SAC/SIC) combinations */
+
+                   /* Local data types: */
+                   /* ----------------- */
+
+                   /* Time of day reconstruction state per source: */
+typedef struct
+{
+	t_Bool after_midnight;
+                   /* Just after midnight */
+	t_Ui32 key;    /* Line number and SAC/SIC (see tod_key()),
+                      or zero for a free entry */
+	t_Ui32 last_tod;
+                   /* Last (full) time of day; 1/128 seconds */
+	t_Bool last_tod_available;
+                   /* Last time of day available */
+} t_Tod_State;
+
                    /* Local data: */
                    /* ----------- */
 
 static const t_Byte max_ub0_after_midnight = 1;
                    /* For fill-up of partial time of day in ASTERIX */
+static t_Tod_State program_tod_table[M_TOD_TABLE_SIZE];
+                   /* Time of day states of the program */
+static t_Tod_State *tod_table = program_tod_table;
+                   /* Time of day states per (line, SAC/SIC) in use;
+                      open addressing with linear probing */
+
+                   /* Local functions: */
+                   /* ---------------- */
+
+static t_Tod_State *find_tod_state (t_Ui16 dsi, t_Bool create);
+                   /* Find (or create) time of day state of a source */
+static t_Ui32 tod_key (t_Ui16 dsi);
+                   /* Key for time of day state of a source */
+
+/*----------------------------------------------------------------------------*/
+/* clear_tod_table -- Clear a table of time of day states                     */
+/*----------------------------------------------------------------------------*/
+
+ void clear_tod_table (t_Pntr tbl_ptr)
+{
+                   /* Check parameters: */
+	Assert (tbl_ptr != NULL, "Invalid parameter");
+
+	memset (tbl_ptr, 0, M_TOD_TABLE_SIZE * sizeof (t_Tod_State));
+
+	return;
+}
+
+/*----------------------------------------------------------------------------*/
+/* create_tod_table -- Create an (empty) table of time of day states          */
+/*----------------------------------------------------------------------------*/
+
+ t_Pntr create_tod_table (void)
+{
+	t_Pntr tbl_ptr;
+                   /* Pointer to table */
+
+	tbl_ptr = calloc (M_TOD_TABLE_SIZE, sizeof (t_Tod_State));
+	Assert (tbl_ptr != NULL, "Not enough memory");
+
+	return tbl_ptr;
+}
+
+/*----------------------------------------------------------------------------*/
+/* delete_tod_table -- Delete a table of time of day states                   */
+/*----------------------------------------------------------------------------*/
+
+ void delete_tod_table (t_Pntr tbl_ptr)
+{
+                   /* Check parameters: */
+	Assert (tbl_ptr != (t_Pntr) tod_table, "Table of time of day states in use");
+
+	free (tbl_ptr);
+
+	return;
+}
 
 /*----------------------------------------------------------------------------*/
 /* fillup_tod      -- Fill up truncated time of day                           */
 /*----------------------------------------------------------------------------*/
 
- t_Retc fillup_tod (t_Ui16 partial_tod, t_Ui32 *tod_ptr)
+ t_Retc fillup_tod (t_Bool dsi_present, t_Ui16 dsi,
+                    t_Ui16 partial_tod, t_Ui32 *tod_ptr)
 {
+	t_Bool amn;    /* Just after midnight */
 	t_Bool c2_new; /* Condition for case 2 (new implementation) */
+	t_Ui32 ltod;   /* Last (full) time of day; 1/128 seconds */
 	t_Bool merged; /* Values successfully merged */
 	t_Retc ret;    /* Return code */
+	t_Tod_State *sp;
+                   /* Time of day state of this source, if any */
 	t_Ui32 tod;    /* Full time of day; 1/128 seconds */
 	t_Si16 ub_diff;
                    /* Absolute difference in upper bytes */
@@ -67,19 +151,43 @@ static const t_Byte max_ub0_after_midnight = 1;
                    /* Check parameters: */
 	Assert (tod_ptr != NULL, "Invalid parameter");
 
-                   /* Is last time of day available ? */
-	if (!last_tod_available)
+                   /* Use the time of day state of this source,
+                      if known - else fall back to the last time
+                      of day of any source: */
+	sp = NULL;
+	if (dsi_present)
 	{
-		ret = RC_SKIP;
-    	goto done;
+		sp = find_tod_state (dsi, FALSE);
+		if (sp != NULL && !sp->last_tod_available)
+		{
+			sp = NULL;
+		}
+	}
+
+	if (sp != NULL)
+	{
+		amn = sp->after_midnight;
+		ltod = sp->last_tod;
+	}
+	else
+	{
+                   /* Is last time of day available ? */
+		if (!last_tod_available)
+		{
+			ret = RC_SKIP;
+			goto done;
+		}
+
+		amn = after_midnight;
+		ltod = last_tod;
 	}
 
                    /* Extract the missing byte: */
-	tod = last_tod & 0x00ff0000;
+	tod = ltod & 0x00ff0000;
 
                    /* Extract upper byte of the two values
                       to be merged: */
-	ub0 = (t_Byte) ((last_tod >> 8) & 0x000000ff);
+	ub0 = (t_Byte) ((ltod >> 8) & 0x000000ff);
 	ub1 = (t_Byte) ((partial_tod >> 8) & 0x00ff);
 
                    /* Evaluate condition for case 2: */
@@ -108,7 +216,7 @@ static const t_Byte max_ub0_after_midnight = 1;
                    /* Case 2: Upper bytes fit (somehow) */
 	else if (c2_new)
 	{
-		if (after_midnight &&
+		if (amn &&
             ub0 <= max_ub0_after_midnight && ub1 >= 0xbd)
         {
                    /* Go back before midnight (which is 0x00a8c000) */
@@ -120,7 +228,7 @@ static const t_Byte max_ub0_after_midnight = 1;
 
 			if (partial_tod > (t_Ui16) 0xfa00)
 			{
-				if ((t_Ui16) (last_tod & 0x0000ffff) < 0x0500)
+				if ((t_Ui16) (ltod & 0x0000ffff) < 0x0500)
 				{
 					tod -= 0x00010000;
 				}
@@ -137,7 +245,7 @@ static const t_Byte max_ub0_after_midnight = 1;
 	}
 
                    /* Case 4: Crossing midnight */
-	else if ((last_tod & 0x00ffff00) >= 0x00a8bd00)
+	else if ((ltod & 0x00ffff00) >= 0x00a8bd00)
 	{
 		tod = (t_Time) partial_tod;
 		merged = TRUE;
@@ -151,18 +259,30 @@ static const t_Byte max_ub0_after_midnight = 1;
 	}
 
                    /* Update last time of day, if higher/later: */
-	if (tod > last_tod)
+	if (tod > ltod)
     {
-		if (!after_midnight || (tod <= M_AFTER_MIDNIGHT))
+		if (!amn || (tod <= M_AFTER_MIDNIGHT))
 		{
-			last_tod = tod;
+			ltod = tod;
 		}
-        after_midnight = (last_tod <= M_AFTER_MIDNIGHT);
+        amn = (ltod <= M_AFTER_MIDNIGHT);
                    /* This is necessary especially with long-period
                       north-marker-only radars where radar service
                       messages (with full time of day) are sparse */
 	}
 
+                   /* Save the state: */
+	if (sp != NULL)
+	{
+		sp->after_midnight = amn;
+		sp->last_tod = ltod;
+	}
+	else
+	{
+		after_midnight = amn;
+		last_tod = ltod;
+	}
+
                    /* Set the return value: */
 	*tod_ptr = tod;
 
@@ -172,4 +292,118 @@ static const t_Byte max_ub0_after_midnight = 1;
 	done:          /* We are done */
 	return ret;
 }
+
+/*----------------------------------------------------------------------------*/
+/* find_tod_state  -- Find (or create) time of day state of a source          */
+/*----------------------------------------------------------------------------*/
+
+ static
+ t_Tod_State *find_tod_state (t_Ui16 dsi, t_Bool create)
+{
+	t_Ui32 ix;     /* Index into table */
+	t_Ui32 key;    /* Key of this source */
+	t_Ui32 n;      /* Number of probes */
+	t_Tod_State *sp;
+                   /* Time of day state */
+
+                   /* Preset the return value: */
+	sp = NULL;
+
+	key = tod_key (dsi);
+	ix = ((key * 2654435761U) >> 16) & (M_TOD_TABLE_SIZE - 1);
+	for (n = 0; n < M_TOD_TABLE_SIZE; n ++)
+	{
+		if (tod_table[ix].key == key)
+		{
+			sp = &(tod_table[ix]);
+			break;
+		}
+
+		if (tod_table[ix].key == 0)
+		{
+			if (create)
+			{
+				sp = &(tod_table[ix]);
+				memset (sp, 0, sizeof (t_Tod_State));
+				sp->key = key;
+			}
+			break;
+		}
+
+		ix = (ix + 1) & (M_TOD_TABLE_SIZE - 1);
+	}
+                   /* If the table is full, the caller will fall back
+                      to the global last time of day */
+
+	return sp;
+}
+
+/*----------------------------------------------------------------------------*/
+/* remember_tod    -- Remember full time of day of a source                   */
+/*----------------------------------------------------------------------------*/
+
+ void remember_tod (t_Bool dsi_present, t_Ui16 dsi, t_Ui32 tod)
+{
+	t_Tod_State *sp;
+                   /* Time of day state of this source */
+
+                   /* Last time of day of any source: */
+	last_tod_available = TRUE;
+	last_tod = tod;
+
+                   /* Last time of day of this source: */
+	if (dsi_present)
+	{
+		sp = find_tod_state (dsi, TRUE);
+		if (sp != NULL)
+		{
+			sp->last_tod_available = TRUE;
+			sp->last_tod = tod;
+		}
+	}
+
+	return;
+}
+
+/*----------------------------------------------------------------------------*/
+/* select_tod_table -- Select the table of time of day states in use          */
+/*----------------------------------------------------------------------------*/
+
+ t_Pntr select_tod_table (t_Pntr tbl_ptr)
+{
+	t_Pntr prev_ptr;
+                   /* Table in use before */
+
+	prev_ptr = (t_Pntr) tod_table;
+
+                   /* NULL is the table of the program: */
+	tod_table = (tbl_ptr != NULL ? (t_Tod_State *) tbl_ptr
+                                 : program_tod_table);
+
+	return (prev_ptr == (t_Pntr) program_tod_table ? NULL : prev_ptr);
+}
+
+/*----------------------------------------------------------------------------*/
+/* tod_key         -- Key for time of day state of a source                   */
+/*----------------------------------------------------------------------------*/
+
+ static
+ t_Ui32 tod_key (t_Ui16 dsi)
+{
+	t_Ui32 key;
+	t_Ui32 line;   /* Line number plus one (zero if not known) */
+
+	line = 0;
+	if (current_line_number_defined &&
+        0 <= current_line_number && current_line_number < 0x7fff)
+	{
+		line = (t_Ui32) (current_line_number + 1);
+	}
+
+                   /* Highest bit set, so that zero can mark a free
+                      table entry: */
+	key = 0x80000000 | (line << 16) | dsi;
+
+	return key;
+}
 /* end-of-file */
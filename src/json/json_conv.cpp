@@ -18,7 +18,8 @@
 #include "json_conv.h"
 #include "common.h"
 
-void convertToJSON (t_Tres& tres, const std::string& name, nlohmann::json& parent)
+template <typename J>
+void convertToJSON (t_Tres& tres, const char* name, J& parent)
 {
     switch (tres)
     {
@@ -40,7 +41,8 @@ void convertToJSON (t_Tres& tres, const std::string& name, nlohmann::json& paren
 
 }
 
-void convertToJSON (t_Rsrv_Type& rsrv, const std::string& name, nlohmann::json& parent)
+template <typename J>
+void convertToJSON (t_Rsrv_Type& rsrv, const char* name, J& parent)
 {
     switch (rsrv)
     {
@@ -73,7 +75,8 @@ void convertToJSON (t_Rsrv_Type& rsrv, const std::string& name, nlohmann::json&
 
 }
 
-void convertToJSON (t_Target_Address_Enum_Type& ta_type, const std::string& name, nlohmann::json& parent)
+template <typename J>
+void convertToJSON (t_Target_Address_Enum_Type& ta_type, const char* name, J& parent)
 {
     switch (ta_type)
     {
@@ -99,4 +102,10 @@ void convertToJSON (t_Target_Address_Enum_Type& ta_type, const std::string& name
     }
 }
 
+template void convertToJSON<nlohmann::json> (t_Tres&, const char*, nlohmann::json&);
+template void convertToJSON<nlohmann::json> (t_Rsrv_Type&, const char*, nlohmann::json&);
+template void convertToJSON<nlohmann::json> (t_Target_Address_Enum_Type&, const char*, nlohmann::json&);
 
+template void convertToJSON<JSONStreamNode> (t_Tres&, const char*, JSONStreamNode&);
+template void convertToJSON<JSONStreamNode> (t_Rsrv_Type&, const char*, JSONStreamNode&);
+template void convertToJSON<JSONStreamNode> (t_Target_Address_Enum_Type&, const char*, JSONStreamNode&);
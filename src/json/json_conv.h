@@ -21,10 +21,14 @@
 #include "common_data_types.h"
 
 #include "json.hpp"
+#include "jsonstreamwriter.h"
 
-extern void convertToJSON (t_Tres& tres, const std::string& name, nlohmann::json& parent);
-extern void convertToJSON (t_Rsrv_Type& rsrv, const std::string& name, nlohmann::json& parent);
-extern void convertToJSON (t_Target_Address_Enum_Type& ta_type, const std::string& name,
-                           nlohmann::json& parent);
+// instantiated for nlohmann::json and JSONStreamNode
+template <typename J>
+void convertToJSON (t_Tres& tres, const char* name, J& parent);
+template <typename J>
+void convertToJSON (t_Rsrv_Type& rsrv, const char* name, J& parent);
+template <typename J>
+void convertToJSON (t_Target_Address_Enum_Type& ta_type, const char* name, J& parent);
 
 #endif // JSON_CONV_H
@@ -0,0 +1,227 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "jsonfields.h"
+#include "json.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <set>
+#include <sstream>
+
+const JSONFieldNode::Member* JSONFieldNode::find (const char* key, std::size_t length) const
+{
+    // a profile lists a few members per object, a hash would not pay off
+    for (const Member& member : members)
+    {
+        if (member.key.size() == length && memcmp (member.key.data(), key, length) == 0)
+            return &member;
+    }
+
+    return nullptr;
+}
+
+template <typename T>
+static void addKeys (std::set<std::string>& keys)
+{
+    // value-initialised, so nothing is present and every member is null
+    std::unique_ptr<T> report (new T ());
+    nlohmann::json j;
+
+    report->toJSON (j);
+
+    for (auto it = j.begin(); it != j.end(); ++it)
+        keys.insert (it.key());
+}
+
+// the members a report of this type may have
+static std::set<std::string> reportKeys (t_Object_Type type)
+{
+    std::set<std::string> keys {"rec_num"};
+    bool nulls = write_json_nulls;
+
+    write_json_nulls = true;
+
+    switch (type)
+    {
+    case e_object_adsb:
+        addKeys<t_Adsb> (keys);
+        break;
+    case e_object_mlat:
+        addKeys<t_Mlat> (keys);
+        break;
+    case e_object_rsrv:
+        addKeys<t_Rsrv> (keys);
+        break;
+    case e_object_rtgt:
+        addKeys<t_Rtgt> (keys);
+        break;
+    case e_object_strk:
+        addKeys<t_Strk> (keys);
+        break;
+    default:
+        break;
+    }
+
+    write_json_nulls = nulls;
+
+    // BDS registers are written under their own keys, only if present
+    if (type == e_object_adsb || type == e_object_mlat || type == e_object_rtgt || type == e_object_strk)
+    {
+        for (const char* key : json_bds_keys)
+            keys.insert (key);
+    }
+
+    return keys;
+}
+
+// adds the member at path (keys joined by '.') to node
+static void addMember (JSONFieldNode& node, const std::string& path, const std::string& name)
+{
+    size_t dot = path.find ('.');
+    std::string key = path.substr (0, dot);
+
+    JSONFieldNode::Member* member = nullptr;
+
+    for (JSONFieldNode::Member& m : node.members)
+    {
+        if (m.key == key)
+            member = &m;
+    }
+
+    bool is_new = member == nullptr;
+
+    if (is_new)
+    {
+        node.members.push_back ({key, key, nullptr});
+        member = &node.members.back();
+    }
+
+    if (dot == std::string::npos)
+    {
+        // wanted with all its members
+        member->fields.reset();
+
+        if (!name.empty())
+            member->name = name;
+        return;
+    }
+
+    // only some members of an object already wanted in full are listed
+    if (!is_new && !member->fields)
+        return;
+
+    if (!member->fields)
+        member->fields.reset (new JSONFieldNode);
+
+    addMember (*member->fields, path.substr (dot + 1), name);
+}
+
+bool JSONFields::load (const std::string& path)
+{
+    static const struct
+    {
+        const char* name;
+        t_Object_Type type;
+    } sections[] = {
+        {"adsb", e_object_adsb},
+        {"mlat", e_object_mlat},
+        {"rsrv", e_object_rsrv},
+        {"rtgt", e_object_rtgt},
+        {"strk", e_object_strk}
+    };
+
+    std::ifstream file (path);
+
+    if (!file)
+    {
+        printf ("-> Cannot open JSON field profile '%s'\n", path.c_str());
+        return false;
+    }
+
+    std::unique_ptr<JSONFieldNode> types[e_object_sentinel];
+    JSONFieldNode* section = nullptr;
+    std::set<std::string> keys;
+    std::string line;
+    unsigned int line_number = 0;
+
+    while (std::getline (file, line))
+    {
+        ++line_number;
+
+        line = line.substr (0, line.find ('#'));
+
+        std::istringstream words (line);
+        std::string field;
+        std::string name;
+        std::string rest;
+
+        if (!(words >> field))
+            continue;
+
+        if (field.front() == '[')
+        {
+            section = nullptr;
+
+            for (const auto& s : sections)
+            {
+                if (field == std::string ("[") + s.name + "]")
+                {
+                    if (!types[s.type])
+                        types[s.type].reset (new JSONFieldNode);
+                    section = types[s.type].get();
+                    keys = reportKeys (s.type);
+                }
+            }
+
+            if (!section)
+            {
+                printf ("-> JSON field profile '%s' line %u: unknown report type %s\n",
+                        path.c_str(), line_number, field.c_str());
+                return false;
+            }
+            continue;
+        }
+
+        words >> name >> rest;
+
+        if (!section || !rest.empty() || field.front() == '.' || field.back() == '.' ||
+            field.find ("..") != std::string::npos)
+        {
+            printf ("-> JSON field profile '%s' line %u: invalid field '%s'\n",
+                    path.c_str(), line_number, line.c_str());
+            return false;
+        }
+
+        // a typing error would silently leave the member out
+        if (!keys.count (field.substr (0, field.find ('.'))))
+        {
+            printf ("-> JSON field profile '%s' line %u: unknown field '%s'\n",
+                    path.c_str(), line_number, field.c_str());
+            return false;
+        }
+
+        addMember (*section, field, name);
+    }
+
+    for (size_t type = 0; type < e_object_sentinel; ++type)
+        types_[type] = std::move (types[type]);
+
+    return true;
+}
@@ -0,0 +1,88 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSONFIELDS_H
+#define JSONFIELDS_H
+
+#include "global.h"
+#include "basics.h"
+
+#include "common.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+ * Members of a JSON object to be written, each under its own or another
+ * name, with the members wanted of a nested object. An object wanted with
+ * all its members has no JSONFieldNode of its own.
+ */
+
+struct JSONFieldNode
+{
+    struct Member
+    {
+        std::string key;
+        std::string name;
+        std::unique_ptr<JSONFieldNode> fields;
+    };
+
+    std::vector<Member> members;
+
+    // nullptr if the member is not wanted
+    const Member* find (const char* key, std::size_t length) const;
+};
+
+/*
+ * Projection of the JSON output onto the members its consumers use, read
+ * from a profile (-json-fields=) like
+ *
+ *     # radar target reports
+ *     [rtgt]
+ *     data_source_identifier
+ *     detection_time          tod
+ *     mode_3_info.code        squawk
+ *
+ * with a section per report type (adsb, mlat, rsrv, rtgt, strk) listing
+ * the wanted members by their JSON key, a member of a nested object by
+ * the keys joined by '.', optionally followed by the name to write it
+ * under. "rec_num" is a member like the others. Reports of a type without
+ * a section are written in full. A profile listing a member its report
+ * type does not have is rejected; of a nested object, only the first key
+ * is checked, as the members below depend on the data.
+ *
+ * The projection is applied by JSONStreamWriter while the report is
+ * converted: nothing is written for a member that is not wanted, nor for
+ * anything below it.
+ */
+
+class JSONFields
+{
+public:
+    // false if the profile cannot be read, the projection is unchanged then
+    bool load (const std::string& path);
+
+    // members wanted of a report of this type, nullptr for all
+    const JSONFieldNode* fields (t_Object_Type type) const { return types_[type].get(); }
+
+private:
+    std::unique_ptr<JSONFieldNode> types_[e_object_sentinel];
+};
+
+#endif // JSONFIELDS_H
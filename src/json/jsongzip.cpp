@@ -0,0 +1,110 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "jsongzip.h"
+
+#include <cassert>
+#include <tbb/parallel_for.h>
+#include <zlib.h>
+
+// window bits for deflateInit2() selecting the gzip wrapper
+const int GZIP_WINDOW_BITS = 15 + 16;
+
+// Z_OK, or the zlib error code; member is then incomplete
+static int compressMember (const std::vector <std::string>& data, size_t begin, size_t end,
+                           std::string& member, int level)
+{
+    z_stream stream {};
+
+    int ret = deflateInit2 (&stream, level, Z_DEFLATED, GZIP_WINDOW_BITS, 8, Z_DEFAULT_STRATEGY);
+    if (ret != Z_OK)
+        return ret;
+
+    uLong size = 0;
+    for (size_t cnt = begin; cnt < end; cnt++)
+        size += data[cnt].size();
+
+    member.resize (deflateBound (&stream, size));
+
+    stream.next_out = reinterpret_cast<Bytef*> (&member[0]);
+    stream.avail_out = member.size();
+
+    for (size_t cnt = begin; cnt < end; cnt++)
+    {
+        stream.next_in = reinterpret_cast<Bytef*> (const_cast<char*> (data[cnt].data()));
+        stream.avail_in = data[cnt].size();
+
+        ret = deflate (&stream, cnt + 1 == end ? Z_FINISH : Z_NO_FLUSH);
+
+        // deflateBound() leaves enough room to consume all input in one go
+        if (ret == Z_STREAM_ERROR || stream.avail_in != 0)
+            break;
+    }
+
+    if (ret == Z_STREAM_END)
+    {
+        member.resize (stream.total_out);
+        ret = Z_OK;
+    }
+    else if (ret == Z_OK)
+        ret = Z_BUF_ERROR;
+
+    deflateEnd (&stream);
+
+    return ret;
+}
+
+int compressGzipMembers (const std::vector <std::string>& data, std::vector <std::string>& members,
+                         size_t block_size, int level)
+{
+    assert (!members.size());
+
+    // first buffer of each block, plus the end
+    std::vector <size_t> blocks {0};
+    size_t bytes = 0;
+
+    for (size_t cnt = 0; cnt < data.size(); cnt++)
+    {
+        bytes += data[cnt].size();
+
+        if (bytes >= block_size || cnt + 1 == data.size())
+        {
+            blocks.push_back (cnt + 1);
+            bytes = 0;
+        }
+    }
+
+    members.resize (blocks.size() - 1);
+
+    std::vector <int> results (members.size(), Z_OK);
+
+    tbb::parallel_for( size_t(0), members.size(), [&]( size_t block )
+    {
+        results[block] = compressMember (data, blocks[block], blocks[block + 1], members[block], level);
+    } );
+
+    for (int ret : results)
+    {
+        if (ret != Z_OK)
+        {
+            members.clear();
+            return ret;
+        }
+    }
+
+    return Z_OK;
+}
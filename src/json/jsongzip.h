@@ -0,0 +1,40 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSONGZIP_H
+#define JSONGZIP_H
+
+#include <string>
+#include <vector>
+
+/*
+ * Compresses a batch of output buffers into gzip members, in parallel.
+ *
+ * Consecutive buffers are grouped into blocks of at least block_size
+ * bytes, and every block becomes a complete gzip member of its own. As
+ * the members do not depend on each other they are compressed on all
+ * TBB worker threads, and members holds them in the order of the input.
+ * A file made of concatenated members is a valid gzip file (RFC 1952),
+ * which gzip, zcat and zlib's gzread() read as one stream.
+ */
+
+// Z_OK, or the zlib error code of a member which could not be compressed;
+// members is then empty
+int compressGzipMembers (const std::vector <std::string>& data, std::vector <std::string>& members,
+                         size_t block_size, int level);
+
+#endif // JSONGZIP_H
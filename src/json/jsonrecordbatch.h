@@ -0,0 +1,115 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSONRECORDBATCH_H
+#define JSONRECORDBATCH_H
+
+#include "common.h"
+
+#include <cassert>
+#include <vector>
+
+/*
+ * Reports waiting for conversion, stored by value in one array per report
+ * type. The entries keep the order in which the reports arrived.
+ *
+ * clear() keeps the capacity of all arrays, so a batch that is reused
+ * stores its reports without any heap allocation once it has grown to
+ * the batch size.
+ */
+
+class JSONRecordBatch
+{
+public:
+    size_t size () const { return entries_.size(); }
+    // memory taken by the stored reports
+    size_t bytes () const { return bytes_; }
+
+    void add (const t_Adsb& adsb) { addRecord (adsb_, adsb, e_object_adsb); }
+    void add (const t_Mlat& mlat) { addRecord (mlat_, mlat, e_object_mlat); }
+    void add (const t_Rsrv& rsrv) { addRecord (rsrv_, rsrv, e_object_rsrv); }
+    void add (const t_Rtgt& rtgt) { addRecord (rtgt_, rtgt, e_object_rtgt); }
+    void add (const t_Strk& strk) { addRecord (strk_, strk, e_object_strk); }
+
+    t_Object_Type type (size_t cnt) const { return entries_[cnt].type; }
+
+    // writes the report at position cnt, may be called from several threads at once
+    template <typename J>
+    void toJSON (size_t cnt, J& j)
+    {
+        const Entry& entry = entries_[cnt];
+
+        switch (entry.type)
+        {
+        case e_object_adsb:
+            adsb_[entry.index].toJSON (j);
+            break;
+        case e_object_mlat:
+            mlat_[entry.index].toJSON (j);
+            break;
+        case e_object_rsrv:
+            rsrv_[entry.index].toJSON (j);
+            break;
+        case e_object_rtgt:
+            rtgt_[entry.index].toJSON (j);
+            break;
+        case e_object_strk:
+            strk_[entry.index].toJSON (j);
+            break;
+        default:
+            assert (false);
+            break;
+        }
+    }
+
+    void clear ()
+    {
+        entries_.clear();
+        bytes_ = 0;
+        adsb_.clear();
+        mlat_.clear();
+        rsrv_.clear();
+        rtgt_.clear();
+        strk_.clear();
+    }
+
+private:
+    struct Entry
+    {
+        t_Object_Type type;
+        size_t index;
+    };
+
+    std::vector<Entry> entries_;
+    size_t bytes_ {0};
+
+    std::vector<t_Adsb> adsb_;
+    std::vector<t_Mlat> mlat_;
+    std::vector<t_Rsrv> rsrv_;
+    std::vector<t_Rtgt> rtgt_;
+    std::vector<t_Strk> strk_;
+
+    template <typename T>
+    void addRecord (std::vector<T>& records, const T& record, t_Object_Type type)
+    {
+        entries_.push_back ({type, records.size()});
+        records.push_back (record);
+        bytes_ += sizeof (Entry) + sizeof (T);
+    }
+};
+
+#endif // JSONRECORDBATCH_H
@@ -0,0 +1,268 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "jsonstreamsink.h"
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// milliseconds the consumer may stall at the end before the rest is dropped
+const int STREAM_CLOSE_TIMEOUT = 5000;
+
+int JSONStreamSink::stdout_fd_ {-1};
+
+bool JSONStreamSink::isStream (const std::string& path)
+{
+    struct stat st;
+
+    if (path == "-" || path.compare (0, 5, "unix:") == 0)
+        return true;
+
+    return stat (path.c_str(), &st) == 0 && S_ISFIFO (st.st_mode);
+}
+
+void JSONStreamSink::reserveStdout ()
+{
+    if (stdout_fd_ >= 0)
+        return;
+
+    fflush (stdout);
+
+    stdout_fd_ = dup (STDOUT_FILENO);
+    dup2 (STDERR_FILENO, STDOUT_FILENO);
+}
+
+JSONStreamSink::JSONStreamSink (const std::string& path, JSON_STREAM_POLICY policy, size_t buffer_size)
+    : path_ {path}, policy_ {policy}, buffer_size_ {buffer_size}
+{
+    if (path_ == "-")
+    {
+        fd_ = stdout_fd_ >= 0 ? stdout_fd_ : dup (STDOUT_FILENO);
+        stdout_fd_ = -1;
+    }
+    else if (path_.compare (0, 5, "unix:") == 0)
+    {
+        struct sockaddr_un addr;
+
+        memset (&addr, 0, sizeof (addr));
+        addr.sun_family = AF_UNIX;
+
+        if (path_.size() - 5 >= sizeof (addr.sun_path))
+        {
+            printf ("-> JSON stream socket path '%s' too long\n", path_.c_str() + 5);
+            return;
+        }
+        strcpy (addr.sun_path, path_.c_str() + 5);
+
+        fd_ = socket (AF_UNIX, SOCK_STREAM, 0);
+        if (fd_ >= 0 && connect (fd_, reinterpret_cast<struct sockaddr*> (&addr), sizeof (addr)) != 0)
+        {
+            printf ("-> Cannot connect to JSON stream socket '%s': %s\n", path_.c_str() + 5, strerror (errno));
+            close (fd_);
+            fd_ = -1;
+            return;
+        }
+        socket_ = true;
+    }
+    else
+    {
+        // a named pipe has no reader yet if the non-blocking open fails
+        fd_ = open (path_.c_str(), O_WRONLY | O_NONBLOCK);
+        if (fd_ < 0 && errno == ENXIO)
+        {
+            printf ("-> Waiting for a reader of named pipe '%s'\n", path_.c_str());
+            fd_ = open (path_.c_str(), O_WRONLY);
+        }
+    }
+
+    if (fd_ < 0)
+    {
+        printf ("-> Cannot open JSON stream '%s': %s\n", path_.c_str(), strerror (errno));
+        return;
+    }
+
+    saved_flags_ = fcntl (fd_, F_GETFL);
+    fcntl (fd_, F_SETFL, saved_flags_ | O_NONBLOCK);
+
+    // a consumer that has gone is seen as EPIPE, not by the signal
+    if (!socket_)
+        signal (SIGPIPE, SIG_IGN);
+}
+
+JSONStreamSink::~JSONStreamSink ()
+{
+    if (fd_ < 0)
+        return;
+
+    // with JSON_STREAM_DROP, a stalled consumer does not hold up the end
+    while (pending() && !broken_)
+    {
+        if (!waitWritable (policy_ == JSON_STREAM_DROP ? STREAM_CLOSE_TIMEOUT : -1))
+        {
+            drop (pending());
+            break;
+        }
+        sendBuffer ();
+    }
+
+    // standard output is shared with the calling shell
+    if (saved_flags_ >= 0)
+        fcntl (fd_, F_SETFL, saved_flags_);
+
+    close (fd_);
+}
+
+void JSONStreamSink::write (const std::string& data)
+{
+    if (fd_ < 0 || broken_)
+    {
+        drop (data.size());
+        return;
+    }
+
+    sendBuffer ();
+
+    // the buffer never holds more than buffer_size_ bytes: a unit that might
+    // not fit is dropped whole, or waits for the consumer to make room
+    if (pending() + data.size() > buffer_size_)
+    {
+        if (policy_ == JSON_STREAM_DROP)
+        {
+            drop (data.size());
+            ++units_dropped_;
+            return;
+        }
+
+        while (pending() && pending() + data.size() > buffer_size_ && !broken_)
+        {
+            waitWritable (-1);
+            sendBuffer ();
+        }
+    }
+
+    size_t sent = pending() ? 0 : send (data.data(), data.size());
+
+    // a unit larger than the buffer is sent until the rest fits
+    while (data.size() - sent > buffer_size_ && !broken_)
+    {
+        waitWritable (-1);
+        sent += send (data.data() + sent, data.size() - sent);
+    }
+
+    if (broken_)
+    {
+        drop (data.size() - sent);
+        return;
+    }
+
+    if (sent < data.size())
+    {
+        // the sent part of the buffer is only removed when it is half of it,
+        // or when the buffer would grow beyond its size
+        if (buffer_begin_ && (buffer_begin_ >= buffer_.size() / 2 ||
+                              buffer_.size() + data.size() - sent > buffer_size_))
+        {
+            buffer_.erase (0, buffer_begin_);
+            buffer_begin_ = 0;
+        }
+        buffer_.append (data, sent, std::string::npos);
+    }
+}
+
+size_t JSONStreamSink::send (const char* data, size_t size)
+{
+    size_t sent = 0;
+
+    while (sent < size)
+    {
+        ssize_t n = socket_ ? ::send (fd_, data + sent, size - sent, MSG_NOSIGNAL)
+                            : ::write (fd_, data + sent, size - sent);
+
+        if (n > 0)
+        {
+            sent += n;
+            continue;
+        }
+
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+
+        printf ("-> JSON stream '%s' closed by the consumer, records are dropped\n", path_.c_str());
+        broken_ = true;
+        break;
+    }
+
+    bytes_written_ += sent;
+    return sent;
+}
+
+void JSONStreamSink::sendBuffer ()
+{
+    if (!pending())
+        return;
+
+    buffer_begin_ += send (buffer_.data() + buffer_begin_, pending());
+
+    if (broken_)
+        drop (pending());
+
+    if (!pending())
+    {
+        buffer_.clear();
+        buffer_begin_ = 0;
+    }
+}
+
+bool JSONStreamSink::waitWritable (int timeout_ms)
+{
+    struct pollfd pfd;
+
+    pfd.fd = fd_;
+    pfd.events = POLLOUT;
+    pfd.revents = 0;
+
+    int n;
+
+    do
+        n = poll (&pfd, 1, timeout_ms);
+    while (n < 0 && errno == EINTR);
+
+    return n > 0;
+}
+
+void JSONStreamSink::drop (size_t bytes)
+{
+    bytes_dropped_ += bytes;
+
+    // the buffered data is given up as a whole
+    if (bytes && bytes == pending())
+    {
+        buffer_.clear();
+        buffer_begin_ = 0;
+    }
+}
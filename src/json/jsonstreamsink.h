@@ -0,0 +1,102 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSONSTREAMSINK_H
+#define JSONSTREAMSINK_H
+
+#include "global.h"
+#include "basics.h"
+
+#include "common.h"
+
+#include <cstddef>
+#include <string>
+
+/*
+ * Live JSON output to a consumer instead of a file: standard output
+ * ("-"), a Unix domain socket ("unix:path", connected to as a client) or
+ * a named pipe (a path that is a FIFO).
+ *
+ * The descriptor is non-blocking. What the consumer does not take at once
+ * is buffered, up to buffer_size bytes; when the data handed to write()
+ * does not fit into the buffer, write() either waits for the consumer
+ * (JSON_STREAM_BLOCK) or drops that data (JSON_STREAM_DROP). Data is only
+ * dropped in the units given to write(), whole records or chunks of
+ * records, so the framing of the stream stays intact; with
+ * JSON_STREAM_DROP, a unit larger than the buffer is always dropped. Once
+ * the consumer has gone, everything further is dropped.
+ *
+ * write() is called by a single thread, the JSON write task.
+ */
+
+class JSONStreamSink
+{
+public:
+    // whether a -json-file= path names a stream rather than a file
+    static bool isStream (const std::string& path);
+
+    // keeps standard output for the records and sends all messages printed
+    // from now on to standard error; to be called before printing anything
+    static void reserveStdout ();
+
+    JSONStreamSink (const std::string& path, JSON_STREAM_POLICY policy, size_t buffer_size);
+    // waits for the consumer to take the buffered data, then closes
+    ~JSONStreamSink ();
+
+    bool isOpen () const { return fd_ >= 0; }
+
+    void write (const std::string& data);
+
+    size_t bytesWritten () const { return bytes_written_; }
+    size_t bytesDropped () const { return bytes_dropped_; }
+    size_t unitsDropped () const { return units_dropped_; }
+    // data the consumer has not taken yet; at most buffer_size
+    size_t bytesBuffered () const { return pending(); }
+
+private:
+    std::string path_;
+    JSON_STREAM_POLICY policy_;
+    size_t buffer_size_;
+
+    int fd_ {-1};
+    bool socket_ {false};
+    // descriptor flags to restore on close
+    int saved_flags_ {-1};
+    bool broken_ {false};
+
+    std::string buffer_;
+    // data before buffer_begin_ has been sent
+    size_t buffer_begin_ {0};
+
+    size_t bytes_written_ {0};
+    size_t bytes_dropped_ {0};
+    size_t units_dropped_ {0};
+
+    static int stdout_fd_;
+
+    size_t pending () const { return buffer_.size() - buffer_begin_; }
+
+    // sends as much as the consumer takes without blocking
+    size_t send (const char* data, size_t size);
+    void sendBuffer ();
+    // false if the consumer did not become ready within timeout_ms (-1 = no limit)
+    bool waitWritable (int timeout_ms);
+
+    void drop (size_t bytes);
+};
+
+#endif // JSONSTREAMSINK_H
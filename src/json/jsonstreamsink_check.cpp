@@ -0,0 +1,247 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "jsonstreamsink.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/*
+ * A consumer of the JSON stream on a Unix domain socket, reading slower
+ * than the records are written, against JSONStreamSink:
+ *
+ *     sddl_json_stream_check
+ *
+ * The consumer checks that every record arrives whole behind its 4 byte
+ * big-endian length, and in order. With JSON_STREAM_BLOCK every record
+ * must arrive, with JSON_STREAM_DROP those of the units not dropped. The
+ * sink must never buffer more than its buffer size, also when handed
+ * units larger than that.
+ */
+
+namespace
+{
+
+const size_t buffer_size = 16384;
+const unsigned units = 2000;
+
+// a record: its number (8 bytes) and filler derived from it
+void appendRecord (std::string& unit, unsigned long number, size_t size)
+{
+    size_t start = unit.size();
+
+    unit.append (4, '\0');
+    for (int ix = 0; ix < 8; ix ++)
+        unit.push_back (static_cast<char> (number >> (8 * ix)));
+    for (size_t ix = 8; ix < size; ix ++)
+        unit.push_back (static_cast<char> (number + ix));
+
+    unit[start] = static_cast<char> (size >> 24);
+    unit[start + 1] = static_cast<char> (size >> 16);
+    unit[start + 2] = static_cast<char> (size >> 8);
+    unit[start + 3] = static_cast<char> (size);
+}
+
+bool readFully (int fd, unsigned char* data, size_t size)
+{
+    while (size)
+    {
+        ssize_t n = read (fd, data, size);
+
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+
+        data += n;
+        size -= n;
+    }
+
+    return true;
+}
+
+// reads the records until the end of the stream; returns their count, or
+// -1 if a record is broken or out of order
+long consume (int listener)
+{
+    int fd = accept (listener, nullptr, nullptr);
+
+    if (fd < 0)
+        return -1;
+
+    long count = 0;
+    long last = -1;
+    std::string record;
+    unsigned char length[4];
+
+    while (readFully (fd, length, 4))
+    {
+        size_t size = (size_t (length[0]) << 24) | (size_t (length[1]) << 16) |
+                      (size_t (length[2]) << 8) | length[3];
+
+        if (size < 8)
+            return -1;
+
+        record.resize (size);
+        if (!readFully (fd, reinterpret_cast<unsigned char*> (&record[0]), size))
+            return -1;
+
+        unsigned long number = 0;
+        for (int ix = 0; ix < 8; ix ++)
+            number |= static_cast<unsigned long> (static_cast<unsigned char> (record[ix])) << (8 * ix);
+        for (size_t ix = 8; ix < size; ix ++)
+            if (record[ix] != static_cast<char> (number + ix))
+                return -1;
+
+        if (static_cast<long> (number) <= last)
+            return -1;
+        last = static_cast<long> (number);
+        ++count;
+
+        // slower than the writer
+        if (count % 16 == 0)
+            usleep (200);
+    }
+
+    close (fd);
+    return count;
+}
+
+bool run (const char* name, JSON_STREAM_POLICY policy)
+{
+    std::string path = "/tmp/sddl_json_stream_check." + std::to_string (getpid());
+    struct sockaddr_un addr;
+
+    memset (&addr, 0, sizeof (addr));
+    addr.sun_family = AF_UNIX;
+    strcpy (addr.sun_path, path.c_str());
+
+    int listener = socket (AF_UNIX, SOCK_STREAM, 0);
+    unlink (path.c_str());
+    if (listener < 0 || bind (listener, reinterpret_cast<struct sockaddr*> (&addr), sizeof (addr)) != 0 ||
+        listen (listener, 1) != 0)
+    {
+        fprintf (stderr, "Cannot listen on '%s': %s\n", path.c_str(), strerror (errno));
+        return false;
+    }
+
+    // the consumer reports the records it has read through a pipe
+    int report[2];
+    if (pipe (report) != 0)
+        return false;
+
+    pid_t pid = fork ();
+    if (pid == 0)
+    {
+        close (report[0]);
+        long count = consume (listener);
+        ssize_t n = ::write (report[1], &count, sizeof (count));
+        _exit (n == sizeof (count) ? 0 : 1);
+    }
+    close (report[1]);
+
+    bool ok = true;
+    long expected = 0;
+    unsigned long number = 0;
+    size_t bytes = 0;
+    size_t largest = 0;
+
+    {
+        JSONStreamSink sink {"unix:" + path, policy, buffer_size};
+
+        ok = sink.isOpen();
+
+        for (unsigned ix = 0; ok && ix < units; ix ++)
+        {
+            std::string unit;
+            // mostly small chunks of records, and every 100th unit larger
+            // than the buffer
+            long records = ix % 100 == 99 ? 60 : 1 + ix % 7;
+
+            for (long rec = 0; rec < records; rec ++)
+                appendRecord (unit, number++, 200 + (ix * 37 + rec * 11) % 400);
+
+            size_t dropped = sink.unitsDropped();
+
+            sink.write (unit);
+            bytes += unit.size();
+
+            if (sink.unitsDropped() == dropped)
+                expected += records;
+            else if (policy == JSON_STREAM_BLOCK)
+                ok = false;
+
+            if (sink.bytesBuffered() > largest)
+                largest = sink.bytesBuffered();
+        }
+
+        ok = ok && sink.bytesWritten() + sink.bytesDropped() + sink.bytesBuffered() == bytes;
+
+        printf ("%-5s %zu byte(s) sent, %zu byte(s) in %zu unit(s) dropped, at most %zu byte(s) buffered\n",
+                name, sink.bytesWritten(), sink.bytesDropped(), sink.unitsDropped(), largest);
+    }
+
+    long count = -1;
+    int status = 0;
+
+    if (read (report[0], &count, sizeof (count)) != sizeof (count))
+        count = -1;
+    close (report[0]);
+    waitpid (pid, &status, 0);
+    close (listener);
+    unlink (path.c_str());
+
+    if (count != expected)
+    {
+        fprintf (stderr, "%s: consumer read %ld record(s), expected %ld\n", name, count, expected);
+        ok = false;
+    }
+
+    if (largest > buffer_size)
+    {
+        fprintf (stderr, "%s: buffer of %zu byte(s) exceeded\n", name, buffer_size);
+        ok = false;
+    }
+
+    return ok;
+}
+
+}
+
+int main ()
+{
+    bool ok = true;
+
+    ok = run ("block", JSON_STREAM_BLOCK) && ok;
+    ok = run ("drop", JSON_STREAM_DROP) && ok;
+
+    if (!ok)
+    {
+        fprintf (stderr, "Stream check failed\n");
+        return 1;
+    }
+
+    return 0;
+}
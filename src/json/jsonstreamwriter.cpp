@@ -0,0 +1,765 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "jsonstreamwriter.h"
+#include "jsonfields.h"
+#include "json.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+/* CBOR major types and simple values: */
+const std::uint8_t CBOR_UNSIGNED = 0x00;
+const std::uint8_t CBOR_NEGATIVE = 0x20;
+const std::uint8_t CBOR_TEXT = 0x60;
+const std::uint8_t CBOR_ARRAY = 0x80;
+const std::uint8_t CBOR_ARRAY_INDEFINITE = 0x9f;
+const std::uint8_t CBOR_MAP_INDEFINITE = 0xbf;
+const std::uint8_t CBOR_FALSE = 0xf4;
+const std::uint8_t CBOR_TRUE = 0xf5;
+const std::uint8_t CBOR_NULL = 0xf6;
+const std::uint8_t CBOR_DOUBLE = 0xfb;
+const std::uint8_t CBOR_BREAK = 0xff;
+
+JSONStreamNode& JSONStreamNode::operator[] (const std::string& key)
+{
+    assert (writer_);
+    if (discard_)
+        return *this;
+    return writer_->child (depth_, key.data(), key.size());
+}
+
+JSONStreamNode& JSONStreamNode::operator[] (const char* key)
+{
+    assert (writer_);
+    if (discard_)
+        return *this;
+    return writer_->child (depth_, key, strlen (key));
+}
+
+bool JSONStreamNode::wants (const char* key) const
+{
+    assert (writer_);
+    return !discard_ && writer_->wanted (depth_, key, strlen (key));
+}
+
+static bool sameKey (const char* a, std::size_t a_length, const char* b, std::size_t b_length)
+{
+    return a_length == b_length && memcmp (a, b, a_length) == 0;
+}
+
+JSONStreamWriter::JSONStreamWriter (std::string& buffer, JSON_STREAM_FORMAT format, int indent)
+    : out_ (buffer), format_ (format), indent_ (format == JSON_STREAM_TEXT ? indent : -1)
+{
+    for (unsigned int depth = 0; depth < max_depth; depth++)
+    {
+        nodes_[depth].writer_ = this;
+        nodes_[depth].depth_ = depth;
+        count_[depth] = 0;
+        offset_[depth] = 0;
+        keys_[depth] = nullptr;
+        key_lengths_[depth] = 0;
+        fields_[depth] = nullptr;
+    }
+
+    discard_.writer_ = this;
+    discard_.discard_ = true;
+}
+
+JSONStreamNode& JSONStreamWriter::begin (const JSONFieldNode* fields)
+{
+    depth_ = 0;
+    pending_ = false;
+    array_open_ = false;
+    fields_[0] = fields;
+
+    openObject ();
+
+    return nodes_[0];
+}
+
+void JSONStreamWriter::end ()
+{
+    closeTo (0);
+    closeObject ();
+}
+
+JSONStreamNode& JSONStreamWriter::child (unsigned int depth, const char* key, std::size_t length)
+{
+    // members are added to a key that was only accessed so far
+    if (pending_ && depth == depth_ + 1)
+        openPending ();
+
+    assert (!(array_open_ && depth == depth_ + 1));
+
+    assert (depth <= depth_);
+
+    const JSONFieldNode* fields = nullptr;
+
+    if (fields_[depth])
+    {
+        const JSONFieldNode::Member* member = fields_[depth]->find (key, length);
+
+        if (!member)
+            return discard_;
+
+        key = member->name.data();
+        length = member->name.size();
+        fields = member->fields.get();
+    }
+
+    if (depth < depth_)
+    {
+        // same object as before, e.g. j[name]["a"] followed by j[name]["b"]
+        if (sameKey (keys_[depth + 1], key_lengths_[depth + 1], key, length))
+        {
+            closeTo (depth + 1);
+            return nodes_[depth + 1];
+        }
+
+        closeTo (depth);
+    }
+    else if (pending_ || array_open_)
+    {
+        if (sameKey (pending_key_, pending_length_, key, length))
+            return nodes_[depth + 1];
+
+        flushPending ();
+    }
+
+    assert (depth + 1 < max_depth);
+
+    pending_ = true;
+    pending_key_ = key;
+    pending_length_ = length;
+    pending_fields_ = fields;
+
+    return nodes_[depth + 1];
+}
+
+bool JSONStreamWriter::wanted (unsigned int depth, const char* key, std::size_t length) const
+{
+    // the object of a key only accessed so far has the projection of that key
+    const JSONFieldNode* fields = depth == depth_ + 1 ? (pending_ ? pending_fields_ : nullptr)
+                                                      : fields_[depth];
+
+    return !fields || fields->find (key, length);
+}
+
+void JSONStreamWriter::flushPending ()
+{
+    if (array_open_)
+        closeArray ();
+
+    if (!pending_)
+        return;
+
+    beginMember (pending_key_, pending_length_);
+    put (nullptr);
+    pending_ = false;
+}
+
+void JSONStreamWriter::closeTo (unsigned int depth)
+{
+    flushPending ();
+
+    while (depth_ > depth)
+    {
+        closeObject ();
+        --depth_;
+    }
+}
+
+void JSONStreamWriter::openPending ()
+{
+    assert (pending_);
+    assert (depth_ + 1 < max_depth);
+
+    beginMember (pending_key_, pending_length_);
+    pending_ = false;
+
+    ++depth_;
+    keys_[depth_] = pending_key_;
+    key_lengths_[depth_] = pending_length_;
+    fields_[depth_] = pending_fields_;
+
+    openObject ();
+}
+
+void JSONStreamWriter::openObject ()
+{
+    count_[depth_] = 0;
+    offset_[depth_] = out_.size();
+
+    switch (format_)
+    {
+    case JSON_STREAM_TEXT:
+        out_ += '{';
+        break;
+    case JSON_STREAM_CBOR:
+        out_ += static_cast<char> (CBOR_MAP_INDEFINITE);
+        break;
+    case JSON_STREAM_MESSAGE_PACK:
+        // map 16, member count patched when closed
+        out_.append ("\xde\x00\x00", 3);
+        break;
+    case JSON_STREAM_UBJSON:
+        out_ += '{';
+        break;
+    }
+}
+
+void JSONStreamWriter::closeObject ()
+{
+    switch (format_)
+    {
+    case JSON_STREAM_TEXT:
+        if (count_[depth_])
+            newline (depth_);
+        out_ += '}';
+        break;
+    case JSON_STREAM_CBOR:
+        out_ += static_cast<char> (CBOR_BREAK);
+        break;
+    case JSON_STREAM_MESSAGE_PACK:
+        patchLength (offset_[depth_] + 1, count_[depth_]);
+        break;
+    case JSON_STREAM_UBJSON:
+        out_ += '}';
+        break;
+    }
+}
+
+void JSONStreamWriter::closeArray ()
+{
+    switch (format_)
+    {
+    case JSON_STREAM_TEXT:
+        newline (depth_ + 1);
+        out_ += ']';
+        break;
+    case JSON_STREAM_CBOR:
+        out_ += static_cast<char> (CBOR_BREAK);
+        break;
+    case JSON_STREAM_MESSAGE_PACK:
+        patchLength (array_offset_ + 1, array_count_);
+        break;
+    case JSON_STREAM_UBJSON:
+        out_ += ']';
+        break;
+    }
+
+    array_open_ = false;
+}
+
+void JSONStreamWriter::beginMember (const char* key, std::size_t length)
+{
+    if (format_ == JSON_STREAM_TEXT)
+    {
+        if (count_[depth_])
+            out_ += ',';
+
+        newline (depth_ + 1);
+        putTextString (key, length);
+
+        if (indent_ >= 0)
+            out_.append (": ", 2);
+        else
+            out_ += ':';
+    }
+    else if (format_ == JSON_STREAM_UBJSON)
+    {
+        // keys are strings without the 'S' marker
+        putUnsigned (length);
+        out_.append (key, length);
+    }
+    else
+        putString (key, length);
+
+    ++count_[depth_];
+}
+
+void JSONStreamWriter::newline (unsigned int depth)
+{
+    if (indent_ < 0)
+        return;
+
+    out_ += '\n';
+    out_.append (indent_ * depth, ' ');
+}
+
+void JSONStreamWriter::beginValue (unsigned int depth)
+{
+    // the DOM would replace an object that has already been written
+    assert (pending_ && depth == depth_ + 1);
+
+    beginMember (pending_key_, pending_length_);
+}
+
+void JSONStreamWriter::beginElement (unsigned int depth)
+{
+    assert ((pending_ || array_open_) && depth == depth_ + 1);
+
+    if (!array_open_)
+    {
+        beginMember (pending_key_, pending_length_);
+        pending_ = false;
+        array_open_ = true;
+        array_count_ = 0;
+        array_offset_ = out_.size();
+
+        switch (format_)
+        {
+        case JSON_STREAM_TEXT:
+            out_ += '[';
+            break;
+        case JSON_STREAM_CBOR:
+            out_ += static_cast<char> (CBOR_ARRAY_INDEFINITE);
+            break;
+        case JSON_STREAM_MESSAGE_PACK:
+            // array 16, element count patched when closed
+            out_.append ("\xdc\x00\x00", 3);
+            break;
+        case JSON_STREAM_UBJSON:
+            out_ += '[';
+            break;
+        }
+    }
+    else if (format_ == JSON_STREAM_TEXT)
+        out_ += ',';
+
+    newline (depth_ + 2);
+    ++array_count_;
+}
+
+void JSONStreamWriter::put (std::nullptr_t)
+{
+    switch (format_)
+    {
+    case JSON_STREAM_TEXT:
+        out_.append ("null", 4);
+        break;
+    case JSON_STREAM_CBOR:
+        out_ += static_cast<char> (CBOR_NULL);
+        break;
+    case JSON_STREAM_MESSAGE_PACK:
+        out_ += '\xc0';
+        break;
+    case JSON_STREAM_UBJSON:
+        out_ += 'Z';
+        break;
+    }
+}
+
+void JSONStreamWriter::put (bool value)
+{
+    switch (format_)
+    {
+    case JSON_STREAM_TEXT:
+        if (value)
+            out_.append ("true", 4);
+        else
+            out_.append ("false", 5);
+        break;
+    case JSON_STREAM_CBOR:
+        out_ += static_cast<char> (value ? CBOR_TRUE : CBOR_FALSE);
+        break;
+    case JSON_STREAM_MESSAGE_PACK:
+        out_ += value ? '\xc3' : '\xc2';
+        break;
+    case JSON_STREAM_UBJSON:
+        out_ += value ? 'T' : 'F';
+        break;
+    }
+}
+
+void JSONStreamWriter::put (double value)
+{
+    if (format_ == JSON_STREAM_TEXT)
+    {
+        if (!std::isfinite (value))
+        {
+            put (nullptr);
+            return;
+        }
+
+        // same shortest round-trip format as nlohmann::json::dump()
+        char buffer[64];
+        char* end = nlohmann::detail::to_chars (buffer, buffer + sizeof (buffer), value);
+        out_.append (buffer, end - buffer);
+        return;
+    }
+
+    switch (format_)
+    {
+    case JSON_STREAM_CBOR:
+        out_ += static_cast<char> (CBOR_DOUBLE);
+        break;
+    case JSON_STREAM_MESSAGE_PACK:
+        out_ += '\xcb';
+        break;
+    case JSON_STREAM_UBJSON:
+        out_ += 'D';
+        break;
+    default:
+        break;
+    }
+
+    std::uint64_t bits;
+    memcpy (&bits, &value, sizeof (bits));
+    putBigEndian (bits, 8);
+}
+
+void JSONStreamWriter::put (const char* value)
+{
+    putString (value, strlen (value));
+}
+
+void JSONStreamWriter::putUnsigned (unsigned long long value)
+{
+    switch (format_)
+    {
+    case JSON_STREAM_TEXT:
+        putDecimal (value);
+        break;
+    case JSON_STREAM_CBOR:
+        putHeader (CBOR_UNSIGNED, value);
+        break;
+    case JSON_STREAM_MESSAGE_PACK:
+        if (value < 0x80)
+            out_ += static_cast<char> (value);
+        else if (value <= 0xff)
+        {
+            out_ += '\xcc';
+            putBigEndian (value, 1);
+        }
+        else if (value <= 0xffff)
+        {
+            out_ += '\xcd';
+            putBigEndian (value, 2);
+        }
+        else if (value <= 0xffffffff)
+        {
+            out_ += '\xce';
+            putBigEndian (value, 4);
+        }
+        else
+        {
+            out_ += '\xcf';
+            putBigEndian (value, 8);
+        }
+        break;
+    case JSON_STREAM_UBJSON:
+        if (value <= static_cast<unsigned long long> (std::numeric_limits<std::int8_t>::max()))
+        {
+            out_ += 'i';
+            putBigEndian (value, 1);
+        }
+        else if (value <= std::numeric_limits<std::uint8_t>::max())
+        {
+            out_ += 'U';
+            putBigEndian (value, 1);
+        }
+        else if (value <= static_cast<unsigned long long> (std::numeric_limits<std::int16_t>::max()))
+        {
+            out_ += 'I';
+            putBigEndian (value, 2);
+        }
+        else if (value <= static_cast<unsigned long long> (std::numeric_limits<std::int32_t>::max()))
+        {
+            out_ += 'l';
+            putBigEndian (value, 4);
+        }
+        else
+        {
+            out_ += 'L';
+            putBigEndian (value, 8);
+        }
+        break;
+    }
+}
+
+void JSONStreamWriter::putInteger (long long value)
+{
+    if (value >= 0)
+    {
+        putUnsigned (static_cast<unsigned long long> (value));
+        return;
+    }
+
+    switch (format_)
+    {
+    case JSON_STREAM_TEXT:
+        out_ += '-';
+        putDecimal (0ULL - static_cast<unsigned long long> (value));
+        break;
+    case JSON_STREAM_CBOR:
+        putHeader (CBOR_NEGATIVE, static_cast<unsigned long long> (-1 - value));
+        break;
+    case JSON_STREAM_MESSAGE_PACK:
+        if (value >= -32)
+            out_ += static_cast<char> (value);
+        else if (value >= std::numeric_limits<std::int8_t>::min())
+        {
+            out_ += '\xd0';
+            putBigEndian (static_cast<unsigned long long> (value), 1);
+        }
+        else if (value >= std::numeric_limits<std::int16_t>::min())
+        {
+            out_ += '\xd1';
+            putBigEndian (static_cast<unsigned long long> (value), 2);
+        }
+        else if (value >= std::numeric_limits<std::int32_t>::min())
+        {
+            out_ += '\xd2';
+            putBigEndian (static_cast<unsigned long long> (value), 4);
+        }
+        else
+        {
+            out_ += '\xd3';
+            putBigEndian (static_cast<unsigned long long> (value), 8);
+        }
+        break;
+    case JSON_STREAM_UBJSON:
+        if (value >= std::numeric_limits<std::int8_t>::min())
+        {
+            out_ += 'i';
+            putBigEndian (static_cast<unsigned long long> (value), 1);
+        }
+        else if (value >= std::numeric_limits<std::int16_t>::min())
+        {
+            out_ += 'I';
+            putBigEndian (static_cast<unsigned long long> (value), 2);
+        }
+        else if (value >= std::numeric_limits<std::int32_t>::min())
+        {
+            out_ += 'l';
+            putBigEndian (static_cast<unsigned long long> (value), 4);
+        }
+        else
+        {
+            out_ += 'L';
+            putBigEndian (static_cast<unsigned long long> (value), 8);
+        }
+        break;
+    }
+}
+
+void JSONStreamWriter::putString (const char* value, std::size_t length)
+{
+    switch (format_)
+    {
+    case JSON_STREAM_TEXT:
+        putTextString (value, length);
+        return;
+    case JSON_STREAM_CBOR:
+        putHeader (CBOR_TEXT, length);
+        break;
+    case JSON_STREAM_MESSAGE_PACK:
+        if (length < 32)
+            out_ += static_cast<char> (0xa0 | length);
+        else if (length <= 0xff)
+        {
+            out_ += '\xd9';
+            putBigEndian (length, 1);
+        }
+        else if (length <= 0xffff)
+        {
+            out_ += '\xda';
+            putBigEndian (length, 2);
+        }
+        else
+        {
+            out_ += '\xdb';
+            putBigEndian (length, 4);
+        }
+        break;
+    case JSON_STREAM_UBJSON:
+        out_ += 'S';
+        putUnsigned (length);
+        break;
+    }
+
+    out_.append (value, length);
+}
+
+void JSONStreamWriter::putByteArray (const unsigned char* values, std::size_t count)
+{
+    switch (format_)
+    {
+    case JSON_STREAM_TEXT:
+        if (count == 0)
+        {
+            out_.append ("[]", 2);
+            return;
+        }
+
+        out_ += '[';
+        for (std::size_t cnt = 0; cnt < count; cnt++)
+        {
+            if (cnt)
+                out_ += ',';
+            newline (depth_ + 2);
+            putDecimal (values[cnt]);
+        }
+        newline (depth_ + 1);
+        out_ += ']';
+        return;
+    case JSON_STREAM_CBOR:
+        putHeader (CBOR_ARRAY, count);
+        break;
+    case JSON_STREAM_MESSAGE_PACK:
+        if (count < 16)
+            out_ += static_cast<char> (0x90 | count);
+        else if (count <= 0xffff)
+        {
+            out_ += '\xdc';
+            putBigEndian (count, 2);
+        }
+        else
+        {
+            out_ += '\xdd';
+            putBigEndian (count, 4);
+        }
+        break;
+    case JSON_STREAM_UBJSON:
+        out_ += '[';
+        break;
+    }
+
+    for (std::size_t cnt = 0; cnt < count; cnt++)
+        putUnsigned (values[cnt]);
+
+    if (format_ == JSON_STREAM_UBJSON)
+        out_ += ']';
+}
+
+void JSONStreamWriter::putDecimal (unsigned long long value)
+{
+    char buffer[20];
+    char* ptr = buffer + sizeof (buffer);
+
+    do
+    {
+        *--ptr = static_cast<char> ('0' + value % 10);
+        value /= 10;
+    } while (value);
+
+    out_.append (ptr, buffer + sizeof (buffer) - ptr);
+}
+
+void JSONStreamWriter::putTextString (const char* value, std::size_t length)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    out_ += '"';
+
+    std::size_t start = 0;
+    for (std::size_t cnt = 0; cnt < length; cnt++)
+    {
+        unsigned char c = static_cast<unsigned char> (value[cnt]);
+
+        if (c >= 0x20 && c != '"' && c != '\\')
+            continue;
+
+        out_.append (value + start, cnt - start);
+        start = cnt + 1;
+
+        switch (c)
+        {
+        case '"':
+            out_.append ("\\\"", 2);
+            break;
+        case '\\':
+            out_.append ("\\\\", 2);
+            break;
+        case '\b':
+            out_.append ("\\b", 2);
+            break;
+        case '\f':
+            out_.append ("\\f", 2);
+            break;
+        case '\n':
+            out_.append ("\\n", 2);
+            break;
+        case '\r':
+            out_.append ("\\r", 2);
+            break;
+        case '\t':
+            out_.append ("\\t", 2);
+            break;
+        default:
+            out_.append ("\\u00", 4);
+            out_ += hex[c >> 4];
+            out_ += hex[c & 0x0f];
+            break;
+        }
+    }
+
+    out_.append (value + start, length - start);
+    out_ += '"';
+}
+
+void JSONStreamWriter::putHeader (std::uint8_t major, unsigned long long value)
+{
+    if (value < 24)
+        out_ += static_cast<char> (major | value);
+    else if (value <= 0xff)
+    {
+        out_ += static_cast<char> (major | 24);
+        putBigEndian (value, 1);
+    }
+    else if (value <= 0xffff)
+    {
+        out_ += static_cast<char> (major | 25);
+        putBigEndian (value, 2);
+    }
+    else if (value <= 0xffffffff)
+    {
+        out_ += static_cast<char> (major | 26);
+        putBigEndian (value, 4);
+    }
+    else
+    {
+        out_ += static_cast<char> (major | 27);
+        putBigEndian (value, 8);
+    }
+}
+
+void JSONStreamWriter::putBigEndian (unsigned long long value, unsigned int bytes)
+{
+    char buffer[8];
+
+    for (unsigned int cnt = bytes; cnt > 0; cnt--)
+    {
+        buffer[cnt - 1] = static_cast<char> (value & 0xff);
+        value >>= 8;
+    }
+
+    out_.append (buffer, bytes);
+}
+
+void JSONStreamWriter::patchLength (std::size_t offset, unsigned int length)
+{
+    // 16-bit MessagePack container length
+    assert (length <= 0xffff);
+    assert (offset + 2 <= out_.size());
+
+    out_[offset] = static_cast<char> ((length >> 8) & 0xff);
+    out_[offset + 1] = static_cast<char> (length & 0xff);
+}
@@ -0,0 +1,232 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSONSTREAMWRITER_H
+#define JSONSTREAMWRITER_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+/*
+ * Writes one report straight into a byte buffer, as JSON text or in one
+ * of the binary JSON formats, without building a nlohmann::json tree
+ * first.
+ *
+ * The toJSON() functions of the report structures are templates on the
+ * node type, so they run unchanged on either a nlohmann::json or a
+ * JSONStreamNode. A node accepts the same "j[key] = value",
+ * "j[key][key] = value" and "j[key].push_back (value)" statements, but
+ * emits every member as soon as it is complete. Members therefore appear
+ * in the order the toJSON() functions write them (a DOM sorts them by
+ * key), and a key must not be revisited once a sibling has been started.
+ *
+ * A key that is accessed but never assigned is written as null, which is
+ * what operator[] does on a nlohmann::json object.
+ *
+ * With a projection (see jsonfields.h) given to begin(), the keys not
+ * wanted lead to a node that ignores everything written to it, so the
+ * members of an excluded object are never encoded. The toJSON() functions
+ * ask wants() before they convert a member, so an excluded one is not
+ * visited at all. Wanted keys are written under the name given by the
+ * projection.
+ *
+ * Keys are not copied: they have to stay valid until the record has been
+ * written, as the string literals of the toJSON() functions do.
+ *
+ * Records are appended to the buffer, so several of them can share one
+ * buffer. The binary encodings are those of nlohmann::json::to_cbor(),
+ * to_msgpack() and to_ubjson(), except for the container headers:
+ * CBOR objects and appended arrays have indefinite length, MessagePack
+ * ones always use the 16-bit length form.
+ */
+
+typedef enum
+{
+    JSON_STREAM_TEXT,
+    JSON_STREAM_CBOR,
+    JSON_STREAM_MESSAGE_PACK,
+    JSON_STREAM_UBJSON
+} JSON_STREAM_FORMAT;
+
+class JSONStreamWriter;
+struct JSONFieldNode;
+
+class JSONStreamNode
+{
+public:
+    JSONStreamNode& operator[] (const std::string& key);
+    JSONStreamNode& operator[] (const char* key);
+
+    // false if member key is not written at all, so its value need not be
+    // converted
+    bool wants (const char* key) const;
+
+    template <typename T>
+    JSONStreamNode& operator= (const T& value);
+
+    template <typename T>
+    void push_back (const T& value);
+
+private:
+    friend class JSONStreamWriter;
+
+    JSONStreamWriter* writer_ {nullptr};
+    unsigned int depth_ {0};
+    bool discard_ {false};
+    // a key that is not wanted, and everything below it
+};
+
+class JSONStreamWriter
+{
+public:
+    // for text, indent < 0 writes compact text, otherwise as nlohmann::json::dump(indent)
+    JSONStreamWriter (std::string& buffer, JSON_STREAM_FORMAT format, int indent = -1);
+
+    // fields is the projection of the record, nullptr to write all members
+    JSONStreamNode& begin (const JSONFieldNode* fields = nullptr);
+    void end ();
+
+private:
+    friend class JSONStreamNode;
+
+    static const unsigned int max_depth = 16;
+
+    std::string& out_;
+    JSON_STREAM_FORMAT format_;
+    int indent_;
+
+    JSONStreamNode nodes_[max_depth];
+    unsigned int count_[max_depth];
+    // members written so far into the object at each depth
+    std::size_t offset_[max_depth];
+    // position of the object header at each depth
+    const char* keys_[max_depth];
+    std::size_t key_lengths_[max_depth];
+    // key of the open object at each depth
+    const JSONFieldNode* fields_[max_depth];
+    // projection of the open object at each depth, nullptr for all members
+    JSONStreamNode discard_;
+
+    unsigned int depth_ {0};
+    // innermost open object
+
+    bool pending_ {false};
+    const char* pending_key_ {nullptr};
+    std::size_t pending_length_ {0};
+    const JSONFieldNode* pending_fields_ {nullptr};
+    // key accessed in depth_ but not yet known to be a value or an object
+
+    bool array_open_ {false};
+    unsigned int array_count_ {0};
+    std::size_t array_offset_ {0};
+    // pending_key_ has become an array that is still open
+
+    JSONStreamNode& child (unsigned int depth, const char* key, std::size_t length);
+    bool wanted (unsigned int depth, const char* key, std::size_t length) const;
+
+    void flushPending ();
+    void closeTo (unsigned int depth);
+    void openPending ();
+
+    void openObject ();
+    void closeObject ();
+    void closeArray ();
+
+    void beginMember (const char* key, std::size_t length);
+    void newline (unsigned int depth);
+
+    void beginValue (unsigned int depth);
+    void endValue () { pending_ = false; }
+
+    void beginElement (unsigned int depth);
+
+    void put (std::nullptr_t);
+    void put (bool value);
+    void put (double value);
+    void put (const char* value);
+    void put (const std::string& value) { putString (value.data(), value.size()); }
+
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type
+    put (T value)
+    {
+        if (value < static_cast<T>(0))
+            putInteger (static_cast<long long> (value));
+        else
+            putUnsigned (static_cast<unsigned long long> (value));
+    }
+
+    template <std::size_t N>
+    void put (const unsigned char (&values)[N])
+    {
+        putByteArray (values, N);
+    }
+
+    void putUnsigned (unsigned long long value);
+    void putInteger (long long value);
+    void putString (const char* value, std::size_t length);
+    void putByteArray (const unsigned char* values, std::size_t count);
+
+    void putDecimal (unsigned long long value);
+    void putTextString (const char* value, std::size_t length);
+    void putHeader (std::uint8_t major, unsigned long long value);
+    void putBigEndian (unsigned long long value, unsigned int bytes);
+    void patchLength (std::size_t offset, unsigned int length);
+
+    template <typename T>
+    void assign (unsigned int depth, const T& value)
+    {
+        beginValue (depth);
+        put (value);
+        endValue ();
+    }
+
+    template <typename T>
+    void append (unsigned int depth, const T& value)
+    {
+        beginElement (depth);
+        put (value);
+    }
+};
+
+// see json_wanted() in common_structs.h
+inline bool json_wanted (JSONStreamNode& j, const char* name)
+{
+    return j.wants (name);
+}
+
+template <typename T>
+JSONStreamNode& JSONStreamNode::operator= (const T& value)
+{
+    assert (writer_);
+    if (!discard_)
+        writer_->assign (depth_, value);
+    return *this;
+}
+
+template <typename T>
+void JSONStreamNode::push_back (const T& value)
+{
+    assert (writer_);
+    if (!discard_)
+        writer_->append (depth_, value);
+}
+
+#endif // JSONSTREAMWRITER_H
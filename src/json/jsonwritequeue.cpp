@@ -0,0 +1,70 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "jsonwritequeue.h"
+
+#include <cassert>
+
+JSONWriteQueue::JSONWriteQueue (size_t capacity)
+    : capacity_ {capacity}
+{
+    assert (capacity_);
+}
+
+bool JSONWriteQueue::push (JSONWriteBatch&& batch)
+{
+    std::unique_lock<std::mutex> lock (mutex_);
+
+    not_full_.wait (lock, [this] { return batches_.size() < capacity_; });
+
+    batches_.push_back (std::move (batch));
+
+    if (consumer_running_)
+        return false;
+
+    consumer_running_ = true;
+    return true;
+}
+
+bool JSONWriteQueue::pop (JSONWriteBatch& batch)
+{
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+
+        assert (consumer_running_);
+
+        if (batches_.empty())
+        {
+            consumer_running_ = false;
+            done_.notify_all();
+            return false;
+        }
+
+        batch = std::move (batches_.front());
+        batches_.pop_front();
+    }
+
+    not_full_.notify_one();
+    return true;
+}
+
+void JSONWriteQueue::waitUntilDone ()
+{
+    std::unique_lock<std::mutex> lock (mutex_);
+
+    done_.wait (lock, [this] { return !consumer_running_ && batches_.empty(); });
+}
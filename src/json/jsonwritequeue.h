@@ -0,0 +1,74 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSONWRITEQUEUE_H
+#define JSONWRITEQUEUE_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// converted records, in output order
+struct JSONWriteBatch
+{
+    std::vector<std::string> data;
+    std::string zip_entry;
+    // if not empty, the data starts a new ZIP archive entry of this name
+    std::string rotate_file;
+    // if not empty, the file written so far is finished under this name first
+};
+
+/*
+ * Bounded queue of converted batches between the decoding thread and the
+ * task writing them to the output file.
+ *
+ * Up to capacity batches wait in the queue while another one is being
+ * written, so the conversion of the next batch overlaps with writing the
+ * previous ones. push() blocks only when the queue is full. The batches
+ * are written in the order they were pushed by a single consumer, which
+ * runs only while there is something to write: push() reports when the
+ * caller has to start it, pop() stops it when the queue has run empty.
+ */
+
+class JSONWriteQueue
+{
+public:
+    explicit JSONWriteQueue (size_t capacity);
+
+    // returns true if no consumer is running and one has to be started
+    bool push (JSONWriteBatch&& batch);
+
+    // returns false if the queue is empty, the consumer has to stop then
+    bool pop (JSONWriteBatch& batch);
+
+    // blocks until all pushed batches have been written
+    void waitUntilDone ();
+
+private:
+    size_t capacity_;
+
+    std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable done_;
+
+    std::deque<JSONWriteBatch> batches_;
+    bool consumer_running_ {false};
+};
+
+#endif // JSONWRITEQUEUE_H
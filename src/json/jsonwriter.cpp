@@ -16,25 +16,96 @@
  */
 
 #include "jsonwriter.h"
-#include "jsonfilewritetask.h"
+#include "jsonstreamwriter.h"
+#include "jsongzip.h"
+#include "json.hpp"
 #include "common.h"
 
+#include <algorithm>
 #include <vector>
 #include <tbb/tbb.h>
+#include <zlib.h>
 
 #include <archive.h>
 #include <archive_entry.h>
 
-#include <chrono>
-#include <thread>
-
-const unsigned int DATA_WRITE_SIZE = 1000;
+// records in a batch at most take about this much memory, the converted
+// batches waiting in the write queue take about as much each
+const size_t BATCH_MEMORY_BUDGET = 32 * 1024 * 1024;
+const unsigned int BINARY_CHUNK_SIZE = 64;
+const unsigned int WRITE_QUEUE_SIZE = 4;
+// input bytes per gzip member, each compressed on its own thread
+const size_t GZIP_BLOCK_SIZE = 256 * 1024;
+const int GZIP_LEVEL = 6;
 
 using namespace tbb;
 
 JSONWriter::JSONWriter(JSON_OUTPUT_TYPE json_output_type, const std::string& json_path)
-    : json_output_type_{json_output_type}, json_path_ {json_path}
+    : json_output_type_{json_output_type}, json_path_ {json_path},
+      zip_entry_records_ {json_zip_entry_records}, zip_entry_seconds_ {60.0 * json_zip_entry_minutes},
+      batch_min_size_ {json_batch_min_size}, batch_max_size_ {json_batch_max_size},
+      batch_max_latency_ {json_batch_max_latency}, write_queue_ {WRITE_QUEUE_SIZE}
 {
+    if (batch_max_size_ < batch_min_size_)
+    {
+        printf ("-> JSON batch maximum size %zu below minimum size, using %zu\n",
+                batch_max_size_, batch_min_size_);
+        batch_max_size_ = batch_min_size_;
+    }
+
+    batch_size_ = batch_min_size_;
+
+    if (json_path_.size() && JSONStreamSink::isStream (json_path_))
+    {
+        // a consumer reads records as they come, not an archive or a
+        // document closed only at the end
+        switch (json_output_type_)
+        {
+        case JSON_TEXT:
+        case JSON_ZIP_TEXT:
+        case JSON_ZIP_NDJSON:
+            printf ("-> JSON stream written as ndjson\n");
+            json_output_type_ = JSON_NDJSON;
+            break;
+        case JSON_ZIP_CBOR:
+            json_output_type_ = JSON_CBOR;
+            break;
+        case JSON_ZIP_MESSAGE_PACK:
+            json_output_type_ = JSON_MESSAGE_PACK;
+            break;
+        case JSON_ZIP_UBJSON:
+            json_output_type_ = JSON_UBJSON;
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (json_fields_path.size())
+    {
+        if (fields_.load (json_fields_path))
+            printf ("-> JSON fields written as listed in '%s'\n", json_fields_path.c_str());
+        else
+            printf ("-> JSON field profile '%s' ignored, writing all fields\n", json_fields_path.c_str());
+    }
+
+    if (json_gzip)
+    {
+        switch (json_output_type_)
+        {
+        case JSON_TEXT:
+        case JSON_NDJSON:
+        case JSON_CBOR:
+        case JSON_MESSAGE_PACK:
+        case JSON_UBJSON:
+            gzip_ = true;
+            break;
+        default:
+            printf ("-> JSON gzip compression only for file output types, ignored\n");
+            break;
+        }
+    }
+
     switch (json_output_type_)
     {
     case JSON_NONE:
@@ -42,12 +113,14 @@ JSONWriter::JSONWriter(JSON_OUTPUT_TYPE json_output_type, const std::string& jso
     case JSON_PRINT:
         break;
     case JSON_TEXT:
+    case JSON_NDJSON:
     case JSON_CBOR:
     case JSON_MESSAGE_PACK:
     case JSON_UBJSON:
         openJsonFile();
         break;
     case JSON_ZIP_TEXT:
+    case JSON_ZIP_NDJSON:
     case JSON_ZIP_CBOR:
     case JSON_ZIP_MESSAGE_PACK:
     case JSON_ZIP_UBJSON:
@@ -57,296 +130,309 @@ JSONWriter::JSONWriter(JSON_OUTPUT_TYPE json_output_type, const std::string& jso
         printf ("-> Unhandled JSON output type '%d' during construction\n", json_output_type_);
         break;
     }
+
+    if (batch_max_latency_.count() && (json_file_open_ || json_zip_file_open_ || stream_))
+        latency_thread_ = std::thread (&JSONWriter::writeLateBatches, this);
 }
 
 JSONWriter::~JSONWriter ()
 {
-    if (data_.size())
-        writeData();
+    if (latency_thread_.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock (batch_mutex_);
+            stop_latency_thread_ = true;
+        }
+        batch_started_.notify_one();
+        latency_thread_.join();
+    }
 
-    while (file_write_in_progress_)
-        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    flush ();
 
     if (json_file_open_)
         closeJsonFile ();
 
     if (json_zip_file_open_)
         closeJsonZipFile();
+
+    stream_.reset();
 }
 
 void JSONWriter::write(t_Adsb *adsb_ptr)
 {
     assert (adsb_ptr);
-
-    switch (json_output_type_)
-    {
-    case JSON_TEST:
-        break;
-    case JSON_PRINT:
-    {
-        nlohmann::json j;
-        adsb_ptr->toJSON(j);
-        j["rec_num"] = rec_num_cnt_++;
-        std::cout << "adsb json: " << j.dump(4) << std::endl;
-    }
-        break;
-    case JSON_TEXT:
-    case JSON_CBOR:
-    case JSON_MESSAGE_PACK:
-    case JSON_UBJSON:
-//        writeJsonToFile (j);
-//        break;
-    case JSON_ZIP_TEXT:
-    case JSON_ZIP_CBOR:
-    case JSON_ZIP_MESSAGE_PACK:
-    case JSON_ZIP_UBJSON:
-    {
-        t_Adsb* adsb_copy = new t_Adsb();
-        *adsb_copy = *adsb_ptr;
-        data_.push_back(dynamic_cast<JSONConvertible*>(adsb_copy));
-        //writeJsonToZipFile (j);
-    }
-        break;
-    default:
-        printf ("-> Unhandled JSON output type '%d' write\n", json_output_type_);
-        break;
-    }
-
-    if (data_.size() > DATA_WRITE_SIZE)
-        writeData();
+    writeRecord (*adsb_ptr, "adsb", e_object_adsb);
 }
 
 void JSONWriter::write(t_Mlat *mlat_ptr)
 {
     assert (mlat_ptr);
-
-    switch (json_output_type_)
-    {
-    case JSON_TEST:
-        break;
-    case JSON_PRINT:
-    {
-        nlohmann::json j;
-        mlat_ptr->toJSON(j);
-        j["rec_num"] = rec_num_cnt_++;
-        std::cout << "mlat json: " << j.dump(4) << std::endl;
-    }
-        break;
-    case JSON_TEXT:
-    case JSON_CBOR:
-    case JSON_MESSAGE_PACK:
-    case JSON_UBJSON:
-//        writeJsonToFile (j);
-//        break;
-    case JSON_ZIP_TEXT:
-    case JSON_ZIP_CBOR:
-    case JSON_ZIP_MESSAGE_PACK:
-    case JSON_ZIP_UBJSON:
-    {
-        //writeJsonToZipFile (j);
-        t_Mlat* mlat_copy = new t_Mlat();
-        *mlat_copy = *mlat_ptr;
-        data_.push_back(dynamic_cast<JSONConvertible*>(mlat_copy));
-    }
-        break;
-    default:
-        printf ("-> Unhandled JSON output type '%d' write\n", json_output_type_);
-        break;
-    }
-
-    if (data_.size() > DATA_WRITE_SIZE)
-        writeData();
+    writeRecord (*mlat_ptr, "mlat", e_object_mlat);
 }
 
 void JSONWriter::write(t_Rsrv *rsrv_ptr)
 {
     assert (rsrv_ptr);
+    writeRecord (*rsrv_ptr, "rsvr", e_object_rsrv);
+}
 
-    switch (json_output_type_)
-    {
-    case JSON_TEST:
-        break;
-    case JSON_PRINT:
-    {
-        nlohmann::json j;
-        rsrv_ptr->toJSON(j);
-        j["rec_num"] = rec_num_cnt_++;
-        std::cout << "rsvr json: " << j.dump(4) << std::endl;
-    }
-        break;
-    case JSON_TEXT:
-    case JSON_CBOR:
-    case JSON_MESSAGE_PACK:
-    case JSON_UBJSON:
-//        writeJsonToFile (j);
-//        break;
-    case JSON_ZIP_TEXT:
-    case JSON_ZIP_CBOR:
-    case JSON_ZIP_MESSAGE_PACK:
-    case JSON_ZIP_UBJSON:
-    {
-        t_Rsrv* rsrv_copy = new t_Rsrv();
-        *rsrv_copy = *rsrv_ptr;
-        data_.push_back(dynamic_cast<JSONConvertible*>(rsrv_copy));
-        //writeJsonToZipFile (j);
-    }
-        break;
-    default:
-        printf ("-> Unhandled JSON output type '%d' write\n", json_output_type_);
-        break;
-    }
+void JSONWriter::write(t_Rtgt *rtgt_ptr)
+{
+    assert (rtgt_ptr);
+    writeRecord (*rtgt_ptr, "rtgt", e_object_rtgt);
+}
+
+void JSONWriter::write(t_Strk *strk_ptr)
+{
+    assert (strk_ptr);
+    writeRecord (*strk_ptr, "track", e_object_strk);
+}
+
+void JSONWriter::flush ()
+{
+    std::lock_guard<std::mutex> lock (batch_mutex_);
 
-    if (data_.size() > DATA_WRITE_SIZE)
+    if (batch_.size())
         writeData();
+
+    write_queue_.waitUntilDone();
 }
 
-void JSONWriter::write(t_Rtgt *rtgt_ptr)
+void JSONWriter::printStatistics ()
 {
-    assert (rtgt_ptr);
+    std::lock_guard<std::mutex> lock (batch_mutex_);
+
+    if (!batches_written_)
+        return;
+
+    printf ("-> JSON: %zu record(s) written in %zu batch(es) of %zu to %zu records\n",
+            rec_num_cnt_, batches_written_, smallest_batch_, largest_batch_);
+    printf ("-> JSON: batch size %zu (%s), %zu full, %zu by latency, %zu by memory\n",
+            batch_size_, batch_size_settled_ ? "settled" : "still growing",
+            batches_full_, batches_latency_, batches_memory_);
 
+    if (zip_entries_.size())
+        printf ("-> JSON: %zu ZIP archive entries\n", zip_entries_.size());
+
+    if (gzip_)
+        printf ("-> JSON: %.3f MB compressed to %.3f MB\n",
+                bytes_converted_ / (1024.0 * 1024.0), bytes_compressed_ / (1024.0 * 1024.0));
+
+    if (stream_)
+        printf ("-> JSON: %.3f MB streamed, %.3f MB in %zu unit(s) dropped\n",
+                stream_->bytesWritten() / (1024.0 * 1024.0), stream_->bytesDropped() / (1024.0 * 1024.0),
+                stream_->unitsDropped());
+}
+
+template <typename T>
+void JSONWriter::writeRecord (T& record, const char* name, t_Object_Type type)
+{
     switch (json_output_type_)
     {
     case JSON_TEST:
         break;
     case JSON_PRINT:
-    {
-        nlohmann::json j;
-        rtgt_ptr->toJSON(j);
-        j["rec_num"] = rec_num_cnt_++;
-        std::cout << "rtgt json: " << j.dump(4) << std::endl;
-    }
+        std::cout << name << " json: " << printText (record, type) << std::endl;
         break;
     case JSON_TEXT:
+    case JSON_NDJSON:
     case JSON_CBOR:
     case JSON_MESSAGE_PACK:
     case JSON_UBJSON:
-//        writeJsonToFile (j);
-//        break;
     case JSON_ZIP_TEXT:
+    case JSON_ZIP_NDJSON:
     case JSON_ZIP_CBOR:
     case JSON_ZIP_MESSAGE_PACK:
     case JSON_ZIP_UBJSON:
     {
-        t_Rtgt* rtgt_copy = new t_Rtgt();
-        *rtgt_copy = *rtgt_ptr;
-        data_.push_back(dynamic_cast<JSONConvertible*>(rtgt_copy));
-        //writeJsonToZipFile (j);
-    }
+        std::lock_guard<std::mutex> lock (batch_mutex_);
+
+        if (json_zip_file_open_ && (zip_entry_records_ || zip_entry_seconds_ > 0))
+            checkZipEntry (record.frame_date, record.frame_time);
+        else if (json_file_open_ && rotation_defined())
+            checkRotation (record.frame_date, record.frame_time);
+
+        if (!batch_.size())
+        {
+            batch_start_ = std::chrono::steady_clock::now();
+            batch_started_.notify_one();
+        }
+
+        batch_.add (record);
+
+        if (batch_.size() >= batch_size_)
+        {
+            batches_full_++;
+            writeData(true);
+        }
+        else if (batch_.bytes() >= BATCH_MEMORY_BUDGET)
+        {
+            // a larger batch would not fit, stop growing
+            batches_memory_++;
+            batch_size_ = batch_.size();
+            batch_size_settled_ = true;
+            writeData();
+        }
+        else if (batch_max_latency_.count()
+                 && std::chrono::steady_clock::now() - batch_start_ >= batch_max_latency_)
+        {
+            batches_latency_++;
+            writeData();
+        }
         break;
+    }
     default:
         printf ("-> Unhandled JSON output type '%d' write\n", json_output_type_);
         break;
     }
-
-    if (data_.size() > DATA_WRITE_SIZE)
-        writeData();
 }
 
-void JSONWriter::write(t_Strk *strk_ptr)
+void JSONWriter::writeLateBatches ()
 {
-    assert (strk_ptr);
+    std::unique_lock<std::mutex> lock (batch_mutex_);
 
-    switch (json_output_type_)
-    {
-    case JSON_TEST:
-        break;
-    case JSON_PRINT:
+    while (!stop_latency_thread_)
     {
-        nlohmann::json j;
-        strk_ptr->toJSON(j);
-        j["rec_num"] = rec_num_cnt_++;
-        std::cout << "track json: " << j.dump(4) << std::endl;
+        if (!batch_.size())
+        {
+            batch_started_.wait (lock);
+            continue;
+        }
+
+        // the records come too slowly to fill the batch in time, or have
+        // stopped coming
+        std::chrono::steady_clock::time_point deadline = batch_start_ + batch_max_latency_;
+
+        if (std::chrono::steady_clock::now() >= deadline)
+        {
+            batches_latency_++;
+            writeData();
+        }
+        else
+            batch_started_.wait_until (lock, deadline);
     }
-        break;
-    case JSON_TEXT:
-    case JSON_CBOR:
-    case JSON_MESSAGE_PACK:
-    case JSON_UBJSON:
-//        writeJsonToFile (j);
-//        break;
-    case JSON_ZIP_TEXT:
-    case JSON_ZIP_CBOR:
-    case JSON_ZIP_MESSAGE_PACK:
-    case JSON_ZIP_UBJSON:
+}
+
+template <typename T>
+const std::string& JSONWriter::printText (T& record, t_Object_Type type)
+{
+    print_buffer_.clear();
+
+    JSONStreamWriter writer (print_buffer_, JSON_STREAM_TEXT, 4);
+    JSONStreamNode& j = writer.begin (fields_.fields (type));
+    record.toJSON (j);
+    j["rec_num"] = rec_num_cnt_++;
+    writer.end();
+
+    return print_buffer_;
+}
+
+void JSONWriter::checkRotation (const t_Frame_Date& frame_date, const t_Frame_Time& frame_time)
+{
+    // the size is that of the batches converted so far, so a file may
+    // exceed it by the batch still being collected
+    if (rotation_check (&rotation_, file_bytes_, frame_date.present, frame_date.value,
+                        frame_time.present, frame_time.value))
     {
-        t_Strk* strk_copy = new t_Strk();
-        *strk_copy = *strk_ptr;
-        data_.push_back(dynamic_cast<JSONConvertible*>(strk_copy));
-        //writeJsonToZipFile (j);
-    }
-        break;
-    default:
-        printf ("-> Unhandled JSON output type '%d' write\n", json_output_type_);
-        break;
+        char name[M_MAX_PATH_LENGTH];
+
+        rotation_name (&rotation_, json_path_.c_str(), name, sizeof (name));
+
+        // records of the finished file go out before it is renamed
+        if (batch_.size())
+            writeData();
+
+        pending_rotation_ = name;
+        file_bytes_ = 0;
     }
 
-    if (data_.size() > DATA_WRITE_SIZE)
-        writeData();
+    rotation_count (&rotation_, frame_date.present, frame_date.value,
+                    frame_time.present, frame_time.value);
 }
 
-void JSONWriter::writeData()
+void JSONWriter::checkZipEntry (const t_Frame_Date& frame_date, const t_Frame_Time& frame_time)
 {
-    assert (data_.size());
+    bool time_slices = zip_entry_seconds_ > 0 && frame_time.present;
+    long slice = time_slices ? static_cast<long> (frame_time.value / zip_entry_seconds_) : 0;
 
-    // convert to json
-    assert (!json_data_.size());
-    json_data_.resize(data_.size());
+    if (zip_entries_.size())
+    {
+        ZipEntryInfo& entry = zip_entries_.back();
+
+        bool full = zip_entry_records_ && entry.records >= zip_entry_records_;
+        bool next_day = frame_date.present && entry.frame_date.present
+                && (frame_date.value.day != entry.frame_date.value.day
+                    || frame_date.value.month != entry.frame_date.value.month
+                    || frame_date.value.year != entry.frame_date.value.year);
+        bool next_slice = time_slices && (slice != zip_entry_slice_ || next_day);
+
+        if (!full && !next_slice)
+        {
+            entry.records++;
+
+            if (frame_time.present)
+            {
+                if (!entry.first_frame_time.present)
+                    entry.first_frame_time = frame_time;
+                entry.last_frame_time = frame_time;
+            }
+            return;
+        }
+
+        // records of the previous entry go out before the new entry starts
+        if (batch_.size())
+            writeData();
+    }
 
-    //size_t cnt = 0;
-    size_t size = data_.size();
+    // named by sequence number, date and time range (or start time)
 
-//    for( size_t i=0; i!=n; ++i )
-//            Foo(a[i]);
+    ZipEntryInfo entry;
+    char text[64];
 
-    tbb::parallel_for( size_t(0), size, [&]( size_t cnt )
+    snprintf (text, sizeof (text), "%04zu", zip_entries_.size() + 1);
+    entry.name = text;
+
+    if (frame_date.present)
     {
-        JSONConvertible* data_ptr = data_.at(cnt);
-
-        nlohmann::json j;
-        if (dynamic_cast<t_Adsb*>(data_ptr))
-            dynamic_cast<t_Adsb*>(data_ptr)->toJSON (j);
-        else if (dynamic_cast<t_Mlat*>(data_ptr))
-            dynamic_cast<t_Mlat*>(data_ptr)->toJSON (j);
-        else if (dynamic_cast<t_Rsrv*>(data_ptr))
-            dynamic_cast<t_Rsrv*>(data_ptr)->toJSON (j);
-        else if (dynamic_cast<t_Rtgt*>(data_ptr))
-            dynamic_cast<t_Rtgt*>(data_ptr)->toJSON (j);
-        else if (dynamic_cast<t_Strk*>(data_ptr))
-            dynamic_cast<t_Strk*>(data_ptr)->toJSON (j);
-        else
-            assert (false);
+        snprintf (text, sizeof (text), "_%04d%02d%02d",
+                  frame_date.value.year, frame_date.value.month, frame_date.value.day);
+        entry.name += text;
+    }
+
+    if (frame_time.present)
+    {
+        long start = time_slices ? static_cast<long> (slice * zip_entry_seconds_)
+                                 : static_cast<long> (frame_time.value);
 
-        delete data_ptr;
+        snprintf (text, sizeof (text), "_%02ld%02ld%02ld", start / 3600, start / 60 % 60, start % 60);
+        entry.name += text;
 
-        json_data_[cnt] = std::move (j);
-    } );
+        if (time_slices)
+        {
+            long end = static_cast<long> ((slice + 1) * zip_entry_seconds_);
+
+            snprintf (text, sizeof (text), "-%02ld%02ld%02ld", end / 3600, end / 60 % 60, end % 60);
+            entry.name += text;
+        }
+    }
 
-    for (nlohmann::json& j_it : json_data_)
-        j_it["rec_num"] = rec_num_cnt_++;
-
-//    for (JSONConvertible* data_ptr : data_)
-//    {
-//        nlohmann::json j;
-//        if (dynamic_cast<t_Adsb*>(data_ptr))
-//            dynamic_cast<t_Adsb*>(data_ptr)->toJSON (j);
-//        else if (dynamic_cast<t_Mlat*>(data_ptr))
-//            dynamic_cast<t_Mlat*>(data_ptr)->toJSON (j);
-//        else if (dynamic_cast<t_Rsrv*>(data_ptr))
-//            dynamic_cast<t_Rsrv*>(data_ptr)->toJSON (j);
-//        else if (dynamic_cast<t_Rtgt*>(data_ptr))
-//            dynamic_cast<t_Rtgt*>(data_ptr)->toJSON (j);
-//        else if (dynamic_cast<t_Strk*>(data_ptr))
-//            dynamic_cast<t_Strk*>(data_ptr)->toJSON (j);
-//        else
-//            assert (false);
-
-//        delete data_ptr;
-
-//        json_data_[cnt] = std::move (j);
-//        ++cnt;
-//    }
-    assert (data_.size() == json_data_.size());
-    data_.clear();
+    entry.name += json_zip_extension_;
+    entry.records = 1;
+    entry.frame_date = frame_date;
+    entry.first_frame_time = frame_time;
+    entry.last_frame_time = frame_time;
+
+    zip_entry_slice_ = slice;
+    pending_zip_entry_ = entry.name;
+    zip_entries_.push_back (entry);
+}
+
+void JSONWriter::writeData(bool full)
+{
+    assert (batch_.size());
+
+    size_t size = batch_.size();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
     // convert to string or binary data
 
@@ -354,19 +440,23 @@ void JSONWriter::writeData()
     {
     case JSON_TEXT:
     case JSON_ZIP_TEXT:
-        convertJSON2Text();
+        convertData2Text(4);
+        break;
+    case JSON_NDJSON:
+    case JSON_ZIP_NDJSON:
+        convertData2Text(-1);
         break;
     case JSON_CBOR:
     case JSON_ZIP_CBOR:
-        convertJSON2CBOR();
+        convertData2Binary(JSON_STREAM_CBOR);
         break;
     case JSON_MESSAGE_PACK:
     case JSON_ZIP_MESSAGE_PACK:
-        convertJSON2MsgPack();
+        convertData2Binary(JSON_STREAM_MESSAGE_PACK);
         break;
     case JSON_UBJSON:
     case JSON_ZIP_UBJSON:
-        convertJSON2UBJSON();
+        convertData2Binary(JSON_STREAM_UBJSON);
         break;
     case JSON_TEST:
     case JSON_PRINT:
@@ -375,131 +465,201 @@ void JSONWriter::writeData()
         break;
     }
 
-    assert (!json_data_.size());
+    assert (!batch_.size());
 
-    switch (json_output_type_)
+    // only full batches tell how the batch size affects the conversion
+    if (full)
+        adaptBatchSize (size, std::chrono::duration<double> (std::chrono::steady_clock::now() - start).count());
+
+    if (!batches_written_ || size < smallest_batch_)
+        smallest_batch_ = size;
+    if (size > largest_batch_)
+        largest_batch_ = size;
+    batches_written_++;
+
+    // written in the background, in the order of conversion
+
+    std::vector <std::string>& data = text_data_.size() ? text_data_ : binary_data_;
+
+    if (gzip_)
     {
-    case JSON_TEXT:
-        writeTextToFile ();
-        break;
-    case JSON_CBOR:
-    case JSON_MESSAGE_PACK:
-    case JSON_UBJSON:
-        writeBinaryToFile ();
-        break;
-    case JSON_ZIP_TEXT:
-        writeTextToZipFile();
-        break;
-    case JSON_ZIP_CBOR:
-    case JSON_ZIP_MESSAGE_PACK:
-    case JSON_ZIP_UBJSON:
-        writeBinaryToZipFile ();
-        break;
-    case JSON_TEST:
-    case JSON_PRINT:
-    default:
-        printf ("-> Unhandled JSON output type '%d' writeData\n", json_output_type_);
-        break;
+        if (compressData (data))
+            queueData (gzip_data_);
     }
+    else
+        queueData (data);
 
     assert (!text_data_.size());
     assert (!binary_data_.size());
+    assert (!gzip_data_.size());
 }
 
-void JSONWriter::convertJSON2Text ()
+bool JSONWriter::compressData (std::vector <std::string>& data)
 {
-    assert (!text_data_.size());
-    text_data_.resize(json_data_.size());
+    assert (data.size());
 
-    size_t size = json_data_.size();
+    // nothing more is written once compression failed, the file ends with
+    // the last complete member
+    int ret = gzip_failed_ ? Z_OK : compressGzipMembers (data, gzip_data_, GZIP_BLOCK_SIZE, GZIP_LEVEL);
 
-    tbb::parallel_for( size_t(0), size, [&]( size_t cnt )
+    if (ret != Z_OK)
     {
-        text_data_[cnt] = json_data_.at(cnt).dump(4) + "\n";
-    } );
+        printf ("-> JSON gzip compression failed (%s), compressed output stopped\n", zError (ret));
+        gzip_failed_ = true;
+    }
 
-//    size_t cnt = 0;
+    for (const std::string& buffer : data)
+        bytes_converted_ += buffer.size();
+    for (const std::string& buffer : gzip_data_)
+        bytes_compressed_ += buffer.size();
 
-//    for (nlohmann::json& j_it : json_data_)
-//        text_data_[cnt++] = j_it.dump(4) + "\n";
+    data.clear();
 
-    assert (text_data_.size() == json_data_.size());
-    json_data_.clear();
+    return !gzip_failed_;
 }
 
-void JSONWriter::convertJSON2CBOR ()
+void JSONWriter::adaptBatchSize (size_t size, double seconds)
 {
-    assert (!binary_data_.size());
-    binary_data_.resize(json_data_.size());
+    if (batch_size_settled_)
+        return;
 
-    size_t size = json_data_.size();
+    double record_time = seconds / size;
 
-    tbb::parallel_for( size_t(0), size, [&]( size_t cnt )
+    // keep doubling while that saves more than 5% per record, then go back to the best size
+    if (!best_batch_size_ || record_time < 0.95 * best_record_time_)
     {
-        binary_data_[cnt] = nlohmann::json::to_cbor(json_data_.at(cnt));
-    } );
+        best_batch_size_ = batch_size_;
+        best_record_time_ = record_time;
 
-//    size_t cnt = 0;
-//    for (nlohmann::json& j_it : json_data_)
-//        binary_data_[cnt++] = nlohmann::json::to_cbor(j_it);
+        batch_size_ = std::min (2 * batch_size_, batch_max_size_);
 
-    assert (json_data_.size() == binary_data_.size());
-    json_data_.clear();
+        if (batch_size_ == best_batch_size_)
+            batch_size_settled_ = true;
+    }
+    else
+    {
+        batch_size_ = best_batch_size_;
+        batch_size_settled_ = true;
+    }
 }
 
-void JSONWriter::convertJSON2UBJSON ()
+void JSONWriter::convertData2Text (int indent)
 {
-    assert (!binary_data_.size());
-    binary_data_.resize(json_data_.size());
+    assert (!text_data_.size());
+    text_data_.resize(batch_.size());
 
-    size_t size = json_data_.size();
+    size_t size = batch_.size();
+    size_t rec_num_base = rec_num_cnt_;
 
+    // written straight from the records, each thread reusing its buffer
     tbb::parallel_for( size_t(0), size, [&]( size_t cnt )
     {
-        binary_data_[cnt] = nlohmann::json::to_ubjson(json_data_.at(cnt));
+        std::string& buffer = text_buffers_.local();
+
+        buffer.clear();
+
+        JSONStreamWriter writer (buffer, JSON_STREAM_TEXT, indent);
+        JSONStreamNode& j = writer.begin (fields_.fields (batch_.type (cnt)));
+        batch_.toJSON (cnt, j);
+        j["rec_num"] = rec_num_base + cnt;
+        writer.end();
+
+        buffer += '\n';
+
+        text_data_[cnt] = buffer;
     } );
 
-//    size_t cnt = 0;
-//    for (nlohmann::json& j_it : json_data_)
-//        binary_data_[cnt++] = nlohmann::json::to_ubjson(j_it);
+    rec_num_cnt_ += size;
 
-    assert (json_data_.size() == binary_data_.size());
-    json_data_.clear();
+    assert (text_data_.size() == batch_.size());
+    batch_.clear();
 }
-void JSONWriter::convertJSON2MsgPack ()
+
+void JSONWriter::convertData2Binary (JSON_STREAM_FORMAT format)
 {
     assert (!binary_data_.size());
-    binary_data_.resize(json_data_.size());
 
-    size_t size = json_data_.size();
+    size_t size = batch_.size();
+    size_t num_chunks = (size + BINARY_CHUNK_SIZE - 1) / BINARY_CHUNK_SIZE;
+    size_t rec_num_base = rec_num_cnt_;
+    size_t chunk_reserve = BINARY_CHUNK_SIZE * binary_record_size_;
+    // records on a stream are framed by their length, 4 bytes big-endian
+    bool framed = stream_ != nullptr;
 
-    tbb::parallel_for( size_t(0), size, [&]( size_t cnt )
+    binary_data_.resize(num_chunks);
+
+    // each chunk of records is encoded into one contiguous buffer
+    tbb::parallel_for( size_t(0), num_chunks, [&]( size_t chunk )
     {
-        binary_data_[cnt] = nlohmann::json::to_msgpack(json_data_.at(cnt));
+        std::string& buffer = binary_data_[chunk];
+        size_t end = std::min (size, (chunk + 1) * BINARY_CHUNK_SIZE);
+
+        buffer.reserve(chunk_reserve);
+
+        for (size_t cnt = chunk * BINARY_CHUNK_SIZE; cnt < end; cnt++)
+        {
+            size_t start = buffer.size();
+
+            if (framed)
+                buffer.append (4, '\0');
+
+            JSONStreamWriter writer (buffer, format);
+            JSONStreamNode& j = writer.begin (fields_.fields (batch_.type (cnt)));
+            batch_.toJSON (cnt, j);
+            j["rec_num"] = rec_num_base + cnt;
+            writer.end();
+
+            if (framed)
+            {
+                size_t length = buffer.size() - start - 4;
+
+                buffer[start] = static_cast<char> (length >> 24);
+                buffer[start + 1] = static_cast<char> (length >> 16);
+                buffer[start + 2] = static_cast<char> (length >> 8);
+                buffer[start + 3] = static_cast<char> (length);
+            }
+        }
     } );
 
-//    size_t cnt = 0;
-//    for (nlohmann::json& j_it : json_data_)
-//        binary_data_[cnt++] = nlohmann::json::to_msgpack(j_it);
+    size_t bytes = 0;
+    for (const std::string& buffer : binary_data_)
+        bytes += buffer.size();
 
-    assert (json_data_.size() == binary_data_.size());
-    json_data_.clear();
-}
+    // reserved for the next batch, with some headroom
+    binary_record_size_ = bytes / size + bytes / size / 8;
 
+    rec_num_cnt_ += size;
+
+    batch_.clear();
+}
 
 void JSONWriter::openJsonFile ()
 {
     Assert (json_file_open_ == FALSE, "JSON export file already open");
 
+    if (JSONStreamSink::isStream (json_path_))
+    {
+        stream_.reset (new JSONStreamSink {json_path_, json_stream_policy, json_stream_buffer_size});
+
+        if (!stream_->isOpen())
+            printf ("-> JSON stream '%s' not open, records are dropped\n", json_path_.c_str());
+
+        return;
+    }
+
     switch (json_output_type_)
     {
     case JSON_TEXT:
-        json_file_.open (json_path);
+    case JSON_NDJSON:
+        if (gzip_)
+            json_file_mode_ = ios::out | ios::binary;
+        json_file_.open (json_path_, json_file_mode_);
         break;
     case JSON_CBOR:
     case JSON_MESSAGE_PACK:
     case JSON_UBJSON:
-        json_file_.open (json_path, ios::out | ios::binary);
+        json_file_mode_ = ios::out | ios::binary;
+        json_file_.open (json_path_, json_file_mode_);
         break;
     default:
         printf ("-> Unhandled JSON output type '%d' during open\n", json_output_type_);
@@ -509,54 +669,97 @@ void JSONWriter::openJsonFile ()
     json_file_open_ = TRUE;
 }
 
-void JSONWriter::writeTextToFile ()
+void JSONWriter::queueData (std::vector <std::string>& data)
 {
-    Assert (json_file_open_ == TRUE, "JSON export file not open");
-    assert (text_data_.size());
-
-//    for (const std::string str_it : text_data_)
-//        json_file_ << str_it;
+    assert (json_file_open_ || json_zip_file_open_ || stream_);
+    assert (data.size());
 
-//    text_data_.clear();
+    for (const std::string& buffer : data)
+        file_bytes_ += buffer.size();
 
-    while (file_write_in_progress_)
-        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    JSONWriteBatch batch;
+    batch.data = std::move (data);
+    batch.zip_entry = std::move (pending_zip_entry_);
+    batch.rotate_file = std::move (pending_rotation_);
 
-    file_write_in_progress_ = true;
+    // enqueued work always gets a worker thread of the arena, even while
+    // this thread is busy converting the next batch
+    if (write_queue_.push (std::move(batch)))
+        write_arena_.enqueue ([this] { writeQueuedData(); });
 
-    JSONTextFileWriteTask* write_task = new (tbb::task::allocate_root()) JSONTextFileWriteTask (
-                json_file_, std::move(text_data_), *this);
-    tbb::task::enqueue(*write_task);
-
-    assert (!text_data_.size());
+    data.clear();
+    pending_zip_entry_.clear();
+    pending_rotation_.clear();
 }
 
-void JSONWriter::writeBinaryToFile ()
+void JSONWriter::writeQueuedData ()
 {
-    Assert (json_file_open_ == TRUE, "JSON export file not open");
-    assert (binary_data_.size());
+    JSONWriteBatch batch;
+
+    while (write_queue_.pop (batch))
+    {
+        if (stream_)
+        {
+            // each buffer is a record or a chunk of records, dropped whole
+            for (const std::string& buffer : batch.data)
+                stream_->write (buffer);
+        }
+        else if (json_file_open_)
+        {
+            if (batch.rotate_file.size())
+                rotateJsonFile (batch.rotate_file);
+
+            for (const std::string& buffer : batch.data)
+                json_file_.write (buffer.data(), buffer.size());
+
+            // readers following the file see every batch once written
+            json_file_.flush();
+        }
+        else
+        {
+            if (batch.zip_entry.size())
+                startJsonZipEntry (batch.zip_entry);
 
-//    for (const std::vector<std::uint8_t>& bin_it : binary_data_)
-//        json_file_.write (reinterpret_cast<const char*>(bin_it.data()), bin_it.size());
+            for (const std::string& buffer : batch.data)
+                archive_write_data (json_zip_file_, buffer.data(), buffer.size());
+        }
 
-//    binary_data_.clear();
+        batch.data.clear();
+        batch.zip_entry.clear();
+        batch.rotate_file.clear();
+    }
+}
 
-    while (file_write_in_progress_)
-        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+void JSONWriter::rotateJsonFile (const std::string& name)
+{
+    json_file_.close();
 
-    file_write_in_progress_ = true;
+    if (rename (json_path_.c_str(), name.c_str()) != 0)
+        printf ("-> Cannot rename JSON file to '%s'\n", name.c_str());
 
-    JSONBinaryFileWriteTask* write_task = new (tbb::task::allocate_root()) JSONBinaryFileWriteTask (
-                json_file_, std::move(binary_data_), *this);
-    tbb::task::enqueue(*write_task);
+    // compressed in the background, unless it is gzip already
+    finish_file (NULL, name.c_str(), rotate_gzip && !gzip_);
 
-    assert (!binary_data_.size());
+    json_file_.open (json_path_, json_file_mode_);
 }
 
 void JSONWriter::closeJsonFile ()
 {
     json_file_.close();
     json_file_open_ = FALSE;
+
+    // the last file of a rotated series is named like the others
+    if (rotation_defined() && rotation_.count)
+    {
+        char name[M_MAX_PATH_LENGTH];
+
+        rotation_name (&rotation_, json_path_.c_str(), name, sizeof (name));
+
+        if (rename (json_path_.c_str(), name) != 0)
+            printf ("-> Cannot rename JSON file to '%s'\n", name);
+
+        finish_file (NULL, name, rotate_gzip && !gzip_);
+    }
 }
 
 void JSONWriter::openJsonZipFile ()
@@ -567,20 +770,23 @@ void JSONWriter::openJsonZipFile ()
     archive_write_set_format_zip(json_zip_file_);
     archive_write_open_filename(json_zip_file_, json_path_.c_str());
 
-    std::string filename{"text.json"};
+    json_zip_extension_ = ".json";
 
     switch (json_output_type_)
     {
     case JSON_ZIP_TEXT:
         break;
+    case JSON_ZIP_NDJSON:
+        json_zip_extension_ = ".ndjson";
+        break;
     case JSON_ZIP_CBOR:
-        filename = "text.json.cbor";
+        json_zip_extension_ = ".json.cbor";
         break;
     case JSON_ZIP_MESSAGE_PACK:
-        filename = "text.json.msgpack";
+        json_zip_extension_ = ".json.msgpack";
         break;
     case JSON_ZIP_UBJSON:
-        filename = "text.json.ubjson";
+        json_zip_extension_ = ".json.ubjson";
         break;
     default:
         printf ("-> Unhandled JSON output type '%d' during open\n", json_output_type_);
@@ -588,58 +794,75 @@ void JSONWriter::openJsonZipFile ()
     }
 
     json_zip_file_entry_ = archive_entry_new();
-    archive_entry_set_pathname(json_zip_file_entry_, filename.c_str());
-    archive_entry_set_filetype(json_zip_file_entry_, AE_IFREG);
-    archive_entry_set_perm(json_zip_file_entry_, 0644);
-    archive_write_header(json_zip_file_, json_zip_file_entry_);
+
+    // otherwise the entries are started as records arrive
+    if (!zip_entry_records_ && zip_entry_seconds_ <= 0)
+        startJsonZipEntry ("text" + json_zip_extension_);
 
     json_zip_file_open_ = TRUE;
 }
 
-void JSONWriter::writeTextToZipFile ()
+void JSONWriter::startJsonZipEntry (const std::string& name)
 {
-    Assert (json_zip_file_open_ == TRUE, "JSON export file not open");
-    assert (text_data_.size());
-
-//    for (const std::string str_it : text_data_)
-//        archive_write_data (json_zip_file_, str_it.c_str(), str_it.size());
-
-    while (file_write_in_progress_)
-        std::this_thread::sleep_for(std::chrono::milliseconds(5));
-
-    file_write_in_progress_ = true;
+    if (json_zip_entry_open_)
+        archive_write_finish_entry(json_zip_file_);
 
-    JSONTextZipFileWriteTask* write_task = new (tbb::task::allocate_root()) JSONTextZipFileWriteTask (
-                json_zip_file_, std::move(text_data_), *this);
-    tbb::task::enqueue(*write_task);
+    archive_entry_clear(json_zip_file_entry_);
+    archive_entry_set_pathname(json_zip_file_entry_, name.c_str());
+    archive_entry_set_filetype(json_zip_file_entry_, AE_IFREG);
+    archive_entry_set_perm(json_zip_file_entry_, 0644);
+    archive_write_header(json_zip_file_, json_zip_file_entry_);
 
-    text_data_.clear();
+    json_zip_entry_open_ = true;
 }
 
-void JSONWriter::writeBinaryToZipFile ()
+void JSONWriter::writeJsonZipManifest ()
 {
-    Assert (json_zip_file_open_ == TRUE, "JSON export file not open");
-    assert (binary_data_.size());
-
-//    for (const std::vector<std::uint8_t> bin_it : binary_data_)
-//        archive_write_data (json_zip_file_, reinterpret_cast<const void*>(bin_it.data()), bin_it.size());
+    nlohmann::json manifest;
 
-//    binary_data_.clear();
+    if (zip_entry_records_)
+        manifest["entry_records"] = zip_entry_records_;
+    if (zip_entry_seconds_ > 0)
+        manifest["entry_minutes"] = zip_entry_seconds_ / 60;
 
-    while (file_write_in_progress_)
-        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    manifest["entries"] = nlohmann::json::array();
 
-    file_write_in_progress_ = true;
+    for (const ZipEntryInfo& info : zip_entries_)
+    {
+        nlohmann::json entry;
+
+        entry["name"] = info.name;
+        entry["records"] = info.records;
+
+        if (info.frame_date.present)
+        {
+            char text[16];
+            snprintf (text, sizeof (text), "%04d-%02d-%02d",
+                      info.frame_date.value.year, info.frame_date.value.month, info.frame_date.value.day);
+            entry["frame_date"] = text;
+        }
+
+        if (info.first_frame_time.present)
+        {
+            entry["first_frame_time"] = info.first_frame_time.value;
+            entry["last_frame_time"] = info.last_frame_time.value;
+        }
+
+        manifest["entries"].push_back (entry);
+    }
 
-    JSONBinaryZipFileWriteTask* write_task = new (tbb::task::allocate_root()) JSONBinaryZipFileWriteTask (
-                json_zip_file_, std::move(binary_data_), *this);
-    tbb::task::enqueue(*write_task);
+    std::string text = manifest.dump(4) + '\n';
 
-    assert (!binary_data_.size());
+    startJsonZipEntry ("manifest.json");
+    archive_write_data (json_zip_file_, text.data(), text.size());
 }
 
 void JSONWriter::closeJsonZipFile ()
 {
+    // the writer is idle, all records are in the archive
+    if (zip_entry_records_ || zip_entry_seconds_ > 0)
+        writeJsonZipManifest ();
+
     archive_entry_free(json_zip_file_entry_);
     archive_write_close(json_zip_file_); // Note 4
     archive_write_free(json_zip_file_); // Note 5
@@ -30,11 +30,23 @@
 #include <fstream>
 
 #include <vector>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/task_arena.h>
+
+#include "jsonfields.h"
+#include "jsonstreamsink.h"
+#include "jsonstreamwriter.h"
+#include "jsonrecordbatch.h"
+#include "jsonwritequeue.h"
 
 class archive;
 class archive_entry;
-struct JSONConvertible;
-class JSONFileWriteTask;
 
 class JSONWriter
 {
@@ -48,7 +60,9 @@ public:
     void write(t_Rtgt *rtgt_ptr);
     void write(t_Strk *strk_ptr);
 
-    void fileWritingDone () { file_write_in_progress_ = false ;}
+    // writes all pending records and waits until they are in the file
+    void flush ();
+    void printStatistics ();
 
 private:
     JSON_OUTPUT_TYPE json_output_type_;
@@ -56,34 +70,112 @@ private:
 
     bool json_file_open_ {false};
     std::ofstream json_file_;
+    std::ios::openmode json_file_mode_ {std::ios::out};
+
+    // file rotated by size, record count or frame time, see rotate.cpp
+    t_Rotation rotation_ {};
+    size_t file_bytes_ {0};
+    std::string pending_rotation_;
 
     bool json_zip_file_open_ {false};
     struct archive* json_zip_file_ {nullptr};
     struct archive_entry* json_zip_file_entry_ {nullptr};
+    bool json_zip_entry_open_ {false};
+    std::string json_zip_extension_;
+
+    // live output to a consumer instead of json_file_, for a stream path
+    std::unique_ptr<JSONStreamSink> stream_;
+
+    // ZIP archive split into entries by record count or frame time, listed in a manifest
+    struct ZipEntryInfo
+    {
+        std::string name;
+        size_t records {0};
+        t_Frame_Date frame_date;
+        t_Frame_Time first_frame_time;
+        t_Frame_Time last_frame_time;
+    };
+
+    size_t zip_entry_records_;
+    t_Secs zip_entry_seconds_;
+    std::vector <ZipEntryInfo> zip_entries_;
+    long zip_entry_slice_ {0};
+    std::string pending_zip_entry_;
+
+    // members written per report type, from -json-fields=
+    JSONFields fields_;
 
     size_t rec_num_cnt_ {0};
-    std::vector <JSONConvertible*> data_;
-    std::vector <nlohmann::json> json_data_;
+    JSONRecordBatch batch_;
+    std::chrono::steady_clock::time_point batch_start_;
+
+    // a partial batch is written by latency_thread_ once it is older than
+    // batch_max_latency_, also when no further record comes; batch_mutex_
+    // guards the batch and the writing of it
+    std::mutex batch_mutex_;
+    std::condition_variable batch_started_;
+    std::thread latency_thread_;
+    bool stop_latency_thread_ {false};
+
+    // batch size, grown from the minimum while the conversion time per record drops
+    size_t batch_min_size_;
+    size_t batch_max_size_;
+    std::chrono::milliseconds batch_max_latency_;
+    size_t batch_size_;
+    size_t best_batch_size_ {0};
+    double best_record_time_ {0};
+    bool batch_size_settled_ {false};
+
+    size_t batches_written_ {0};
+    size_t batches_full_ {0};
+    size_t batches_latency_ {0};
+    size_t batches_memory_ {0};
+    size_t smallest_batch_ {0};
+    size_t largest_batch_ {0};
+
+    bool gzip_ {false};
+    bool gzip_failed_ {false};
+    size_t bytes_converted_ {0};
+    size_t bytes_compressed_ {0};
     std::vector <std::string> text_data_;
-    std::vector <std::vector<std::uint8_t>> binary_data_;
+    std::vector <std::string> binary_data_;
+    std::vector <std::string> gzip_data_;
+    size_t binary_record_size_ {1024};
+
+    tbb::enumerable_thread_specific<std::string> text_buffers_;
+    std::string print_buffer_;
+
+    JSONWriteQueue write_queue_;
+    tbb::task_arena write_arena_ {1, 0};
+
+    template <typename T>
+    void writeRecord (T& record, const char* name, t_Object_Type type);
+    void writeLateBatches ();
+
+    void checkRotation (const t_Frame_Date& frame_date, const t_Frame_Time& frame_time);
+    void checkZipEntry (const t_Frame_Date& frame_date, const t_Frame_Time& frame_time);
+    void writeData(bool full = false);
+    void adaptBatchSize (size_t size, double seconds);
 
-    bool file_write_in_progress_ {false};
+    template <typename T>
+    const std::string& printText (T& record, t_Object_Type type);
 
-    void writeData();
+    // indent < 0 writes one compact record per line
+    void convertData2Text (int indent);
+    void convertData2Binary (JSON_STREAM_FORMAT format);
 
-    void convertJSON2Text ();
-    void convertJSON2CBOR ();
-    void convertJSON2UBJSON ();
-    void convertJSON2MsgPack ();
+    // false once compression failed; data is then dropped
+    bool compressData (std::vector <std::string>& data);
+    void queueData (std::vector <std::string>& data);
+    void writeQueuedData ();
 
     void openJsonFile ();
-    void writeTextToFile ();
-    void writeBinaryToFile ();
+    void rotateJsonFile (const std::string& name);
     void closeJsonFile ();
 
     void openJsonZipFile ();
-    void writeTextToZipFile ();
-    void writeBinaryToZipFile ();
+    void startJsonZipEntry (const std::string& name);
+    void writeJsonZipManifest ();
     void closeJsonZipFile ();
 };
 
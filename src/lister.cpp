@@ -69,6 +69,12 @@ static void initiate (void);
 	Assert (length > 0, "Invalid parameter");
 	Assert (buffer != NULL, "Invalid parameter");
 
+                   /* Hand to the embedding program, if any: */
+	if (hook_error (offset, *text_ptr ? text_ptr : "Bad frame"))
+	{
+		return;
+	}
+
 	fprintf (stderr, "-> ");
 	if (*text_ptr)
 	{
@@ -266,7 +272,6 @@ static void initiate (void);
 
  void list_adsb (t_Adsb *adsb_ptr)
 {
-	int ix;
 	t_Bool new_sensor;
 	t_Secs tm;
 	t_Bool to_be_listed;
@@ -311,43 +316,16 @@ static void initiate (void);
 
                    /* Check for sensor number: */
 	new_sensor = FALSE;
-	if (!adsb_ptr->sensor_number.present)
+	if (!adsb_ptr->sensor_number.present &&
+        adsb_ptr->data_source_identifier.present)
 	{
-		if (adsb_ptr->data_source_identifier.present)
-		{
-			t_Ui16 dsi;
-			t_Bool found;
-
-			found = FALSE;
-			dsi = adsb_ptr->data_source_identifier.value;
-			for (ix = 0; ix < M_MAX_NUMBER_OF_SENSORS; ix ++)
-			{
-				if (sacsic_list[ix].orig_defined &&
-                    sacsic_list[ix].orig == dsi)
-				{
-					found = TRUE;
-					break;
-				}
-			}
+		t_Ui16 sno;
 
-			if (!found)
-			{
-				for (ix = 0; ix < M_MAX_NUMBER_OF_SENSORS; ix ++)
-				{
-					if (sacsic_list[ix].rsap_defined &&
-                        sacsic_list[ix].rsap == dsi)
-					{
-						found = TRUE;
-						break;
-					}
-				}
-			}
-
-			if (found)
-			{
-				adsb_ptr->sensor_number.present = TRUE;
-				adsb_ptr->sensor_number.value = 1 + ix;
-			}
+		if (find_sensor (adsb_ptr->data_source_identifier.value,
+                         &sno, &new_sensor) == RC_OKAY)
+		{
+			adsb_ptr->sensor_number.present = TRUE;
+			adsb_ptr->sensor_number.value = sno;
 		}
 	}
 
@@ -760,8 +738,11 @@ static void initiate (void);
 	Assert (length > 0, "Invalid parameter");
 	Assert (buffer != NULL, "Invalid parameter");
 
-				   /* Check if list file available: */
-	Assert (list_file != NULL, "No list file");
+				   /* Check if list file available (not so for the decoder API): */
+	if (list_file == NULL)
+	{
+		return;
+	}
 
                    /* Check if package has been initiated: */
 	if (!initiated)
@@ -820,8 +801,11 @@ static void initiate (void);
 	Assert (length > 0, "Invalid frame length");
 	Assert (buffer != NULL, "NULL pointer");
 
-				   /* Check if list file available: */
-	Assert (list_file != NULL, "No list file");
+				   /* Check if list file available (not so for the decoder API): */
+	if (list_file == NULL)
+	{
+		return;
+	}
 
                    /* Check if package has been initiated: */
 	if (!initiated)
@@ -871,7 +855,6 @@ static void initiate (void);
 
  void list_mlat (t_Mlat *mlat_ptr)
 {
-	int ix;
 	t_Bool new_sensor;
 	t_Secs tm;
 	t_Bool to_be_listed;
@@ -916,44 +899,16 @@ static void initiate (void);
 
                    /* Check for sensor number: */
 	new_sensor = FALSE;
-	if (!mlat_ptr->sensor_number.present)
+	if (!mlat_ptr->sensor_number.present &&
+        mlat_ptr->data_source_identifier.present)
 	{
-		if (mlat_ptr->data_source_identifier.present)
-		{
-			t_Ui16 dsi;
-			t_Bool found;
-
-			dsi = mlat_ptr->data_source_identifier.value;
-
-			found = FALSE;
-			for (ix = 0; ix < M_MAX_NUMBER_OF_SENSORS; ix ++)
-			{
-				if (sacsic_list[ix].orig_defined &&
-                    sacsic_list[ix].orig == dsi)
-				{
-					found = TRUE;
-					break;
-				}
-			}
-
-			if (!found)
-			{
-				for (ix = 0; ix < M_MAX_NUMBER_OF_SENSORS; ix ++)
-				{
-					if (sacsic_list[ix].rsap_defined &&
-                        sacsic_list[ix].rsap == dsi)
-					{
-						found = TRUE;
-						break;
-					}
-				}
-			}
+		t_Ui16 sno;
 
-			if (found)
-			{
-				mlat_ptr->sensor_number.present = TRUE;
-				mlat_ptr->sensor_number.value = 1 + ix;
-			}
+		if (find_sensor (mlat_ptr->data_source_identifier.value,
+                         &sno, &new_sensor) == RC_OKAY)
+		{
+			mlat_ptr->sensor_number.present = TRUE;
+			mlat_ptr->sensor_number.value = sno;
 		}
 	}
 
@@ -1331,7 +1286,6 @@ static void initiate (void);
 
  void list_rsrv (t_Rsrv *rsrv_ptr)
 {
-	int ix;
 	t_Bool new_sensor;
 	t_Secs tm;
 	t_Bool to_be_listed;
@@ -1376,44 +1330,16 @@ static void initiate (void);
 
                    /* Check for sensor number: */
 	new_sensor = FALSE;
-	if (!rsrv_ptr->sensor_number.present)
+	if (!rsrv_ptr->sensor_number.present &&
+        rsrv_ptr->data_source_identifier.present)
 	{
-		if (rsrv_ptr->data_source_identifier.present)
-		{
-			t_Ui16 dsi;
-			t_Bool found;
-
-			dsi = rsrv_ptr->data_source_identifier.value;
-
-			found = FALSE;
-			for (ix = 0; ix < M_MAX_NUMBER_OF_SENSORS; ix ++)
-			{
-				if (sacsic_list[ix].orig_defined &&
-                    sacsic_list[ix].orig == dsi)
-				{
-					found = TRUE;
-					break;
-				}
-			}
-
-			if (!found)
-			{
-				for (ix = 0; ix < M_MAX_NUMBER_OF_SENSORS; ix ++)
-				{
-					if (sacsic_list[ix].rsap_defined &&
-                        sacsic_list[ix].rsap == dsi)
-					{
-						found = TRUE;
-						break;
-					}
-				}
-			}
+		t_Ui16 sno;
 
-			if (found)
-			{
-				rsrv_ptr->sensor_number.present = TRUE;
-				rsrv_ptr->sensor_number.value = 1 + ix;
-			}
+		if (find_sensor (rsrv_ptr->data_source_identifier.value,
+                         &sno, &new_sensor) == RC_OKAY)
+		{
+			rsrv_ptr->sensor_number.present = TRUE;
+			rsrv_ptr->sensor_number.value = sno;
 		}
 	}
 
@@ -1618,7 +1544,6 @@ static void initiate (void);
 
  void list_rtgt (t_Rtgt *rtgt_ptr)
 {
-	int ix;
 	t_Bool new_sensor;
 	t_Secs tm;
 	t_Bool to_be_listed;
@@ -1667,44 +1592,16 @@ static void initiate (void);
 
                    /* Check for sensor number: */
 	new_sensor = FALSE;
-	if (!rtgt_ptr->sensor_number.present)
+	if (!rtgt_ptr->sensor_number.present &&
+        rtgt_ptr->data_source_identifier.present)
 	{
-		if (rtgt_ptr->data_source_identifier.present)
-		{
-			t_Ui16 dsi;
-			t_Bool found;
-
-			dsi = rtgt_ptr->data_source_identifier.value;
-
-			found = FALSE;
-			for (ix = 0; ix < M_MAX_NUMBER_OF_SENSORS; ix ++)
-			{
-				if (sacsic_list[ix].orig_defined &&
-                    sacsic_list[ix].orig == dsi)
-				{
-					found = TRUE;
-					break;
-				}
-			}
-
-			if (!found)
-			{
-				for (ix = 0; ix < M_MAX_NUMBER_OF_SENSORS; ix ++)
-				{
-					if (sacsic_list[ix].rsap_defined &&
-                        sacsic_list[ix].rsap == dsi)
-					{
-						found = TRUE;
-						break;
-					}
-				}
-			}
+		t_Ui16 sno;
 
-			if (found)
-			{
-				rtgt_ptr->sensor_number.present = TRUE;
-				rtgt_ptr->sensor_number.value = 1 + ix;
-			}
+		if (find_sensor (rtgt_ptr->data_source_identifier.value,
+                         &sno, &new_sensor) == RC_OKAY)
+		{
+			rtgt_ptr->sensor_number.present = TRUE;
+			rtgt_ptr->sensor_number.value = sno;
 		}
 	}
 
@@ -3466,6 +3363,12 @@ static void initiate (void);
 
  void term_lister (void)
 {
+                   /* List the sensor registry, if required: */
+	if (list_sensor_registry)
+	{
+		list_sensors ();
+	}
+
 	if (excel_output)
 	{
 		if (exc_file != NULL)
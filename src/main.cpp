@@ -40,106 +40,12 @@
 #include "global.h"
 
 #if USE_JSON
+#include "jsonstreamsink.h"
 #include "jsonwriter.h"
 #endif
-
-                   /* Public variables: */
-                   /* ----------------- */
-
-t_Adsb adsb;
-                   /* Buffer for ADS-B report information */
-t_Bool after_midnight;
-				   /* After midnight flag */
-				   /* Set from 00:00:00 to approx. 00:01:00 */
-int current_line_number;
-                   /* Current board/line number */
-t_Bool current_line_number_defined;
-                   /* Current board/line number defined */
-t_Byte current_stns;
-                   /* Current system track numbering scheme */
-t_Bool current_stns_defined;
-                   /* Current system track numbering scheme defined */
-t_Ui16 current_stns_dsi;
-                   /* Associated data source identifier */
-FILE *exc_file;
-                   /* Pointer to special output file */
-t_Frame_Time first_frame_time;
-                   /* First frame time */
-t_Date frame_date;
-                   /* Frame date */
-t_Bool frame_date_present;
-                   /* Frame date present */
-t_Secs frame_time;
-                   /* Frame time; seconds */
-t_Bool frame_time_present;
-                   /* Frame time present */
-t_Ui32 frames_count;
-				   /* Input frames count */
-FILE *input_file;
-				   /* Pointer to input file */
-t_Ui32 input_frames;
-                   /* Number of frames read (and listed) from
-                      input file */
-t_Ui32 input_length;
-                   /* Number of bytes read (and listed) from
-                      input file */
-t_Ui32 input_offset;
-				   /* Offset within input file */
-t_Ui32 input_rtm;
-                   /* Relative time within input file */
-t_Frame_Time last_frame_time;
-                   /* Last frame time */
-t_Ui16 last_sacsic;
-                   /* Last radar SAC/SIC */
-t_Bool last_sacsic_available;
-                   /* Last radar SAC/SIC */
-t_Ui32 last_tod;
-                   /* Last time of day; 1/128 seconds */
-				   /* Needed to transfer full time_of_day values
-				      between radar links, i.e. to allow radar
-				      links without radar service messages to
-				      fill up the truncated time_of_day */
-t_Bool last_tod_available;
-                   /* Last time of day available flag */ 
-#if LISTER
-FILE *list_file;
-				   /* Pointer to list file */
-#endif /* LISTER */
-t_Listed_Sensor listed_sensors[M_MAX_NUMBER_OF_SENSORS];
-                   /* Listed sensors */
-t_Mlat mlat;
-                   /* Buffer for multilateration report information */
-t_Ui16 number_of_sensor_descriptions;
-                   /* Number of sensor descriptions */
-t_Ui16 records_in_current_frame;
-                   /* Number of records in current frame */
-t_Rsrv rsrv;
-                   /* Buffer for radar service information */
-t_Rtgt rtgt;
-                   /* Buffer for radar target information */
-t_Sensor_Ident sacsic_list[M_MAX_NUMBER_OF_SENSORS];
-                   /* List of sensor identities */
-t_Ssta ssta;
-                   /* Buffer for sensor status information */
-t_Time start_time;
-				   /* Start time of input; milliseconds */
-t_Bool start_time_available;
-				   /* Start time available flag */
-t_Wall_Time start_wall_time;
-				   /* Wall time for start of input */
-t_Step step;
-                   /* System picture step */
-t_Wall_Time stop_wall_time;
-				   /* Wall time for stop of input */
-t_Bool stop_time_available;
-				   /* Stop time available flag */
-t_Strk strk;
-                   /* Buffer for system track information */
-
-#if CHKASS
-jmp_buf on_fatal_error;
-                   /* Label for longjmp() in case of fatal error */
-#endif
+#include "arrowwriter.h"
+#include "parquetwriter.h"
+#include "sqlitewriter.h"
 
 				   /* Local functions: */
 				   /* ---------------- */
@@ -239,6 +145,7 @@ static void print_subtypes (void);
 	printf (" -net     Binary 'netto' recording\n");
 	printf (" -rec     Sequence of records\n");
 	printf (" -rff     Comsoft (TM) RFF recording\n");
+	printf (" -store   Record store of decoded reports (see -store-file)\n");
 
 	printf ("\n");
 	printf ("Our '%s' utility at the moment supports the "
@@ -272,6 +179,8 @@ static void print_subtypes (void);
     printf ("where the following options are supported:\n");
 	printf (" -ah=xxx\t\tuse value (in FL) as assumed height\n");
 	printf (" -all\t\t\tlist all levels\n");
+	printf (" -arrow-file=pathname\tpath name of arrow (feather v2) files to be written,\n"
+            "\t\t\tone per report type: <stem>_adsb, _mlat, _rsrv, _rtgt, _strk\n");
 	printf (" -cat\t\t\tlist ASTERIX category\n");
 	printf (" -cat=xxx\t\tonly this ASTERIX category to be listed\n");
 	printf (" -categories\t\tprint list of supported ASTERIX categories\n");
@@ -291,9 +200,22 @@ static void print_subtypes (void);
 #endif /* LISTER */
 #if USE_JSON
     printf (" -json-type=type\toutput type of json file to be written, possible types: none,test,print,text,\n"
-            "\t\t\t\tcbor,msgpack,ubjson,zip-text,zip-cbor,zip-msgpack,zip-ubjson\n");
-    printf (" -json-file=pathname\tpath name of json file to be written\n");
+            "\t\t\t\tndjson,cbor,msgpack,ubjson,zip-text,zip-ndjson,zip-cbor,zip-msgpack,zip-ubjson\n");
+    printf (" -json-file=pathname\tpath name of json file to be written; '-' for standard output,\n"
+            "\t\t\t\t'unix:path' for a unix socket, or a named pipe (messages then on stderr\n"
+            "\t\t\t\tfor '-'; cbor/msgpack/ubjson records are prefixed by their 4-byte length)\n");
+    printf (" -json-stream-policy=block|drop\twait for a slow stream consumer (default) or drop records\n");
+    printf (" -json-stream-buffer=nn[K|M|G]\tbytes buffered for a stream consumer (default 16M)\n");
     printf (" -json-write-nulls\twrite null values in json output\n");
+    printf (" -json-fields=pathname\tprofile of json fields to be written per report type,\n"
+            "\t\t\t\toptionally renamed (one field per line, [rtgt] etc. as sections)\n");
+    printf (" -json-gzip\t\tcompress json file as gzip, on all cores (not for zip types)\n");
+    printf (" -json-zip-entry-records=nn\tstart a new zip archive entry every nn records\n");
+    printf (" -json-zip-entry-minutes=nn\tstart a new zip archive entry every nn minutes of frame time,\n"
+            "\t\t\t\tentries are listed in manifest.json\n");
+    printf (" -json-batch-min=nn\tminimum number of records converted per json batch (default 1000)\n");
+    printf (" -json-batch-max=nn\tmaximum number of records converted per json batch (default 32000)\n");
+    printf (" -json-batch-latency=nn\tmaximum time in ms a record waits for its json batch (default 1000, 0=none)\n");
 #endif
 	printf (" -list_065\t\tlist ASTERIX category 065 messages\n");
 	printf (" -list_dsi\t\tlist data source identifiers (SAC/SIC)\n");
@@ -301,20 +223,43 @@ static void print_subtypes (void);
 	printf (" -list_lus\t\tlist last updating sensor (for system tracks)\n");
 	printf (" -list_only_bg\t\tlist only system tracks from background service\n");
 	printf (" -list_only_cy\t\tlist only system tracks from complementary service\n");
+	printf (" -list_sensors\t\tlist sensor registry (at end of listing)\n");
 	printf (" -list_service_id\tlist service identification (for system tracks)\n");
 	printf (" -ll=nn\t\t\tlength limit (only first nn bytes are listed)\n");
 	printf (" -ml\t\t\thandle multiple lines (per sensor)\n");
 	printf (" -mof\t\t\tlist mode of flight (for system tracks)\n");
 	printf (" -nft\t\t\tdon't list frame time\n");
 	printf (" -no_utc\t\tNo UTC time of day in list file\n");
+	printf (" -parquet-file=pathname\tpath name of parquet files to be written,\n"
+            "\t\t\tone per report type: <stem>_adsb, _mlat, _rsrv, _rtgt, _strk\n");
+	printf (" -parquet-row-group-minutes=nn\n"
+            "\t\t\tminutes of frame time per parquet row group (default 10, 0=unlimited)\n");
 	printf (" -progress\t\tshow some progress indication\n");
 	printf (" -reftrj\t\tinput file holds reference trajectories\n");
+	printf (" -rotate-count=nn\trotate list and json files every nn frames (list)\n"
+            "\t\t\tor records (json)\n");
+	printf (" -rotate-gzip\t\tcompress rotated files as gzip (in background)\n");
+	printf (" -rotate-minutes=nn\trotate list and json files every nn minutes of frame time\n");
+	printf (" -rotate-size=nn[K|M|G]\trotate list and json files at nn bytes\n");
+	printf (" -sacsic=ssss\t\tonly reports with SAC/SIC ssss (hex; record store input)\n");
+	printf (" -sensor=ssss[/rrrr][,name]\n"
+            "\t\t\tdefine (and number) sensor with SAC/SIC ssss (hex),\n"
+            "\t\t\toptional RSAP rrrr (hex) and name\n");
+	printf (" -sink-reports=name:type,...\n"
+            "\t\t\tonly these report types (adsb,mlat,rsrv,rtgt,strk) to sink\n"
+            "\t\t\tname (store,list,json,arrow,parquet,sqlite); repeatable\n");
 	printf (" -soe\t\t\tstop on (ASTERIX) error\n");
+	printf (" -sqlite-file=pathname\tpath name of sqlite database to be written, one table\n"
+            "\t\t\tper report type plus the sensor registry, indexed at the end\n");
 	printf (" -sqn\t\t\twith sequence numbers\n");
 	printf (" -srv_id=xxx\t\tfilter ARTAS output by service_identification\n");
 	printf (" -ssta\t\t\tlist sensor status information\n");
 	printf (" -start_date=yyyy-mm-dd\tstart date\n");
 	printf (" -start_offset=nnn\tstart offset in input file\n");
+	printf (" -start_time=hh:mm:ss\tonly reports from this frame time on (record store input)\n");
+	printf (" -stop_time=hh:mm:ss\tonly reports up to this frame time (record store input)\n");
+	printf (" -store-file=pathname\tpath name of record store of decoded reports to be written,\n"
+            "\t\t\tto be read again with -store (without decoding)\n");
 	printf (" -subtypes\t\tprint list of supported format subtypes\n");
 	printf (" -timebias=ttt\t\ttime bias (milliseconds)\n");
 	printf (" -tn12\t\t\tsystem track number with 12 bits (legacy)\n");
@@ -391,6 +336,18 @@ static void print_subtypes (void);
 	struct timeval tv1;
                    /* Time at end */
 
+#if USE_JSON
+                   /* Keep standard output for a JSON stream,
+                      messages go to standard error then: */
+	for (arg = 1; arg < argc; ++ arg)
+	{
+		if (strcmp (argv[arg], "-json-file=-") == 0)
+		{
+			JSONStreamSink::reserveStdout ();
+		}
+	}
+#endif
+
     printf ("*** " M_PROMPT "\t\t\t   %s ***\n", PACKAGE_VERSION.c_str());
 	printf (M_COPYRT "\n");
 	printf ("\n");
@@ -436,6 +393,8 @@ static void print_subtypes (void);
 	last_frame_time.value = 0.0;
 	last_sacsic = 0;
 	last_sacsic_available = FALSE;
+	last_service_sacsic = 0;
+	last_service_sacsic_available = FALSE;
 	last_tod = 0;
 	last_tod_available = FALSE;
 #if LISTER
@@ -683,10 +642,12 @@ static void print_subtypes (void);
     case JSON_PRINT:
         break;
     case JSON_TEXT:
+    case JSON_NDJSON:
     case JSON_CBOR:
     case JSON_MESSAGE_PACK:
     case JSON_UBJSON:
     case JSON_ZIP_TEXT:
+    case JSON_ZIP_NDJSON:
     case JSON_ZIP_CBOR:
     case JSON_ZIP_MESSAGE_PACK:
     case JSON_ZIP_UBJSON:
@@ -706,6 +667,32 @@ static void print_subtypes (void);
     json_writer = new JSONWriter {json_output_type, json_path};
 #endif
 
+    if (arrow_path.size())
+    {
+        Assert (arrow_writer == nullptr, "Arrow writer already exists");
+        arrow_writer = new ArrowWriter {arrow_path};
+    }
+
+    if (parquet_path.size())
+    {
+        Assert (parquet_writer == nullptr, "Parquet writer already exists");
+        parquet_writer = new ParquetWriter {parquet_path};
+    }
+
+    if (sqlite_path.size())
+    {
+        Assert (sqlite_writer == nullptr, "SQLite writer already exists");
+        sqlite_writer = new SqliteWriter {sqlite_path};
+    }
+
+    if (store_path.size())
+    {
+        if (open_store_file () != RC_OKAY)
+        {
+            goto term;
+        }
+    }
+
                    /* Initiate message processing: */
     process_init ();
 
@@ -740,7 +727,7 @@ static void print_subtypes (void);
 			list_text (-1, "\n");
 			list_text (-1, "; end of listing\n");
 
-			fclose (list_file);
+			close_list_file ();
 		}
 
 		list_file = NULL;
@@ -750,11 +737,44 @@ static void print_subtypes (void);
 #if USE_JSON
     if (json_writer != nullptr)
     {
+        json_writer->flush ();
+        json_writer->printStatistics ();
+
         delete json_writer;
         json_writer = nullptr;
     }
 #endif
 
+    if (arrow_writer != nullptr)
+    {
+        arrow_writer->printStatistics ();
+
+        delete arrow_writer;
+        arrow_writer = nullptr;
+    }
+
+    if (parquet_writer != nullptr)
+    {
+        parquet_writer->printStatistics ();
+
+        delete parquet_writer;
+        parquet_writer = nullptr;
+    }
+
+    if (sqlite_writer != nullptr)
+    {
+        sqlite_writer->printStatistics ();
+
+        delete sqlite_writer;
+        sqlite_writer = nullptr;
+    }
+
+                   /* Close the record store: */
+	close_store_file ();
+
+                   /* Wait for rotated files to be finished: */
+	term_rotation ();
+
                    /* Terminate message processing: */
 	process_term ();
 
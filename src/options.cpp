@@ -29,9 +29,11 @@
                    /* Common declarations and definitions */
 
 #include <ctype.h>
+#include <errno.h>
 #include <malloc.h>
 #include <stddef.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
                    /* Global variables: */
@@ -135,6 +137,8 @@ t_Bool list_sensor_name;
                    /* List sensor name */
 t_Bool list_sensor_number;
                    /* List sensor number */
+t_Bool list_sensor_registry;
+                   /* List sensor registry (at end of listing) */
 t_Bool list_service_id;
                    /* List service identification (for system tracks) */
 t_Bool list_ssta_info;
@@ -155,21 +159,69 @@ std::map<std::string, JSON_OUTPUT_TYPE> json_output_type_map {
     {"test", JSON_TEST},
     {"print", JSON_PRINT},
     {"text", JSON_TEXT},
+    {"ndjson", JSON_NDJSON},
     {"cbor", JSON_CBOR},
     {"msgpack", JSON_MESSAGE_PACK},
     {"ubjson", JSON_UBJSON},
     {"zip-text", JSON_ZIP_TEXT},
+    {"zip-ndjson", JSON_ZIP_NDJSON},
     {"zip-cbor", JSON_ZIP_CBOR},
-    {"zip-msgpack", JSON_MESSAGE_PACK},
-    {"zip-ubjson", JSON_ZIP_MESSAGE_PACK}
+    {"zip-msgpack", JSON_ZIP_MESSAGE_PACK},
+    {"zip-ubjson", JSON_ZIP_UBJSON}
 };
 
 std::string json_path;
 bool write_json_nulls {false};
+std::string json_fields_path;
+                   /* Path name of profile of JSON fields to be written */
+JSON_STREAM_POLICY json_stream_policy {JSON_STREAM_BLOCK};
+                   /* Wait for or drop records a JSON stream consumer lags behind */
+size_t json_stream_buffer_size {16777216};
+                   /* Bytes buffered for a JSON stream consumer */
+size_t json_batch_min_size {1000};
+                   /* Records converted at least per JSON batch */
+size_t json_batch_max_size {32000};
+                   /* Records converted at most per JSON batch */
+unsigned int json_batch_max_latency {1000};
+                   /* Milliseconds a record may wait for its JSON batch (0=unlimited) */
+bool json_gzip {false};
+                   /* Compress JSON file output as gzip */
+size_t json_zip_entry_records {0};
+                   /* Records per JSON ZIP archive entry (0=unlimited) */
+unsigned int json_zip_entry_minutes {0};
+                   /* Minutes of frame time per JSON ZIP archive entry (0=unlimited) */
 
 JSONWriter* json_writer {nullptr};
 #endif
 
+std::string arrow_path;
+                   /* Path name of Arrow files to be written */
+ArrowWriter* arrow_writer {nullptr};
+                   /* Arrow writer, if Arrow files are written */
+
+std::string parquet_path;
+                   /* Path name of Parquet files to be written */
+unsigned int parquet_row_group_minutes {10};
+                   /* Minutes of frame time per Parquet row group (0=unlimited) */
+ParquetWriter* parquet_writer {nullptr};
+                   /* Parquet writer, if Parquet files are written */
+
+std::string sqlite_path;
+                   /* Path name of SQLite database to be written */
+SqliteWriter* sqlite_writer {nullptr};
+                   /* SQLite writer, if a SQLite database is written */
+
+std::string store_path;
+                   /* Path name of record store to be written */
+
+t_Ui32 rotate_count;
+                   /* Rotate output files after this many frames or records */
+t_Bool rotate_gzip;
+                   /* Compress rotated output files */
+t_Ui32 rotate_minutes;
+                   /* Rotate output files every this many minutes (frame time) */
+t_Ui64 rotate_size;
+                   /* Rotate output files at this size; bytes */
 t_Byte service_identification;
                    /* Service identification (for ARTAS output) */
 t_Bool service_identification_defined;
@@ -200,6 +252,18 @@ int track_number_bits;
                    /* Number of bits in a track number */
 t_Bool use_mmcc;
                    /* Use minimum mode C condition in ZSF processing */
+t_Ui16 wanted_sacsic;
+                   /* Wanted SAC/SIC (record store input) */
+t_Bool wanted_sacsic_defined;
+                   /* Wanted SAC/SIC defined */
+t_Secs wanted_start_time;
+                   /* Wanted start time; seconds */
+t_Bool wanted_start_time_defined;
+                   /* Wanted start time defined */
+t_Secs wanted_stop_time;
+                   /* Wanted stop time; seconds */
+t_Bool wanted_stop_time_defined;
+                   /* Wanted stop time defined */
 t_Bool with_sequence_number;
                    /* Each RFF frame holds a 4 bytes sequence number */
 
@@ -252,6 +316,66 @@ static void select_cat (t_Byte category);
 	}
 #endif /* LISTER */
 
+    {
+        std::string tmp {option_ptr};
+
+        if (tmp.find("arrow-file=") == 0)
+        {
+            if (tmp.size() == 11)
+            {
+                printf ("-> Export Arrow to filename failed since no filename was supplied\n");
+                goto done;
+            }
+
+            arrow_path = tmp.substr (11);
+            printf ("-> Export Arrow to filename '%s'\n", arrow_path.c_str());
+
+            goto done;
+        }
+
+        if (tmp.find("parquet-file=") == 0)
+        {
+            if (tmp.size() == 13)
+            {
+                printf ("-> Export Parquet to filename failed since no filename was supplied\n");
+                goto done;
+            }
+
+            parquet_path = tmp.substr (13);
+            printf ("-> Export Parquet to filename '%s'\n", parquet_path.c_str());
+
+            goto done;
+        }
+
+        if (tmp.find("sqlite-file=") == 0)
+        {
+            if (tmp.size() == 12)
+            {
+                printf ("-> Export SQLite to filename failed since no filename was supplied\n");
+                goto done;
+            }
+
+            sqlite_path = tmp.substr (12);
+            printf ("-> Export SQLite to filename '%s'\n", sqlite_path.c_str());
+
+            goto done;
+        }
+
+        if (tmp.find("store-file=") == 0)
+        {
+            if (tmp.size() == 11)
+            {
+                printf ("-> Record store to filename failed since no filename was supplied\n");
+                goto done;
+            }
+
+            store_path = tmp.substr (11);
+            printf ("-> Record store to filename '%s'\n", store_path.c_str());
+
+            goto done;
+        }
+    }
+
 #if USE_JSON
     {
         std::string tmp {option_ptr};
@@ -275,6 +399,51 @@ static void select_cat (t_Byte category);
         }
     }
 
+    {
+        std::string tmp {option_ptr};
+
+        if (tmp.find("json-fields=") == 0)
+        {
+            if (tmp.size() == 12)
+            {
+                printf ("-> JSON field profile failed since no filename was supplied\n");
+                goto done;
+            }
+
+            json_fields_path = tmp.substr (12);
+            printf ("-> JSON field profile '%s'\n", json_fields_path.c_str());
+
+            goto done;
+        }
+    }
+
+    {
+        std::string tmp {option_ptr};
+
+        if (tmp.find("json-stream-policy=") == 0)
+        {
+            std::string policy = tmp.substr (19);
+
+            if (policy == "block")
+            {
+                json_stream_policy = JSON_STREAM_BLOCK;
+            }
+            else if (policy == "drop")
+            {
+                json_stream_policy = JSON_STREAM_DROP;
+            }
+            else
+            {
+                printf ("-> JSON stream policy failed since unknown policy '%s' was supplied\n", policy.c_str());
+                goto done;
+            }
+
+            printf ("-> JSON stream policy '%s'\n", policy.c_str());
+
+            goto done;
+        }
+    }
+
     {
         std::string tmp {option_ptr};
 
@@ -312,6 +481,18 @@ static void select_cat (t_Byte category);
             goto done;
         }
     }
+
+    {
+        std::string tmp {option_ptr};
+
+        if (tmp == "json-gzip")
+        {
+            json_gzip = true;
+            printf ("-> Compress JSON file as gzip\n");
+
+            goto done;
+        }
+    }
 #endif
 
                    /* Handle 'amplitude' option: */
@@ -558,6 +739,17 @@ static void select_cat (t_Byte category);
 		goto done;
 	}
 
+                   /* Handle 'list_sensors' option: */
+	if (strcmp (option_ptr, "list_sensors") == 0)
+	{
+                   /* List sensor registry (at end of listing) */
+
+		printf ("-> List sensor registry\n");
+
+		list_sensor_registry = TRUE;
+		goto done;
+	}
+
                    /* Handle 'list_service_id' option: */
 	if (strcmp (option_ptr, "list_service_id") == 0)
 	{
@@ -699,6 +891,17 @@ static void select_cat (t_Byte category);
 		goto done;
 	}
 
+                   /* Handle 'rotate-gzip' option: */
+	if (strcmp (option_ptr, "rotate-gzip") == 0)
+	{
+                   /* Compress rotated output files */
+
+		printf ("-> Compress rotated output files\n");
+
+		rotate_gzip = TRUE;
+		goto done;
+	}
+
                    /* Handle 'soe' option: */
 	if (strcmp (option_ptr, "soe") == 0)
 	{
@@ -742,6 +945,15 @@ static void select_cat (t_Byte category);
 		goto done;
 	}
 
+                   /* Handle 'store' option: */
+	if (strcmp (option_ptr, "store") == 0)
+	{
+                   /* Record store (of decoded reports) */
+
+		set_input_format (option_ptr, e_input_format_store);
+		goto done;
+	}
+
                    /* Handle 'subtypes' option: */
 	if (strcmp (option_ptr, "subtypes") == 0)
 	{
@@ -878,6 +1090,122 @@ static void select_cat (t_Byte category);
 		}
 	}
 
+#if USE_JSON
+				   /* Check for 'json-batch-min=nn' option: */
+	if (strcmp (fp, "json-batch-min") == 0)
+	{
+		n = sscanf (vp, M_FMT_UI32, &u32);
+		if (n == 1 && u32 > 0)
+		{
+			printf ("-> JSON batch size at least " M_FMT_UI32 " record(s)\n", u32);
+
+			json_batch_min_size = u32;
+			goto done;
+		}
+	}
+
+				   /* Check for 'json-batch-max=nn' option: */
+	if (strcmp (fp, "json-batch-max") == 0)
+	{
+		n = sscanf (vp, M_FMT_UI32, &u32);
+		if (n == 1 && u32 > 0)
+		{
+			printf ("-> JSON batch size at most " M_FMT_UI32 " record(s)\n", u32);
+
+			json_batch_max_size = u32;
+			goto done;
+		}
+	}
+
+				   /* Check for 'json-batch-latency=nn' option: */
+	if (strcmp (fp, "json-batch-latency") == 0)
+	{
+		n = sscanf (vp, M_FMT_UI32, &u32);
+		if (n == 1)
+		{
+			printf ("-> JSON batch latency at most " M_FMT_UI32 " ms\n", u32);
+
+			json_batch_max_latency = u32;
+			goto done;
+		}
+	}
+
+				   /* Check for 'json-zip-entry-records=nn' option: */
+	if (strcmp (fp, "json-zip-entry-records") == 0)
+	{
+		n = sscanf (vp, M_FMT_UI32, &u32);
+		if (n == 1)
+		{
+			printf ("-> JSON ZIP entry for every " M_FMT_UI32 " record(s)\n", u32);
+
+			json_zip_entry_records = u32;
+			goto done;
+		}
+	}
+
+				   /* Check for 'json-zip-entry-minutes=nn' option: */
+	if (strcmp (fp, "json-zip-entry-minutes") == 0)
+	{
+		n = sscanf (vp, M_FMT_UI32, &u32);
+		if (n == 1 && u32 <= 1440)
+		{
+			printf ("-> JSON ZIP entry for every " M_FMT_UI32 " minute(s) of frame time\n", u32);
+
+			json_zip_entry_minutes = u32;
+			goto done;
+		}
+	}
+
+				   /* Check for 'json-stream-buffer=nn' option: */
+	if (strcmp (fp, "json-stream-buffer") == 0)
+	{
+		char *ep;
+		size_t mul;    /* Multiplier of K, M or G suffix */
+		unsigned long long ull;
+
+                   /* A number is required (strtoull() would accept
+                      leading blanks and a sign): */
+		if (*vp < '0' || *vp > '9')
+		{
+			goto ignored;
+		}
+
+		errno = 0;
+		ull = strtoull (vp, &ep, 10);
+		if (errno != 0 || ull == 0)
+		{
+			goto ignored;
+		}
+
+		mul = 1;
+		if (*ep == 'K')
+		{
+			mul = 1024;
+			++ ep;
+		}
+		else if (*ep == 'M')
+		{
+			mul = 1048576;
+			++ ep;
+		}
+		else if (*ep == 'G')
+		{
+			mul = 1073741824;
+			++ ep;
+		}
+
+		if (*ep != '\0' || ull > ~(size_t) 0 / mul)
+		{
+			goto ignored;
+		}
+
+		json_stream_buffer_size = (size_t) ull * mul;
+
+		printf ("-> JSON stream buffer of %zu byte(s)\n", json_stream_buffer_size);
+		goto done;
+	}
+#endif
+
 #if LISTER
 				   /* Check for 'l=nn' option: */
 	if (strcmp (fp, "l") == 0)
@@ -931,6 +1259,171 @@ static void select_cat (t_Byte category);
 		}
 	}
 
+				   /* Check for 'parquet-row-group-minutes=nn' option: */
+	if (strcmp (fp, "parquet-row-group-minutes") == 0)
+	{
+		n = sscanf (vp, M_FMT_UI32, &u32);
+		if (n == 1 && u32 <= 1440)
+		{
+			printf ("-> Parquet row group for every " M_FMT_UI32 " minute(s) of frame time\n", u32);
+
+			parquet_row_group_minutes = u32;
+			goto done;
+		}
+	}
+
+				   /* Check for 'rotate-count=nn' option: */
+	if (strcmp (fp, "rotate-count") == 0)
+	{
+		n = sscanf (vp, M_FMT_UI32, &u32);
+		if (n == 1)
+		{
+			printf ("-> Rotate output files every " M_FMT_UI32
+                    " frame(s) or record(s)\n", u32);
+
+			rotate_count = u32;
+			goto done;
+		}
+	}
+
+				   /* Check for 'rotate-minutes=nn' option: */
+	if (strcmp (fp, "rotate-minutes") == 0)
+	{
+		n = sscanf (vp, M_FMT_UI32, &u32);
+		if (n == 1 && u32 <= 1440)
+		{
+			printf ("-> Rotate output files every " M_FMT_UI32
+                    " minute(s) of frame time\n", u32);
+
+			rotate_minutes = u32;
+			goto done;
+		}
+	}
+
+				   /* Check for 'rotate-size=nn' option: */
+	if (strcmp (fp, "rotate-size") == 0)
+	{
+		char *ep;
+		t_Ui64 mul;    /* Multiplier of K, M or G suffix */
+		unsigned long long ull;
+
+                   /* A number is required (strtoull() would accept
+                      leading blanks and a sign): */
+		if (*vp < '0' || *vp > '9')
+		{
+			goto ignored;
+		}
+
+		errno = 0;
+		ull = strtoull (vp, &ep, 10);
+		if (errno != 0)
+		{
+			goto ignored;
+		}
+
+		mul = 1;
+		if (*ep == 'K')
+		{
+			mul = 1024;
+			++ ep;
+		}
+		else if (*ep == 'M')
+		{
+			mul = 1048576;
+			++ ep;
+		}
+		else if (*ep == 'G')
+		{
+			mul = 1073741824;
+			++ ep;
+		}
+
+		if (*ep != '\0' || ull > ~(t_Ui64) 0 / mul)
+		{
+			goto ignored;
+		}
+
+		rotate_size = (t_Ui64) ull * mul;
+
+		printf ("-> Rotate output files at %llu byte(s)\n",
+                (unsigned long long) rotate_size);
+
+		goto done;
+	}
+
+                   /* Check for 'sink-reports=name:type,...' option: */
+	if (strcmp (fp, "sink-reports") == 0)
+	{
+		lrc = select_sink_reports (vp);
+		if (lrc == RC_OKAY)
+		{
+			printf ("-> Reports for sink '%s'\n", vp);
+
+			goto done;
+		}
+	}
+
+                   /* Check for 'sacsic=ssss' option: */
+	if (strcmp (fp, "sacsic") == 0)
+	{
+		char *ep;
+		unsigned long ul;
+
+		ul = strtoul (vp, &ep, 16);
+		if (ep != vp && *ep == '\0' && ul <= 0xffff)
+		{
+			printf ("-> Only reports with SAC/SIC 0x%04lx\n", ul);
+
+			wanted_sacsic = (t_Ui16) ul;
+			wanted_sacsic_defined = TRUE;
+			goto done;
+		}
+	}
+
+                   /* Check for 'sensor=ssss[/rrrr][,name]' option: */
+	if (strcmp (fp, "sensor") == 0)
+	{
+		char *ep;
+		char *np;
+		t_Ui16 rsap;
+		t_Bool rsap_defined;
+		unsigned long ul;
+
+                   /* Isolate the (optional) sensor name: */
+		np = strchr (vp, ',');
+		if (np != NULL)
+		{
+			*np = '\0';
+			++ np;
+		}
+
+		ul = strtoul (vp, &ep, 16);
+		if (ep != vp && ul <= 0xffff && (*ep == '\0' || *ep == '/'))
+		{
+			rsap = 0;
+			rsap_defined = FALSE;
+			if (*ep == '/')
+			{
+				u32 = strtoul (ep + 1, &ep, 16);
+				if (*ep != '\0' || u32 > 0xffff)
+				{
+					goto ignored;
+				}
+
+				rsap = (t_Ui16) u32;
+				rsap_defined = TRUE;
+			}
+
+			lrc = define_sensor ((t_Ui16) ul, rsap_defined, rsap, np);
+			if (lrc == RC_OKAY)
+			{
+				printf ("-> Sensor 0x%04lx defined\n", ul);
+
+				goto done;
+			}
+		}
+	}
+
 				   /* Check for 'so=nn' option: */
 	if (strcmp (fp, "so") == 0)
 	{
@@ -1045,6 +1538,40 @@ static void select_cat (t_Byte category);
 		}
 	}
 
+                   /* Check for 'start_time=hh:mm:ss[.fff]' option: */
+	if (strcmp (fp, "start_time") == 0)
+	{
+		unsigned int h, m;
+		double s;
+
+		n = sscanf (vp, "%u:%u:%lf", &h, &m, &s);
+		if (n == 3 && h < 24 && m < 60 && 0.0 <= s && s < 60.0)
+		{
+			wanted_start_time = 3600.0 * h + 60.0 * m + s;
+			wanted_start_time_defined = TRUE;
+
+			printf ("-> Start time set to %s\n", utc_text (wanted_start_time));
+			goto done;
+		}
+	}
+
+                   /* Check for 'stop_time=hh:mm:ss[.fff]' option: */
+	if (strcmp (fp, "stop_time") == 0)
+	{
+		unsigned int h, m;
+		double s;
+
+		n = sscanf (vp, "%u:%u:%lf", &h, &m, &s);
+		if (n == 3 && h < 24 && m < 60 && 0.0 <= s && s < 60.0)
+		{
+			wanted_stop_time = 3600.0 * h + 60.0 * m + s;
+			wanted_stop_time_defined = TRUE;
+
+			printf ("-> Stop time set to %s\n", utc_text (wanted_stop_time));
+			goto done;
+		}
+	}
+
 				   /* Check for 'timebias=ttt' option: */
 	if (strcmp (fp, "timebias") == 0)
 	{
@@ -1156,6 +1683,7 @@ static void select_cat (t_Byte category);
 		}
 	}
 
+	ignored:       /* Option not understood */
 	printf ("t> Option '%s' ignored\n", option_ptr);
 
 	done:          /* We are done */
@@ -1223,12 +1751,17 @@ static void select_cat (t_Byte category);
 	list_received_power = FALSE;
 	list_sensor_name = TRUE;
 	list_sensor_number = TRUE;
+	list_sensor_registry = FALSE;
 	list_service_id = FALSE;
 	list_ssta_info = FALSE;
 	list_ssta_info_for_excel = FALSE;
 	list_time_as_utc_text = TRUE;
 	list_time_of_day = TRUE;
 	list_wgs84 = FALSE;
+	rotate_count = 0;
+	rotate_gzip = FALSE;
+	rotate_minutes = 0;
+	rotate_size = 0;
 	service_identification = 0;
 	service_identification_defined = FALSE;
 	show_progress_indication = FALSE;
@@ -1246,6 +1779,12 @@ static void select_cat (t_Byte category);
 	track_data_from_dec = FALSE;
 	track_number_bits = 16;
 	use_mmcc = FALSE;
+	wanted_sacsic = 0;
+	wanted_sacsic_defined = FALSE;
+	wanted_start_time = 0.0;
+	wanted_start_time_defined = FALSE;
+	wanted_stop_time = 0.0;
+	wanted_stop_time_defined = FALSE;
 	with_sequence_number = FALSE;
 
 	return;
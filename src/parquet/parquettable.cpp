@@ -0,0 +1,726 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "parquettable.h"
+#include "parquetthrift.h"
+#include "arrowcolumns.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+#include <zlib.h>
+
+// Parquet format constants, see parquet.thrift
+const char PARQUET_MAGIC[] = "PAR1";
+const int32_t PARQUET_VERSION = 1;
+const int32_t PARQUET_TYPE_BOOLEAN = 0;
+const int32_t PARQUET_TYPE_INT32 = 1;
+const int32_t PARQUET_TYPE_DOUBLE = 5;
+const int32_t PARQUET_TYPE_BYTE_ARRAY = 6;
+const int32_t PARQUET_OPTIONAL = 1;
+const int32_t PARQUET_CONVERTED_UTF8 = 0;
+const int32_t PARQUET_CONVERTED_DATE = 6;
+const int32_t PARQUET_CONVERTED_UINT_8 = 11;
+const int32_t PARQUET_CONVERTED_UINT_16 = 12;
+const int32_t PARQUET_CONVERTED_UINT_32 = 13;
+const int32_t PARQUET_CONVERTED_INT_16 = 16;
+const int32_t PARQUET_CONVERTED_INT_32 = 17;
+const int16_t PARQUET_LOGICAL_STRING = 1;
+const int16_t PARQUET_LOGICAL_DATE = 6;
+const int16_t PARQUET_LOGICAL_INTEGER = 10;
+const int32_t PARQUET_ENCODING_PLAIN = 0;
+const int32_t PARQUET_ENCODING_RLE = 3;
+const int32_t PARQUET_ENCODING_DELTA_BINARY_PACKED = 5;
+const int32_t PARQUET_ENCODING_RLE_DICTIONARY = 8;
+const int32_t PARQUET_CODEC_GZIP = 2;
+const int32_t PARQUET_PAGE_DATA = 0;
+const int32_t PARQUET_PAGE_DICTIONARY = 2;
+
+// rows per data page; all pages of a column chunk share its dictionary
+const size_t PARQUET_PAGE_ROWS = 16384;
+// a dictionary is used for at most this many distinct values, each used
+// at least PARQUET_DICTIONARY_MIN_USE times on average
+const size_t PARQUET_DICTIONARY_MAX_VALUES = 4096;
+const size_t PARQUET_DICTIONARY_MIN_USE = 4;
+// values per block and miniblocks per block of DELTA_BINARY_PACKED
+const size_t PARQUET_DELTA_BLOCK = 128;
+const size_t PARQUET_DELTA_MINIBLOCKS = 4;
+const int PARQUET_GZIP_LEVEL = 6;
+// window bits for deflateInit2() selecting the gzip wrapper
+const int PARQUET_GZIP_WINDOW_BITS = 15 + 16;
+
+namespace
+{
+    void putVarint (std::string& out, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back (static_cast<char> (value | 0x80));
+            value >>= 7;
+        }
+        out.push_back (static_cast<char> (value));
+    }
+
+    uint64_t zigzag (int64_t value)
+    {
+        return (static_cast<uint64_t> (value) << 1) ^ static_cast<uint64_t> (value >> 63);
+    }
+
+    int bitWidth (uint32_t max)
+    {
+        int width = 0;
+        while (max)
+        {
+            width++;
+            max >>= 1;
+        }
+        return width;
+    }
+
+    // little endian, least significant bit first
+    void packBits (std::string& out, const uint32_t* values, size_t count, int width)
+    {
+        uint64_t buffer = 0;
+        int bits = 0;
+
+        for (size_t cnt = 0; cnt < count; ++cnt)
+        {
+            buffer |= static_cast<uint64_t> (values[cnt]) << bits;
+            bits += width;
+
+            while (bits >= 8)
+            {
+                out.push_back (static_cast<char> (buffer));
+                buffer >>= 8;
+                bits -= 8;
+            }
+        }
+
+        if (bits > 0)
+            out.push_back (static_cast<char> (buffer));
+    }
+
+    // RLE/bit-packed hybrid: runs of at least 8 equal values as RLE runs,
+    // everything in between as bit-packed groups of 8 values
+    void encodeHybrid (std::string& out, const std::vector<uint32_t>& values, int width)
+    {
+        std::vector<uint32_t> literal;
+
+        auto flushLiteral = [&] ()
+        {
+            if (literal.empty())
+                return;
+
+            literal.resize ((literal.size() + 7) / 8 * 8, 0);
+            putVarint (out, (literal.size() / 8) << 1 | 1);
+            packBits (out, literal.data(), literal.size(), width);
+            literal.clear();
+        };
+
+        size_t pos = 0;
+
+        while (pos < values.size())
+        {
+            size_t run = 1;
+            while (pos + run < values.size() && values[pos + run] == values[pos])
+                run++;
+
+            if (run < 8)
+                literal.insert (literal.end(), values.begin() + pos, values.begin() + pos + run);
+            else if (literal.size() % 8)
+            {
+                // complete the group first, the rest of the run may still be long enough
+                run = 8 - literal.size() % 8;
+                literal.insert (literal.end(), run, values[pos]);
+            }
+            else
+            {
+                flushLiteral();
+                putVarint (out, run << 1);
+                for (int byte = 0; byte < (width + 7) / 8; ++byte)
+                    out.push_back (static_cast<char> (values[pos] >> (8 * byte)));
+            }
+
+            pos += run;
+        }
+
+        flushLiteral();
+    }
+
+    // DELTA_BINARY_PACKED, with int32 wrap-around as the readers do
+    void encodeDelta (std::string& out, const int32_t* values, size_t count)
+    {
+        const size_t miniblock = PARQUET_DELTA_BLOCK / PARQUET_DELTA_MINIBLOCKS;
+
+        putVarint (out, PARQUET_DELTA_BLOCK);
+        putVarint (out, PARQUET_DELTA_MINIBLOCKS);
+        putVarint (out, count);
+        putVarint (out, zigzag (count ? values[0] : 0));
+
+        uint32_t deltas[PARQUET_DELTA_BLOCK];
+
+        for (size_t pos = 1; pos < count; pos += PARQUET_DELTA_BLOCK)
+        {
+            size_t size = std::min (PARQUET_DELTA_BLOCK, count - pos);
+            int32_t min_delta = INT32_MAX;
+
+            for (size_t cnt = 0; cnt < size; ++cnt)
+            {
+                deltas[cnt] = static_cast<uint32_t> (values[pos + cnt]) - static_cast<uint32_t> (values[pos + cnt - 1]);
+                min_delta = std::min (min_delta, static_cast<int32_t> (deltas[cnt]));
+            }
+            for (size_t cnt = 0; cnt < size; ++cnt)
+                deltas[cnt] -= static_cast<uint32_t> (min_delta);
+            std::fill (deltas + size, deltas + PARQUET_DELTA_BLOCK, 0);
+
+            putVarint (out, zigzag (min_delta));
+
+            int widths[PARQUET_DELTA_MINIBLOCKS] = {};
+            for (size_t mb = 0; mb * miniblock < size; ++mb)
+                widths[mb] = bitWidth (*std::max_element (deltas + mb * miniblock, deltas + (mb + 1) * miniblock));
+            for (size_t mb = 0; mb < PARQUET_DELTA_MINIBLOCKS; ++mb)
+                out.push_back (static_cast<char> (widths[mb]));
+
+            for (size_t mb = 0; mb * miniblock < size; ++mb)
+                packBits (out, deltas + mb * miniblock, miniblock, widths[mb]);
+        }
+    }
+
+    void compressGzip (const std::string& data, std::string& compressed)
+    {
+        z_stream stream {};
+
+        int ret = deflateInit2 (&stream, PARQUET_GZIP_LEVEL, Z_DEFLATED, PARQUET_GZIP_WINDOW_BITS, 8, Z_DEFAULT_STRATEGY);
+        assert (ret == Z_OK);
+
+        compressed.resize (deflateBound (&stream, data.size()));
+
+        stream.next_in = reinterpret_cast<Bytef*> (const_cast<char*> (data.data()));
+        stream.avail_in = data.size();
+        stream.next_out = reinterpret_cast<Bytef*> (&compressed[0]);
+        stream.avail_out = compressed.size();
+
+        ret = deflate (&stream, Z_FINISH);
+        assert (ret == Z_STREAM_END);
+
+        compressed.resize (stream.total_out);
+
+        deflateEnd (&stream);
+    }
+
+    template <typename T>
+    void appendPlain (std::string& out, T value)
+    {
+        out.append (reinterpret_cast<const char*> (&value), sizeof (value));
+    }
+}
+
+void ParquetColumn::writeChunk (std::string& out, int64_t offset)
+{
+    size_t start = out.size();
+    size_t values = ints_.size() + doubles_.size() + strings_.size();
+
+    chunk_ = {};
+    chunk_.offset = offset;
+    chunk_.values = defined_.size();
+    chunk_.nulls = defined_.size() - values;
+
+    statistics();
+
+    std::vector<uint32_t> indices;
+    std::string dictionary;
+    size_t dictionary_size = 0;
+    int dictionary_width = 0;
+    int32_t encoding = PARQUET_ENCODING_PLAIN;
+
+    if (values && type_ != PARQUET_BOOL && type_ != PARQUET_DOUBLE &&
+        buildDictionary (indices, dictionary, dictionary_size))
+    {
+        chunk_.dictionary_offset = offset;
+        writePage (out, true, dictionary_size, PARQUET_ENCODING_PLAIN, dictionary);
+
+        encoding = PARQUET_ENCODING_RLE_DICTIONARY;
+        dictionary_width = std::max (1, bitWidth (dictionary_size - 1));
+    }
+    else if (values && type_ != PARQUET_BOOL && type_ != PARQUET_DOUBLE && type_ != PARQUET_UTF8)
+        encoding = PARQUET_ENCODING_DELTA_BINARY_PACKED;
+
+    chunk_.data_offset = offset + (out.size() - start);
+    chunk_.encodings = {PARQUET_ENCODING_PLAIN, PARQUET_ENCODING_RLE};
+    if (encoding != PARQUET_ENCODING_PLAIN)
+        chunk_.encodings.push_back (encoding);
+
+    std::vector<uint32_t> levels;
+    std::string body;
+    size_t value = 0;
+
+    for (size_t row = 0; row < defined_.size(); row += PARQUET_PAGE_ROWS)
+    {
+        size_t rows = std::min (PARQUET_PAGE_ROWS, defined_.size() - row);
+
+        levels.assign (defined_.begin() + row, defined_.begin() + row + rows);
+        size_t present = std::count (levels.begin(), levels.end(), 1u);
+
+        // definition levels, prefixed by their length
+        body.assign (4, '\0');
+        encodeHybrid (body, levels, 1);
+        uint32_t length = static_cast<uint32_t> (body.size() - 4);
+        memcpy (&body[0], &length, 4);
+
+        if (encoding == PARQUET_ENCODING_RLE_DICTIONARY)
+        {
+            body.push_back (static_cast<char> (dictionary_width));
+            encodeHybrid (body, std::vector<uint32_t> (indices.begin() + value, indices.begin() + value + present),
+                          dictionary_width);
+        }
+        else if (encoding == PARQUET_ENCODING_DELTA_BINARY_PACKED)
+            encodeDelta (body, ints_.data() + value, present);
+        else
+            plainValues (value, value + present, body);
+
+        writePage (out, false, rows, encoding, body);
+
+        value += present;
+    }
+
+    chunk_.size = out.size() - start;
+}
+
+void ParquetColumn::writeChunkMetaData (ParquetThrift& thrift) const
+{
+    thrift.beginElement();
+    thrift.fieldI64 (2, chunk_.offset);
+
+    thrift.beginStruct (3);
+    thrift.fieldI32 (1, physicalType());
+    thrift.beginList (2, ParquetThrift::TYPE_I32, chunk_.encodings.size());
+    for (int32_t encoding : chunk_.encodings)
+        thrift.elementI32 (encoding);
+    thrift.beginList (3, ParquetThrift::TYPE_BINARY, 1);
+    thrift.elementBinary (name_);
+    thrift.fieldI32 (4, PARQUET_CODEC_GZIP);
+    thrift.fieldI64 (5, chunk_.values);
+    thrift.fieldI64 (6, chunk_.uncompressed_size);
+    thrift.fieldI64 (7, chunk_.size);
+    thrift.fieldI64 (9, chunk_.data_offset);
+    if (chunk_.dictionary_offset)
+        thrift.fieldI64 (11, chunk_.dictionary_offset);
+
+    thrift.beginStruct (12);
+    thrift.fieldI64 (3, chunk_.nulls);
+    if (chunk_.statistics)
+    {
+        thrift.fieldBinary (5, chunk_.max);
+        thrift.fieldBinary (6, chunk_.min);
+    }
+    thrift.endStruct();
+
+    thrift.endStruct();
+    thrift.endStruct();
+}
+
+void ParquetColumn::writeSchemaElement (ParquetThrift& thrift) const
+{
+    thrift.beginElement();
+    thrift.fieldI32 (1, physicalType());
+    thrift.fieldI32 (3, PARQUET_OPTIONAL);
+    thrift.fieldBinary (4, name_);
+
+    switch (type_)
+    {
+    case PARQUET_BOOL:
+    case PARQUET_DOUBLE:
+        break;
+    case PARQUET_UINT8:
+    case PARQUET_UINT16:
+    case PARQUET_UINT32:
+    case PARQUET_INT16:
+    case PARQUET_INT32:
+        thrift.fieldI32 (6, type_ == PARQUET_UINT8 ? PARQUET_CONVERTED_UINT_8 :
+                            type_ == PARQUET_UINT16 ? PARQUET_CONVERTED_UINT_16 :
+                            type_ == PARQUET_UINT32 ? PARQUET_CONVERTED_UINT_32 :
+                            type_ == PARQUET_INT16 ? PARQUET_CONVERTED_INT_16 : PARQUET_CONVERTED_INT_32);
+        thrift.beginStruct (10);
+        thrift.beginStruct (PARQUET_LOGICAL_INTEGER);
+        thrift.fieldI8 (1, type_ == PARQUET_UINT8 ? 8 : type_ == PARQUET_UINT16 || type_ == PARQUET_INT16 ? 16 : 32);
+        thrift.fieldBool (2, type_ == PARQUET_INT16 || type_ == PARQUET_INT32);
+        thrift.endStruct();
+        thrift.endStruct();
+        break;
+    case PARQUET_DATE:
+        thrift.fieldI32 (6, PARQUET_CONVERTED_DATE);
+        thrift.beginStruct (10);
+        thrift.beginStruct (PARQUET_LOGICAL_DATE);
+        thrift.endStruct();
+        thrift.endStruct();
+        break;
+    case PARQUET_UTF8:
+        thrift.fieldI32 (6, PARQUET_CONVERTED_UTF8);
+        thrift.beginStruct (10);
+        thrift.beginStruct (PARQUET_LOGICAL_STRING);
+        thrift.endStruct();
+        thrift.endStruct();
+        break;
+    }
+
+    thrift.endStruct();
+}
+
+void ParquetColumn::clear ()
+{
+    defined_.clear();
+    ints_.clear();
+    doubles_.clear();
+    strings_.clear();
+}
+
+bool ParquetColumn::buildDictionary (std::vector<uint32_t>& indices, std::string& dictionary, size_t& size) const
+{
+    size_t values = ints_.size() + strings_.size();
+
+    indices.reserve (values);
+
+    if (type_ == PARQUET_UTF8)
+    {
+        std::unordered_map<std::string, uint32_t> entries;
+
+        for (const std::string& text : strings_)
+        {
+            auto entry = entries.emplace (text, static_cast<uint32_t> (entries.size()));
+            if (entry.second)
+            {
+                if (entries.size() > PARQUET_DICTIONARY_MAX_VALUES)
+                    return false;
+
+                appendPlain<uint32_t> (dictionary, text.size());
+                dictionary.append (text);
+            }
+            indices.push_back (entry.first->second);
+        }
+
+        size = entries.size();
+    }
+    else
+    {
+        std::unordered_map<int32_t, uint32_t> entries;
+
+        for (int32_t number : ints_)
+        {
+            auto entry = entries.emplace (number, static_cast<uint32_t> (entries.size()));
+            if (entry.second)
+            {
+                if (entries.size() > PARQUET_DICTIONARY_MAX_VALUES)
+                    return false;
+
+                appendPlain (dictionary, number);
+            }
+            indices.push_back (entry.first->second);
+        }
+
+        size = entries.size();
+    }
+
+    return size * PARQUET_DICTIONARY_MIN_USE <= values;
+}
+
+void ParquetColumn::plainValues (size_t begin, size_t end, std::string& out) const
+{
+    switch (type_)
+    {
+    case PARQUET_BOOL:
+    {
+        std::vector<uint32_t> bits (ints_.begin() + begin, ints_.begin() + end);
+        packBits (out, bits.data(), bits.size(), 1);
+        break;
+    }
+    case PARQUET_DOUBLE:
+        out.append (reinterpret_cast<const char*> (doubles_.data() + begin), (end - begin) * sizeof (double));
+        break;
+    case PARQUET_UTF8:
+        for (size_t cnt = begin; cnt < end; ++cnt)
+        {
+            appendPlain<uint32_t> (out, strings_[cnt].size());
+            out.append (strings_[cnt]);
+        }
+        break;
+    default:
+        out.append (reinterpret_cast<const char*> (ints_.data() + begin), (end - begin) * sizeof (int32_t));
+        break;
+    }
+}
+
+void ParquetColumn::statistics ()
+{
+    // min/max of the values present, in the order of the logical type
+    switch (type_)
+    {
+    case PARQUET_BOOL:
+        if (!ints_.empty())
+        {
+            auto range = std::minmax_element (ints_.begin(), ints_.end());
+            chunk_.min.assign (1, static_cast<char> (*range.first));
+            chunk_.max.assign (1, static_cast<char> (*range.second));
+            chunk_.statistics = true;
+        }
+        break;
+    case PARQUET_UINT32:
+        if (!ints_.empty())
+        {
+            auto range = std::minmax_element (ints_.begin(), ints_.end(), [] (int32_t a, int32_t b)
+                                              { return static_cast<uint32_t> (a) < static_cast<uint32_t> (b); });
+            appendPlain (chunk_.min, *range.first);
+            appendPlain (chunk_.max, *range.second);
+            chunk_.statistics = true;
+        }
+        break;
+    case PARQUET_DOUBLE:
+    {
+        bool found = false;
+        double min = 0.0;
+        double max = 0.0;
+
+        for (double number : doubles_)
+        {
+            if (std::isnan (number))
+                continue;
+            min = found ? std::min (min, number) : number;
+            max = found ? std::max (max, number) : number;
+            found = true;
+        }
+
+        if (found)
+        {
+            appendPlain (chunk_.min, min);
+            appendPlain (chunk_.max, max);
+            chunk_.statistics = true;
+        }
+        break;
+    }
+    case PARQUET_UTF8:
+        if (!strings_.empty())
+        {
+            auto range = std::minmax_element (strings_.begin(), strings_.end());
+            chunk_.min = *range.first;
+            chunk_.max = *range.second;
+            chunk_.statistics = true;
+        }
+        break;
+    default:
+        if (!ints_.empty())
+        {
+            auto range = std::minmax_element (ints_.begin(), ints_.end());
+            appendPlain (chunk_.min, *range.first);
+            appendPlain (chunk_.max, *range.second);
+            chunk_.statistics = true;
+        }
+        break;
+    }
+}
+
+int32_t ParquetColumn::physicalType () const
+{
+    switch (type_)
+    {
+    case PARQUET_BOOL:
+        return PARQUET_TYPE_BOOLEAN;
+    case PARQUET_DOUBLE:
+        return PARQUET_TYPE_DOUBLE;
+    case PARQUET_UTF8:
+        return PARQUET_TYPE_BYTE_ARRAY;
+    default:
+        return PARQUET_TYPE_INT32;
+    }
+}
+
+void ParquetColumn::writePage (std::string& out, bool dictionary_page, size_t values,
+                               int32_t encoding, const std::string& body)
+{
+    std::string compressed;
+    compressGzip (body, compressed);
+
+    std::string header;
+    ParquetThrift thrift {header};
+
+    thrift.fieldI32 (1, dictionary_page ? PARQUET_PAGE_DICTIONARY : PARQUET_PAGE_DATA);
+    thrift.fieldI32 (2, static_cast<int32_t> (body.size()));
+    thrift.fieldI32 (3, static_cast<int32_t> (compressed.size()));
+
+    if (dictionary_page)
+    {
+        thrift.beginStruct (7);
+        thrift.fieldI32 (1, static_cast<int32_t> (values));
+        thrift.fieldI32 (2, encoding);
+        thrift.endStruct();
+    }
+    else
+    {
+        thrift.beginStruct (5);
+        thrift.fieldI32 (1, static_cast<int32_t> (values));
+        thrift.fieldI32 (2, encoding);
+        thrift.fieldI32 (3, PARQUET_ENCODING_RLE);
+        thrift.fieldI32 (4, PARQUET_ENCODING_RLE);
+        thrift.endStruct();
+    }
+    thrift.end();
+
+    out.append (header);
+    out.append (compressed);
+
+    chunk_.uncompressed_size += header.size() + body.size();
+}
+
+ParquetTable::ParquetTable (const std::string& path, unsigned int row_group_minutes, size_t max_rows)
+    : path_ {path}, slice_seconds_ {60.0 * row_group_minutes}, max_rows_ {max_rows}
+{
+    file_.open (path_, std::ios::out | std::ios::binary);
+
+    if (!file_)
+        printf ("-> Cannot open Parquet file '%s'\n", path_.c_str());
+
+    file_.write (PARQUET_MAGIC, 4);
+    file_offset_ = 4;
+}
+
+ParquetTable::~ParquetTable ()
+{
+    flush ();
+
+    if (!schema_)
+        return;
+
+    writeFooter ();
+    file_.close();
+}
+
+void ParquetTable::value (const char* name, bool present, const t_Date& date)
+{
+    column (name, PARQUET_DATE).append (present, present ? daysSinceEpoch (date) : 0);
+}
+
+void ParquetTable::value (const char* name, bool present, const char* text)
+{
+    column (name, PARQUET_UTF8).appendString (present, text);
+}
+
+ParquetColumn& ParquetTable::column (const char* name, PARQUET_COLUMN_TYPE type)
+{
+    if (!schema_)
+    {
+        columns_.emplace_back (name, type);
+        return columns_.back();
+    }
+
+    assert (column_ < columns_.size());
+    assert (columns_[column_].name() == name && columns_[column_].type() == type);
+
+    return columns_[column_++];
+}
+
+void ParquetTable::checkSlice (bool date_present, const t_Date& date, bool time_present, t_Secs time)
+{
+    if (!time_present || slice_seconds_ <= 0.0)
+        return;
+
+    double seconds = time + (date_present ? 86400.0 * daysSinceEpoch (date) : 0.0);
+    int64_t slice = static_cast<int64_t> (std::floor (seconds / slice_seconds_));
+
+    if (slice_present_ && slice != slice_)
+        flush ();
+
+    slice_present_ = true;
+    slice_ = slice;
+}
+
+void ParquetTable::flush ()
+{
+    if (!rows_)
+        return;
+
+    RowGroup group {static_cast<int64_t> (rows_), file_offset_, 0, 0, {}};
+    ParquetThrift thrift {group.columns};
+    std::string data;
+
+    for (ParquetColumn& column : columns_)
+    {
+        column.writeChunk (data, file_offset_ + data.size());
+        column.writeChunkMetaData (thrift);
+        group.size += column.chunkUncompressedSize();
+        column.clear();
+    }
+
+    group.compressed_size = data.size();
+
+    file_.write (data.data(), data.size());
+    file_offset_ += data.size();
+
+    row_groups_.push_back (std::move (group));
+
+    rows_written_ += rows_;
+    rows_ = 0;
+}
+
+void ParquetTable::writeFooter ()
+{
+    std::string metadata;
+    ParquetThrift thrift {metadata};
+
+    thrift.fieldI32 (1, PARQUET_VERSION);
+
+    thrift.beginStructList (2, columns_.size() + 1);
+    thrift.beginElement();
+    thrift.fieldBinary (4, "schema");
+    thrift.fieldI32 (5, static_cast<int32_t> (columns_.size()));
+    thrift.endStruct();
+    for (const ParquetColumn& column : columns_)
+        column.writeSchemaElement (thrift);
+
+    thrift.fieldI64 (3, static_cast<int64_t> (rows_written_));
+
+    thrift.beginStructList (4, row_groups_.size());
+    for (const RowGroup& group : row_groups_)
+    {
+        thrift.beginElement();
+        thrift.beginStructList (1, columns_.size());
+        thrift.raw (group.columns);
+        thrift.fieldI64 (2, group.size);
+        thrift.fieldI64 (3, group.rows);
+        thrift.fieldI64 (5, group.offset);
+        thrift.fieldI64 (6, group.compressed_size);
+        thrift.endStruct();
+    }
+
+    thrift.fieldBinary (6, "sddl");
+
+    // TypeDefinedOrder for all columns, which makes min/max valid
+    thrift.beginStructList (7, columns_.size());
+    for (size_t cnt = 0; cnt < columns_.size(); ++cnt)
+    {
+        thrift.beginElement();
+        thrift.beginStruct (1);
+        thrift.endStruct();
+        thrift.endStruct();
+    }
+
+    thrift.end();
+
+    int32_t length = static_cast<int32_t> (metadata.size());
+
+    file_.write (metadata.data(), metadata.size());
+    file_.write (reinterpret_cast<const char*> (&length), sizeof (length));
+    file_.write (PARQUET_MAGIC, 4);
+}
@@ -0,0 +1,247 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PARQUETTABLE_H
+#define PARQUETTABLE_H
+
+#include "global.h"
+#include "basics.h"
+
+#include "common.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+typedef enum
+{
+    PARQUET_BOOL,
+    PARQUET_UINT8,
+    PARQUET_UINT16,
+    PARQUET_UINT32,
+    PARQUET_INT16,
+    PARQUET_INT32,
+    PARQUET_DOUBLE,
+    PARQUET_DATE,
+    PARQUET_UTF8
+} PARQUET_COLUMN_TYPE;
+
+class ParquetThrift;
+
+/*
+ * One column of the row group being collected: the definition level of
+ * every row (1 where the value is present) and the present values only.
+ * Booleans, integers and dates are kept as int32, a uint32 by its
+ * bit pattern.
+ *
+ * writeChunk() encodes the column as a column chunk: integer and string
+ * columns with few distinct values in a dictionary page followed by
+ * RLE_DICTIONARY data pages, other integers and dates as
+ * DELTA_BINARY_PACKED, the rest PLAIN. Pages are gzip compressed.
+ */
+
+class ParquetColumn
+{
+public:
+    ParquetColumn (const std::string& name, PARQUET_COLUMN_TYPE type)
+        : name_ {name}, type_ {type} {}
+
+    const std::string& name () const { return name_; }
+    PARQUET_COLUMN_TYPE type () const { return type_; }
+
+    void append (bool present, int32_t value)
+    {
+        defined_.push_back (present);
+        if (present)
+            ints_.push_back (value);
+    }
+
+    void append (bool present, double value)
+    {
+        assert (type_ == PARQUET_DOUBLE);
+
+        defined_.push_back (present);
+        if (present)
+            doubles_.push_back (value);
+    }
+
+    void appendString (bool present, const char* text)
+    {
+        assert (type_ == PARQUET_UTF8);
+
+        defined_.push_back (present);
+        if (present)
+            strings_.emplace_back (text);
+    }
+
+    // appends the column chunk to out, which starts at file offset offset
+    void writeChunk (std::string& out, int64_t offset);
+    // ColumnChunk of the last chunk written, for the file metadata
+    void writeChunkMetaData (ParquetThrift& thrift) const;
+    void writeSchemaElement (ParquetThrift& thrift) const;
+
+    int64_t chunkUncompressedSize () const { return chunk_.uncompressed_size; }
+    void clear ();
+
+private:
+    std::string name_;
+    PARQUET_COLUMN_TYPE type_;
+
+    std::vector<bool> defined_;
+    std::vector<int32_t> ints_;
+    std::vector<double> doubles_;
+    std::vector<std::string> strings_;
+
+    struct Chunk
+    {
+        int64_t offset;
+        int64_t dictionary_offset;
+        // 0 without dictionary page
+        int64_t data_offset;
+        int64_t values;
+        int64_t nulls;
+        int64_t size;
+        int64_t uncompressed_size;
+        std::vector<int32_t> encodings;
+        bool statistics;
+        std::string min;
+        std::string max;
+    };
+
+    Chunk chunk_ {};
+
+    bool buildDictionary (std::vector<uint32_t>& indices, std::string& dictionary, size_t& size) const;
+    void plainValues (size_t begin, size_t end, std::string& out) const;
+    void statistics ();
+    int32_t physicalType () const;
+
+    void writePage (std::string& out, bool dictionary_page, size_t values,
+                    int32_t encoding, const std::string& body);
+};
+
+/*
+ * The reports of one type, written as a Parquet file: row groups holding
+ * the reports of row_group_minutes of frame time (at most max_rows rows),
+ * each column chunk with min/max statistics, so query engines can skip
+ * row groups by time and sensor, and the file metadata at the end.
+ *
+ * The columns are those visited by arrowColumns() in arrowcolumns.h, of
+ * the same types as in the Arrow tables.
+ */
+
+class ParquetTable
+{
+public:
+    ParquetTable (const std::string& path, unsigned int row_group_minutes, size_t max_rows);
+    ~ParquetTable ();
+
+    template <typename T>
+    void add (const T& record);
+
+    // writes the reports collected so far as a row group
+    void flush ();
+
+    size_t rows () const { return rows_written_ + rows_; }
+    size_t rowGroups () const { return row_groups_.size() + (rows_ ? 1 : 0); }
+
+    // called by arrowColumns()
+    template <typename T>
+    void value (const char* name, bool present, T value);
+    void value (const char* name, bool present, const t_Date& date);
+    void value (const char* name, bool present, const char* text);
+    void time (const char* name, bool present, t_Secs secs);
+    void flag (const char* name, t_Bool flag) { value<bool> (name, true, flag != 0); }
+    void tres (const char* name, t_Tres tres) { value<bool> (name, tres != e_is_undefined, tres == e_is_true); }
+
+private:
+    struct RowGroup
+    {
+        int64_t rows;
+        int64_t offset;
+        int64_t size;
+        int64_t compressed_size;
+        std::string columns;
+        // the ColumnChunk structures, thrift encoded
+    };
+
+    std::string path_;
+    double slice_seconds_;
+    size_t max_rows_;
+
+    std::ofstream file_;
+    int64_t file_offset_ {0};
+    std::vector<RowGroup> row_groups_;
+
+    std::vector<ParquetColumn> columns_;
+    size_t column_ {0};
+    bool schema_ {false};
+    size_t rows_ {0};
+    size_t rows_written_ {0};
+    bool slice_present_ {false};
+    int64_t slice_ {0};
+
+    ParquetColumn& column (const char* name, PARQUET_COLUMN_TYPE type);
+    void checkSlice (bool date_present, const t_Date& date, bool time_present, t_Secs time);
+
+    template <typename T>
+    static PARQUET_COLUMN_TYPE columnType ();
+
+    void writeFooter ();
+};
+
+template <typename T>
+void ParquetTable::add (const T& record)
+{
+    checkSlice (record.frame_date.present, record.frame_date.value,
+                record.frame_time.present, record.frame_time.value);
+
+    column_ = 0;
+    arrowColumns (*this, record);
+    schema_ = true;
+
+    if (++rows_ >= max_rows_)
+        flush ();
+}
+
+template <typename T>
+void ParquetTable::value (const char* name, bool present, T value)
+{
+    column (name, columnType<T>()).append (present, present ? static_cast<int32_t> (value) : 0);
+}
+
+template <>
+inline void ParquetTable::value<double> (const char* name, bool present, double value)
+{
+    column (name, PARQUET_DOUBLE).append (present, value);
+}
+
+inline void ParquetTable::time (const char* name, bool present, t_Secs secs)
+{
+    value<double> (name, present, secs);
+}
+
+template <> inline PARQUET_COLUMN_TYPE ParquetTable::columnType<bool> () { return PARQUET_BOOL; }
+template <> inline PARQUET_COLUMN_TYPE ParquetTable::columnType<uint8_t> () { return PARQUET_UINT8; }
+template <> inline PARQUET_COLUMN_TYPE ParquetTable::columnType<uint16_t> () { return PARQUET_UINT16; }
+template <> inline PARQUET_COLUMN_TYPE ParquetTable::columnType<uint32_t> () { return PARQUET_UINT32; }
+template <> inline PARQUET_COLUMN_TYPE ParquetTable::columnType<int16_t> () { return PARQUET_INT16; }
+template <> inline PARQUET_COLUMN_TYPE ParquetTable::columnType<int32_t> () { return PARQUET_INT32; }
+
+#endif // PARQUETTABLE_H
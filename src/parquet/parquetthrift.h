@@ -0,0 +1,123 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PARQUETTHRIFT_H
+#define PARQUETTHRIFT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * Writer for the Thrift compact protocol, in which the Parquet page
+ * headers and the file metadata (parquet.thrift) are encoded.
+ *
+ * Fields are written in the order of their ids, structs and lists are
+ * nested by begin...() and end...() calls. List elements are written
+ * without a field header, through the element functions.
+ */
+
+class ParquetThrift
+{
+public:
+    explicit ParquetThrift (std::string& out) : out_ (out) { last_.push_back (0); }
+
+    void fieldBool (int16_t id, bool value) { header (id, value ? TYPE_TRUE : TYPE_FALSE); }
+    void fieldI8 (int16_t id, int8_t value) { header (id, TYPE_BYTE); out_.push_back (static_cast<char> (value)); }
+    void fieldI32 (int16_t id, int32_t value) { header (id, TYPE_I32); varint (zigzag (value)); }
+    void fieldI64 (int16_t id, int64_t value) { header (id, TYPE_I64); varint (zigzag (value)); }
+    void fieldBinary (int16_t id, const std::string& value) { header (id, TYPE_BINARY); binary (value); }
+
+    void beginStruct (int16_t id) { header (id, TYPE_STRUCT); last_.push_back (0); }
+    void endStruct () { out_.push_back (0); last_.pop_back(); }
+
+    void beginList (int16_t id, uint8_t type, size_t size);
+    void beginStructList (int16_t id, size_t size) { beginList (id, TYPE_STRUCT, size); }
+
+    // list elements
+    void elementI32 (int32_t value) { varint (zigzag (value)); }
+    void elementBinary (const std::string& value) { binary (value); }
+    void beginElement () { last_.push_back (0); }
+    // elements encoded before, by another writer
+    void raw (const std::string& elements) { out_.append (elements); }
+
+    // the message itself is a struct without a header
+    void end () { out_.push_back (0); }
+
+    static const uint8_t TYPE_TRUE = 1;
+    static const uint8_t TYPE_FALSE = 2;
+    static const uint8_t TYPE_BYTE = 3;
+    static const uint8_t TYPE_I32 = 5;
+    static const uint8_t TYPE_I64 = 6;
+    static const uint8_t TYPE_BINARY = 8;
+    static const uint8_t TYPE_LIST = 9;
+    static const uint8_t TYPE_STRUCT = 12;
+
+private:
+    std::string& out_;
+    std::vector<int16_t> last_;
+    // id of the last field written, per nesting level
+
+    void header (int16_t id, uint8_t type);
+    void binary (const std::string& value) { varint (value.size()); out_.append (value); }
+    void varint (uint64_t value);
+
+    static uint64_t zigzag (int64_t value)
+    {
+        return (static_cast<uint64_t> (value) << 1) ^ static_cast<uint64_t> (value >> 63);
+    }
+};
+
+inline void ParquetThrift::beginList (int16_t id, uint8_t type, size_t size)
+{
+    header (id, TYPE_LIST);
+
+    if (size < 15)
+        out_.push_back (static_cast<char> (size << 4 | type));
+    else
+    {
+        out_.push_back (static_cast<char> (0xf0 | type));
+        varint (size);
+    }
+}
+
+inline void ParquetThrift::header (int16_t id, uint8_t type)
+{
+    int16_t delta = id - last_.back();
+
+    if (0 < delta && delta <= 15)
+        out_.push_back (static_cast<char> (delta << 4 | type));
+    else
+    {
+        out_.push_back (static_cast<char> (type));
+        varint (zigzag (id));
+    }
+
+    last_.back() = id;
+}
+
+inline void ParquetThrift::varint (uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out_.push_back (static_cast<char> (value | 0x80));
+        value >>= 7;
+    }
+    out_.push_back (static_cast<char> (value));
+}
+
+#endif // PARQUETTHRIFT_H
@@ -0,0 +1,92 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "parquetwriter.h"
+#include "arrowcolumns.h"
+
+#include <cassert>
+#include <cstdio>
+
+// reports per row group at most, which bounds the memory held per table
+const size_t PARQUET_ROW_GROUP_MAX_ROWS = 1048576;
+
+ParquetWriter::ParquetWriter (const std::string& path)
+    : path_ {path}
+{
+}
+
+void ParquetWriter::write (const t_Adsb *adsb_ptr)
+{
+    assert (adsb_ptr);
+    writeRecord (adsb_, *adsb_ptr, "adsb");
+}
+
+void ParquetWriter::write (const t_Mlat *mlat_ptr)
+{
+    assert (mlat_ptr);
+    writeRecord (mlat_, *mlat_ptr, "mlat");
+}
+
+void ParquetWriter::write (const t_Rsrv *rsrv_ptr)
+{
+    assert (rsrv_ptr);
+    writeRecord (rsrv_, *rsrv_ptr, "rsrv");
+}
+
+void ParquetWriter::write (const t_Rtgt *rtgt_ptr)
+{
+    assert (rtgt_ptr);
+    writeRecord (rtgt_, *rtgt_ptr, "rtgt");
+}
+
+void ParquetWriter::write (const t_Strk *strk_ptr)
+{
+    assert (strk_ptr);
+    writeRecord (strk_, *strk_ptr, "strk");
+}
+
+void ParquetWriter::printStatistics ()
+{
+    const std::unique_ptr<ParquetTable>* tables[] = {&adsb_, &mlat_, &rsrv_, &rtgt_, &strk_};
+    const char* types[] = {"adsb", "mlat", "rsrv", "rtgt", "strk"};
+
+    for (size_t cnt = 0; cnt < 5; ++cnt)
+    {
+        if (*tables[cnt])
+            printf ("-> Parquet: %zu %s report(s) written in %zu row group(s)\n",
+                    (*tables[cnt])->rows(), types[cnt], (*tables[cnt])->rowGroups());
+    }
+}
+
+template <typename T>
+void ParquetWriter::writeRecord (std::unique_ptr<ParquetTable>& table, const T& record, const char* type)
+{
+    if (!table)
+    {
+        size_t slash = path_.rfind ('/');
+        size_t dot = path_.rfind ('.');
+
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+            dot = path_.size();
+
+        std::string path = path_.substr (0, dot) + "_" + type + path_.substr (dot);
+
+        table.reset (new ParquetTable (path, parquet_row_group_minutes, PARQUET_ROW_GROUP_MAX_ROWS));
+    }
+
+    table->add (record);
+}
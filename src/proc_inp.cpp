@@ -267,6 +267,15 @@ static t_Retc hex_dump (void);
 		progress_limit = 100 * 1024;
 	}
 
+                   /* A record store is read as a whole: */
+	if (input_format == e_input_format_store)
+	{
+		lrc = store_input ();
+
+		ret = lrc;
+		goto done;
+	}
+
                    /* Check for RFF header: */
 	if (input_format == e_input_format_rff)
 	{
@@ -32,6 +32,9 @@
 #if USE_JSON
 #include "jsonwriter.h"
 #endif
+#include "arrowwriter.h"
+#include "parquetwriter.h"
+#include "sqlitewriter.h"
 
 #include <stddef.h>
 #include <stdio.h>
@@ -40,6 +43,19 @@
 
 #include <iostream>
 
+                   /* Local functions: */
+                   /* ---------------- */
+
+#if LISTER
+static void list_sink (t_Object_Type object, t_Pntr pntr, t_Pntr context);
+                   /* List a decoded report */
+#endif /* LISTER */
+static void store_sink (t_Object_Type object, t_Pntr pntr, t_Pntr context);
+                   /* Append a decoded report to the record store */
+template <typename W>
+static void writer_sink (t_Object_Type object, t_Pntr pntr, t_Pntr context);
+                   /* Write a decoded report by one of the writers */
+
 /*----------------------------------------------------------------------------*/
 /* process_adsb    -- Process ADS-B report                                    */
 /*----------------------------------------------------------------------------*/
@@ -53,18 +69,11 @@ t_Retc process_adsb (t_Adsb *adsb_ptr)
     /* Check parameters: */
     Assert (adsb_ptr != NULL, "Invalid parameter");
 
-#if LISTER
-    /* And list: */
-    list_adsb (adsb_ptr);
-#endif /* LISTER */
+    /* Update the sensor registry: */
+    update_sensor (e_object_adsb, adsb_ptr);
 
-#if USE_JSON
-    if (json_output_type != JSON_NONE)
-    {
-        Assert (json_writer != nullptr, "JSON writer doesn't exist");
-        json_writer->write(adsb_ptr);
-    }
-#endif
+    /* Hand to the sinks consuming it: */
+    deliver_report (e_object_adsb, adsb_ptr);
 
     /* Set the return code: */
     ret = RC_OKAY;
@@ -78,6 +87,41 @@ t_Retc process_adsb (t_Adsb *adsb_ptr)
 
 void process_init (void)
 {
+    /* Register the sinks, in the order they get each report: */
+    if (store_path.size())
+    {
+        register_sink ("store", M_ALL_REPORTS, store_sink, NULL);
+    }
+
+#if LISTER
+    register_sink ("list", M_ALL_REPORTS, list_sink, NULL);
+#endif /* LISTER */
+
+#if USE_JSON
+    if (json_output_type != JSON_NONE)
+    {
+        Assert (json_writer != nullptr, "JSON writer doesn't exist");
+        register_sink ("json", M_ALL_REPORTS, writer_sink<JSONWriter>, json_writer);
+    }
+#endif
+
+    if (arrow_writer != nullptr)
+    {
+        register_sink ("arrow", M_ALL_REPORTS, writer_sink<ArrowWriter>, arrow_writer);
+    }
+
+    if (parquet_writer != nullptr)
+    {
+        register_sink ("parquet", M_ALL_REPORTS, writer_sink<ParquetWriter>, parquet_writer);
+    }
+
+    if (sqlite_writer != nullptr)
+    {
+        register_sink ("sqlite", M_ALL_REPORTS, writer_sink<SqliteWriter>, sqlite_writer);
+    }
+
+    start_sinks ();
+
     /* We are done: */
     return;
 }
@@ -96,18 +140,11 @@ t_Retc process_mlat (t_Mlat *mlat_ptr)
     /* Check parameters: */
     Assert (mlat_ptr != NULL, "Invalid parameter");
 
-#if LISTER
-    /* And list: */
-    list_mlat (mlat_ptr);
-#endif /* LISTER */
+    /* Update the sensor registry: */
+    update_sensor (e_object_mlat, mlat_ptr);
 
-#if USE_JSON
-    if (json_output_type != JSON_NONE)
-    {
-        Assert (json_writer != nullptr, "JSON writer doesn't exist");
-        json_writer->write(mlat_ptr);
-    }
-#endif
+    /* Hand to the sinks consuming it: */
+    deliver_report (e_object_mlat, mlat_ptr);
 
     /* Set the return code: */
     ret = RC_OKAY;
@@ -129,18 +166,11 @@ t_Retc process_rsrv (t_Rsrv *rsrv_ptr)
     /* Check parameters: */
     Assert (rsrv_ptr != NULL, "Invalid parameter");
 
-#if LISTER
-    /* And list: */
-    list_rsrv (rsrv_ptr);
-#endif /* LISTER */
+    /* Update the sensor registry: */
+    update_sensor (e_object_rsrv, rsrv_ptr);
 
-#if USE_JSON
-    if (json_output_type != JSON_NONE)
-    {
-        Assert (json_writer != nullptr, "JSON writer doesn't exist");
-        json_writer->write(rsrv_ptr);
-    }
-#endif
+    /* Hand to the sinks consuming it: */
+    deliver_report (e_object_rsrv, rsrv_ptr);
 
     /* Set the return code: */
     ret = RC_OKAY;
@@ -162,18 +192,11 @@ t_Retc process_rtgt (t_Rtgt *rtgt_ptr)
     /* Check parameters: */
     Assert (rtgt_ptr != NULL, "Invalid parameter");
 
-#if LISTER
-    /* And list: */
-    list_rtgt (rtgt_ptr);
-#endif /* LISTER */
+    /* Update the sensor registry: */
+    update_sensor (e_object_rtgt, rtgt_ptr);
 
-#if USE_JSON
-    if (json_output_type != JSON_NONE)
-    {
-        Assert (json_writer != nullptr, "JSON writer doesn't exist");
-        json_writer->write(rtgt_ptr);
-    }
-#endif
+    /* Hand to the sinks consuming it: */
+    deliver_report (e_object_rtgt, rtgt_ptr);
 
     /* Set the return code: */
     ret = RC_OKAY;
@@ -195,18 +218,8 @@ t_Retc process_strk (t_Strk *strk_ptr)
     /* Check parameters: */
     Assert (strk_ptr != NULL, "Invalid parameter");
 
-#if LISTER
-    /* And list: */
-    list_strk (strk_ptr);
-#endif /* LISTER */
-
-#if USE_JSON
-    if (json_output_type != JSON_NONE)
-    {
-        Assert (json_writer != nullptr, "JSON writer doesn't exist");
-        json_writer->write(strk_ptr);
-    }
-#endif
+    /* Hand to the sinks consuming it: */
+    deliver_report (e_object_strk, strk_ptr);
 
     /* Set the return code: */
     ret = RC_OKAY;
@@ -220,7 +233,86 @@ t_Retc process_strk (t_Strk *strk_ptr)
 
 void process_term (void)
 {
+    /* The writers are gone, so are their sinks: */
+    term_sinks ();
+
     /* We are done: */
     return;
 }
+
+#if LISTER
+/*----------------------------------------------------------------------------*/
+/* list_sink       -- List a decoded report                                   */
+/*----------------------------------------------------------------------------*/
+
+static void list_sink (t_Object_Type object, t_Pntr pntr, t_Pntr context)
+{
+    switch (object)
+    {
+    case e_object_adsb:
+        list_adsb ((t_Adsb *) pntr);
+        break;
+    case e_object_mlat:
+        list_mlat ((t_Mlat *) pntr);
+        break;
+    case e_object_rsrv:
+        list_rsrv ((t_Rsrv *) pntr);
+        break;
+    case e_object_rtgt:
+        list_rtgt ((t_Rtgt *) pntr);
+        break;
+    case e_object_strk:
+        list_strk ((t_Strk *) pntr);
+        break;
+    default:
+        break;
+    }
+
+    return;
+}
+#endif /* LISTER */
+
+/*----------------------------------------------------------------------------*/
+/* store_sink      -- Append a decoded report to the record store             */
+/*----------------------------------------------------------------------------*/
+
+static void store_sink (t_Object_Type object, t_Pntr pntr, t_Pntr context)
+{
+    store_report (object, pntr);
+
+    return;
+}
+
+/*----------------------------------------------------------------------------*/
+/* writer_sink     -- Write a decoded report by one of the writers            */
+/*----------------------------------------------------------------------------*/
+
+template <typename W>
+static void writer_sink (t_Object_Type object, t_Pntr pntr, t_Pntr context)
+{
+    W *writer = static_cast<W *> (context);
+
+    switch (object)
+    {
+    case e_object_adsb:
+        writer->write (static_cast<t_Adsb *> (pntr));
+        break;
+    case e_object_mlat:
+        writer->write (static_cast<t_Mlat *> (pntr));
+        break;
+    case e_object_rsrv:
+        writer->write (static_cast<t_Rsrv *> (pntr));
+        break;
+    case e_object_rtgt:
+        writer->write (static_cast<t_Rtgt *> (pntr));
+        break;
+    case e_object_strk:
+        writer->write (static_cast<t_Strk *> (pntr));
+        break;
+    default:
+        break;
+    }
+
+    return;
+}
 /* end-of-file */
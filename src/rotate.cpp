@@ -0,0 +1,504 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*----------------------------------------------------------------------------*/
+/* Project:        Surveillance Data Decoder and Lister                       */
+/* File:           rotate.cpp                                                 */
+/* Contents:       Rotation of output files (by size, count or frame time)    */
+/* Author(s):      agent                                                      */
+/* Last change:    2026-10-18                                                 */
+/*----------------------------------------------------------------------------*/
+
+#include "basics.h"
+                   /* Basic system definitions */
+#include "common.h"
+                   /* Common declarations and definitions */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <zlib.h>
+
+/*
+ * An output file is rotated when it has reached rotate_size bytes, holds
+ * rotate_count frames (list file) or records (JSON file), or when the
+ * frame time enters the next rotate_minutes slice of the day. The file
+ * written so far is renamed to
+ *
+ *     <stem>_<sequence>[_<yyyymmdd>][_<hhmmss>-<hhmmss>]<extension>
+ *
+ * from the frame date and the first and last frame time it holds, and
+ * a new file is started under the original path name. Closing the
+ * finished file and compressing it (rotate_gzip) is left to a
+ * background thread, so decoding does not wait for either.
+ */
+
+                   /* Local data: */
+                   /* ----------- */
+
+typedef struct
+{
+	FILE *file;
+                   /* File to be closed, or NULL */
+	std::string path;
+                   /* Path name of the finished file */
+	t_Bool compress;
+                   /* Compress the finished file */
+} t_Finished_File;
+
+static std::mutex finisher_mutex;
+                   /* Protects the finisher queue */
+static std::condition_variable finisher_wakeup;
+                   /* Signals new work or termination */
+static std::deque<t_Finished_File> finisher_queue;
+                   /* Finished files waiting for the background thread */
+static std::thread finisher_thread;
+                   /* Background thread closing and compressing files */
+static t_Bool finisher_stopping;
+                   /* Background thread is to terminate */
+
+#if LISTER
+static t_Rotation list_rotation;
+                   /* Rotation state of the list file */
+#endif /* LISTER */
+
+                   /* Local functions: */
+                   /* ---------------- */
+
+static t_Retc compress_file (const std::string& path);
+                   /* Compress a file into <path>.gz */
+static void finisher (void);
+                   /* Background thread closing and compressing files */
+#if LISTER
+static void rotate_list_file (t_Bool reopen);
+                   /* Finish the list file */
+#endif /* LISTER */
+
+/*----------------------------------------------------------------------------*/
+/* check_list_rotation -- Rotate the list file, if due                        */
+/*----------------------------------------------------------------------------*/
+
+#if LISTER
+ void check_list_rotation (void)
+{
+	long pos;      /* Current size of the list file */
+
+	if (!rotation_defined () || list_file == NULL || list_file == stdout)
+	{
+		goto done;
+	}
+
+	pos = ftell (list_file);
+
+	if (rotation_check (&list_rotation, pos > 0 ? (size_t) pos : 0,
+                        frame_date_present, frame_date,
+                        frame_time_present, frame_time))
+	{
+		rotate_list_file (TRUE);
+	}
+
+	rotation_count (&list_rotation, frame_date_present, frame_date,
+                    frame_time_present, frame_time);
+
+	done:          /* We are done */
+	return;
+}
+#endif /* LISTER */
+
+/*----------------------------------------------------------------------------*/
+/* close_list_file -- Close the list file                                     */
+/*----------------------------------------------------------------------------*/
+
+#if LISTER
+ void close_list_file (void)
+{
+                   /* Check list file: */
+	Assert (list_file != NULL && list_file != stdout, "Invalid list file");
+
+	if (rotation_defined ())
+	{
+		rotate_list_file (FALSE);
+	}
+	else
+	{
+		fclose (list_file);
+	}
+
+	list_file = NULL;
+
+	return;
+}
+#endif /* LISTER */
+
+/*----------------------------------------------------------------------------*/
+/* compress_file   -- Compress a file into <path>.gz                          */
+/*----------------------------------------------------------------------------*/
+
+ static t_Retc compress_file (const std::string& path)
+{
+	char buffer[64 * 1024];
+                   /* Copy buffer */
+	FILE *in;      /* Finished file */
+	size_t length; /* Bytes read */
+	gzFile out;    /* Compressed file */
+	t_Retc ret;    /* Return code */
+
+                   /* Preset the return code: */
+	ret = RC_FAIL;
+
+	in = fopen (path.c_str(), "rb");
+	if (in == NULL)
+	{
+		error_msg ("Cannot open '%s'", path.c_str());
+		goto done;
+	}
+
+	out = gzopen ((path + ".gz").c_str(), "wb");
+	if (out == NULL)
+	{
+		error_msg ("Cannot create '%s.gz'", path.c_str());
+		fclose (in);
+		goto done;
+	}
+
+	while ((length = fread (buffer, 1, sizeof (buffer), in)) > 0)
+	{
+		if (gzwrite (out, buffer, (unsigned) length) != (int) length)
+		{
+			error_msg ("Cannot write '%s.gz'", path.c_str());
+			break;
+		}
+	}
+
+	fclose (in);
+
+	if (gzclose (out) != Z_OK || length != 0)
+	{
+		goto done;
+	}
+
+                   /* Keep only the compressed file: */
+	remove (path.c_str());
+
+                   /* Set the return code: */
+	ret = RC_OKAY;
+
+	done:          /* We are done */
+	return ret;
+}
+
+/*----------------------------------------------------------------------------*/
+/* finish_file     -- Close and compress a finished file in background        */
+/*----------------------------------------------------------------------------*/
+
+ void finish_file (FILE *file, const char *path, t_Bool compress)
+{
+                   /* Check parameters: */
+	Assert (path != NULL, "Invalid parameter");
+
+	if (file == NULL && !compress)
+	{
+		goto done;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock (finisher_mutex);
+
+		if (!finisher_thread.joinable())
+		{
+			finisher_stopping = FALSE;
+			finisher_thread = std::thread (finisher);
+		}
+
+		finisher_queue.push_back (t_Finished_File {file, path, compress});
+	}
+
+	finisher_wakeup.notify_one ();
+
+	done:          /* We are done */
+	return;
+}
+
+/*----------------------------------------------------------------------------*/
+/* finisher        -- Background thread closing and compressing files         */
+/*----------------------------------------------------------------------------*/
+
+ static void finisher (void)
+{
+	std::unique_lock<std::mutex> lock (finisher_mutex);
+
+	while (TRUE)
+	{
+		finisher_wakeup.wait (lock, [] {
+			return finisher_stopping || !finisher_queue.empty(); });
+
+		if (finisher_queue.empty())
+		{
+                   /* Stopping, and nothing left to do */
+			break;
+		}
+
+		t_Finished_File ff = finisher_queue.front();
+		finisher_queue.pop_front();
+
+		lock.unlock();
+
+		if (ff.file != NULL)
+		{
+			fclose (ff.file);
+		}
+
+		if (ff.compress)
+		{
+			compress_file (ff.path);
+		}
+
+		lock.lock();
+	}
+
+	return;
+}
+
+/*----------------------------------------------------------------------------*/
+/* rotate_list_file -- Finish the list file                                   */
+/*----------------------------------------------------------------------------*/
+
+#if LISTER
+ static void rotate_list_file (t_Bool reopen)
+{
+	FILE *file;    /* Finished list file */
+	char name[M_MAX_PATH_LENGTH];
+                   /* Path name of the finished list file */
+
+	file = list_file;
+
+	rotation_name (&list_rotation, list_path, name, sizeof (name));
+
+	if (rename (list_path, name) != 0)
+	{
+		error_msg ("Cannot rename list file to '%s'", name);
+		goto done;
+	}
+
+	if (reopen)
+	{
+		list_file = fopen (list_path, "w");
+		if (list_file == NULL)
+		{
+			error_msg ("Cannot open list file '%s'", list_path);
+			list_file = file;
+			goto done;
+		}
+	}
+
+	finish_file (file, name, rotate_gzip);
+
+	done:          /* We are done */
+	return;
+}
+#endif /* LISTER */
+
+/*----------------------------------------------------------------------------*/
+/* rotation_check  -- Check whether a file is to be rotated before an item    */
+/*----------------------------------------------------------------------------*/
+
+ t_Bool rotation_check (t_Rotation *rot_ptr, size_t bytes,
+                        t_Bool date_present, t_Date date,
+                        t_Bool time_present, t_Secs time)
+{
+	t_Bool due;    /* Rotation due */
+
+                   /* Check parameters: */
+	Assert (rot_ptr != NULL, "Invalid parameter");
+
+                   /* Preset the return value: */
+	due = FALSE;
+
+                   /* Never rotate an empty file: */
+	if (rot_ptr->count == 0)
+	{
+		goto done;
+	}
+
+	if (rotate_count > 0 && rot_ptr->count >= rotate_count)
+	{
+		due = TRUE;
+	}
+
+	if (rotate_size > 0 && bytes >= rotate_size)
+	{
+		due = TRUE;
+	}
+
+	if (rotate_minutes > 0)
+	{
+		if (time_present && rot_ptr->times_present &&
+            (long) (time / (60.0 * rotate_minutes)) != rot_ptr->slice)
+		{
+			due = TRUE;
+		}
+
+		if (date_present && rot_ptr->date_present &&
+            !same_day (date, rot_ptr->date))
+		{
+			due = TRUE;
+		}
+	}
+
+	done:          /* We are done */
+	return due;
+}
+
+/*----------------------------------------------------------------------------*/
+/* rotation_count  -- Count an item written into a rotated file               */
+/*----------------------------------------------------------------------------*/
+
+ void rotation_count (t_Rotation *rot_ptr,
+                      t_Bool date_present, t_Date date,
+                      t_Bool time_present, t_Secs time)
+{
+                   /* Check parameters: */
+	Assert (rot_ptr != NULL, "Invalid parameter");
+
+	if (date_present && !rot_ptr->date_present)
+	{
+		rot_ptr->date = date;
+		rot_ptr->date_present = TRUE;
+	}
+
+	if (time_present)
+	{
+		if (!rot_ptr->times_present)
+		{
+			rot_ptr->first_time = time;
+			if (rotate_minutes > 0)
+			{
+				rot_ptr->slice = (long) (time / (60.0 * rotate_minutes));
+			}
+			rot_ptr->times_present = TRUE;
+		}
+
+		rot_ptr->last_time = time;
+	}
+
+	++ rot_ptr->count;
+
+	return;
+}
+
+/*----------------------------------------------------------------------------*/
+/* rotation_defined -- Check whether output files are rotated                 */
+/*----------------------------------------------------------------------------*/
+
+ t_Bool rotation_defined (void)
+{
+	return rotate_count > 0 || rotate_size > 0 || rotate_minutes > 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* rotation_name   -- Build path name of a finished file                      */
+/*----------------------------------------------------------------------------*/
+
+ void rotation_name (t_Rotation *rot_ptr, const char *path,
+                     char *name, size_t size)
+{
+	const char *dot;
+                   /* Start of extension, if any */
+	const char *file_name;
+                   /* Start of file name in path */
+	int len;       /* Length of name built so far */
+	long t1, t2;   /* First and last frame time; seconds */
+
+                   /* Check parameters: */
+	Assert (rot_ptr != NULL, "Invalid parameter");
+	Assert (path != NULL, "Invalid parameter");
+	Assert (name != NULL && size > 0, "Invalid parameter");
+
+	file_name = strrchr (path, '/');
+	file_name = (file_name != NULL) ? file_name + 1 : path;
+
+	dot = strrchr (file_name, '.');
+	if (dot == NULL || dot == file_name)
+	{
+		dot = path + strlen (path);
+	}
+
+	++ rot_ptr->sequence;
+
+	len = snprintf (name, size, "%.*s_%04u",
+                    (int) (dot - path), path, (unsigned) rot_ptr->sequence);
+
+	if (rot_ptr->date_present && len >= 0 && (size_t) len < size)
+	{
+		len += snprintf (name + len, size - len, "_%04d%02d%02d",
+                         rot_ptr->date.year, rot_ptr->date.month,
+                         rot_ptr->date.day);
+	}
+
+	if (rot_ptr->times_present && len >= 0 && (size_t) len < size)
+	{
+		t1 = (long) rot_ptr->first_time;
+		t2 = (long) rot_ptr->last_time;
+
+		len += snprintf (name + len, size - len,
+                         "_%02ld%02ld%02ld-%02ld%02ld%02ld",
+                         t1 / 3600, t1 / 60 % 60, t1 % 60,
+                         t2 / 3600, t2 / 60 % 60, t2 % 60);
+	}
+
+	if (len >= 0 && (size_t) len < size)
+	{
+		snprintf (name + len, size - len, "%s", dot);
+	}
+
+                   /* Start counting the next file: */
+	rot_ptr->count = 0;
+	rot_ptr->date_present = FALSE;
+	rot_ptr->times_present = FALSE;
+
+	return;
+}
+
+/*----------------------------------------------------------------------------*/
+/* term_rotation   -- Wait for finished files to be closed and compressed     */
+/*----------------------------------------------------------------------------*/
+
+ void term_rotation (void)
+{
+	{
+		std::lock_guard<std::mutex> lock (finisher_mutex);
+
+		finisher_stopping = TRUE;
+	}
+
+	finisher_wakeup.notify_one ();
+
+	if (finisher_thread.joinable())
+	{
+		finisher_thread.join ();
+	}
+
+	return;
+}
+/* end-of-file */
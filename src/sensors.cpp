@@ -0,0 +1,472 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*----------------------------------------------------------------------------*/
+/* Project:        Surveillance Data Decoder and Lister                       */
+/* File:           sensors.cpp                                                */
+/* Contents:       Sensor registry (indexed by SAC/SIC)                       */
+/* Author(s):      agent                                                      */
+/* Last change:    2026-10-18                                                 */
+/*----------------------------------------------------------------------------*/
+
+#include "basics.h"
+                   /* Basic system definitions */
+#include "common.h"
+                   /* Common declarations and definitions */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+                   /* Local data types: */
+                   /* ----------------- */
+
+typedef struct
+{
+	t_Sensor sensors[M_MAX_NUMBER_OF_SENSORS];
+                   /* Sensor records; dense, in order of registration */
+	t_Ui16 sensor_index[65536];
+                   /* Direct index from data source identifier (SAC/SIC)
+                      to sensor record; 0 = no sensor registered,
+                      else 1 + index into the sensors table */
+	t_Ui16 sensors_registered;
+                   /* Number of registered sensors */
+	t_Bool sensors_overflow;
+                   /* Sensor table overflow already reported */
+} t_Sensor_Registry;
+
+                   /* Local data: */
+                   /* ----------- */
+
+static t_Sensor_Registry program_registry;
+                   /* Sensor registry of the program */
+static t_Sensor_Registry *registry = &program_registry;
+                   /* Sensor registry in use */
+
+                   /* Local functions: */
+                   /* ---------------- */
+
+static t_Sensor *register_sensor (t_Ui16 dsi);
+                   /* Register a sensor */
+
+/*----------------------------------------------------------------------------*/
+/* clear_sensor_registry -- Clear a sensor registry                           */
+/*----------------------------------------------------------------------------*/
+
+ void clear_sensor_registry (t_Pntr rgy_ptr)
+{
+                   /* Check parameters: */
+	Assert (rgy_ptr != NULL, "Invalid parameter");
+
+	memset (rgy_ptr, 0, sizeof (t_Sensor_Registry));
+
+	return;
+}
+
+/*----------------------------------------------------------------------------*/
+/* create_sensor_registry -- Create an (empty) sensor registry                */
+/*----------------------------------------------------------------------------*/
+
+ t_Pntr create_sensor_registry (void)
+{
+	t_Pntr rgy_ptr;
+                   /* Pointer to sensor registry */
+
+	rgy_ptr = calloc (1, sizeof (t_Sensor_Registry));
+	Assert (rgy_ptr != NULL, "Not enough memory");
+
+	return rgy_ptr;
+}
+
+/*----------------------------------------------------------------------------*/
+/* define_sensor   -- Define a sensor (number, alias and name)                */
+/*----------------------------------------------------------------------------*/
+
+ t_Retc define_sensor (t_Ui16 dsi, t_Bool rsap_defined, t_Ui16 rsap,
+                       const char *name)
+{
+	t_Retc ret;    /* Return code */
+	t_Sensor *sp;  /* Pointer to sensor record */
+
+                   /* Preset the return code: */
+	ret = RC_FAIL;
+
+                   /* Check for a sensor already defined: */
+	sp = get_sensor (dsi);
+	if (sp != NULL && sp->sensor_number_defined)
+	{
+		error_msg ("Sensor 0x%04x defined twice", dsi);
+		goto done;
+	}
+	if (rsap_defined && registry->sensor_index[rsap] != 0 &&
+        get_sensor (rsap) != get_sensor (dsi))
+	{
+		error_msg ("RSAP 0x%04x already in use", rsap);
+		goto done;
+	}
+
+                   /* Register the sensor: */
+	sp = register_sensor (dsi);
+	if (sp == NULL)
+	{
+		goto done;
+	}
+
+                   /* Give the next sensor number: */
+	++ number_of_sensor_descriptions;
+	sp->sensor_number = number_of_sensor_descriptions;
+	sp->sensor_number_defined = TRUE;
+
+                   /* The RSAP is an alias of the original SAC/SIC: */
+	if (rsap_defined)
+	{
+		sp->rsap = rsap;
+		sp->rsap_defined = TRUE;
+
+		registry->sensor_index[rsap] = registry->sensor_index[dsi];
+	}
+
+                   /* Remember the sensor name: */
+	if (name != NULL && *name != '\0')
+	{
+		strncpy (sp->name, name, M_MAX_SENSOR_NAME_LENGTH);
+		sp->name[M_MAX_SENSOR_NAME_LENGTH] = '\0';
+		sp->name_defined = TRUE;
+	}
+
+                   /* Set the return code: */
+	ret = RC_OKAY;
+
+	done:          /* We are done */
+	return ret;
+}
+
+/*----------------------------------------------------------------------------*/
+/* delete_sensor_registry -- Delete a sensor registry                         */
+/*----------------------------------------------------------------------------*/
+
+ void delete_sensor_registry (t_Pntr rgy_ptr)
+{
+                   /* Check parameters: */
+	Assert (rgy_ptr != (t_Pntr) registry, "Sensor registry in use");
+
+	free (rgy_ptr);
+
+	return;
+}
+
+/*----------------------------------------------------------------------------*/
+/* find_sensor     -- Find sensor (number) by data source identifier          */
+/*----------------------------------------------------------------------------*/
+
+ t_Retc find_sensor (t_Ui16 dsi, t_Ui16 *sno_ptr, t_Bool *new_ptr)
+{
+	t_Retc ret;    /* Return code */
+	t_Sensor *sp;  /* Pointer to sensor record */
+
+                   /* Check parameters: */
+	Assert (sno_ptr != NULL, "Invalid parameter");
+
+                   /* Preset the return code: */
+	ret = RC_FAIL;
+
+                   /* Only sensors defined by the user are numbered: */
+	sp = get_sensor (dsi);
+	if (sp == NULL || !sp->sensor_number_defined)
+	{
+		goto done;
+	}
+
+	*sno_ptr = sp->sensor_number;
+
+                   /* Tell whether this is the first encounter: */
+	if (new_ptr != NULL)
+	{
+		*new_ptr = !sp->announced;
+		sp->announced = TRUE;
+	}
+
+                   /* Set the return code: */
+	ret = RC_OKAY;
+
+	done:          /* We are done */
+	return ret;
+}
+
+/*----------------------------------------------------------------------------*/
+/* get_sensor      -- Get sensor record for data source identifier            */
+/*----------------------------------------------------------------------------*/
+
+ t_Sensor * get_sensor (t_Ui16 dsi)
+{
+	t_Ui16 ix;     /* Index into sensors table (plus 1) */
+
+	ix = registry->sensor_index[dsi];
+
+	return (ix == 0 ? NULL : &registry->sensors[ix - 1]);
+}
+
+#if LISTER
+/*----------------------------------------------------------------------------*/
+/* list_sensors    -- List sensor registry                                    */
+/*----------------------------------------------------------------------------*/
+
+ void list_sensors (void)
+{
+	int cat;       /* ASTERIX category */
+	int ix;        /* Auxiliary */
+	t_Sensor *sp;  /* Pointer to sensor record */
+
+	if (registry->sensors_registered == 0)
+	{
+		goto done;
+	}
+
+	list_text (-1, "\n");
+	list_text (-1, "; Sensors:\n");
+
+	for (ix = 0; ix < registry->sensors_registered; ix ++)
+	{
+		sp = &registry->sensors[ix];
+
+		list_text (-1, ";  sacsic=0x%04x (%u/%u)",
+                       sp->data_source_identifier,
+                       hi_byte (sp->data_source_identifier),
+                       lo_byte (sp->data_source_identifier));
+
+		if (sp->sensor_number_defined)
+		{
+			list_text (-1, " sno=%hu", sp->sensor_number);
+		}
+		if (sp->rsap_defined)
+		{
+			list_text (-1, " rsap=0x%04x", sp->rsap);
+		}
+		if (sp->name_defined)
+		{
+			list_text (-1, " name='%s'", sp->name);
+		}
+		if (sp->line_number_defined)
+		{
+			list_text (-1, " line=%hu", sp->line_number);
+		}
+
+		list_text (-1, " cat=");
+		for (cat = 0; cat < 256; cat ++)
+		{
+			if (sp->asterix_categories[cat])
+			{
+				list_text (-1, "%03d ", cat);
+			}
+		}
+
+		if (sp->adsb_count > 0)
+		{
+			list_text (-1, "adsb=" M_FMT_UI32 " ", sp->adsb_count);
+		}
+		if (sp->mlat_count > 0)
+		{
+			list_text (-1, "mlat=" M_FMT_UI32 " ", sp->mlat_count);
+		}
+		if (sp->rsrv_count > 0)
+		{
+			list_text (-1, "rsrv=" M_FMT_UI32 " ", sp->rsrv_count);
+		}
+		if (sp->rtgt_count > 0)
+		{
+			list_text (-1, "rtgt=" M_FMT_UI32 " ", sp->rtgt_count);
+		}
+
+		if (sp->position.present)
+		{
+			list_text (-1, "pos=(%s; %s; %.1f m)",
+                           lat_text (M_RAD2DEG * sp->position.value_latitude),
+                           lon_text (M_RAD2DEG * sp->position.value_longitude),
+                           sp->position.value_altitude);
+		}
+
+		list_text (-1, "\n");
+	}
+
+	done:          /* We are done */
+	return;
+}
+#endif /* LISTER */
+
+/*----------------------------------------------------------------------------*/
+/* register_sensor -- Register a sensor                                       */
+/*----------------------------------------------------------------------------*/
+
+ static
+ t_Sensor *register_sensor (t_Ui16 dsi)
+{
+	t_Sensor *sp;  /* Pointer to sensor record */
+
+                   /* Check for a sensor already registered: */
+	sp = get_sensor (dsi);
+	if (sp != NULL)
+	{
+		goto done;
+	}
+
+                   /* Check against the size of the sensors table: */
+	if (registry->sensors_registered >= M_MAX_NUMBER_OF_SENSORS)
+	{
+		if (!registry->sensors_overflow)
+		{
+			error_msg ("Too many sensors (max. %d)",
+                       M_MAX_NUMBER_OF_SENSORS);
+
+			registry->sensors_overflow = TRUE;
+		}
+		goto done;
+	}
+
+                   /* Take the next free sensor record: */
+	sp = &registry->sensors[registry->sensors_registered];
+	memset (sp, 0, sizeof (t_Sensor));
+	sp->data_source_identifier = dsi;
+
+	++ registry->sensors_registered;
+	registry->sensor_index[dsi] = registry->sensors_registered;
+
+	done:          /* We are done */
+	return sp;
+}
+
+/*----------------------------------------------------------------------------*/
+/* registered_sensor -- Get sensor record by index (in order of registration) */
+/*----------------------------------------------------------------------------*/
+
+ t_Sensor * registered_sensor (t_Ui16 ix)
+{
+	return (ix < registry->sensors_registered ? &registry->sensors[ix] : NULL);
+}
+
+/*----------------------------------------------------------------------------*/
+/* select_sensor_registry -- Select the sensor registry in use                */
+/*----------------------------------------------------------------------------*/
+
+ t_Pntr select_sensor_registry (t_Pntr rgy_ptr)
+{
+	t_Pntr prev_ptr;
+                   /* Sensor registry in use before */
+
+	prev_ptr = (t_Pntr) registry;
+
+                   /* NULL is the registry of the program: */
+	registry = (rgy_ptr != NULL ? (t_Sensor_Registry *) rgy_ptr
+                                : &program_registry);
+
+	return (prev_ptr == (t_Pntr) &program_registry ? NULL : prev_ptr);
+}
+
+/*----------------------------------------------------------------------------*/
+/* update_sensor   -- Update sensor registry from a decoded report            */
+/*----------------------------------------------------------------------------*/
+
+ void update_sensor (t_Object_Type object, t_Pntr pntr)
+{
+	t_Byte cat;    /* ASTERIX category */
+	t_Ui32 *count_ptr;
+                   /* Pointer to report counter */
+	t_Data_Source_Identifier *dsi_ptr;
+                   /* Pointer to data source identifier */
+	t_Data_Format fmt;
+                   /* Data format */
+	t_Data_Source_Position *pos_ptr;
+                   /* Pointer to data source position */
+	t_Sensor *sp;  /* Pointer to sensor record */
+
+                   /* Check parameters: */
+	Assert (e_no_object < object && object < e_object_sentinel,
+            "Invalid parameter");
+	Assert (pntr != NULL, "Invalid parameter");
+
+                   /* Extract the relevant information: */
+	pos_ptr = NULL;
+	switch (object)
+	{
+	case e_object_adsb:
+		dsi_ptr = &((t_Adsb *) pntr)->data_source_identifier;
+		fmt = ((t_Adsb *) pntr)->data_format;
+		cat = ((t_Adsb *) pntr)->asterix_category;
+		break;
+	case e_object_mlat:
+		dsi_ptr = &((t_Mlat *) pntr)->data_source_identifier;
+		fmt = ((t_Mlat *) pntr)->data_format;
+		cat = ((t_Mlat *) pntr)->asterix_category;
+		break;
+	case e_object_rsrv:
+		dsi_ptr = &((t_Rsrv *) pntr)->data_source_identifier;
+		fmt = ((t_Rsrv *) pntr)->data_format;
+		cat = ((t_Rsrv *) pntr)->asterix_category;
+		pos_ptr = &((t_Rsrv *) pntr)->data_source_position;
+		break;
+	case e_object_rtgt:
+		dsi_ptr = &((t_Rtgt *) pntr)->data_source_identifier;
+		fmt = ((t_Rtgt *) pntr)->data_format;
+		cat = ((t_Rtgt *) pntr)->asterix_category;
+		break;
+	default:
+		goto done;
+	}
+
+                   /* Without SAC/SIC there is no sensor: */
+	if (!dsi_ptr->present)
+	{
+		goto done;
+	}
+
+                   /* Look up or register the sensor: */
+	sp = register_sensor (dsi_ptr->value);
+	if (sp == NULL)
+	{
+		goto done;
+	}
+
+                   /* Count the report: */
+	count_ptr = (object == e_object_adsb ? &sp->adsb_count :
+                 object == e_object_mlat ? &sp->mlat_count :
+                 object == e_object_rsrv ? &sp->rsrv_count :
+                                           &sp->rtgt_count);
+	++ (*count_ptr);
+
+                   /* Remember the ASTERIX category: */
+	if (fmt == e_data_format_asterix)
+	{
+		sp->asterix_categories[cat] = TRUE;
+	}
+
+                   /* Remember the (first) line number: */
+	if (!sp->line_number_defined && current_line_number_defined)
+	{
+		sp->line_number = (t_Ui16) current_line_number;
+		sp->line_number_defined = TRUE;
+	}
+
+                   /* Remember the (latest) sensor position: */
+	if (pos_ptr != NULL && pos_ptr->present)
+	{
+		sp->position = *pos_ptr;
+	}
+
+	done:          /* We are done */
+	return;
+}
+/* end-of-file */
@@ -0,0 +1,661 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*----------------------------------------------------------------------------*/
+/* Project:        Surveillance Data Decoder and Lister                       */
+/* File:           sinks.cpp                                                  */
+/* Contents:       Registry of sinks of decoded reports                       */
+/* Author(s):      agent                                                      */
+/* Last change:    2026-10-18                                                 */
+/*----------------------------------------------------------------------------*/
+
+#include "basics.h"
+                   /* Basic system definitions */
+#include "common.h"
+                   /* Common declarations and definitions */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+                   /* Local macros: */
+                   /* ------------- */
+
+#define M_MAX_BATCH_REPORTS 4096
+                   /* Max. number of reports kept for batch sinks;
+                      delivered early when reached */
+#define M_MAX_SINK_NAME_LENGTH 16
+                   /* Max. length of a sink name */
+
+                   /* Local data types: */
+                   /* ----------------- */
+
+typedef struct
+{
+	char name[M_MAX_SINK_NAME_LENGTH + 1];
+                   /* Name of the sink */
+	t_Ui32 objects;
+                   /* Report types consumed; bit mask by t_Object_Type */
+	t_Sink_Report report;
+                   /* Function receiving a report; NULL for batches */
+	t_Sink_Batch batch;
+                   /* Function receiving a batch of reports */
+	t_Batch_Unit unit;
+                   /* Reports per batch */
+	t_Pntr context;
+                   /* Passed to the function */
+	t_Ui32 reports;
+                   /* Number of reports delivered */
+} t_Sink;
+
+typedef struct
+{
+	char name[M_MAX_SINK_NAME_LENGTH + 1];
+                   /* Name of the sink */
+	t_Ui32 objects;
+                   /* Report types selected; bit mask by t_Object_Type */
+	t_Bool used;
+                   /* A sink of this name has been registered */
+} t_Sink_Selection;
+
+                   /* Local data: */
+                   /* ----------- */
+
+static t_Sink sinks[M_MAX_NUMBER_OF_SINKS];
+                   /* Registered sinks; in order of registration */
+static int sinks_registered;
+                   /* Number of registered sinks */
+static t_Ui32 batch_objects;
+                   /* Report types consumed by batch sinks */
+static std::vector<t_Adsb> kept_adsb;
+static std::vector<t_Mlat> kept_mlat;
+static std::vector<t_Rsrv> kept_rsrv;
+static std::vector<t_Rtgt> kept_rtgt;
+static std::vector<t_Strk> kept_strk;
+                   /* Copies of the reports for batch sinks; the decoder
+                      reuses its report buffers */
+static std::vector<t_Object_Type> kept_objects;
+                   /* Types of the kept reports, in order of decoding */
+static std::vector<size_t> kept_index;
+                   /* Index of each kept report into its copies */
+static size_t block_start;
+                   /* First kept report of the current data block */
+static std::vector<t_Object_Type> batch_objects_buffer;
+static std::vector<t_Pntr> batch_pntrs_buffer;
+                   /* Reports handed to a batch sink */
+static t_Sink_Selection selections[M_MAX_NUMBER_OF_SINKS];
+                   /* Report types selected per sink by option */
+static int selections_defined;
+                   /* Number of selections */
+
+                   /* Local functions: */
+                   /* ---------------- */
+
+static t_Retc add_sink (const char *name, t_Ui32 objects,
+                        t_Sink_Report report, t_Sink_Batch batch,
+                        t_Batch_Unit unit, t_Pntr context);
+                   /* Add a sink to the registry */
+static void deliver_batches (t_Batch_Unit unit, size_t first,
+                             t_Ui32 offset, t_Bool category_present,
+                             t_Byte category);
+                   /* Deliver kept reports to the batch sinks */
+static void drop_kept (void);
+                   /* Drop the kept reports */
+static t_Pntr kept_report (size_t ix);
+                   /* Get kept report */
+template <typename T>
+static void keep (std::vector<T>& copies, t_Object_Type object, t_Pntr pntr);
+                   /* Keep a copy of a report */
+
+                   /* Report type names (by t_Object_Type): */
+static const char *object_names[e_object_sentinel] =
+{
+	NULL, "adsb", "mlat", "rsrv", "rtgt", NULL, NULL, "strk"
+};
+
+/*----------------------------------------------------------------------------*/
+/* deliver_report  -- Deliver a decoded report to all sinks consuming it      */
+/*----------------------------------------------------------------------------*/
+
+ void deliver_report (t_Object_Type object, t_Pntr pntr)
+{
+	int ix;        /* Auxiliary */
+	t_Ui32 mask;   /* Bit of the report type */
+	t_Sink *sp;    /* Pointer to sink */
+
+	mask = (t_Ui32) 1 << object;
+
+	for (ix = 0; ix < sinks_registered; ix ++)
+	{
+		sp = &sinks[ix];
+
+		if ((sp->objects & mask) && sp->report != NULL)
+		{
+			sp->report (object, pntr, sp->context);
+
+			++ sp->reports;
+		}
+	}
+
+	if ((batch_objects & mask) == 0)
+	{
+		goto done;
+	}
+
+                   /* Keep a copy for the batch sinks: */
+	switch (object)
+	{
+	case e_object_adsb:
+		keep (kept_adsb, object, pntr);
+		break;
+	case e_object_mlat:
+		keep (kept_mlat, object, pntr);
+		break;
+	case e_object_rsrv:
+		keep (kept_rsrv, object, pntr);
+		break;
+	case e_object_rtgt:
+		keep (kept_rtgt, object, pntr);
+		break;
+	case e_object_strk:
+		keep (kept_strk, object, pntr);
+		break;
+	default:
+		goto done;
+	}
+
+                   /* Deliver early if the data block or frame is huge,
+                      or the reports are not from frames at all: */
+	if (kept_objects.size () >= M_MAX_BATCH_REPORTS)
+	{
+		deliver_batches (e_batch_data_block, block_start,
+                         input_offset, FALSE, 0);
+		deliver_batches (e_batch_frame, 0, input_offset, FALSE, 0);
+		drop_kept ();
+	}
+
+	done:          /* We are done */
+	return;
+}
+
+/*----------------------------------------------------------------------------*/
+/* end_data_block  -- Deliver the reports of a data block to batch sinks      */
+/*----------------------------------------------------------------------------*/
+
+ void end_data_block (t_Ui32 offset, t_Byte category)
+{
+	if (block_start < kept_objects.size ())
+	{
+		deliver_batches (e_batch_data_block, block_start,
+                         offset, TRUE, category);
+	}
+
+	block_start = kept_objects.size ();
+
+	return;
+}
+
+/*----------------------------------------------------------------------------*/
+/* end_frame       -- Deliver the reports of a frame to batch sinks           */
+/*----------------------------------------------------------------------------*/
+
+ void end_frame (t_Ui32 offset)
+{
+	if (kept_objects.size () > 0)
+	{
+		deliver_batches (e_batch_frame, 0, offset, FALSE, 0);
+	}
+
+	drop_kept ();
+
+	return;
+}
+
+/*----------------------------------------------------------------------------*/
+/* register_batch_sink -- Register a sink of batches of decoded reports       */
+/*----------------------------------------------------------------------------*/
+
+ t_Retc register_batch_sink (const char *name, t_Ui32 objects,
+                             t_Batch_Unit unit, t_Sink_Batch batch,
+                             t_Pntr context)
+{
+                   /* Check parameters: */
+	Assert (batch != NULL, "Invalid parameter");
+
+	return add_sink (name, objects, NULL, batch, unit, context);
+}
+
+/*----------------------------------------------------------------------------*/
+/* register_sink   -- Register a sink of decoded reports                      */
+/*----------------------------------------------------------------------------*/
+
+ t_Retc register_sink (const char *name, t_Ui32 objects,
+                       t_Sink_Report report, t_Pntr context)
+{
+                   /* Check parameters: */
+	Assert (report != NULL, "Invalid parameter");
+
+	return add_sink (name, objects, report, NULL, e_batch_data_block,
+                     context);
+}
+
+/*----------------------------------------------------------------------------*/
+/* select_sink_reports -- Select report types for a sink ("name:type,...")    */
+/*----------------------------------------------------------------------------*/
+
+ t_Retc select_sink_reports (char *text)
+{
+	char *cp;      /* Pointer to colon */
+	int ix;        /* Auxiliary */
+	size_t len;    /* Length of name */
+	t_Ui32 objects;
+                   /* Selected report types */
+	t_Retc ret;    /* Return code */
+	char *tp;      /* Pointer to type name */
+
+                   /* Preset the return code: */
+	ret = RC_FAIL;
+
+                   /* Check parameters: */
+	Assert (text != NULL, "Invalid parameter");
+
+	cp = strchr (text, ':');
+	if (cp == NULL || cp == text || cp[1] == '\0')
+	{
+		goto done;
+	}
+
+	len = cp - text;
+	if (len > M_MAX_SINK_NAME_LENGTH)
+	{
+		goto done;
+	}
+
+	if (selections_defined >= M_MAX_NUMBER_OF_SINKS)
+	{
+		goto done;
+	}
+
+	objects = 0;
+
+	tp = cp + 1;
+	while (*tp != '\0')
+	{
+		len = strcspn (tp, ",");
+
+		for (ix = 0; ix < e_object_sentinel; ix ++)
+		{
+			if (object_names[ix] != NULL &&
+                strlen (object_names[ix]) == len &&
+                strncmp (object_names[ix], tp, len) == 0)
+			{
+				break;
+			}
+		}
+
+		if (ix >= e_object_sentinel)
+		{
+			goto done;
+		}
+
+		objects |= (t_Ui32) 1 << ix;
+
+		tp += len;
+		if (*tp == ',')
+		{
+			++ tp;
+		}
+	}
+
+	memset (selections[selections_defined].name, 0, M_MAX_SINK_NAME_LENGTH + 1);
+	strncpy (selections[selections_defined].name, text, cp - text);
+	selections[selections_defined].objects = objects;
+	selections[selections_defined].used = FALSE;
+
+	++ selections_defined;
+
+                   /* Set the return code: */
+	ret = RC_OKAY;
+
+	done:          /* We are done */
+	return ret;
+}
+
+/*----------------------------------------------------------------------------*/
+/* sink_registered -- Check whether sinks with this context are registered    */
+/*----------------------------------------------------------------------------*/
+
+ t_Bool sink_registered (t_Pntr context)
+{
+	int ix;        /* Auxiliary */
+
+	for (ix = 0; ix < sinks_registered; ix ++)
+	{
+		if (sinks[ix].context == context)
+		{
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+/*----------------------------------------------------------------------------*/
+/* start_sinks     -- Check the registered sinks before the first report      */
+/*----------------------------------------------------------------------------*/
+
+ void start_sinks (void)
+{
+	int ix;        /* Auxiliary */
+	int jx;        /* Auxiliary */
+
+	for (ix = 0; ix < selections_defined; ix ++)
+	{
+		if (!selections[ix].used)
+		{
+			printf ("-> No sink '%s' (one of:", selections[ix].name);
+
+			for (jx = 0; jx < sinks_registered; jx ++)
+			{
+				printf (" %s", sinks[jx].name);
+			}
+
+			printf ("), report selection ignored\n");
+		}
+	}
+
+	return;
+}
+
+/*----------------------------------------------------------------------------*/
+/* term_sinks      -- Unregister all sinks                                    */
+/*----------------------------------------------------------------------------*/
+
+ void term_sinks (void)
+{
+	int ix;        /* Auxiliary */
+
+                   /* Reports not from frames, e. g. from a record store: */
+	if (kept_objects.size () > 0)
+	{
+		deliver_batches (e_batch_data_block, block_start,
+                         input_offset, FALSE, 0);
+		deliver_batches (e_batch_frame, 0, input_offset, FALSE, 0);
+		drop_kept ();
+	}
+
+                   /* Reports per sink differ only by selection: */
+	if (selections_defined > 0)
+	{
+		for (ix = 0; ix < sinks_registered; ix ++)
+		{
+			printf ("-> Sink '%s': " M_FMT_UI32 " report(s)\n",
+                    sinks[ix].name, sinks[ix].reports);
+		}
+	}
+
+	sinks_registered = 0;
+	batch_objects = 0;
+
+	return;
+}
+/*----------------------------------------------------------------------------*/
+/* unregister_sink -- Unregister the sinks with this context                  */
+/*----------------------------------------------------------------------------*/
+
+ t_Retc unregister_sink (t_Pntr context)
+{
+	int ix;        /* Auxiliary */
+	int jx;        /* Auxiliary */
+	t_Retc ret;    /* Return code */
+
+                   /* Preset the return code: */
+	ret = RC_FAIL;
+
+                   /* Keep the order of the others: */
+	jx = 0;
+	batch_objects = 0;
+	for (ix = 0; ix < sinks_registered; ix ++)
+	{
+		if (sinks[ix].context == context)
+		{
+			ret = RC_OKAY;
+			continue;
+		}
+
+		if (sinks[ix].batch != NULL)
+		{
+			batch_objects |= sinks[ix].objects;
+		}
+
+		if (jx != ix)
+		{
+			sinks[jx] = sinks[ix];
+		}
+		++ jx;
+	}
+	sinks_registered = jx;
+
+	return ret;
+}
+
+/*----------------------------------------------------------------------------*/
+/* add_sink        -- Add a sink to the registry                              */
+/*----------------------------------------------------------------------------*/
+
+static t_Retc add_sink (const char *name, t_Ui32 objects,
+                        t_Sink_Report report, t_Sink_Batch batch,
+                        t_Batch_Unit unit, t_Pntr context)
+{
+	int ix;        /* Auxiliary */
+	t_Retc ret;    /* Return code */
+	t_Sink *sp;    /* Pointer to sink */
+
+                   /* Preset the return code: */
+	ret = RC_FAIL;
+
+                   /* Check parameters: */
+	Assert (name != NULL, "Invalid parameter");
+
+	if (strlen (name) > M_MAX_SINK_NAME_LENGTH)
+	{
+		error_msg ("Sink name '%s' too long", name);
+		goto done;
+	}
+
+	if (sinks_registered >= M_MAX_NUMBER_OF_SINKS)
+	{
+		error_msg ("Too many sinks of decoded reports");
+		goto done;
+	}
+
+                   /* Restrict to the report types selected by option: */
+	for (ix = 0; ix < selections_defined; ix ++)
+	{
+		if (strcmp (selections[ix].name, name) == 0)
+		{
+			objects &= selections[ix].objects;
+			selections[ix].used = TRUE;
+		}
+	}
+
+	sp = &sinks[sinks_registered];
+
+	strcpy (sp->name, name);
+	sp->objects = objects;
+	sp->report = report;
+	sp->batch = batch;
+	sp->unit = unit;
+	sp->context = context;
+	sp->reports = 0;
+
+	++ sinks_registered;
+
+	if (batch != NULL)
+	{
+		batch_objects |= objects;
+	}
+
+                   /* Set the return code: */
+	ret = RC_OKAY;
+
+	done:          /* We are done */
+	return ret;
+}
+
+/*----------------------------------------------------------------------------*/
+/* deliver_batches -- Deliver kept reports to the batch sinks                 */
+/*----------------------------------------------------------------------------*/
+
+static void deliver_batches (t_Batch_Unit unit, size_t first,
+                             t_Ui32 offset, t_Bool category_present,
+                             t_Byte category)
+{
+	t_Report_Batch batch;
+                   /* Batch handed to the sinks */
+	size_t cnt;    /* Number of reports */
+	int ix;        /* Auxiliary */
+	size_t jx;     /* Auxiliary */
+	t_Ui32 mask;   /* Bit of a report type */
+	t_Sink *sp;    /* Pointer to sink */
+
+	cnt = kept_objects.size () - first;
+
+	batch.offset = offset;
+	batch.category_present = category_present;
+	batch.category = category;
+	batch.frame_time_present = frame_time_present;
+	batch.frame_time = frame_time;
+	batch.line_number_defined = current_line_number_defined;
+	batch.line_number = current_line_number;
+
+	for (ix = 0; ix < sinks_registered; ix ++)
+	{
+		sp = &sinks[ix];
+
+		if (sp->batch == NULL || sp->unit != unit)
+		{
+			continue;
+		}
+
+                   /* Only the report types the sink consumes: */
+		batch_objects_buffer.clear ();
+		batch_pntrs_buffer.clear ();
+		batch_objects_buffer.reserve (cnt);
+		batch_pntrs_buffer.reserve (cnt);
+
+		for (jx = first; jx < first + cnt; jx ++)
+		{
+			mask = (t_Ui32) 1 << kept_objects[jx];
+
+			if (sp->objects & mask)
+			{
+				batch_objects_buffer.push_back (kept_objects[jx]);
+				batch_pntrs_buffer.push_back (kept_report (jx));
+			}
+		}
+
+		if (batch_pntrs_buffer.empty ())
+		{
+			continue;
+		}
+
+		batch.count = (t_Ui32) batch_pntrs_buffer.size ();
+		batch.objects = batch_objects_buffer.data ();
+		batch.pntrs = batch_pntrs_buffer.data ();
+
+		sp->batch (&batch, sp->context);
+
+		sp->reports += batch.count;
+	}
+
+	return;
+}
+
+/*----------------------------------------------------------------------------*/
+/* drop_kept       -- Drop the kept reports                                   */
+/*----------------------------------------------------------------------------*/
+
+static void drop_kept (void)
+{
+                   /* The capacity is kept for the next frame: */
+	kept_adsb.clear ();
+	kept_mlat.clear ();
+	kept_rsrv.clear ();
+	kept_rtgt.clear ();
+	kept_strk.clear ();
+	kept_objects.clear ();
+	kept_index.clear ();
+
+	block_start = 0;
+
+	return;
+}
+
+/*----------------------------------------------------------------------------*/
+/* keep            -- Keep a copy of a report                                 */
+/*----------------------------------------------------------------------------*/
+
+template <typename T>
+static void keep (std::vector<T>& copies, t_Object_Type object, t_Pntr pntr)
+{
+	kept_index.push_back (copies.size ());
+	kept_objects.push_back (object);
+
+	copies.push_back (*static_cast<T *> (pntr));
+
+	return;
+}
+
+/*----------------------------------------------------------------------------*/
+/* kept_report     -- Get kept report                                         */
+/*----------------------------------------------------------------------------*/
+
+static t_Pntr kept_report (size_t ix)
+{
+	size_t kx;     /* Index into the copies */
+	t_Pntr pntr;   /* Pointer to report */
+
+	kx = kept_index[ix];
+
+	switch (kept_objects[ix])
+	{
+	case e_object_adsb:
+		pntr = &kept_adsb[kx];
+		break;
+	case e_object_mlat:
+		pntr = &kept_mlat[kx];
+		break;
+	case e_object_rsrv:
+		pntr = &kept_rsrv[kx];
+		break;
+	case e_object_rtgt:
+		pntr = &kept_rtgt[kx];
+		break;
+	case e_object_strk:
+		pntr = &kept_strk[kx];
+		break;
+	default:
+		pntr = NULL;
+		break;
+	}
+
+	return pntr;
+}
+/* end-of-file */
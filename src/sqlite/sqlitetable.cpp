@@ -0,0 +1,191 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sqlitetable.h"
+
+#include <cstdio>
+#include <cstring>
+
+SqliteBatch SqliteTable::takeBatch ()
+{
+    SqliteBatch batch;
+
+    std::swap (batch, batch_);
+    batch.table = this;
+
+    // the next batch will be about as large
+    batch_.values.reserve (batch.values.size());
+    batch_.text.reserve (batch.text.size());
+
+    return batch;
+}
+
+void SqliteTable::value (const char* name, bool present, const t_Date& date)
+{
+    SqliteValue& v = append (name, SQLCOL_TEXT);
+
+    v = {present, static_cast<int64_t> (batch_.text.size()), 0.0};
+
+    if (present)
+    {
+        char text[32];
+
+        snprintf (text, sizeof (text), "%04d-%02d-%02d", date.year, date.month, date.day);
+        batch_.text.append (text);
+    }
+    batch_.text.push_back ('\0');
+}
+
+void SqliteTable::value (const char* name, bool present, const char* text)
+{
+    SqliteValue& v = append (name, SQLCOL_TEXT);
+
+    v = {present, static_cast<int64_t> (batch_.text.size()), 0.0};
+
+    if (present)
+        batch_.text.append (text);
+    batch_.text.push_back ('\0');
+}
+
+void SqliteTable::time (const char* name, bool present, t_Secs secs)
+{
+    append (name, SQLCOL_REAL) = {present, 0, present ? secs : 0.0};
+}
+
+SqliteValue& SqliteTable::append (const char* name, SQLCOL_TYPE type)
+{
+    if (!schema_)
+        columns_.push_back ({name, type});
+    else
+    {
+        assert (column_ < columns_.size());
+        assert (columns_[column_].name == name && columns_[column_].type == type);
+    }
+
+    ++column_;
+
+    batch_.values.emplace_back();
+    return batch_.values.back();
+}
+
+bool SqliteTable::hasColumn (const char* name) const
+{
+    for (const Column& column : columns_)
+    {
+        if (column.name == name)
+            return true;
+    }
+
+    return false;
+}
+
+bool SqliteTable::create (sqlite3* db)
+{
+    static const char* types[] = {"INTEGER", "REAL", "TEXT"};
+
+    std::string sql = "CREATE TABLE " + name_ + " (";
+    std::string insert = "INSERT INTO " + name_ + " VALUES (";
+
+    for (size_t cnt = 0; cnt < columns_.size(); ++cnt)
+    {
+        sql += (cnt ? ", " : "") + columns_[cnt].name + " " + types[columns_[cnt].type];
+        insert += cnt ? ", ?" : "?";
+    }
+    sql += ")";
+    insert += ")";
+
+    if (sqlite3_exec (db, sql.c_str(), nullptr, nullptr, nullptr) != SQLITE_OK ||
+        sqlite3_prepare_v2 (db, insert.c_str(), -1, &insert_, nullptr) != SQLITE_OK)
+    {
+        printf ("-> SQLite: cannot create table '%s': %s\n", name_.c_str(), sqlite3_errmsg (db));
+        return false;
+    }
+
+    return true;
+}
+
+bool SqliteTable::insert (const SqliteBatch& batch)
+{
+    assert (insert_);
+    assert (batch.values.size() == batch.rows * columns_.size());
+
+    const SqliteValue* v = batch.values.data();
+
+    for (size_t row = 0; row < batch.rows; ++row)
+    {
+        for (size_t cnt = 0; cnt < columns_.size(); ++cnt, ++v)
+        {
+            int ix = static_cast<int> (cnt + 1);
+
+            if (!v->present)
+                sqlite3_bind_null (insert_, ix);
+            else if (columns_[cnt].type == SQLCOL_INTEGER)
+                sqlite3_bind_int64 (insert_, ix, v->integer);
+            else if (columns_[cnt].type == SQLCOL_REAL)
+                sqlite3_bind_double (insert_, ix, v->real);
+            else
+                sqlite3_bind_text (insert_, ix, batch.text.data() + v->integer, -1, SQLITE_STATIC);
+        }
+
+        if (sqlite3_step (insert_) != SQLITE_DONE)
+        {
+            printf ("-> SQLite: cannot insert into table '%s': %s\n",
+                    name_.c_str(), sqlite3_errmsg (sqlite3_db_handle (insert_)));
+            sqlite3_reset (insert_);
+            return false;
+        }
+        sqlite3_reset (insert_);
+    }
+
+    return true;
+}
+
+bool SqliteTable::createIndex (sqlite3* db, const char* suffix, const char* columns)
+{
+    std::string sql = "CREATE INDEX " + name_ + "_" + suffix + " ON " + name_ + " (" + columns + ")";
+
+    if (sqlite3_exec (db, sql.c_str(), nullptr, nullptr, nullptr) != SQLITE_OK)
+    {
+        printf ("-> SQLite: cannot create index on table '%s': %s\n", name_.c_str(), sqlite3_errmsg (db));
+        return false;
+    }
+
+    return true;
+}
+
+bool SqliteTable::createIndexes (sqlite3* db)
+{
+    if (!createIndex (db, "sac_sic_tod", "sac_sic, tod"))
+        return false;
+
+    // the Mode S address
+    if (hasColumn ("target_address") && !createIndex (db, "target_address", "target_address"))
+        return false;
+    if (hasColumn ("aircraft_address") && !createIndex (db, "aircraft_address", "aircraft_address"))
+        return false;
+
+    if (hasColumn ("track_number") && !createIndex (db, "track_number", "track_number"))
+        return false;
+
+    return true;
+}
+
+void SqliteTable::finalize ()
+{
+    sqlite3_finalize (insert_);
+    insert_ = nullptr;
+}
@@ -0,0 +1,157 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SQLITETABLE_H
+#define SQLITETABLE_H
+
+#include "global.h"
+#include "basics.h"
+
+#include "common.h"
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <sqlite3.h>
+
+typedef enum
+{
+    SQLCOL_INTEGER,
+    SQLCOL_REAL,
+    SQLCOL_TEXT
+} SQLCOL_TYPE;
+
+class SqliteTable;
+
+/*
+ * Rows of one table, collected by the decoding thread and inserted by the
+ * writer thread. Every row has one value per column of the table; the
+ * text of a SQLCOL_TEXT value is kept in text, NUL terminated, at the
+ * offset given by integer.
+ */
+
+struct SqliteValue
+{
+    bool present;
+    int64_t integer;
+    double real;
+};
+
+struct SqliteBatch
+{
+    SqliteTable* table {nullptr};
+    size_t rows {0};
+    std::vector<SqliteValue> values;
+    std::string text;
+};
+
+/*
+ * The reports of one type, written as a table of the SQLite database.
+ *
+ * The columns are "sac_sic" and "tod" (the data source and the time of
+ * day of the report itself, in seconds) followed by those visited by
+ * arrowColumns() in arrowcolumns.h: integers and flags as INTEGER,
+ * doubles and times of day as REAL, dates ('yyyy-mm-dd') and strings as
+ * TEXT. Absent values are NULL.
+ *
+ * add() and takeBatch() are called by the decoding thread, create(),
+ * insert(), createIndexes() and finalize() by the writer thread only.
+ */
+
+class SqliteTable
+{
+public:
+    explicit SqliteTable (const std::string& name) : name_ {name} {}
+
+    const std::string& name () const { return name_; }
+    size_t rows () const { return rows_; }
+
+    template <typename T>
+    void add (const T& record, bool sacsic_present, t_Ui16 sacsic, bool tod_present, t_Secs tod);
+
+    bool full (size_t batch_rows) const { return batch_.rows >= batch_rows; }
+    SqliteBatch takeBatch ();
+
+    // called by arrowColumns()
+    template <typename T>
+    void value (const char* name, bool present, T value);
+    void value (const char* name, bool present, const t_Date& date);
+    void value (const char* name, bool present, const char* text);
+    void time (const char* name, bool present, t_Secs secs);
+    void flag (const char* name, t_Bool flag) { value<int64_t> (name, true, flag != 0); }
+    void tres (const char* name, t_Tres tres) { value<int64_t> (name, tres != e_is_undefined, tres == e_is_true); }
+
+    // creates the table and prepares the insert statement
+    bool create (sqlite3* db);
+    bool created () const { return insert_ != nullptr; }
+    bool insert (const SqliteBatch& batch);
+    bool createIndexes (sqlite3* db);
+    void finalize ();
+
+private:
+    struct Column
+    {
+        std::string name;
+        SQLCOL_TYPE type;
+    };
+
+    std::string name_;
+
+    std::vector<Column> columns_;
+    size_t column_ {0};
+    bool schema_ {false};
+    size_t rows_ {0};
+
+    SqliteBatch batch_;
+
+    sqlite3_stmt* insert_ {nullptr};
+
+    SqliteValue& append (const char* name, SQLCOL_TYPE type);
+    bool hasColumn (const char* name) const;
+    bool createIndex (sqlite3* db, const char* suffix, const char* columns);
+};
+
+template <typename T>
+void SqliteTable::add (const T& record, bool sacsic_present, t_Ui16 sacsic, bool tod_present, t_Secs tod)
+{
+    column_ = 0;
+
+    value<int64_t> ("sac_sic", sacsic_present, sacsic);
+    time ("tod", tod_present, tod);
+    arrowColumns (*this, record);
+
+    schema_ = true;
+
+    ++batch_.rows;
+    ++rows_;
+}
+
+template <typename T>
+void SqliteTable::value (const char* name, bool present, T value)
+{
+    append (name, SQLCOL_INTEGER) = {present, present ? static_cast<int64_t> (value) : 0, 0.0};
+}
+
+template <>
+inline void SqliteTable::value<double> (const char* name, bool present, double value)
+{
+    append (name, SQLCOL_REAL) = {present, 0, present ? value : 0.0};
+}
+
+#endif // SQLITETABLE_H
@@ -0,0 +1,314 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sqlitewriter.h"
+#include "arrowcolumns.h"
+
+#include <cassert>
+#include <cstdio>
+
+// rows per batch handed to the writer thread
+const size_t SQLITE_BATCH_ROWS = 4096;
+// batches waiting for the writer thread at most, before the decoding blocks
+const size_t SQLITE_QUEUED_BATCHES = 64;
+// rows inserted per transaction
+const size_t SQLITE_TRANSACTION_ROWS = 1048576;
+
+SqliteWriter::SqliteWriter (const std::string& path)
+    : path_ {path}
+{
+    std::remove (path_.c_str());
+
+    if (sqlite3_open (path_.c_str(), &db_) != SQLITE_OK)
+    {
+        printf ("-> Cannot open SQLite database '%s': %s\n", path_.c_str(), sqlite3_errmsg (db_));
+        failed_ = true;
+    }
+    // a database being loaded is of no use after a crash, so no journal
+    // has to be synced; a larger page cache speeds up building the indexes
+    else if (!exec ("PRAGMA synchronous = OFF") ||
+             !exec ("PRAGMA journal_mode = MEMORY") ||
+             !exec ("PRAGMA cache_size = -262144"))
+        failed_ = true;
+
+    thread_ = std::thread (&SqliteWriter::writeBatches, this);
+}
+
+SqliteWriter::~SqliteWriter ()
+{
+    SqliteTable* tables[] = {adsb_.get(), mlat_.get(), rsrv_.get(), rtgt_.get(), strk_.get()};
+
+    // the last, partial batches
+    for (SqliteTable* table : tables)
+    {
+        if (table && table->full (1))
+            push (table->takeBatch());
+    }
+
+    {
+        std::lock_guard<std::mutex> lock (mutex_);
+        closing_ = true;
+    }
+    not_empty_.notify_one();
+    thread_.join();
+
+    if (!failed_ && exec ("BEGIN"))
+    {
+        bool ok = writeSensors();
+
+        for (SqliteTable* table : tables)
+        {
+            if (ok && table)
+                ok = table->createIndexes (db_);
+        }
+
+        exec ("COMMIT");
+    }
+
+    for (SqliteTable* table : tables)
+    {
+        if (table)
+            table->finalize();
+    }
+
+    sqlite3_close (db_);
+}
+
+void SqliteWriter::write (const t_Adsb *adsb_ptr)
+{
+    assert (adsb_ptr);
+
+    const t_Time_of_Day& tod = adsb_ptr->detection_time.present ? adsb_ptr->detection_time : adsb_ptr->time_of_report;
+
+    writeRecord (adsb_, *adsb_ptr, "adsb",
+                 adsb_ptr->data_source_identifier.present, adsb_ptr->data_source_identifier.value,
+                 tod.present, tod.value);
+}
+
+void SqliteWriter::write (const t_Mlat *mlat_ptr)
+{
+    assert (mlat_ptr);
+    writeRecord (mlat_, *mlat_ptr, "mlat",
+                 mlat_ptr->data_source_identifier.present, mlat_ptr->data_source_identifier.value,
+                 mlat_ptr->detection_time.present, mlat_ptr->detection_time.value);
+}
+
+void SqliteWriter::write (const t_Rsrv *rsrv_ptr)
+{
+    assert (rsrv_ptr);
+    writeRecord (rsrv_, *rsrv_ptr, "rsrv",
+                 rsrv_ptr->data_source_identifier.present, rsrv_ptr->data_source_identifier.value,
+                 rsrv_ptr->message_time.present, rsrv_ptr->message_time.value);
+}
+
+void SqliteWriter::write (const t_Rtgt *rtgt_ptr)
+{
+    assert (rtgt_ptr);
+    writeRecord (rtgt_, *rtgt_ptr, "rtgt",
+                 rtgt_ptr->data_source_identifier.present, rtgt_ptr->data_source_identifier.value,
+                 rtgt_ptr->detection_time.present, rtgt_ptr->detection_time.value);
+}
+
+void SqliteWriter::write (const t_Strk *strk_ptr)
+{
+    assert (strk_ptr);
+    writeRecord (strk_, *strk_ptr, "strk",
+                 strk_ptr->server_sacsic.present, strk_ptr->server_sacsic.value,
+                 strk_ptr->time_of_message.present, strk_ptr->time_of_message.value);
+}
+
+void SqliteWriter::printStatistics ()
+{
+    const std::unique_ptr<SqliteTable>* tables[] = {&adsb_, &mlat_, &rsrv_, &rtgt_, &strk_};
+
+    for (const std::unique_ptr<SqliteTable>* table : tables)
+    {
+        if (*table)
+            printf ("-> SQLite: %zu %s report(s) written\n", (*table)->rows(), (*table)->name().c_str());
+    }
+}
+
+template <typename T>
+void SqliteWriter::writeRecord (std::unique_ptr<SqliteTable>& table, const T& record, const char* type,
+                                bool sacsic_present, t_Ui16 sacsic, bool tod_present, t_Secs tod)
+{
+    if (!table)
+        table.reset (new SqliteTable (type));
+
+    table->add (record, sacsic_present, sacsic, tod_present, tod);
+
+    if (table->full (SQLITE_BATCH_ROWS))
+        push (table->takeBatch());
+}
+
+void SqliteWriter::push (SqliteBatch&& batch)
+{
+    {
+        std::unique_lock<std::mutex> lock (mutex_);
+
+        not_full_.wait (lock, [this] { return batches_.size() < SQLITE_QUEUED_BATCHES; });
+        batches_.push_back (std::move (batch));
+    }
+    not_empty_.notify_one();
+}
+
+void SqliteWriter::writeBatches ()
+{
+    if (!failed_ && !exec ("BEGIN"))
+        failed_ = true;
+
+    for (;;)
+    {
+        SqliteBatch batch;
+
+        {
+            std::unique_lock<std::mutex> lock (mutex_);
+
+            not_empty_.wait (lock, [this] { return !batches_.empty() || closing_; });
+            if (batches_.empty())
+                break;
+
+            batch = std::move (batches_.front());
+            batches_.pop_front();
+        }
+        not_full_.notify_one();
+
+        // after an error the remaining batches are only taken off the queue
+        if (failed_)
+            continue;
+
+        SqliteTable* table = batch.table;
+
+        if (!table->created() && !table->create (db_))
+        {
+            failed_ = true;
+            continue;
+        }
+
+        if (!table->insert (batch))
+        {
+            failed_ = true;
+            continue;
+        }
+
+        transaction_rows_ += batch.rows;
+        if (transaction_rows_ >= SQLITE_TRANSACTION_ROWS)
+        {
+            if (!exec ("COMMIT") || !exec ("BEGIN"))
+                failed_ = true;
+
+            transaction_rows_ = 0;
+        }
+    }
+
+    if (!failed_ && !exec ("COMMIT"))
+        failed_ = true;
+}
+
+bool SqliteWriter::exec (const char* sql)
+{
+    if (sqlite3_exec (db_, sql, nullptr, nullptr, nullptr) != SQLITE_OK)
+    {
+        printf ("-> SQLite: '%s' failed: %s\n", sql, sqlite3_errmsg (db_));
+        return false;
+    }
+
+    return true;
+}
+
+bool SqliteWriter::writeSensors ()
+{
+    const char* create =
+        "CREATE TABLE sensor (sac_sic INTEGER PRIMARY KEY, sac INTEGER, sic INTEGER,"
+        " sensor_number INTEGER, rsap INTEGER, name TEXT, line_number INTEGER,"
+        " asterix_categories TEXT, latitude_rad REAL, longitude_rad REAL, altitude_m REAL,"
+        " adsb_count INTEGER, mlat_count INTEGER, rsrv_count INTEGER, rtgt_count INTEGER)";
+    const char* insert = "INSERT INTO sensor VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)";
+
+    sqlite3_stmt* stmt = nullptr;
+    bool ok = exec (create);
+
+    if (ok && sqlite3_prepare_v2 (db_, insert, -1, &stmt, nullptr) != SQLITE_OK)
+    {
+        printf ("-> SQLite: cannot create table 'sensor': %s\n", sqlite3_errmsg (db_));
+        ok = false;
+    }
+
+    for (t_Ui16 ix = 0; ok && registered_sensor (ix) != NULL; ++ix)
+    {
+        const t_Sensor* sp = registered_sensor (ix);
+        std::string categories;
+
+        for (int cat = 0; cat < 256; ++cat)
+        {
+            if (sp->asterix_categories[cat])
+            {
+                char text[8];
+
+                snprintf (text, sizeof (text), "%s%03d", categories.empty() ? "" : " ", cat);
+                categories += text;
+            }
+        }
+
+        sqlite3_bind_int (stmt, 1, sp->data_source_identifier);
+        sqlite3_bind_int (stmt, 2, hi_byte (sp->data_source_identifier));
+        sqlite3_bind_int (stmt, 3, lo_byte (sp->data_source_identifier));
+        if (sp->sensor_number_defined)
+            sqlite3_bind_int (stmt, 4, sp->sensor_number);
+        else
+            sqlite3_bind_null (stmt, 4);
+        if (sp->rsap_defined)
+            sqlite3_bind_int (stmt, 5, sp->rsap);
+        else
+            sqlite3_bind_null (stmt, 5);
+        if (sp->name_defined)
+            sqlite3_bind_text (stmt, 6, sp->name, -1, SQLITE_STATIC);
+        else
+            sqlite3_bind_null (stmt, 6);
+        if (sp->line_number_defined)
+            sqlite3_bind_int (stmt, 7, sp->line_number);
+        else
+            sqlite3_bind_null (stmt, 7);
+        sqlite3_bind_text (stmt, 8, categories.c_str(), -1, SQLITE_STATIC);
+        if (sp->position.present)
+        {
+            sqlite3_bind_double (stmt, 9, sp->position.value_latitude);
+            sqlite3_bind_double (stmt, 10, sp->position.value_longitude);
+            sqlite3_bind_double (stmt, 11, sp->position.value_altitude);
+        }
+        else
+        {
+            sqlite3_bind_null (stmt, 9);
+            sqlite3_bind_null (stmt, 10);
+            sqlite3_bind_null (stmt, 11);
+        }
+        sqlite3_bind_int64 (stmt, 12, sp->adsb_count);
+        sqlite3_bind_int64 (stmt, 13, sp->mlat_count);
+        sqlite3_bind_int64 (stmt, 14, sp->rsrv_count);
+        sqlite3_bind_int64 (stmt, 15, sp->rtgt_count);
+
+        if (sqlite3_step (stmt) != SQLITE_DONE)
+        {
+            printf ("-> SQLite: cannot insert into table 'sensor': %s\n", sqlite3_errmsg (db_));
+            ok = false;
+        }
+        sqlite3_reset (stmt);
+    }
+
+    sqlite3_finalize (stmt);
+    return ok;
+}
@@ -0,0 +1,100 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SQLITEWRITER_H
+#define SQLITEWRITER_H
+
+#include "global.h"
+#include "basics.h"
+
+#include "common.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <sqlite3.h>
+
+#include "sqlitetable.h"
+
+/*
+ * Writes the decoded reports into a SQLite database for ad-hoc queries:
+ * one table per report type (adsb, mlat, rsrv, rtgt, strk), created once
+ * a report of its type arrives, and a table "sensor" of the sensor
+ * registry, written when the writer is deleted. An existing database of
+ * the same name is replaced.
+ *
+ * The decoding thread collects the rows in batches; a dedicated writer
+ * thread inserts them through one prepared statement per table, in
+ * transactions of SQLITE_TRANSACTION_ROWS rows. The indexes, on
+ * (sac_sic, tod), the Mode S address and the track number, are only built
+ * after the bulk load, when the writer is deleted.
+ */
+
+class SqliteWriter
+{
+public:
+    // the database is completed when the writer is deleted
+    explicit SqliteWriter (const std::string& path);
+    ~SqliteWriter ();
+
+    void write (const t_Adsb *adsb_ptr);
+    void write (const t_Mlat *mlat_ptr);
+    void write (const t_Rsrv *rsrv_ptr);
+    void write (const t_Rtgt *rtgt_ptr);
+    void write (const t_Strk *strk_ptr);
+
+    void printStatistics ();
+
+private:
+    std::string path_;
+    sqlite3* db_ {nullptr};
+
+    std::unique_ptr<SqliteTable> adsb_;
+    std::unique_ptr<SqliteTable> mlat_;
+    std::unique_ptr<SqliteTable> rsrv_;
+    std::unique_ptr<SqliteTable> rtgt_;
+    std::unique_ptr<SqliteTable> strk_;
+
+    // batches between the decoding and the writer thread
+    std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::deque<SqliteBatch> batches_;
+    bool closing_ {false};
+
+    std::thread thread_;
+    // only touched by the writer thread, until it has been joined
+    bool failed_ {false};
+    size_t transaction_rows_ {0};
+    size_t transactions_ {0};
+
+    template <typename T>
+    void writeRecord (std::unique_ptr<SqliteTable>& table, const T& record, const char* type,
+                      bool sacsic_present, t_Ui16 sacsic, bool tod_present, t_Secs tod);
+
+    void push (SqliteBatch&& batch);
+    void writeBatches ();
+
+    bool exec (const char* sql);
+    bool writeSensors ();
+};
+
+#endif // SQLITEWRITER_H
@@ -0,0 +1,914 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*----------------------------------------------------------------------------*/
+/* Project:        Surveillance Data Decoder and Lister                       */
+/* File:           store.cpp                                                  */
+/* Contents:       Record store of decoded reports (write and re-read)        */
+/* Author(s):      agent                                                      */
+/* Last change:    2026-10-18                                                 */
+/*----------------------------------------------------------------------------*/
+
+#include "basics.h"
+                   /* Basic system definitions */
+#include "common.h"
+                   /* Common declarations and definitions */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+
+/*
+ * The record store keeps decoded reports so they can be listed or
+ * exported again without decoding the ASTERIX data a second time.
+ *
+ * A report is stored as the image of its report structure, packed: a
+ * presence bitmask with one bit per 8-byte word of the structure, then
+ * the words whose bit is set (those not zero). The structures are
+ * cleared before decoding, so data items not present cost a bit each.
+ * Bytes held outside the structure (t_Data_Reference) follow the words.
+ *
+ *     file:     t_Store_Header, segments
+ *     segment:  t_Store_Segment, SAC/SIC list (t_Ui16, padded to 8 bytes),
+ *               records
+ *     record:   t_Ui32 length, t_Ui32 report type, bitmask, words,
+ *               referenced bytes
+ *
+ * Segments hold the records of all report types in the order they were
+ * decoded, so a re-read processes them in that order, and are only
+ * appended. Their header indexes the frame time range and the SAC/SIC
+ * values, so the reader (input format "-store") skips segments that
+ * cannot match -sacsic, -start_time or -stop_time without looking at
+ * their records.
+ * The reader maps the file and unpacks the records straight into the
+ * report buffers.
+ *
+ * As the structures are stored in their in-memory layout, a store can
+ * only be read by a build with the same layout; the header holds the
+ * structure sizes, and a store with other sizes is refused.
+ */
+
+                   /* Local macros: */
+                   /* ------------- */
+
+#define M_STORE_MAGIC "SDDLSTO1"
+                   /* Magic of a record store file (8 bytes) */
+#define M_STORE_MAX_SACSIC 64
+                   /* SAC/SIC values indexed per segment */
+#define M_STORE_SEGMENT_MAGIC 0x32474553
+                   /* Magic of a segment ("SEG2") */
+#define M_STORE_SEGMENT_RECORDS 4096
+                   /* Records per segment at most */
+#define M_STORE_SEGMENT_SIZE (1024 * 1024)
+                   /* Bytes of records per segment (about) */
+#define M_STORE_SACSIC_COMPLETE 0x0001
+                   /* Segment flag: all SAC/SIC values are listed */
+#define M_STORE_TIMES_PRESENT 0x0002
+                   /* Segment flag: frame time range is valid */
+#define M_STORE_TYPES 5
+                   /* Number of report types */
+#define M_STORE_VERSION 2
+                   /* Version of the record store format */
+#define M_STORE_WORD 8
+                   /* Size of a word in the presence bitmask; bytes */
+
+                   /* Local data types: */
+                   /* ----------------- */
+
+typedef struct
+{
+	char magic[8];
+                   /* M_STORE_MAGIC */
+	t_Ui32 version;
+                   /* M_STORE_VERSION */
+	t_Ui32 sizes[M_STORE_TYPES];
+                   /* Sizes of the report structures; bytes */
+	t_Ui32 reserved[2];
+                   /* Zero */
+} t_Store_Header;
+
+typedef struct
+{
+	t_Ui32 magic;
+                   /* M_STORE_SEGMENT_MAGIC */
+	t_Ui32 records;
+                   /* Number of records */
+	t_Ui32 sacsic_count;
+                   /* Number of SAC/SIC values listed */
+	t_Ui32 flags;
+                   /* M_STORE_SACSIC_COMPLETE, M_STORE_TIMES_PRESENT */
+	t_Ui64 length;
+                   /* Bytes following this header */
+	t_Secs first_tod;
+                   /* Lowest frame time; seconds */
+	t_Secs last_tod;
+                   /* Highest frame time; seconds */
+} t_Store_Segment;
+
+typedef struct
+{
+	t_Object_Type object;
+                   /* Report type */
+	const char *name;
+                   /* Name of the report type */
+	size_t size;
+                   /* Size of the report structure; bytes */
+} t_Store_Type;
+
+typedef struct
+{
+	std::string data;
+                   /* Records collected */
+	t_Ui32 records;
+                   /* Number of records collected */
+	t_Ui16 sacsic[M_STORE_MAX_SACSIC];
+                   /* SAC/SIC values of the records */
+	t_Ui32 sacsic_count;
+                   /* Number of SAC/SIC values */
+	t_Bool sacsic_overflow;
+                   /* More SAC/SIC values than listed */
+	t_Bool times_present;
+                   /* Frame time range valid */
+	t_Secs first_tod;
+                   /* Lowest frame time; seconds */
+	t_Secs last_tod;
+                   /* Highest frame time; seconds */
+} t_Store_Buffer;
+
+                   /* Local data: */
+                   /* ----------- */
+
+static const t_Store_Type store_types[M_STORE_TYPES] =
+{
+	{ e_object_adsb, "adsb", sizeof (t_Adsb) },
+	{ e_object_mlat, "mlat", sizeof (t_Mlat) },
+	{ e_object_rsrv, "rsrv", sizeof (t_Rsrv) },
+	{ e_object_rtgt, "rtgt", sizeof (t_Rtgt) },
+	{ e_object_strk, "strk", sizeof (t_Strk) }
+};
+                   /* Report types in the store */
+static t_Store_Buffer store_buffer;
+                   /* Segment being collected */
+static FILE *store_file = NULL;
+                   /* Record store being written */
+static t_Ui32 store_records[M_STORE_TYPES];
+                   /* Number of records written, per report type */
+static t_Ui32 store_segments;
+                   /* Number of segments written */
+
+                   /* Local functions: */
+                   /* ---------------- */
+
+static void report_index (int type, const t_Byte *image, t_Bool *sacsic_present,
+                          t_Ui16 *sacsic, t_Bool *tod_present, t_Secs *tod);
+                   /* Get the index values of a report */
+static t_Data_Reference *rsrv_references (t_Rsrv *rsrv_ptr, int ix);
+                   /* Get a data reference of a radar service message */
+static int store_type (t_Object_Type object);
+                   /* Get the report type index of an object */
+static t_Bool wanted_record (int type, const t_Byte *image);
+                   /* Check the report against the selection */
+static t_Bool wanted_segment (const t_Store_Segment *seg_ptr, const t_Ui16 *sacsic_ptr);
+                   /* Check the segment index against the selection */
+static void write_segment (void);
+                   /* Write the segment collected */
+
+/*----------------------------------------------------------------------------*/
+/* close_store_file -- Write the remaining segments and close the store       */
+/*----------------------------------------------------------------------------*/
+
+ void close_store_file (void)
+{
+	int ix;        /* Auxiliary */
+
+	if (store_file == NULL)
+	{
+		return;
+	}
+
+	write_segment ();
+
+	for (ix = 0; ix < M_STORE_TYPES; ix ++)
+	{
+		if (store_records[ix] > 0)
+		{
+			printf ("-> Store: " M_FMT_UI32 " %s record(s)\n",
+                    store_records[ix], store_types[ix].name);
+		}
+	}
+	printf ("-> Store: " M_FMT_UI32 " segment(s)\n", store_segments);
+
+	store_buffer.data.clear ();
+	store_buffer.data.shrink_to_fit ();
+
+	fclose (store_file);
+	store_file = NULL;
+
+	return;
+}
+
+/*----------------------------------------------------------------------------*/
+/* open_store_file -- Create the record store and write its header            */
+/*----------------------------------------------------------------------------*/
+
+ t_Retc open_store_file (void)
+{
+	t_Store_Header header;
+                   /* File header */
+	int ix;        /* Auxiliary */
+	t_Retc ret;    /* Return code */
+
+				   /* Preset the return code: */
+	ret = RC_FAIL;
+
+	Assert (store_file == NULL, "Record store already open");
+	Assert (store_path.size () > 0, "No path name for record store");
+
+	store_file = fopen (store_path.c_str (), "wb");
+	if (store_file == NULL)
+	{
+		error_msg ("Cannot open record store '%s'", store_path.c_str ());
+		goto done;
+	}
+
+	memset (&header, 0, sizeof (header));
+	memcpy (header.magic, M_STORE_MAGIC, sizeof (header.magic));
+	header.version = M_STORE_VERSION;
+	for (ix = 0; ix < M_STORE_TYPES; ix ++)
+	{
+		header.sizes[ix] = (t_Ui32) store_types[ix].size;
+		store_records[ix] = 0;
+	}
+
+	store_buffer.data.clear ();
+	store_buffer.records = 0;
+	store_buffer.sacsic_count = 0;
+	store_buffer.sacsic_overflow = FALSE;
+	store_buffer.times_present = FALSE;
+	store_segments = 0;
+
+	fwrite (&header, sizeof (header), 1, store_file);
+
+	printf ("-> Record store '%s' opened ...\n", store_path.c_str ());
+
+				   /* Set the return code: */
+	ret = RC_OKAY;
+
+	done:          /* We are done */
+	return ret;
+}
+
+/*----------------------------------------------------------------------------*/
+/* report_index    -- Get the index values of a report                        */
+/*----------------------------------------------------------------------------*/
+
+ static
+ void report_index (int type, const t_Byte *image, t_Bool *sacsic_present,
+                    t_Ui16 *sacsic, t_Bool *tod_present, t_Secs *tod)
+{
+	const t_Data_Source_Identifier *dsi_ptr;
+                   /* Data source identifier */
+	const t_Frame_Time *ftm_ptr;
+                   /* Frame time */
+
+	switch (store_types[type].object)
+	{
+	case e_object_adsb:
+		dsi_ptr = &((const t_Adsb *) image)->data_source_identifier;
+		ftm_ptr = &((const t_Adsb *) image)->frame_time;
+		break;
+	case e_object_mlat:
+		dsi_ptr = &((const t_Mlat *) image)->data_source_identifier;
+		ftm_ptr = &((const t_Mlat *) image)->frame_time;
+		break;
+	case e_object_rsrv:
+		dsi_ptr = &((const t_Rsrv *) image)->data_source_identifier;
+		ftm_ptr = &((const t_Rsrv *) image)->frame_time;
+		break;
+	case e_object_rtgt:
+		dsi_ptr = &((const t_Rtgt *) image)->data_source_identifier;
+		ftm_ptr = &((const t_Rtgt *) image)->frame_time;
+		break;
+	default:
+		dsi_ptr = &((const t_Strk *) image)->server_sacsic;
+		ftm_ptr = &((const t_Strk *) image)->frame_time;
+		break;
+	}
+
+	*sacsic_present = dsi_ptr->present;
+	*sacsic = dsi_ptr->value;
+	*tod_present = ftm_ptr->present;
+	*tod = ftm_ptr->value;
+
+	return;
+}
+
+/*----------------------------------------------------------------------------*/
+/* rsrv_references -- Get a data reference of a radar service message         */
+/*----------------------------------------------------------------------------*/
+
+ static
+ t_Data_Reference *rsrv_references (t_Rsrv *rsrv_ptr, int ix)
+{
+	switch (ix)
+	{
+	case 0:
+		return &rsrv_ptr->station_configuration_status;
+	case 1:
+		return &rsrv_ptr->station_processing_mode;
+	case 2:
+		return &rsrv_ptr->warning_error_conditions;
+	default:
+		return NULL;
+	}
+}
+
+/*----------------------------------------------------------------------------*/
+/* store_input     -- Read and process a record store                         */
+/*----------------------------------------------------------------------------*/
+
+ t_Retc store_input (void)
+{
+	const t_Byte *base;
+                   /* Mapped input file */
+	t_Ui32 count;  /* Number of records processed */
+	int fd;        /* File descriptor of input file */
+	t_Store_Header header;
+                   /* File header */
+	static t_Byte *images[M_STORE_TYPES] =
+	{
+		(t_Byte *) &adsb, (t_Byte *) &mlat, (t_Byte *) &rsrv,
+		(t_Byte *) &rtgt, (t_Byte *) &strk
+	};
+                   /* Report buffers, per report type */
+	int ix;        /* Auxiliary */
+	size_t pos;    /* Position in input file */
+	size_t rec_pos;
+                   /* Position of current record in input file */
+	t_Retc ret;    /* Return code */
+	t_Store_Segment seg;
+                   /* Segment header */
+	t_Ui32 skipped;
+                   /* Number of segments skipped */
+	struct stat st;
+                   /* Status of input file */
+
+				   /* Preset the return code: */
+	ret = RC_FAIL;
+
+	Assert (input_file != NULL, "Input file not available");
+
+	fd = fileno (input_file);
+	if (fstat (fd, &st) != 0 || (size_t) st.st_size < sizeof (header))
+	{
+		error_msg ("Input file '%s' is no record store", input_path);
+		goto done;
+	}
+
+	base = (const t_Byte *) mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (base == (const t_Byte *) MAP_FAILED)
+	{
+		error_msg ("Cannot map input file '%s'", input_path);
+		goto done;
+	}
+	madvise ((void *) base, st.st_size, MADV_SEQUENTIAL);
+
+	memcpy (&header, base, sizeof (header));
+	if (memcmp (header.magic, M_STORE_MAGIC, sizeof (header.magic)) != 0 ||
+        header.version != M_STORE_VERSION)
+	{
+		error_msg ("Input file '%s' is no record store", input_path);
+		goto unmap;
+	}
+	for (ix = 0; ix < M_STORE_TYPES; ix ++)
+	{
+		if (header.sizes[ix] != store_types[ix].size)
+		{
+			error_msg ("Record store '%s' was written with other %s report"
+                       " structures", input_path, store_types[ix].name);
+			goto unmap;
+		}
+	}
+
+	count = 0;
+	skipped = 0;
+	pos = sizeof (header);
+	while (pos + sizeof (seg) <= (size_t) st.st_size)
+	{
+		const t_Byte *end;
+                   /* End of segment */
+		const t_Byte *rp;
+                   /* Current record */
+		t_Ui32 rec;
+                   /* Record number in segment */
+		size_t sacsic_size;
+                   /* Size of SAC/SIC list; bytes */
+
+		memcpy (&seg, base + pos, sizeof (seg));
+		sacsic_size = (2 * seg.sacsic_count + 7) / 8 * 8;
+		if (seg.magic != M_STORE_SEGMENT_MAGIC ||
+            seg.sacsic_count > M_STORE_MAX_SACSIC ||
+            seg.length > (t_Ui64) st.st_size - pos - sizeof (seg) ||
+            sacsic_size > seg.length)
+		{
+			error_msg ("Corrupt record store segment at offset %zu", pos);
+			goto unmap;
+		}
+
+		rp = base + pos + sizeof (seg);
+		end = rp + seg.length;
+
+		pos += sizeof (seg) + seg.length;
+                   /* The offsets are 32 bits wide; a store larger than
+                      that shows the last offset that fits: */
+		input_length = (t_Ui32) (pos < 0xffffffff ? pos : 0xffffffff);
+		input_offset = input_length;
+
+		{
+			t_Ui16 sacsic[M_STORE_MAX_SACSIC];
+
+			memcpy (sacsic, rp, 2 * seg.sacsic_count);
+			if (!wanted_segment (&seg, sacsic))
+			{
+				++ skipped;
+				continue;
+			}
+		}
+
+#if LISTER
+		check_list_rotation ();
+#endif /* LISTER */
+
+		rp += sacsic_size;
+		for (rec = 0; rec < seg.records; rec ++)
+		{
+			const t_Byte *bp;
+                   /* Presence bitmask */
+			t_Byte *image;
+                   /* Report buffer */
+			t_Ui32 length;
+                   /* Length of record; bytes */
+			size_t size;
+                   /* Size of report structure; bytes */
+			t_Ui32 type;
+                   /* Report type (index into store_types) */
+			size_t word;
+                   /* Word in report structure */
+			size_t words;
+                   /* Words in report structure */
+			const t_Byte *wp;
+                   /* Current word in record */
+			const t_Byte *xp;
+                   /* End of record */
+
+                   /* Everything read must lie within the record, and
+                      the record within the segment: */
+			rec_pos = (size_t) (rp - base);
+			if ((size_t) (end - rp) < sizeof (length) + sizeof (type))
+			{
+				goto corrupt;
+			}
+
+			memcpy (&length, rp, sizeof (length));
+			memcpy (&type, rp + sizeof (length), sizeof (type));
+			if (type >= M_STORE_TYPES)
+			{
+				goto corrupt;
+			}
+
+			size = store_types[type].size;
+			words = (size + M_STORE_WORD - 1) / M_STORE_WORD;
+			image = images[type];
+
+			if (length < sizeof (length) + sizeof (type) + (words + 7) / 8 ||
+                length > (size_t) (end - rp))
+			{
+				goto corrupt;
+			}
+			xp = rp + length;
+
+                   /* Unpack the words present: */
+			memset (image, 0, size);
+			bp = rp + sizeof (length) + sizeof (type);
+			wp = bp + (words + 7) / 8;
+			for (word = 0; word < words; word ++)
+			{
+				if (bp[word / 8] & (1 << (word % 8)))
+				{
+					size_t n = size - word * M_STORE_WORD;
+
+					if ((size_t) (xp - wp) < M_STORE_WORD)
+					{
+						goto corrupt;
+					}
+
+					memcpy (image + word * M_STORE_WORD, wp,
+                            n < M_STORE_WORD ? n : M_STORE_WORD);
+					wp += M_STORE_WORD;
+				}
+			}
+
+                   /* Point data references to their bytes: */
+			if (store_types[type].object == e_object_rsrv)
+			{
+				t_Data_Reference *ref_ptr;
+
+				for (ix = 0; (ref_ptr = rsrv_references ((t_Rsrv *) image, ix)) != NULL; ix ++)
+				{
+					if (ref_ptr->length > 2)
+					{
+						if ((size_t) ref_ptr->length > (size_t) (xp - wp))
+						{
+							goto corrupt;
+						}
+
+						ref_ptr->data_ptr = (t_Byte *) wp;
+						wp += ref_ptr->length;
+					}
+				}
+			}
+
+			rp += length;
+
+			if (!wanted_record ((int) type, image))
+			{
+				continue;
+			}
+
+			switch (store_types[type].object)
+			{
+			case e_object_adsb:
+				process_adsb ((t_Adsb *) image);
+				break;
+			case e_object_mlat:
+				process_mlat ((t_Mlat *) image);
+				break;
+			case e_object_rsrv:
+				process_rsrv ((t_Rsrv *) image);
+				break;
+			case e_object_rtgt:
+				process_rtgt ((t_Rtgt *) image);
+				break;
+			default:
+				process_strk ((t_Strk *) image);
+				break;
+			}
+
+			++ count;
+		}
+	}
+
+	printf ("-> " M_FMT_UI32 " record(s) read from record store, " M_FMT_UI32
+            " segment(s) skipped\n", count, skipped);
+
+				   /* Set the return code: */
+	ret = RC_OKAY;
+	goto unmap;
+
+	corrupt:       /* Record not within its bounds */
+	error_msg ("Corrupt record store record at offset %zu", rec_pos);
+
+	unmap:         /* Unmap the input file */
+	munmap ((void *) base, st.st_size);
+
+	done:          /* We are done */
+	return ret;
+}
+
+/*----------------------------------------------------------------------------*/
+/* store_report    -- Append a decoded report to the record store             */
+/*----------------------------------------------------------------------------*/
+
+ void store_report (t_Object_Type object, t_Pntr pntr)
+{
+	t_Store_Buffer *buf_ptr;
+                   /* Segment being collected */
+	t_Rsrv copy;   /* Radar service message without pointers */
+	const t_Byte *image;
+                   /* Report structure */
+	size_t mask;   /* Offset of the presence bitmask in data */
+	size_t size;   /* Size of report structure; bytes */
+	size_t start;  /* Offset of the record in data */
+	t_Bool sacsic_present;
+	t_Ui16 sacsic;
+	t_Bool tod_present;
+	t_Secs tod;
+	t_Ui32 length; /* Length of record; bytes */
+	int type;      /* Report type */
+	t_Ui32 type32; /* Report type as stored */
+	size_t word;   /* Word in report structure */
+	size_t words;  /* Words in report structure */
+
+	if (store_file == NULL)
+	{
+		return;
+	}
+
+	Assert (pntr != NULL, "Invalid parameter");
+
+	type = store_type (object);
+	if (type < 0)
+	{
+		return;
+	}
+
+	buf_ptr = &store_buffer;
+	type32 = (t_Ui32) type;
+	image = (const t_Byte *) pntr;
+	size = store_types[type].size;
+	words = (size + M_STORE_WORD - 1) / M_STORE_WORD;
+
+                   /* Pointers are meaningless in the store: */
+	if (object == e_object_rsrv)
+	{
+		t_Data_Reference *ref_ptr;
+		int ix;
+
+		memcpy (&copy, pntr, sizeof (copy));
+		for (ix = 0; (ref_ptr = rsrv_references (&copy, ix)) != NULL; ix ++)
+		{
+			ref_ptr->data_ptr = NULL;
+		}
+
+		image = (const t_Byte *) &copy;
+	}
+
+                   /* Length, report type, presence bitmask and the words
+                      present: */
+	start = buf_ptr->data.size ();
+	buf_ptr->data.append (sizeof (length), '\0');
+	buf_ptr->data.append ((const char *) &type32, sizeof (type32));
+	mask = buf_ptr->data.size ();
+	buf_ptr->data.append ((words + 7) / 8, '\0');
+
+	for (word = 0; word < words; word ++)
+	{
+		t_Byte w[M_STORE_WORD];
+		size_t n = size - word * M_STORE_WORD;
+
+		memset (w, 0, sizeof (w));
+		memcpy (w, image + word * M_STORE_WORD, n < M_STORE_WORD ? n : M_STORE_WORD);
+
+		if (memcmp (w, "\0\0\0\0\0\0\0\0", M_STORE_WORD) != 0)
+		{
+			buf_ptr->data[mask + word / 8] |= (char) (1 << (word % 8));
+			buf_ptr->data.append ((const char *) w, M_STORE_WORD);
+		}
+	}
+
+                   /* Bytes held outside the report structure: */
+	if (object == e_object_rsrv)
+	{
+		t_Data_Reference *ref_ptr;
+		int ix;
+
+		for (ix = 0; (ref_ptr = rsrv_references ((t_Rsrv *) pntr, ix)) != NULL; ix ++)
+		{
+			if (ref_ptr->length > 2)
+			{
+				Assert (ref_ptr->data_ptr != NULL, "Invalid data reference");
+
+				buf_ptr->data.append ((const char *) ref_ptr->data_ptr, ref_ptr->length);
+			}
+		}
+	}
+
+	length = (t_Ui32) (buf_ptr->data.size () - start);
+	memcpy (&buf_ptr->data[start], &length, sizeof (length));
+
+                   /* Update the segment index: */
+	report_index (type, image, &sacsic_present, &sacsic, &tod_present, &tod);
+
+	if (sacsic_present && !buf_ptr->sacsic_overflow)
+	{
+		t_Ui32 ix;
+
+		for (ix = 0; ix < buf_ptr->sacsic_count; ix ++)
+		{
+			if (buf_ptr->sacsic[ix] == sacsic)
+			{
+				break;
+			}
+		}
+
+		if (ix == buf_ptr->sacsic_count)
+		{
+			if (buf_ptr->sacsic_count < M_STORE_MAX_SACSIC)
+			{
+				buf_ptr->sacsic[buf_ptr->sacsic_count ++] = sacsic;
+			}
+			else
+			{
+				buf_ptr->sacsic_overflow = TRUE;
+			}
+		}
+	}
+
+	if (tod_present)
+	{
+		if (!buf_ptr->times_present)
+		{
+			buf_ptr->first_tod = tod;
+			buf_ptr->last_tod = tod;
+			buf_ptr->times_present = TRUE;
+		}
+		else if (tod < buf_ptr->first_tod)
+		{
+			buf_ptr->first_tod = tod;
+		}
+		else if (tod > buf_ptr->last_tod)
+		{
+			buf_ptr->last_tod = tod;
+		}
+	}
+
+	++ buf_ptr->records;
+	++ store_records[type];
+
+	if (buf_ptr->records >= M_STORE_SEGMENT_RECORDS ||
+        buf_ptr->data.size () >= M_STORE_SEGMENT_SIZE)
+	{
+		write_segment ();
+	}
+
+	return;
+}
+
+/*----------------------------------------------------------------------------*/
+/* store_type      -- Get the report type index of an object                  */
+/*----------------------------------------------------------------------------*/
+
+ static
+ int store_type (t_Object_Type object)
+{
+	int ix;        /* Auxiliary */
+
+	for (ix = 0; ix < M_STORE_TYPES; ix ++)
+	{
+		if (store_types[ix].object == object)
+		{
+			return ix;
+		}
+	}
+
+	return -1;
+}
+
+/*----------------------------------------------------------------------------*/
+/* wanted_record   -- Check the report against the selection                  */
+/*----------------------------------------------------------------------------*/
+
+ static
+ t_Bool wanted_record (int type, const t_Byte *image)
+{
+	t_Bool sacsic_present;
+	t_Ui16 sacsic;
+	t_Bool tod_present;
+	t_Secs tod;
+
+	report_index (type, image, &sacsic_present, &sacsic, &tod_present, &tod);
+
+	if (wanted_sacsic_defined && (!sacsic_present || sacsic != wanted_sacsic))
+	{
+		return FALSE;
+	}
+
+	if (wanted_start_time_defined && (!tod_present || tod < wanted_start_time))
+	{
+		return FALSE;
+	}
+
+	if (wanted_stop_time_defined && (!tod_present || tod > wanted_stop_time))
+	{
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/*----------------------------------------------------------------------------*/
+/* wanted_segment  -- Check the segment index against the selection           */
+/*----------------------------------------------------------------------------*/
+
+ static
+ t_Bool wanted_segment (const t_Store_Segment *seg_ptr, const t_Ui16 *sacsic_ptr)
+{
+	t_Ui32 ix;     /* Auxiliary */
+
+	if (wanted_sacsic_defined && (seg_ptr->flags & M_STORE_SACSIC_COMPLETE))
+	{
+		for (ix = 0; ix < seg_ptr->sacsic_count; ix ++)
+		{
+			if (sacsic_ptr[ix] == wanted_sacsic)
+			{
+				break;
+			}
+		}
+
+		if (ix == seg_ptr->sacsic_count)
+		{
+			return FALSE;
+		}
+	}
+
+	if (wanted_start_time_defined || wanted_stop_time_defined)
+	{
+		if (!(seg_ptr->flags & M_STORE_TIMES_PRESENT))
+		{
+			return FALSE;
+		}
+
+		if (wanted_start_time_defined && seg_ptr->last_tod < wanted_start_time)
+		{
+			return FALSE;
+		}
+
+		if (wanted_stop_time_defined && seg_ptr->first_tod > wanted_stop_time)
+		{
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+/*----------------------------------------------------------------------------*/
+/* write_segment   -- Write the segment collected                             */
+/*----------------------------------------------------------------------------*/
+
+ static
+ void write_segment (void)
+{
+	t_Store_Buffer *buf_ptr;
+                   /* Segment being collected */
+	t_Store_Segment seg;
+                   /* Segment header */
+	t_Ui16 sacsic[M_STORE_MAX_SACSIC + 3];
+                   /* SAC/SIC list, padded */
+	size_t sacsic_size;
+                   /* Size of SAC/SIC list; bytes */
+
+	Assert (store_file != NULL, "Record store not open");
+
+	buf_ptr = &store_buffer;
+	if (buf_ptr->records == 0)
+	{
+		return;
+	}
+
+	sacsic_size = (2 * buf_ptr->sacsic_count + 7) / 8 * 8;
+	memset (sacsic, 0, sizeof (sacsic));
+	memcpy (sacsic, buf_ptr->sacsic, 2 * buf_ptr->sacsic_count);
+
+	memset (&seg, 0, sizeof (seg));
+	seg.magic = M_STORE_SEGMENT_MAGIC;
+	seg.records = buf_ptr->records;
+	seg.sacsic_count = buf_ptr->sacsic_count;
+	seg.length = sacsic_size + buf_ptr->data.size ();
+	if (!buf_ptr->sacsic_overflow)
+	{
+		seg.flags |= M_STORE_SACSIC_COMPLETE;
+	}
+	if (buf_ptr->times_present)
+	{
+		seg.first_tod = buf_ptr->first_tod;
+		seg.last_tod = buf_ptr->last_tod;
+		seg.flags |= M_STORE_TIMES_PRESENT;
+	}
+
+	fwrite (&seg, sizeof (seg), 1, store_file);
+	fwrite (sacsic, sacsic_size, 1, store_file);
+	fwrite (buf_ptr->data.data (), buf_ptr->data.size (), 1, store_file);
+
+	++ store_segments;
+
+	buf_ptr->data.clear ();
+	buf_ptr->records = 0;
+	buf_ptr->sacsic_count = 0;
+	buf_ptr->sacsic_overflow = FALSE;
+	buf_ptr->times_present = FALSE;
+
+	return;
+}
+/* end-of-file */
@@ -27,6 +27,8 @@
                    /* Basic system definitions */
 #include "common.h"
                    /* Common declarations and definitions */
+#include "astx_items.h"
+                   /* Values of ASTERIX data items */
 
 #include <ctype.h>
 #include <limits.h>
@@ -45,10 +47,128 @@
                    /* ----------- */
 
                    /* Special tables for mc_to_alt(): */
-static t_Si16 gg_table[8] = { 0, 7, 3, 4, 1, 6, 2, 5 };
-static t_Si16 gz_table[8] = { 7, 0, 4, 3, 6, 1, 5, 2 };
-static t_Si16 pg_table[8] = { M_UTL_NVA, 4, 2, 3, 0, M_UTL_NVA, 1, M_UTL_NVA };
-static t_Si16 pz_table[8] = { M_UTL_NVA, 0, 2, 1, 4, M_UTL_NVA, 3, M_UTL_NVA };
+static constexpr t_Si16 gg_table[8] = { 0, 7, 3, 4, 1, 6, 2, 5 };
+static constexpr t_Si16 gz_table[8] = { 7, 0, 4, 3, 6, 1, 5, 2 };
+static constexpr t_Si16 pg_table[8] =
+	{ M_UTL_NVA, 4, 2, 3, 0, M_UTL_NVA, 1, M_UTL_NVA };
+static constexpr t_Si16 pz_table[8] =
+	{ M_UTL_NVA, 0, 2, 1, 4, M_UTL_NVA, 3, M_UTL_NVA };
+
+                   /* Compile-time generation of the SSR code tables: */
+                   /* ---------------------------------------------- */
+
+                   /* Sequence of table indices 0 .. N-1, built with
+                      logarithmic template depth (C++11 has no
+                      std::make_index_sequence) */
+template <t_Ui16... I> struct t_Idx_Seq { };
+
+template <typename S1, typename S2> struct t_Idx_Cat;
+
+template <t_Ui16... I1, t_Ui16... I2>
+struct t_Idx_Cat<t_Idx_Seq<I1...>, t_Idx_Seq<I2...> >
+{
+	typedef t_Idx_Seq<I1..., (t_Ui16) (sizeof... (I1) + I2)...> type;
+};
+
+template <t_Ui16 N> struct t_Idx_Make
+	: t_Idx_Cat<typename t_Idx_Make<N / 2>::type,
+                typename t_Idx_Make<N - N / 2>::type> { };
+
+template <> struct t_Idx_Make<0> { typedef t_Idx_Seq<> type; };
+template <> struct t_Idx_Make<1> { typedef t_Idx_Seq<0> type; };
+
+                   /* Lookup table (an array wrapped into a literal type) */
+template <typename T, t_Ui16 N> struct t_Code_Table { T v[N]; };
+
+                   /* Octal digits of a mode C code (A B C D): */
+static constexpr t_Ui16 mc_digit_a (t_Ui16 mc) { return (mc >> 9) & 0x0007; }
+static constexpr t_Ui16 mc_digit_b (t_Ui16 mc) { return (mc >> 6) & 0x0007; }
+static constexpr t_Ui16 mc_digit_c (t_Ui16 mc) { return (mc >> 3) & 0x0007; }
+static constexpr t_Ui16 mc_digit_d (t_Ui16 mc) { return mc & 0x0007; }
+
+                   /* Factors as in the (loop) algorithm of mc_to_alt(): */
+static constexpr t_Si16 mc_factor_x (t_Ui16 mc)
+{
+	return gg_table[mc_digit_d (mc)];
+}
+static constexpr t_Si16 mc_factor_y (t_Ui16 mc)
+{
+	return (mc_factor_x (mc) & 0x0001) ?
+           gz_table[mc_digit_a (mc)] : gg_table[mc_digit_a (mc)];
+}
+static constexpr t_Si16 mc_factor_z (t_Ui16 mc)
+{
+	return (mc_factor_y (mc) & 0x0001) ?
+           gz_table[mc_digit_b (mc)] : gg_table[mc_digit_b (mc)];
+}
+static constexpr t_Si16 mc_factor_v (t_Ui16 mc)
+{
+	return (mc_factor_z (mc) & 0x0001) ?
+           pz_table[mc_digit_c (mc)] : pg_table[mc_digit_c (mc)];
+}
+
+                   /* Height (in 100 feet) for a 12 bits octal mode C code,
+                      or M_UTL_NVA if not an allowable code: */
+static constexpr t_Si16 mc_entry (t_Ui16 mc)
+{
+	return ((mc & 0x0001) || mc_factor_v (mc) == M_UTL_NVA) ?
+           (t_Si16) M_UTL_NVA :
+           (t_Si16) (mc_factor_x (mc) * 320 + mc_factor_y (mc) * 40 +
+                     mc_factor_z (mc) * 5 + mc_factor_v (mc) - 12);
+}
+
+                   /* Octal code for 12 bits in pulse order
+                      C1 A1 C2 A2 C4 A4 B1 D1 B2 D2 B4 D4
+                      (i. e. with the X pulse removed): */
+static constexpr t_Ui16 ug_entry (t_Ui16 p)
+{
+	return (t_Ui16) ((((p >>  6) & 0x0001) << 11) |   /* A4 */
+                     (((p >>  8) & 0x0001) << 10) |   /* A2 */
+                     (((p >> 10) & 0x0001) <<  9) |   /* A1 */
+                     (((p >>  1) & 0x0001) <<  8) |   /* B4 */
+                     (((p >>  3) & 0x0001) <<  7) |   /* B2 */
+                     (((p >>  5) & 0x0001) <<  6) |   /* B1 */
+                     (((p >>  7) & 0x0001) <<  5) |   /* C4 */
+                     (((p >>  9) & 0x0001) <<  4) |   /* C2 */
+                     (((p >> 11) & 0x0001) <<  3) |   /* C1 */
+                     ((p & 0x0001) << 2) |            /* D4 */
+                     (((p >>  2) & 0x0001) <<  1) |   /* D2 */
+                     ((p >>  4) & 0x0001));           /* D1 */
+}
+
+template <t_Ui16... I>
+static constexpr t_Code_Table<t_Si16, sizeof... (I)> make_mc_table
+	(t_Idx_Seq<I...>)
+{
+	return {{ mc_entry (I)... }};
+}
+
+template <t_Ui16... I>
+static constexpr t_Code_Table<t_Ui16, sizeof... (I)> make_ug_table
+	(t_Idx_Seq<I...>)
+{
+	return {{ ug_entry (I)... }};
+}
+
+                   /* Mode C code (octal ABCD) to height in 100 feet: */
+static constexpr t_Code_Table<t_Si16, 4096> mc_table =
+	make_mc_table (t_Idx_Make<4096>::type ());
+
+                   /* 12 bits pulse order to octal code: */
+static constexpr t_Code_Table<t_Ui16, 4096> ug_table =
+	make_ug_table (t_Idx_Make<4096>::type ());
+
+                   /* Some known values: */
+static_assert (mc_table.v[00040] == -12, "mode C table: -1200 ft");
+static_assert (mc_table.v[00620] == 0, "mode C table: 0 ft");
+static_assert (mc_table.v[06520] == 100, "mode C table: 10000 ft");
+static_assert (mc_table.v[05124] == 350, "mode C table: 35000 ft");
+static_assert (mc_table.v[00042] == 1267, "mode C table: 126700 ft");
+static_assert (mc_table.v[00000] == M_UTL_NVA, "mode C table: no pulses");
+static_assert (mc_table.v[06521] == M_UTL_NVA, "mode C table: D1 set");
+static_assert (ug_table.v[01542] == 06520, "ungarble table");
+static_assert (ug_table.v[03141] == 05124, "ungarble table");
+static_assert (ug_table.v[07777] == 07777, "ungarble table");
 
 static t_Ui16 month_length[12] =
 	{ 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
@@ -993,6 +1113,37 @@ static t_Ui16 month_length[12] =
 	return ch;
 }
 
+/*----------------------------------------------------------------------------*/
+/* expand_idt      -- Expand ICAO 6-bits aircraft identification              */
+/*----------------------------------------------------------------------------*/
+
+ t_Bool expand_idt (const t_Byte *buffer, char *txt)
+{
+                   /* Check parameters: */
+	Assert (buffer != NULL, "Invalid parameter");
+	Assert (txt != NULL, "Invalid parameter");
+
+                   /* Expand and check all characters at once: */
+	return item_idt (buffer, txt);
+}
+
+/*----------------------------------------------------------------------------*/
+/* gillham_to_alt  -- Convert SSR mode C pulses to altitude                   */
+/*----------------------------------------------------------------------------*/
+
+ t_Si16 gillham_to_alt (t_Ui16 pulses)
+{
+	t_Si16 alt;
+
+                   /* The 12 bits are in the order of the reply pulses
+                      (C1 A1 C2 A2 C4 A4 B1 D1 B2 D2 B4 D4), as used
+                      e. g. in I001/100 or I048/100; returns the height
+                      in 100 feet or M_UTL_NVA: */
+	alt = mc_table.v[ug_table.v[pulses & 0x0fff]];
+
+	return alt;
+}
+
 /*----------------------------------------------------------------------------*/
 /* hi_byte         -- Extract high byte                                       */
 /*----------------------------------------------------------------------------*/
@@ -1295,9 +1446,7 @@ static t_Ui16 month_length[12] =
 
  t_Si16 mc_to_alt (t_Ui16 mc)
 {
-	t_Ui16 a, b, c, d;
 	t_Si16 alt;
-	t_Si16 v, x, y, z;
  
                    /* Preset the return value: */
 	alt = M_UTL_NVA;
@@ -1308,53 +1457,9 @@ static t_Ui16 month_length[12] =
 		goto done;
 	}
  
-                   /* Check D1 bit (should be zero): */
-	if (mc & 0x0001)
-	{
-		goto done;
-	}
- 
-                   /* Extract octal digits: */
-	a = ((mc & 0x0e00) >> 9);
-	b = ((mc & 0x01c0) >> 6);
-	c = ((mc & 0x0038) >> 3);
-	d = (mc & 0x0007);
- 
-                   /* Compute factors: */
-	x = gg_table[d];
-	if (x & 0x0001)
-	{
-		y = gz_table[a];
-	}
-	else
-	{
-		y = gg_table[a];
-	}
-	if (y & 0x0001)
-	{
-		z = gz_table[b];
-	}
-	else
-	{
-		z = gg_table[b];
-	}
-	if (z & 0x0001)
-	{
-		v = pz_table[c];
-	}
-	else
-	{
-		v = pg_table[c];
-	}
- 
-                   /* Check if an allowable SSR mode C code: */
-	if (v == M_UTL_NVA)
-	{
-		goto done;
-	}
- 
-                   /* Compute height (in 100 feet): */
-	alt = x * 320 + y * 40 + z * 5 + v - 12;
+                   /* Look up the height (in 100 feet); the table
+                      holds M_UTL_NVA for codes which are not allowed: */
+	alt = mc_table.v[mc];
  
 	done:
 	return alt;
@@ -1720,26 +1825,10 @@ static t_Ui16 month_length[12] =
 
  t_Ui16 ungarble (t_Ui16 bits)
 {
-	t_Ui16 a1, a2, a4, b1, b2, b4, c1, c2, c4, d1, d2, d4;
 	t_Ui16 u;
  
-	c1 = (bits >> 12) & 0x0001;
-	a1 = (bits >> 11) & 0x0001;
-	c2 = (bits >> 10) & 0x0001;
-	a2 = (bits >>  9) & 0x0001;
-	c4 = (bits >>  8) & 0x0001;
-	a4 = (bits >>  7) & 0x0001;
-	b1 = (bits >>  5) & 0x0001;
-	d1 = (bits >>  4) & 0x0001;
-	b2 = (bits >>  3) & 0x0001;
-	d2 = (bits >>  2) & 0x0001;
-	b4 = (bits >>  1) & 0x0001;
-	d4 = bits & 0x0001;
- 
-	u = (a4 << 11) | (a2 << 10) | (a1 << 9) |
-        (b4 << 8) | (b2 << 7) | (b1 << 6) |
-        (c4 << 5) | (c2 << 4) | (c1 << 3) |
-        (d4 << 2) | (d2 << 1) | d1;
+                   /* Drop the X pulse and look up the octal code: */
+	u = ug_table.v[((bits >> 1) & 0x0fc0) | (bits & 0x003f)];
  
 	return u;
 }
@@ -0,0 +1,133 @@
+/*
+ * This file is part of SDDL.
+ *
+ * SDDL is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SDDL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with SDDL.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*----------------------------------------------------------------------------*/
+/* Project:        Surveillance Data Decoder and Lister                       */
+/* File:           variables.cpp                                              */
+/* Contents:       Public variables of the decoder                            */
+/* Author(s):      agent                                                      */
+/* Last change:    2026-10-18                                                 */
+/*----------------------------------------------------------------------------*/
+
+#include "basics.h"
+                   /* Basic system definitions */
+#include "common.h"
+                   /* Common declarations and definitions */
+
+#include <stdio.h>
+#if CHKASS
+#include <setjmp.h>
+#endif
+
+                   /* Public variables: */
+                   /* ----------------- */
+
+t_Adsb adsb;
+                   /* Buffer for ADS-B report information */
+t_Bool after_midnight;
+				   /* After midnight flag */
+				   /* Set from 00:00:00 to approx. 00:01:00 */
+int current_line_number;
+                   /* Current board/line number */
+t_Bool current_line_number_defined;
+                   /* Current board/line number defined */
+t_Byte current_stns;
+                   /* Current system track numbering scheme */
+t_Bool current_stns_defined;
+                   /* Current system track numbering scheme defined */
+t_Ui16 current_stns_dsi;
+                   /* Associated data source identifier */
+FILE *exc_file;
+                   /* Pointer to special output file */
+t_Frame_Time first_frame_time;
+                   /* First frame time */
+t_Date frame_date;
+                   /* Frame date */
+t_Bool frame_date_present;
+                   /* Frame date present */
+t_Secs frame_time;
+                   /* Frame time; seconds */
+t_Bool frame_time_present;
+                   /* Frame time present */
+t_Ui32 frames_count;
+				   /* Input frames count */
+FILE *input_file;
+				   /* Pointer to input file */
+t_Ui32 input_frames;
+                   /* Number of frames read (and listed) from
+                      input file */
+t_Ui32 input_length;
+                   /* Number of bytes read (and listed) from
+                      input file */
+t_Ui32 input_offset;
+				   /* Offset within input file */
+t_Ui32 input_rtm;
+                   /* Relative time within input file */
+t_Frame_Time last_frame_time;
+                   /* Last frame time */
+t_Ui16 last_sacsic;
+                   /* Last radar SAC/SIC */
+t_Bool last_sacsic_available;
+                   /* Last radar SAC/SIC */
+t_Ui16 last_service_sacsic;
+                   /* SAC/SIC of last radar service message */
+t_Bool last_service_sacsic_available;
+                   /* SAC/SIC of last radar service message available */
+t_Ui32 last_tod;
+                   /* Last time of day; 1/128 seconds */
+				   /* Needed to transfer full time_of_day values
+				      between radar links, i.e. to allow radar
+				      links without radar service messages to
+				      fill up the truncated time_of_day */
+t_Bool last_tod_available;
+                   /* Last time of day available flag */ 
+#if LISTER
+FILE *list_file;
+				   /* Pointer to list file */
+#endif /* LISTER */
+t_Mlat mlat;
+                   /* Buffer for multilateration report information */
+t_Ui16 number_of_sensor_descriptions;
+                   /* Number of sensor descriptions */
+t_Ui16 records_in_current_frame;
+                   /* Number of records in current frame */
+t_Rsrv rsrv;
+                   /* Buffer for radar service information */
+t_Rtgt rtgt;
+                   /* Buffer for radar target information */
+t_Ssta ssta;
+                   /* Buffer for sensor status information */
+t_Time start_time;
+				   /* Start time of input; milliseconds */
+t_Bool start_time_available;
+				   /* Start time available flag */
+t_Wall_Time start_wall_time;
+				   /* Wall time for start of input */
+t_Step step;
+                   /* System picture step */
+t_Wall_Time stop_wall_time;
+				   /* Wall time for stop of input */
+t_Bool stop_time_available;
+				   /* Stop time available flag */
+t_Strk strk;
+                   /* Buffer for system track information */
+
+#if CHKASS
+jmp_buf on_fatal_error;
+                   /* Label for longjmp() in case of fatal error */
+#endif
+/* end-of-file */